@@ -0,0 +1,585 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "ChakraDynamic.h"
+
+#include "ChakraHelpers.h"
+#include "ChakraValue.h"
+#include "Unicode.h"
+#include "Utf8DebugExtensions.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+// 2^63, the first integer past the range of int64_t. Every integral double
+// below it in magnitude converts to int64_t exactly.
+constexpr double kInt64Limit = 9223372036854775808.0;
+
+void throwIfFailed(JsErrorCode result, const char *api) {
+  if (result == JsNoError) {
+    return;
+  }
+
+  if (result == JsErrorScriptException) {
+    JsValueRef exn = JS_INVALID_REFERENCE;
+    JsGetAndClearException(&exn);
+    std::string exceptionText = ChakraValue(exn).toString().str();
+    throwJSExecutionException("%s failed: %s", api, exceptionText.c_str());
+  }
+
+  throwJSExecutionException(
+      "%s failed with error code %d", api, static_cast<int>(result));
+}
+
+folly::dynamic numberToDynamic(double number) {
+  if (!std::isfinite(number)) {
+    // JSON.stringify writes NaN and Infinity as null.
+    return nullptr;
+  }
+
+  // folly::parseJson reads the digits JSON.stringify writes for these as
+  // int64_t too.
+  if (std::trunc(number) == number && number >= -kInt64Limit &&
+      number < kInt64Limit) {
+    return static_cast<int64_t>(number);
+  }
+
+  return number;
+}
+
+// Array indices go up to 2^32 - 2, past what JsIntToNumber takes.
+JsValueRef indexToNumber(size_t index) {
+  JsValueRef result;
+  if (index <= INT_MAX) {
+    throwIfFailed(
+        JsIntToNumber(static_cast<int>(index), &result), "JsIntToNumber");
+  } else {
+    throwIfFailed(
+        JsDoubleToNumber(static_cast<double>(index), &result),
+        "JsDoubleToNumber");
+  }
+  return result;
+}
+
+std::string stringToStdString(JsValueRef string) {
+  const wchar_t *chars = nullptr;
+  size_t length = 0;
+  throwIfFailed(
+      JsStringToPointer(string, &chars, &length), "JsStringToPointer");
+  return Microsoft::Common::Unicode::Utf16ToUtf8(chars, length);
+}
+
+template <typename T>
+void typedArrayElementsToDynamic(
+    const uint8_t *storage,
+    unsigned count,
+    folly::dynamic &target) {
+  const T *elements = reinterpret_cast<const T *>(storage);
+  for (unsigned i = 0; i < count; ++i) {
+    target.insert(
+        std::to_string(i), numberToDynamic(static_cast<double>(elements[i])));
+  }
+}
+
+class DynamicBuilder {
+ public:
+  DynamicBuilder() {
+    throwIfFailed(
+        JsGetPropertyIdFromName(L"length", &m_lengthId),
+        "JsGetPropertyIdFromName");
+    throwIfFailed(
+        JsGetPropertyIdFromName(L"toJSON", &m_toJSONId),
+        "JsGetPropertyIdFromName");
+
+    // JSON.stringify only writes enumerable own properties, which is what
+    // Object.keys returns; JsGetOwnPropertyNames includes the others too.
+    JsValueRef global;
+    throwIfFailed(JsGetGlobalObject(&global), "JsGetGlobalObject");
+    m_objectKeys = getNamed(getNamed(global, L"Object"), L"keys");
+    throwIfFailed(JsGetUndefinedValue(&m_undefined), "JsGetUndefinedValue");
+  }
+
+  folly::dynamic build(JsValueRef root) {
+    folly::dynamic result;
+    if (!visit(root, result)) {
+      // JSON.stringify returns undefined here, which the JSON path could not
+      // parse either.
+      throwJSExecutionException(
+          "Value cannot be converted to folly::dynamic: it is undefined, a function or a symbol");
+    }
+
+    while (!m_stack.empty()) {
+      // visit() may push onto m_stack, so do not hold a reference to the
+      // frame across it. The frame keeps source and keys alive until it is
+      // popped.
+      Frame &frame = m_stack.back();
+      if (frame.index == frame.length) {
+        m_stack.pop_back();
+        continue;
+      }
+
+      JsValueRef source = frame.source;
+      JsValueRef keys = frame.keys;
+      folly::dynamic *target = frame.target;
+      unsigned index = frame.index++;
+
+      if (keys == JS_INVALID_REFERENCE) {
+        // Elements that cannot be represented stay null, like in JSON.
+        JsValueRef element = getIndexed(source, index);
+        visit(element, (*target)[index]);
+      } else {
+        JsValueRef key = getIndexed(keys, index);
+        JsValueRef member = getIndexed(source, key);
+
+        folly::dynamic converted;
+        bool isContainer = false;
+        if (visit(member, converted, &isContainer)) {
+          folly::dynamic &slot = (*target)[stringToStdString(key)];
+          slot = std::move(converted);
+          if (isContainer) {
+            // The frame pushed by visit() points at the local; retarget it to
+            // the slot now owned by the object. folly::dynamic objects are
+            // node based, so the address stays stable.
+            m_stack.back().target = &slot;
+          }
+        }
+      }
+    }
+
+    return result;
+  }
+
+ private:
+  // Chakra finds the values native code uses by scanning the native stack,
+  // not the heap that m_stack lives on, so frames keep their values alive
+  // themselves: the keys Object.keys returns and the values toJSON returns
+  // are not referenced from anywhere else.
+  struct Frame {
+    Frame(
+        JsValueRef sourceValue,
+        JsValueRef keysValue,
+        folly::dynamic *targetValue,
+        unsigned lengthValue)
+        : source{sourceValue},
+          keys{keysValue},
+          target{targetValue},
+          length{lengthValue} {
+      source.makeProtected();
+      keys.makeProtected();
+    }
+
+    ChakraObject source;
+    ChakraObject keys; // JS_INVALID_REFERENCE for arrays
+    folly::dynamic *target;
+    unsigned index = 0;
+    unsigned length;
+  };
+
+  JsValueRef getNamed(JsValueRef object, const wchar_t *name) {
+    JsPropertyIdRef propertyId;
+    throwIfFailed(
+        JsGetPropertyIdFromName(name, &propertyId), "JsGetPropertyIdFromName");
+    JsValueRef value;
+    throwIfFailed(JsGetProperty(object, propertyId, &value), "JsGetProperty");
+    return value;
+  }
+
+  JsValueRef getIndexed(JsValueRef object, unsigned index) {
+    return getIndexed(object, indexToNumber(index));
+  }
+
+  JsValueRef getIndexed(JsValueRef object, JsValueRef index) {
+    JsValueRef value;
+    throwIfFailed(
+        JsGetIndexedProperty(object, index, &value), "JsGetIndexedProperty");
+    return value;
+  }
+
+  unsigned getLength(JsValueRef object) {
+    JsValueRef lengthRef;
+    throwIfFailed(
+        JsGetProperty(object, m_lengthId, &lengthRef), "JsGetProperty");
+    // Array lengths go up to 2^32 - 1, past what JsNumberToInt returns.
+    double length = 0;
+    throwIfFailed(JsNumberToDouble(lengthRef, &length), "JsNumberToDouble");
+    return static_cast<unsigned>(
+        std::min(std::max(length, 0.0), static_cast<double>(UINT_MAX)));
+  }
+
+  JsValueRef getKeys(JsValueRef object) {
+    JsValueRef args[] = {m_undefined, object};
+    JsValueRef keys;
+    throwIfFailed(
+        JsCallFunction(m_objectKeys, args, 2, &keys), "JsCallFunction");
+    return keys;
+  }
+
+  void pushContainer(
+      JsValueRef source,
+      JsValueRef keys,
+      unsigned length,
+      folly::dynamic &target) {
+    // Only the ancestors of a value are on the stack, so finding it there
+    // means the graph loops back on itself.
+    for (const auto &frame : m_stack) {
+      if (static_cast<JsValueRef>(frame.source) == source) {
+        throwJSExecutionException(
+            "Value cannot be converted to folly::dynamic: it contains a cycle");
+      }
+    }
+    m_stack.emplace_back(source, keys, &target, length);
+  }
+
+  // Converts scalars in place and pushes containers onto m_stack for build()
+  // to fill in. Returns false for values JSON would omit.
+  bool visit(
+      JsValueRef value,
+      folly::dynamic &target,
+      bool *isContainer = nullptr,
+      bool allowToJSON = true) {
+    JsValueType type;
+    throwIfFailed(JsGetValueType(value, &type), "JsGetValueType");
+
+    switch (type) {
+      case JsUndefined:
+      case JsFunction:
+      case JsSymbol:
+        return false;
+
+      case JsNull:
+        target = nullptr;
+        return true;
+
+      case JsBoolean: {
+        bool boolValue;
+        throwIfFailed(JsBooleanToBool(value, &boolValue), "JsBooleanToBool");
+        target = boolValue;
+        return true;
+      }
+
+      case JsNumber: {
+        double number;
+        throwIfFailed(JsNumberToDouble(value, &number), "JsNumberToDouble");
+        target = numberToDynamic(number);
+        return true;
+      }
+
+      case JsString:
+        target = stringToStdString(value);
+        return true;
+
+      case JsArray: {
+        unsigned length = getLength(value);
+        target = folly::dynamic::array();
+        target.resize(length);
+        pushContainer(value, JS_INVALID_REFERENCE, length, target);
+        break;
+      }
+
+      case JsTypedArray:
+        target = folly::dynamic::object();
+        typedArrayToDynamic(value, target);
+        return true;
+
+      default: {
+        if (allowToJSON) {
+          JsValueRef toJSON;
+          throwIfFailed(
+              JsGetProperty(value, m_toJSONId, &toJSON), "JsGetProperty");
+          JsValueType toJSONType;
+          throwIfFailed(JsGetValueType(toJSON, &toJSONType), "JsGetValueType");
+          if (toJSONType == JsFunction) {
+            JsValueRef key;
+            throwIfFailed(JsPointerToString(L"", 0, &key), "JsPointerToString");
+            JsValueRef args[] = {value, key};
+            JsValueRef replacement;
+            throwIfFailed(
+                JsCallFunction(toJSON, args, 2, &replacement),
+                "JsCallFunction");
+            return visit(replacement, target, isContainer, false);
+          }
+        }
+
+        JsValueRef keys = getKeys(value);
+        target = folly::dynamic::object();
+        pushContainer(value, keys, getLength(keys), target);
+        break;
+      }
+    }
+
+    if (isContainer) {
+      *isContainer = true;
+    }
+    return true;
+  }
+
+  void typedArrayToDynamic(JsValueRef value, folly::dynamic &target) {
+    ChakraBytePtr storage;
+    unsigned int byteLength;
+    JsTypedArrayType arrayType;
+    int elementSize;
+    throwIfFailed(
+        JsGetTypedArrayStorage(
+            value, &storage, &byteLength, &arrayType, &elementSize),
+        "JsGetTypedArrayStorage");
+
+    unsigned count = byteLength / static_cast<unsigned>(elementSize);
+    switch (arrayType) {
+      case JsArrayTypeInt8:
+        typedArrayElementsToDynamic<int8_t>(storage, count, target);
+        break;
+      case JsArrayTypeUint8:
+      case JsArrayTypeUint8Clamped:
+        typedArrayElementsToDynamic<uint8_t>(storage, count, target);
+        break;
+      case JsArrayTypeInt16:
+        typedArrayElementsToDynamic<int16_t>(storage, count, target);
+        break;
+      case JsArrayTypeUint16:
+        typedArrayElementsToDynamic<uint16_t>(storage, count, target);
+        break;
+      case JsArrayTypeInt32:
+        typedArrayElementsToDynamic<int32_t>(storage, count, target);
+        break;
+      case JsArrayTypeUint32:
+        typedArrayElementsToDynamic<uint32_t>(storage, count, target);
+        break;
+      case JsArrayTypeFloat32:
+        typedArrayElementsToDynamic<float>(storage, count, target);
+        break;
+      case JsArrayTypeFloat64:
+        typedArrayElementsToDynamic<double>(storage, count, target);
+        break;
+      default:
+        throwJSExecutionException(
+            "Unsupported typed array type %d", static_cast<int>(arrayType));
+    }
+  }
+
+  JsPropertyIdRef m_lengthId = JS_INVALID_REFERENCE;
+  JsPropertyIdRef m_toJSONId = JS_INVALID_REFERENCE;
+  JsValueRef m_objectKeys = JS_INVALID_REFERENCE;
+  JsValueRef m_undefined = JS_INVALID_REFERENCE;
+  std::vector<Frame> m_stack;
+};
+
+class JsValueBuilder {
+ public:
+  explicit JsValueBuilder(PropertyIdCache &propertyIds)
+      : m_propertyIds{propertyIds} {}
+
+  JsValueRef build(const folly::dynamic &root) {
+    JsValueRef result = create(root);
+
+    while (!m_stack.empty()) {
+      // create() may push onto m_stack, so frame must not be used after
+      // calling it.
+      Frame &frame = m_stack.back();
+      JsValueRef target = frame.target;
+
+      if (frame.source->isArray()) {
+        if (frame.index == frame.source->size()) {
+          m_stack.pop_back();
+          continue;
+        }
+
+        size_t index = frame.index++;
+        const folly::dynamic &element = (*frame.source)[index];
+        throwIfFailed(
+            JsSetIndexedProperty(target, indexToNumber(index), create(element)),
+            "JsSetIndexedProperty");
+      } else {
+        if (frame.item == frame.source->items().end()) {
+          m_stack.pop_back();
+          continue;
+        }
+
+        const auto &item = *frame.item++;
+        JsPropertyIdRef propertyId = item.first.isString()
+            ? m_propertyIds.get(item.first.getString())
+            : m_propertyIds.get(item.first.asString());
+        throwIfFailed(
+            JsSetProperty(
+                target,
+                propertyId,
+                create(item.second),
+                true /* useStrictRules */),
+            "JsSetProperty");
+      }
+    }
+
+    return result;
+  }
+
+ private:
+  // Like DynamicBuilder's frames, these keep their target alive while it is
+  // not referenced from the native stack.
+  struct Frame {
+    Frame(
+        const folly::dynamic *sourceValue,
+        JsValueRef targetValue,
+        folly::dynamic::const_item_iterator itemValue)
+        : source{sourceValue}, target{targetValue}, item{itemValue} {
+      target.makeProtected();
+    }
+
+    const folly::dynamic *source;
+    ChakraObject target;
+    size_t index = 0; // for arrays
+    folly::dynamic::const_item_iterator item; // for objects
+  };
+
+  // Converts scalars directly, and creates empty arrays and objects that it
+  // pushes onto m_stack for build() to fill in.
+  JsValueRef create(const folly::dynamic &value) {
+    JsValueRef result = JS_INVALID_REFERENCE;
+
+    switch (value.type()) {
+      case folly::dynamic::NULLT:
+        throwIfFailed(JsGetNullValue(&result), "JsGetNullValue");
+        break;
+
+      case folly::dynamic::BOOL:
+        throwIfFailed(
+            JsBoolToBoolean(value.getBool(), &result), "JsBoolToBoolean");
+        break;
+
+      case folly::dynamic::INT64: {
+        int64_t number = value.getInt();
+        if (number >= INT_MIN && number <= INT_MAX) {
+          throwIfFailed(
+              JsIntToNumber(static_cast<int>(number), &result),
+              "JsIntToNumber");
+        } else {
+          throwIfFailed(
+              JsDoubleToNumber(static_cast<double>(number), &result),
+              "JsDoubleToNumber");
+        }
+        break;
+      }
+
+      case folly::dynamic::DOUBLE:
+        throwIfFailed(
+            JsDoubleToNumber(value.getDouble(), &result), "JsDoubleToNumber");
+        break;
+
+      case folly::dynamic::STRING: {
+        const std::string &string = value.getString();
+        throwIfFailed(
+            JsPointerToStringUtf8(string.c_str(), string.size(), &result),
+            "JsPointerToStringUtf8");
+        break;
+      }
+
+      case folly::dynamic::ARRAY:
+        throwIfFailed(
+            JsCreateArray(static_cast<unsigned int>(value.size()), &result),
+            "JsCreateArray");
+        m_stack.emplace_back(
+            &value, result, folly::dynamic::const_item_iterator{});
+        break;
+
+      case folly::dynamic::OBJECT:
+        throwIfFailed(JsCreateObject(&result), "JsCreateObject");
+        m_stack.emplace_back(&value, result, value.items().begin());
+        break;
+    }
+
+    return result;
+  }
+
+  PropertyIdCache &m_propertyIds;
+  std::vector<Frame> m_stack;
+};
+
+} // namespace
+
+folly::dynamic jsValueToDynamic(JsValueRef value) {
+  return DynamicBuilder().build(value);
+}
+
+JsValueRef dynamicToJsValue(const folly::dynamic &value) {
+  return JsValueBuilder(PropertyIdCache::forCurrentRuntime()).build(value);
+}
+
+/* static */
+PropertyIdCache::Caches &PropertyIdCache::threadCaches() {
+  static thread_local Caches caches;
+  return caches;
+}
+
+/* static */
+JsRuntimeHandle PropertyIdCache::currentRuntime() {
+  JsContextRef context = JS_INVALID_REFERENCE;
+  throwIfFailed(JsGetCurrentContext(&context), "JsGetCurrentContext");
+  JsRuntimeHandle runtime = JS_INVALID_RUNTIME_HANDLE;
+  throwIfFailed(JsGetRuntime(context, &runtime), "JsGetRuntime");
+  return runtime;
+}
+
+/* static */
+PropertyIdCache &PropertyIdCache::forCurrentRuntime() {
+  auto &cache = threadCaches()[currentRuntime()];
+  if (!cache) {
+    cache.reset(new PropertyIdCache());
+  }
+  return *cache;
+}
+
+/* static */
+void PropertyIdCache::clear() {
+  auto &caches = threadCaches();
+  auto it = caches.find(currentRuntime());
+  if (it != caches.end()) {
+    it->second->reset();
+    caches.erase(it);
+  }
+}
+
+JsPropertyIdRef PropertyIdCache::get(const std::string &name) {
+  auto it = m_ids.find(name);
+  if (it != m_ids.end()) {
+    return it->second;
+  }
+
+  JsPropertyIdRef propertyId = JS_INVALID_REFERENCE;
+#if defined(USE_EDGEMODE_JSRT)
+  throwIfFailed(
+      JsGetPropertyIdFromName(
+          Microsoft::Common::Unicode::Utf8ToUtf16(name).c_str(), &propertyId),
+      "JsGetPropertyIdFromName");
+#else
+  throwIfFailed(
+      JsCreatePropertyId(name.c_str(), name.size(), &propertyId),
+      "JsCreatePropertyId");
+#endif
+
+  if (m_ids.size() < MaxEntries) {
+    // Keep the property ID alive for as long as it is cached.
+    throwIfFailed(JsAddRef(propertyId, nullptr), "JsAddRef");
+    m_ids.emplace(name, propertyId);
+  }
+
+  return propertyId;
+}
+
+void PropertyIdCache::reset() {
+  for (const auto &entry : m_ids) {
+    JsRelease(entry.second, nullptr);
+  }
+  m_ids.clear();
+}
+
+} // namespace react
+} // namespace facebook
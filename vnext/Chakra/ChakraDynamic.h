@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <folly/dynamic.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#if defined(USE_EDGEMODE_JSRT)
+#include <jsrt.h>
+#else
+#include <ChakraCore.h>
+#endif
+
+namespace facebook {
+namespace react {
+
+// Converts a Chakra value graph into a folly::dynamic without going through
+// JSON.stringify and folly::parseJson. The result matches what the JSON round
+// trip produces for the data shapes the bridge sends:
+//  - only enumerable own properties of objects are converted,
+//  - undefined, functions and symbols are dropped from objects and become
+//    null inside arrays,
+//  - NaN and +/-Infinity become null,
+//  - integral numbers within the range of int64_t become int64_t, everything
+//    else double,
+//  - objects with a callable toJSON member are replaced by its result,
+//  - typed arrays become objects keyed by element index.
+// Cyclic values throw a ChakraJSException, like JSON.stringify throws a
+// TypeError. The value graph is walked with an explicit stack, so deeply
+// nested values do not exhaust the native stack.
+folly::dynamic jsValueToDynamic(JsValueRef value);
+
+// Builds a Chakra value from a folly::dynamic with JsCreateObject,
+// JsCreateArray and the property setters instead of folly::toJson followed by
+// JSON.parse. Object keys are resolved through the PropertyIdCache of the
+// current runtime. Requires a current context.
+JsValueRef dynamicToJsValue(const folly::dynamic &value);
+
+// Per-thread, per-runtime map from object key to JsPropertyIdRef, so that the
+// keys bridge payloads repeat on every call (event names, style props,
+// "target", ...) are converted to property IDs once instead of once per
+// object. The cache holds a reference on each property ID, so owners of a
+// runtime must call clear() before disposing it.
+class PropertyIdCache {
+ public:
+  PropertyIdCache(const PropertyIdCache &) = delete;
+  PropertyIdCache &operator=(const PropertyIdCache &) = delete;
+
+  // Returns the calling thread's cache for the runtime of the current context.
+  static PropertyIdCache &forCurrentRuntime();
+
+  // Releases the property IDs cached for the runtime of the current context
+  // and drops its cache. Must be called on the runtime's thread while the
+  // runtime is still alive.
+  static void clear();
+
+  JsPropertyIdRef get(const std::string &name);
+
+  size_t size() const {
+    return m_ids.size();
+  }
+
+ private:
+  // Keeps hot keys cached while bounding what a payload with arbitrary keys
+  // (e.g. a map keyed by ids) can pin in memory.
+  static constexpr size_t MaxEntries = 4096;
+
+  PropertyIdCache() = default;
+
+  using Caches =
+      std::unordered_map<JsRuntimeHandle, std::unique_ptr<PropertyIdCache>>;
+
+  static Caches &threadCaches();
+
+  static JsRuntimeHandle currentRuntime();
+
+  // Releases and forgets all cached property IDs.
+  void reset();
+
+  std::unordered_map<std::string, JsPropertyIdRef> m_ids;
+};
+
+} // namespace react
+} // namespace facebook
@@ -27,6 +27,7 @@
 #include <cxxreact/Platform.h>
 #endif
 
+#include "ChakraDynamic.h"
 #include "ChakraNativeModules.h"
 #include "ChakraPlatform.h"
 #include "ChakraTracing.h"
@@ -417,6 +418,10 @@ void ChakraExecutor::terminateOnJSVMThread() {
   --tls_runtimeTracker.RefCount;
 
   if (tls_runtimeTracker.RefCount == 0) {
+    // Cached property IDs must be released while the runtime is alive.
+    JSContextHolder ctx(m_context);
+    PropertyIdCache::clear();
+
 #if !defined(USE_EDGEMODE_JSRT)
     if (tls_runtimeTracker.DebugService) {
       JsErrorCode result = tls_runtimeTracker.DebugService->Close();
@@ -632,8 +637,7 @@ void ChakraExecutor::bindBridge() noexcept {
 void ChakraExecutor::callNativeModules(ChakraValue &&value) {
   SystraceSection s("ChakraExecutor::callNativeModules");
   try {
-    auto calls = value.toJSONString();
-    m_delegate->callNativeModules(*this, folly::parseJson(calls), true);
+    m_delegate->callNativeModules(*this, value.toDynamic(), true);
   } catch (...) {
     std::string message = "Error in callNativeModules()";
     try {
@@ -732,8 +736,7 @@ int64_t ChakraExecutor::getPeakJsMemoryUsage() const noexcept {
 #endif
 
 void ChakraExecutor::flushQueueImmediate(ChakraValue &&queue) {
-  auto queueStr = queue.toJSONString();
-  m_delegate->callNativeModules(*this, folly::parseJson(queueStr), false);
+  m_delegate->callNativeModules(*this, queue.toDynamic(), false);
 }
 
 void ChakraExecutor::loadModule(uint32_t bundleId, uint32_t moduleId) {
@@ -748,8 +751,14 @@ void ChakraExecutor::loadModule(uint32_t bundleId, uint32_t moduleId) {
 
   auto module = m_bundleRegistry->getModule(bundleId, moduleId);
   auto sourceUrl = ChakraString::createExpectingAscii(module.name);
-  auto source = ChakraString(module.code.c_str());
-  evaluateScript(source, sourceUrl);
+#if defined(USE_EDGEMODE_JSRT)
+  evaluateScript(ChakraString(module.code.c_str()), sourceUrl);
+#else
+  // Hand the UTF-8 code over as it is, rather than converting it to UTF-16.
+  auto source = jsArrayBufferFromBigString(
+      std::make_unique<const JSBigStdString>(std::move(module.code)));
+  evaluateScript(source.get(), sourceUrl);
+#endif
 }
 
 // Native JS hooks
@@ -4,6 +4,7 @@
 #include "pch.h"
 
 #include "ChakraHelpers.h"
+#include "ChakraDynamic.h"
 #include "ChakraUtils.h"
 #include "ChakraValue.h"
 #include "Unicode.h"
@@ -264,6 +265,7 @@ MinimalChakraRuntime::MinimalChakraRuntime(bool multithreaded)
                 delete h;
               }},
       context{new JsContextRef, [](JsContextRef *c) {
+                PropertyIdCache::clear();
                 JsSetCurrentContext(JS_INVALID_REFERENCE);
                 delete c;
               }} {
@@ -3,18 +3,10 @@
 
 #include "pch.h"
 
-#include <folly/json.h>
-
+#include "ChakraDynamic.h"
 #include "ChakraHelpers.h"
 #include "ChakraValue.h"
 
-// See the comment under Value::fromDynamic()
-#if !defined(__APPLE__) && defined(WITH_FB_JSC_TUNING)
-#define USE_FAST_FOLLY_DYNAMIC_CONVERSION 1
-#else
-#define USE_FAST_FOLLY_DYNAMIC_CONVERSION 0
-#endif
-
 namespace facebook {
 namespace react {
 
@@ -35,6 +27,10 @@ std::string ChakraValue::toJSONString(unsigned indent) const {
   return ChakraString::ref(stringToAdopt).str();
 }
 
+folly::dynamic ChakraValue::toDynamic() const {
+  return jsValueToDynamic(m_value);
+}
+
 /* static */
 ChakraValue ChakraValue::fromJSON(const ChakraString &json) {
   auto result = JSValueMakeFromJSONString(json);
@@ -46,27 +42,7 @@ ChakraValue ChakraValue::fromJSON(const ChakraString &json) {
 }
 
 JsValueRef ChakraValue::fromDynamic(const folly::dynamic &value) {
-  // JavaScriptCore's iOS APIs have their own version of this direct conversion.
-  // In addition, using this requires exposing some of JSC's private APIs,
-  //  so it's limited to non-apple platforms and to builds that use the custom
-  //  JSC.
-  // Otherwise, we use the old way of converting through JSON.
-#if USE_FAST_FOLLY_DYNAMIC_CONVERSION
-  // Defer GC during the creation of the JSValue, as we don't want
-  //  intermediate objects to be collected.
-  // We could use JSValueProtect(), but it will make the process much slower.
-  JSDeferredGCRef deferGC = JSDeferGarbageCollection(ctx);
-  // Set a global lock for the whole process,
-  //  instead of re-acquiring the lock for each operation.
-  JSLock(ctx);
-  JsValueRef jsVal = Value::fromDynamicInner(ctx, value);
-  JSUnlock(ctx);
-  JSResumeGarbageCollection(ctx, deferGC);
-  return jsVal;
-#else
-  auto json = folly::toJson(value);
-  return fromJSON(ChakraString(json.c_str()));
-#endif
+  return dynamicToJsValue(value);
 }
 
 ChakraObject ChakraValue::asObject() {
@@ -307,13 +307,13 @@ class ChakraValue {
   }
 
   std::string toJSONString(unsigned indent = 0) const;
+  // Walks the value graph directly; see jsValueToDynamic().
+  folly::dynamic toDynamic() const;
   static ChakraValue fromJSON(const ChakraString &json);
   static JsValueRef fromDynamic(const folly::dynamic &value);
 
  protected:
   JsValueRef m_value;
-  // static JsValueRef fromDynamicInner(JsContextRef ctx, const folly::dynamic&
-  // obj);
 };
 
 } // namespace react
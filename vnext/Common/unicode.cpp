@@ -9,12 +9,263 @@
 #include "stringapiset.h"
 
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <exception>
 #include <string>
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define UNICODE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace Microsoft::Common::Unicode {
 
+namespace {
+
+// Almost every string converted here (bundles, property names, module and
+// method names, file paths) is well-formed, and most of it is ASCII. The
+// functions below convert well-formed strings in a single pass, copying ASCII
+// runs 16 code units at a time. They return false as soon as they find an
+// ill-formed sequence, and the caller falls back to the conversion APIs of
+// the OS, so that how ill-formed strings are converted (and which errors are
+// reported) does not change.
+
+// Widens the ASCII prefix of utf8 into utf16, and returns its length.
+template <typename TChar16>
+size_t WidenAsciiPrefix(
+    const char *utf8,
+    size_t utf8Len,
+    TChar16 *utf16) noexcept {
+  size_t i = 0;
+#ifdef UNICODE_USE_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= utf8Len; i += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf8 + i));
+    if (_mm_movemask_epi8(chunk) != 0) {
+      break;
+    }
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(utf16 + i),
+        _mm_unpacklo_epi8(chunk, zero));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(utf16 + i + 8),
+        _mm_unpackhi_epi8(chunk, zero));
+  }
+#else
+  for (; i + 8 <= utf8Len; i += 8) {
+    uint64_t chunk;
+    memcpy(&chunk, utf8 + i, sizeof(chunk));
+    if ((chunk & 0x8080808080808080ull) != 0) {
+      break;
+    }
+    for (size_t j = i; j < i + 8; ++j) {
+      utf16[j] = static_cast<TChar16>(utf8[j]);
+    }
+  }
+#endif
+  for (; i < utf8Len && static_cast<uint8_t>(utf8[i]) < 0x80; ++i) {
+    utf16[i] = static_cast<TChar16>(utf8[i]);
+  }
+  return i;
+}
+
+// Narrows the ASCII prefix of utf16 into utf8, and returns its length.
+template <typename TChar16>
+size_t NarrowAsciiPrefix(
+    const TChar16 *utf16,
+    size_t utf16Len,
+    char *utf8) noexcept {
+  static_assert(sizeof(TChar16) == 2, "TChar16 must be a UTF-16 code unit");
+  size_t i = 0;
+#ifdef UNICODE_USE_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i nonAsciiBits = _mm_set1_epi16(static_cast<short>(0xff80));
+  for (; i + 16 <= utf16Len; i += 16) {
+    const __m128i low =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf16 + i));
+    const __m128i high =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf16 + i + 8));
+    const __m128i nonAscii =
+        _mm_and_si128(_mm_or_si128(low, high), nonAsciiBits);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, zero)) != 0xffff) {
+      break;
+    }
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(utf8 + i), _mm_packus_epi16(low, high));
+  }
+#else
+  for (; i + 4 <= utf16Len; i += 4) {
+    uint64_t chunk;
+    memcpy(&chunk, utf16 + i, sizeof(chunk));
+    if ((chunk & 0xff80ff80ff80ff80ull) != 0) {
+      break;
+    }
+    for (size_t j = i; j < i + 4; ++j) {
+      utf8[j] = static_cast<char>(utf16[j]);
+    }
+  }
+#endif
+  for (; i < utf16Len && static_cast<uint16_t>(utf16[i]) < 0x80; ++i) {
+    utf8[i] = static_cast<char>(utf16[i]);
+  }
+  return i;
+}
+
+inline bool IsContinuationByte(uint8_t byte) noexcept {
+  return (byte & 0xc0) == 0x80;
+}
+
+// Decodes the non-ASCII UTF-8 sequence at the start of utf8, and returns its
+// length, or 0 if it is not one of the well-formed sequences of table 3-7 of
+// the Unicode standard (overlong forms, surrogates and code points above
+// U+10FFFF are not).
+inline size_t DecodeUtf8Sequence(
+    const uint8_t *utf8,
+    size_t utf8Len,
+    uint32_t &codePoint) noexcept {
+  const uint8_t lead = utf8[0];
+  if (lead < 0xc2) {
+    // A continuation byte, or the lead byte of an overlong form.
+    return 0;
+  }
+
+  if (lead < 0xe0) {
+    if (utf8Len < 2 || !IsContinuationByte(utf8[1])) {
+      return 0;
+    }
+    codePoint = ((lead & 0x1fu) << 6) | (utf8[1] & 0x3fu);
+    return 2;
+  }
+
+  if (lead < 0xf0) {
+    const uint8_t lowest = lead == 0xe0 ? 0xa0 : 0x80;
+    const uint8_t highest = lead == 0xed ? 0x9f : 0xbf;
+    if (utf8Len < 3 || utf8[1] < lowest || utf8[1] > highest ||
+        !IsContinuationByte(utf8[2])) {
+      return 0;
+    }
+    codePoint = ((lead & 0x0fu) << 12) | ((utf8[1] & 0x3fu) << 6) |
+        (utf8[2] & 0x3fu);
+    return 3;
+  }
+
+  if (lead < 0xf5) {
+    const uint8_t lowest = lead == 0xf0 ? 0x90 : 0x80;
+    const uint8_t highest = lead == 0xf4 ? 0x8f : 0xbf;
+    if (utf8Len < 4 || utf8[1] < lowest || utf8[1] > highest ||
+        !IsContinuationByte(utf8[2]) || !IsContinuationByte(utf8[3])) {
+      return 0;
+    }
+    codePoint = ((lead & 0x07u) << 18) | ((utf8[1] & 0x3fu) << 12) |
+        ((utf8[2] & 0x3fu) << 6) | (utf8[3] & 0x3fu);
+    return 4;
+  }
+
+  return 0;
+}
+
+template <typename TString>
+bool TryUtf8ToUtf16(const char *utf8, size_t utf8Len, TString &utf16) {
+  using TChar16 = typename TString::value_type;
+
+  // No code point takes more UTF-16 code units than UTF-8 ones.
+  utf16.resize(utf8Len);
+  TChar16 *const begin = &utf16[0];
+  TChar16 *out = begin;
+  const auto *bytes = reinterpret_cast<const uint8_t *>(utf8);
+
+  size_t i = 0;
+  while (i < utf8Len) {
+    const size_t asciiLength = WidenAsciiPrefix(utf8 + i, utf8Len - i, out);
+    i += asciiLength;
+    out += asciiLength;
+
+    while (i < utf8Len && bytes[i] >= 0x80) {
+      uint32_t codePoint;
+      const size_t length =
+          DecodeUtf8Sequence(bytes + i, utf8Len - i, codePoint);
+      if (length == 0) {
+        return false;
+      }
+
+      if (codePoint < 0x10000) {
+        *out++ = static_cast<TChar16>(codePoint);
+      } else {
+        codePoint -= 0x10000;
+        *out++ = static_cast<TChar16>(0xd800 + (codePoint >> 10));
+        *out++ = static_cast<TChar16>(0xdc00 + (codePoint & 0x3ff));
+      }
+      i += length;
+    }
+  }
+
+  utf16.resize(out - begin);
+  return true;
+}
+
+template <typename TChar16>
+bool TryUtf16ToUtf8(const TChar16 *utf16, size_t utf16Len, std::string &utf8) {
+  // Assume the string is ASCII until it is not.
+  utf8.resize(utf16Len);
+  size_t i = NarrowAsciiPrefix(utf16, utf16Len, &utf8[0]);
+  if (i == utf16Len) {
+    return true;
+  }
+
+  // Size the rest of the string, rejecting unpaired surrogates.
+  size_t utf8Length = i;
+  for (size_t j = i; j < utf16Len; ++j) {
+    const uint16_t unit = static_cast<uint16_t>(utf16[j]);
+    if (unit < 0x80) {
+      utf8Length += 1;
+    } else if (unit < 0x800) {
+      utf8Length += 2;
+    } else if (unit < 0xd800 || unit > 0xdfff) {
+      utf8Length += 3;
+    } else if (
+        unit < 0xdc00 && j + 1 < utf16Len &&
+        (static_cast<uint16_t>(utf16[j + 1]) & 0xfc00) == 0xdc00) {
+      utf8Length += 4;
+      ++j;
+    } else {
+      return false;
+    }
+  }
+
+  utf8.resize(utf8Length);
+  char *out = &utf8[i];
+  while (i < utf16Len) {
+    const size_t asciiLength = NarrowAsciiPrefix(utf16 + i, utf16Len - i, out);
+    i += asciiLength;
+    out += asciiLength;
+
+    while (i < utf16Len && static_cast<uint16_t>(utf16[i]) >= 0x80) {
+      uint32_t codePoint = static_cast<uint16_t>(utf16[i++]);
+      if (codePoint < 0x800) {
+        *out++ = static_cast<char>(0xc0 | (codePoint >> 6));
+      } else {
+        if (codePoint < 0xd800 || codePoint > 0xdfff) {
+          *out++ = static_cast<char>(0xe0 | (codePoint >> 12));
+        } else {
+          // Surrogates were paired up above.
+          codePoint = 0x10000 + ((codePoint - 0xd800) << 10) +
+              (static_cast<uint16_t>(utf16[i++]) - 0xdc00);
+          *out++ = static_cast<char>(0xf0 | (codePoint >> 18));
+          *out++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+        }
+        *out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+      }
+      *out++ = static_cast<char>(0x80 | (codePoint & 0x3f));
+    }
+  }
+
+  return true;
+}
+
+} // namespace
+
 // The implementations of the following functions heavily reference the MSDN
 // article at https://msdn.microsoft.com/en-us/magazine/mt763237.aspx.
 
@@ -33,6 +284,10 @@ std::wstring Utf8ToUtf16(const char *utf8, size_t utf8Len) {
         "Length of input string to Utf8ToUtf16() must fit into an int.");
   }
 
+  if (TryUtf8ToUtf16(utf8, utf8Len, utf16)) {
+    return utf16;
+  }
+
   const int utf8Length = static_cast<int>(utf8Len);
 
   // We do not specify MB_ERR_INVALID_CHARS here, which means that invalid UTF-8
@@ -116,6 +371,10 @@ std::string Utf16ToUtf8(const wchar_t *utf16, size_t utf16Len) {
         "Length of input string to Utf16ToUtf8() must fit into an int.");
   }
 
+  if (TryUtf16ToUtf8(utf16, utf16Len, utf8)) {
+    return utf8;
+  }
+
   const int utf16Length = static_cast<int>(utf16Len);
 
   // We do not specify WC_ERR_INVALID_CHARS here, which means that invalid
@@ -60,6 +60,9 @@ ChakraRuntimeHolder::RuntimeArgsFromDevSettings(
 
   runtimeArgs.memoryTracker = devSettings->memoryTracker;
 
+  runtimeArgs.prepareScriptsInBackground =
+      devSettings->prepareScriptsInBackground;
+
   return runtimeArgs;
 }
 
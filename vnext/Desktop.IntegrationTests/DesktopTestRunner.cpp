@@ -68,8 +68,9 @@ shared_ptr<ITestInstance> TestRunner::GetInstance(
               nativeQueue),
           make_tuple(
               "Networking",
-              []() -> unique_ptr<CxxModule> {
-                return make_unique<Microsoft::React::NetworkingModule>();
+              [nativeQueue]() -> unique_ptr<CxxModule> {
+                return make_unique<Microsoft::React::NetworkingModule>(
+                    nativeQueue);
               },
               nativeQueue),
           make_tuple(
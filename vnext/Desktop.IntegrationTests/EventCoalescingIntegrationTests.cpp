@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+
+#include <CreateModules.h>
+#include <DevSettings.h>
+#include <IUIManager.h>
+#include <InstanceManager.h>
+#include <Modules/AppStateModule.h>
+#include "ChakraRuntimeHolder.h"
+#include "TestInstance.h"
+#include "TestMessageQueueThread.h"
+#include "TestModule.h"
+#include "TestRootView.h"
+
+#include <atomic>
+#include <future>
+
+using namespace facebook::react;
+using namespace facebook::xplat::module;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+using std::make_shared;
+using std::make_tuple;
+using std::make_unique;
+using std::promise;
+using std::shared_ptr;
+using std::string;
+using std::tuple;
+using std::unique_ptr;
+using std::vector;
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(EventCoalescingIntegrationTests) {
+  TEST_METHOD(EventsSentWhileJSIsBusyAreCoalesced) {
+    std::atomic_bool mounted{false};
+    promise<void> mountedPromise;
+
+    auto nativeQueue = make_shared<TestMessageQueueThread>();
+    auto jsQueue = make_shared<TestMessageQueueThread>();
+
+    vector<unique_ptr<IViewManager>> viewManagers;
+    viewManagers.push_back(make_unique<TestViewManager>("RCTView"));
+    viewManagers.push_back(make_unique<TestViewManager>("RCTText"));
+    viewManagers.push_back(make_unique<TestViewManager>("RCTRawText"));
+    auto uiManager =
+        createIUIManager(std::move(viewManagers), new TestNativeUIManager());
+
+    vector<tuple<string, CxxModule::Provider, shared_ptr<MessageQueueThread>>>
+        modules{
+            make_tuple(
+                TestModule::name,
+                [&mounted, &mountedPromise]() -> unique_ptr<CxxModule> {
+                  return make_unique<TestModule>(
+                      [&mounted, &mountedPromise](bool /*success*/) {
+                        if (!mounted.exchange(true))
+                          mountedPromise.set_value();
+                      });
+                },
+                nativeQueue),
+            make_tuple(
+                "Timing",
+                [nativeQueue]() -> unique_ptr<CxxModule> {
+                  return CreateTimingModule(nativeQueue);
+                },
+                nativeQueue),
+            make_tuple(
+                AppStateModule::name,
+                []() -> unique_ptr<CxxModule> {
+                  return make_unique<AppStateModule>(make_unique<AppState>());
+                },
+                nativeQueue),
+            make_tuple(
+                "UIManager",
+                [uiManager]() -> unique_ptr<CxxModule> {
+                  return createUIManagerModule(uiManager);
+                },
+                nativeQueue),
+            make_tuple(
+                TestDeviceInfoModule::name,
+                []() -> unique_ptr<CxxModule> {
+                  return make_unique<TestDeviceInfoModule>();
+                },
+                nativeQueue)};
+
+    auto devSettings = make_shared<DevSettings>();
+    devSettings->debugHost = "localhost:8081";
+    devSettings->liveReloadCallback = []() {};
+    devSettings->platformName = "windesktop";
+    devSettings->jsiRuntimeHolder = make_shared<ChakraRuntimeHolder>(
+        devSettings, jsQueue, nullptr, nullptr);
+
+    auto instance = CreateReactInstance(
+        "",
+        std::move(modules),
+        std::move(uiManager),
+        jsQueue,
+        std::move(nativeQueue),
+        std::move(devSettings));
+    instance->loadBundle("IntegrationTests/DummyTest");
+
+    // Once the app is mounted, JS has registered RCTEventEmitter.
+    TestRootView rootView{"DummyTest"};
+    instance->AttachMeasuredRootView(&rootView, {});
+    Assert::IsTrue(
+        mountedPromise.get_future().wait_for(std::chrono::seconds(30)) ==
+        std::future_status::ready);
+
+    // Keeps the JS thread busy while the events are sent. No view has the
+    // tag, so JS drops the events it receives.
+    promise<void> resume;
+    std::shared_future<void> resumed = resume.get_future().share();
+    jsQueue->runOnQueue([resumed]() { resumed.wait(); });
+
+    auto before = instance->GetEventCounters();
+    for (int i = 0; i < 3; ++i) {
+      instance->DispatchEvent(
+          12345,
+          "topScroll",
+          folly::dynamic::object(
+              "contentOffset", folly::dynamic::object("x", 0)("y", i)));
+    }
+    instance->DispatchEvent(
+        12345, "topScrollEndDrag", folly::dynamic::object());
+    instance->DispatchEvent(
+        12345,
+        "topScroll",
+        folly::dynamic::object(
+            "contentOffset", folly::dynamic::object("x", 0)("y", 3)));
+
+    auto busy = instance->GetEventCounters();
+    Assert::IsTrue(before.queued + 5 == busy.queued);
+    Assert::IsTrue(before.coalesced + 2 == busy.coalesced);
+    Assert::IsTrue(before.drained == busy.drained);
+
+    resume.set_value();
+    jsQueue->runOnQueueSync([]() {});
+
+    auto after = instance->GetEventCounters();
+    Assert::IsTrue(busy.queued == after.queued);
+    Assert::IsTrue(busy.coalesced == after.coalesced);
+    Assert::IsTrue(before.drained + 1 == after.drained);
+
+    instance->DetachRootView(&rootView);
+  }
+};
+
+} // namespace Microsoft::React::Test
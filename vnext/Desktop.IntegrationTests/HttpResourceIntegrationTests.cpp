@@ -2,60 +2,442 @@
 // Licensed under the MIT License.
 
 #include <CppUnitTest.h>
+#include <HttpEngine.h>
 #include <IHttpResource.h>
+#include <Test/HttpServer.h>
+#include "TestMessageQueueThread.h"
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <thread>
 
 using namespace Microsoft::React;
 using namespace folly;
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
+namespace http = boost::beast::http;
+
+using Microsoft::React::Experimental::HttpEngine;
+using std::make_shared;
 using std::string;
 using std::vector;
 
-TEST_CLASS(HttpResourceIntegrationTest){
-    TEST_METHOD(MakeIsNotNull){auto rc = IHttpResource::Make();
-Assert::IsFalse(nullptr == rc);
+namespace {
+
+std::shared_ptr<Test::HttpServer> StartServer(
+    string body = "hello",
+    std::chrono::milliseconds delay = {}) {
+  auto server = make_shared<Test::HttpServer>("127.0.0.1", 5558);
+  server->SetOnResponseSent([]() {});
+  server->SetOnGet(
+      [body, delay](const http::request<http::string_body> &request) {
+        std::this_thread::sleep_for(delay);
+        http::response<http::dynamic_body> response{http::status::ok,
+                                                    request.version()};
+        response.body() = Test::CreateStringResponseBody(string{body});
+        response.prepare_payload();
+        return response;
+      });
+  // Echoes the body of the request.
+  server->SetOnPost([](const http::request<http::string_body> &request) {
+    http::response<http::dynamic_body> response{http::status::ok,
+                                                request.version()};
+    response.body() = Test::CreateStringResponseBody(string{request.body()});
+    response.prepare_payload();
+    return response;
+  });
+  server->Start();
+
+  return server;
 }
 
-TEST_METHOD(RequestGetSucceeds) {
-  auto rc = IHttpResource::Make();
-  bool sent = false;
-  bool received = false;
+struct Result {
+  string body;
   string error;
-  rc->SetOnRequest([&sent]() { sent = true; });
-  rc->SetOnResponse([&received](const string &message) { received = true; });
-  rc->SetOnError([&error](const string &message) { error = message; });
+  bool isTimeout{false};
+};
 
-  rc->SendRequest(
-      "GET",
-      "http://localhost:8081/debugger-ui",
-      {},
-      dynamic(),
-      "text",
-      false,
-      1000,
-      [](int64_t) {});
+Result Get(HttpEngine &engine, std::chrono::milliseconds timeout = {}) {
+  std::promise<Result> result;
+  HttpEngine::Handlers handlers;
+  handlers.OnResponse = [&result](HttpEngine::Response &&response) {
+    result.set_value({std::move(response.body())});
+  };
+  handlers.OnError = [&result](const string &message, bool isTimeout) {
+    result.set_value({{}, message, isTimeout});
+  };
 
-  Assert::IsTrue(sent);
-  Assert::IsTrue(received);
-  Assert::AreEqual(string(), error);
+  HttpEngine::Request request{http::verb::get, "/", 11};
+  request.set(http::field::host, "localhost:5558");
+  engine.Send(
+      "localhost", "5558", std::move(request), timeout, std::move(handlers));
+
+  return result.get_future().get();
 }
 
-TEST_METHOD(RequestGetFails) {
-  auto rc = IHttpResource::Make();
-  string error;
-  rc->SetOnError([&error](const string &message) { error = message; });
+// About a megabyte of text, with two-byte UTF-8 sequences that parts of the
+// body are likely to split.
+string LargeText() {
+  std::stringstream text;
+  for (int i = 0; i < 100000; ++i) {
+    text << "line " << i << " \xC3\xA9\n";
+  }
+  return text.str();
+}
+
+// Sends its body in small parts, without saying how large it is.
+class UnknownSizeSource : public HttpEngine::BodySource {
+  string m_body;
+  size_t m_offset{0};
+
+ public:
+  explicit UnknownSizeSource(string &&body) : m_body{std::move(body)} {}
+
+  int64_t Size() const noexcept override {
+    return -1;
+  }
+
+  bool Next(std::string_view &part) noexcept override {
+    part = std::string_view{m_body}.substr(m_offset, 1000);
+    m_offset += part.size();
+    return true;
+  }
+
+  bool Rewind() noexcept override {
+    m_offset = 0;
+    return true;
+  }
+};
 
-  rc->SendRequest(
-      "GET",
-      "http://nonexistinghost",
+// Sends a POST request with bodyData and returns the echoed body.
+string Post(IHttpResource &rc, dynamic bodyData) {
+  std::promise<string> done;
+  rc.SetOnResponse([&done](const string &message) { done.set_value(message); });
+  rc.SetOnError(
+      [&done](const string &message) { done.set_value("error: " + message); });
+
+  rc.SendRequest(
+      "POST",
+      "http://localhost:5558/",
       {},
-      dynamic(),
+      std::move(bodyData),
       "text",
       false,
-      1000,
+      0,
       [](int64_t) {});
 
-  Assert::AreEqual(string("No such host is known"), error);
-}
+  return done.get_future().get();
 }
-;
+
+} // namespace
+
+TEST_CLASS(HttpResourceIntegrationTest) {
+  TEST_METHOD(MakeIsNotNull) {
+    auto rc = IHttpResource::Make();
+    Assert::IsFalse(nullptr == rc);
+  }
+
+  TEST_METHOD(RequestGetSucceeds) {
+    auto server = StartServer();
+    auto rc = IHttpResource::Make();
+    std::promise<void> sent;
+    std::promise<string> done;
+    rc->SetOnRequest([&sent]() { sent.set_value(); });
+    rc->SetOnResponse(
+        [&done](const string &message) { done.set_value(message); });
+    rc->SetOnError([&done](const string &message) {
+      done.set_value("error: " + message);
+    });
+
+    rc->SendRequest(
+        "GET",
+        "http://localhost:5558/",
+        {},
+        dynamic(),
+        "text",
+        false,
+        1000,
+        [](int64_t) {});
+
+    auto response = done.get_future().get();
+    server->Stop();
+
+    Assert::IsTrue(
+        sent.get_future().wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready);
+    Assert::AreEqual(string("hello"), response);
+  }
+
+  TEST_METHOD(RequestGetFails) {
+    auto rc = IHttpResource::Make();
+    std::promise<string> error;
+    rc->SetOnError(
+        [&error](const string &message) { error.set_value(message); });
+
+    rc->SendRequest(
+        "GET",
+        "http://nonexistinghost",
+        {},
+        dynamic(),
+        "text",
+        false,
+        1000,
+        [](int64_t) {});
+
+    Assert::AreEqual(
+        string("No such host is known"), error.get_future().get());
+  }
+
+  TEST_METHOD(ReusesKeptAliveConnections) {
+    auto server = StartServer();
+    {
+      HttpEngine engine{HttpEngine::Options{}};
+      for (int i = 0; i < 3; ++i) {
+        auto result = Get(engine);
+        Assert::AreEqual(string(), result.error);
+        Assert::AreEqual(string("hello"), result.body);
+      }
+
+      auto counters = engine.GetCounters();
+      Assert::IsTrue(counters.connectionsOpened == 1);
+      Assert::IsTrue(counters.connectionsReused == 2);
+      Assert::IsTrue(counters.dnsLookups == 1);
+    }
+    server->Stop();
+  }
+
+  TEST_METHOD(RequestTimesOut) {
+    auto server = StartServer("hello", std::chrono::milliseconds(500));
+    {
+      HttpEngine engine{HttpEngine::Options{}};
+      auto result = Get(engine, std::chrono::milliseconds(50));
+      Assert::IsTrue(result.isTimeout);
+      Assert::AreEqual(string(), result.body);
+    }
+    server->Stop();
+  }
+
+  TEST_METHOD(StreamsIncrementalText) {
+    const auto text = LargeText();
+    auto server = StartServer(text);
+    auto queue = make_shared<Test::TestMessageQueueThread>();
+    auto rc = IHttpResource::Make(queue);
+
+    // Delivered on the queue, one at a time.
+    int64_t statusCode = 0;
+    string received;
+    int64_t lastLoaded = 0;
+    int64_t lastTotal = 0;
+    bool splitSequence = false;
+    std::promise<string> done;
+    rc->SetOnResponseReceived(
+        [&statusCode](int64_t status, const IHttpResource::Headers &) {
+          statusCode = status;
+        });
+    rc->SetOnIncrementalData(
+        [&](const string &data, int64_t loaded, int64_t total) {
+          // Slow down, so that the body arrives faster than it is delivered.
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          splitSequence = splitSequence || data.back() == '\xC3';
+          received += data;
+          lastLoaded = loaded;
+          lastTotal = total;
+        });
+    rc->SetOnResponse(
+        [&done](const string &message) { done.set_value(message); });
+    rc->SetOnError([&done](const string &message) {
+      done.set_value("error: " + message);
+    });
+
+    rc->SendRequest(
+        "GET",
+        "http://localhost:5558/",
+        {},
+        dynamic(),
+        "text",
+        true /*useIncrementalUpdates*/,
+        0,
+        [](int64_t) {});
+
+    auto response = done.get_future().get();
+    queue->quitSynchronous();
+    server->Stop();
+
+    Assert::AreEqual(string(), response);
+    Assert::IsTrue(statusCode == 200);
+    Assert::IsTrue(received == text);
+    Assert::IsFalse(splitSequence);
+    Assert::IsTrue(lastLoaded == static_cast<int64_t>(text.size()));
+    Assert::IsTrue(lastTotal == static_cast<int64_t>(text.size()));
+  }
+
+  TEST_METHOD(WritesResponseToFile) {
+    const auto text = LargeText();
+    auto server = StartServer(text);
+    auto path = std::filesystem::temp_directory_path() /
+        "HttpResourceIntegrationTest.txt";
+    auto rc = IHttpResource::Make();
+    rc->SetResponseFile(path.u8string());
+
+    int64_t lastLoaded = 0;
+    std::promise<string> done;
+    rc->SetOnDataProgress(
+        [&lastLoaded](int64_t loaded, int64_t) { lastLoaded = loaded; });
+    rc->SetOnResponse(
+        [&done](const string &message) { done.set_value(message); });
+    rc->SetOnError([&done](const string &message) {
+      done.set_value("error: " + message);
+    });
+
+    rc->SendRequest(
+        "GET",
+        "http://localhost:5558/",
+        {},
+        dynamic(),
+        "file",
+        true /*useIncrementalUpdates*/,
+        0,
+        [](int64_t) {});
+
+    auto response = done.get_future().get();
+    server->Stop();
+
+    Assert::AreEqual(path.u8string(), response);
+    Assert::IsTrue(lastLoaded == static_cast<int64_t>(text.size()));
+
+    std::ifstream file{path, std::ios::binary};
+    std::stringstream contents;
+    contents << file.rdbuf();
+    file.close();
+    std::filesystem::remove(path);
+    Assert::IsTrue(contents.str() == text);
+  }
+
+  TEST_METHOD(GetsBase64Body) {
+    auto server = StartServer(string("hello\xff\x00world", 12));
+    auto rc = IHttpResource::Make();
+
+    for (bool useIncrementalUpdates : {false, true}) {
+      std::promise<string> done;
+      rc->SetOnResponse(
+          [&done](const string &message) { done.set_value(message); });
+      rc->SetOnError([&done](const string &message) {
+        done.set_value("error: " + message);
+      });
+
+      rc->SendRequest(
+          "GET",
+          "http://localhost:5558/",
+          {},
+          dynamic(),
+          "base64",
+          useIncrementalUpdates,
+          0,
+          [](int64_t) {});
+
+      Assert::AreEqual(string("aGVsbG//AHdvcmxk"), done.get_future().get());
+    }
+
+    server->Stop();
+  }
+
+  TEST_METHOD(PostsBase64Body) {
+    auto server = StartServer();
+    auto rc = IHttpResource::Make();
+
+    auto response = Post(*rc, dynamic::object("base64", "aGVsbG8gd29ybGQ="));
+    auto invalid = Post(*rc, dynamic::object("base64", "aGVs*G8="));
+    server->Stop();
+
+    Assert::AreEqual(string("hello world"), response);
+    Assert::AreEqual(string("error: Invalid base64 request body"), invalid);
+  }
+
+  TEST_METHOD(UploadsFileBody) {
+    // Several parts, below the test server's limit on request bodies.
+    const auto text = LargeText().substr(0, 300000);
+    auto path = std::filesystem::temp_directory_path() /
+        "HttpResourceIntegrationTestUpload.txt";
+    {
+      std::ofstream file{path, std::ios::binary};
+      file << text;
+    }
+
+    auto server = StartServer();
+    auto rc = IHttpResource::Make();
+    int64_t lastSent = 0;
+    int64_t lastTotal = 0;
+    rc->SetOnDataSent([&lastSent, &lastTotal](int64_t sent, int64_t total) {
+      lastSent = sent;
+      lastTotal = total;
+    });
+
+    auto response =
+        Post(*rc, dynamic::object("uri", "file://" + path.generic_u8string()));
+    server->Stop();
+    std::filesystem::remove(path);
+
+    Assert::IsTrue(response == text);
+    Assert::IsTrue(lastSent == static_cast<int64_t>(text.size()));
+    Assert::IsTrue(lastTotal == static_cast<int64_t>(text.size()));
+  }
+
+  TEST_METHOD(UploadsFileBodyFromEncodedUri) {
+    auto path = std::filesystem::temp_directory_path() /
+        "HttpResource Integration Test Upload.txt";
+    {
+      std::ofstream file{path, std::ios::binary};
+      file << "hello world";
+    }
+
+    // The URI escapes the spaces, as JS hands it over.
+    string uri = "file://";
+    for (char c : path.generic_u8string()) {
+      if (c == ' ')
+        uri += "%20";
+      else
+        uri += c;
+    }
+
+    auto server = StartServer();
+    auto rc = IHttpResource::Make();
+    auto response = Post(*rc, dynamic::object("uri", uri));
+    server->Stop();
+    std::filesystem::remove(path);
+
+    Assert::AreEqual(string("hello world"), response);
+  }
+
+  TEST_METHOD(SendsBodyOfUnknownSizeChunked) {
+    const auto text = LargeText().substr(0, 100000);
+    auto server = StartServer();
+    HttpEngine engine{HttpEngine::Options{}};
+
+    std::promise<Result> result;
+    HttpEngine::Handlers handlers;
+    handlers.OnResponse = [&result](HttpEngine::Response &&response) {
+      result.set_value({std::move(response.body())});
+    };
+    handlers.OnError = [&result](const string &message, bool isTimeout) {
+      result.set_value({{}, message, isTimeout});
+    };
+
+    HttpEngine::Request request{http::verb::post, "/", 11};
+    request.set(http::field::host, "localhost:5558");
+    engine.Send(
+        "localhost",
+        "5558",
+        std::move(request),
+        std::make_unique<UnknownSizeSource>(string{text}),
+        {},
+        std::move(handlers));
+
+    auto response = result.get_future().get();
+    server->Stop();
+
+    Assert::AreEqual(string(), response.error);
+    Assert::IsTrue(response.body == text);
+  }
+};
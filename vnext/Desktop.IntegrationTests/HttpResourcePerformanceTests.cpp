@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <HttpEngine.h>
+#include <Test/HttpServer.h>
+
+#include <atomic>
+#include <future>
+#include <sstream>
+
+using namespace Microsoft::React;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace http = boost::beast::http;
+
+using Microsoft::React::Experimental::HttpEngine;
+using std::string;
+
+namespace {
+
+struct LoadResult {
+  double seconds{0};
+  uint32_t errors{0};
+  HttpEngine::Counters counters;
+};
+
+// Keeps `concurrency` requests in flight until `total` have completed.
+LoadResult RunLoad(uint32_t concurrency, uint32_t total) {
+  HttpEngine::Options options;
+  options.maxIdleConnectionsPerHost = concurrency;
+  HttpEngine engine{options};
+
+  std::atomic<uint32_t> started{0};
+  std::atomic<uint32_t> completed{0};
+  std::atomic<uint32_t> errors{0};
+  std::promise<void> done;
+
+  std::function<void()> sendNext = [&]() {
+    if (started++ >= total)
+      return;
+
+    HttpEngine::Handlers handlers;
+    handlers.OnResponse = [&](HttpEngine::Response &&) {
+      if (++completed == total)
+        done.set_value();
+      else
+        sendNext();
+    };
+    handlers.OnError = [&](const string &, bool) {
+      ++errors;
+      if (++completed == total)
+        done.set_value();
+      else
+        sendNext();
+    };
+
+    HttpEngine::Request request{http::verb::get, "/", 11};
+    request.set(http::field::host, "localhost:5559");
+    engine.Send(
+        "localhost",
+        "5559",
+        std::move(request),
+        std::chrono::seconds(10),
+        std::move(handlers));
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < concurrency; ++i) {
+    sendNext();
+  }
+  done.get_future().wait();
+
+  LoadResult result;
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  result.errors = errors;
+  result.counters = engine.GetCounters();
+  return result;
+}
+
+} // namespace
+
+TEST_CLASS(HttpResourcePerformanceTest) {
+  ///
+  // Measures the requests per second the shared HTTP engine sustains against a
+  // local server, with 1, 16 and 256 requests in flight.
+  ///
+  TEST_METHOD(RequestsPerSecond) {
+    auto server = std::make_shared<Test::HttpServer>("127.0.0.1", 5559);
+    server->SetOnResponseSent([]() {});
+    server->SetOnGet([](const http::request<http::string_body> &request) {
+      http::response<http::dynamic_body> response{http::status::ok,
+                                                  request.version()};
+      response.body() = Test::CreateStringResponseBody(string(1024, 'x'));
+      response.prepare_payload();
+      return response;
+    });
+    server->Start();
+
+    constexpr uint32_t total = 4096;
+    for (uint32_t concurrency : {1, 16, 256}) {
+      auto result = RunLoad(concurrency, total);
+      Assert::AreEqual(0u, result.errors);
+
+      std::stringstream ss;
+      ss << "HttpEngine(" << concurrency << "): its=" << total
+         << "; tt=" << result.seconds
+         << " s; rps=" << total / result.seconds
+         << "; opened=" << result.counters.connectionsOpened
+         << "; reused=" << result.counters.connectionsReused;
+      Logger::WriteMessage(ss.str().c_str());
+    }
+
+    server->Stop();
+  }
+};
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <ImageCache.h>
+#include <Test/HttpServer.h>
+
+#include <boost/asio/connect.hpp>
+#include <boost/beast/http.hpp>
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+using namespace Microsoft::React;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace http = boost::beast::http;
+
+using boost::asio::ip::tcp;
+using std::make_shared;
+using std::string;
+
+namespace {
+
+ImageCache::Bytes Download(const string &target) {
+  try {
+    boost::asio::io_context context;
+    tcp::resolver resolver{context};
+    tcp::socket socket{context};
+    boost::asio::connect(socket, resolver.resolve("127.0.0.1", "5557"));
+
+    http::request<http::empty_body> request{http::verb::get, target, 11};
+    request.set(http::field::host, "localhost");
+    http::write(socket, request);
+
+    boost::beast::flat_buffer buffer;
+    http::response<http::vector_body<uint8_t>> response;
+    http::read(socket, buffer, response);
+    if (response.result() != http::status::ok)
+      return nullptr;
+
+    return make_shared<const std::vector<uint8_t>>(
+        std::move(response.body()));
+  } catch (const boost::system::system_error &) {
+    return nullptr;
+  }
+}
+
+} // namespace
+
+TEST_CLASS(ImageCacheIntegrationTest) {
+  TEST_METHOD(DownloadsImageOnce) {
+    const string image(4096, 'x');
+    std::atomic<int> getCount{0};
+
+    // Every download the cache starts reaches the server, and is counted.
+    auto server = make_shared<Test::HttpServer>("127.0.0.1", 5557);
+    server->SetOnResponseSent([]() {});
+    server->SetOnGet([&image, &getCount](
+                         const http::request<http::string_body> &request) {
+      ++getCount;
+      http::response<http::dynamic_body> response{http::status::ok,
+                                                  request.version()};
+      response.set(http::field::content_type, "image/png");
+      response.body() = Test::CreateStringResponseBody(string{image});
+      response.prepare_payload();
+      return response;
+    });
+    server->Start();
+
+    auto cache = make_shared<ImageCache>(
+        ImageCache::Options{},
+        [](const ImageCache::Request & /*request*/,
+           ImageCache::Callback &&done) {
+          std::thread([done = std::move(done)]() {
+            done(Download("/image.png"));
+          }).detach();
+        });
+
+    constexpr int requestCount = 3;
+    std::atomic<int> servedCount{0};
+    std::promise<void> served;
+    for (int i = 0; i < requestCount; ++i) {
+      cache->Get(
+          {"http://localhost:5557/image.png"},
+          [&image, &servedCount, &served](ImageCache::Bytes bytes) {
+            Assert::IsTrue(bytes && bytes->size() == image.size());
+            if (++servedCount == requestCount)
+              served.set_value();
+          });
+    }
+
+    Assert::IsTrue(
+        served.get_future().wait_for(std::chrono::seconds(5)) ==
+        std::future_status::ready);
+    server->Stop();
+
+    Assert::AreEqual(1, getCount.load());
+    Assert::IsTrue(
+        cache->Query({"http://localhost:5557/image.png"}) ==
+        ImageCache::Location::Memory);
+  }
+};
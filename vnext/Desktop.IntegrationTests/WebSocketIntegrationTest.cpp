@@ -32,7 +32,10 @@ ws->SetOnConnect([&connected]() { connected = true; });
 
 server->Start();
 ws->Connect();
+promise<void> closed;
+ws->SetOnClose([&closed](CloseCode, const string &) { closed.set_value(); });
 ws->Close(CloseCode::Normal, "Closing");
+closed.get_future().wait();
 server->Stop();
 
 Assert::IsTrue(connected);
@@ -46,9 +49,14 @@ TEST_METHOD(ConnectNoClose) {
   // IWebSocket scope. Ensures object is closed implicitly by destructor.
   {
     auto ws = IWebSocket::Make("ws://localhost:5556/");
-    ws->SetOnConnect([&connected]() { connected = true; });
+    promise<void> connectedPromise;
+    ws->SetOnConnect([&connected, &connectedPromise]() {
+      connected = true;
+      connectedPromise.set_value();
+    });
 
     ws->Connect();
+    connectedPromise.get_future().wait();
   }
 
   server->Stop();
@@ -147,7 +155,10 @@ TEST_METHOD(SendReceiveClose) {
   string received = receivedFuture.get();
   Assert::AreEqual({}, errorMessage);
 
+  promise<void> closed;
+  ws->SetOnClose([&closed](CloseCode, const string &) { closed.set_value(); });
   ws->Close(CloseCode::Normal, "Closing after reading");
+  closed.get_future().wait();
   server->Stop();
 
   Assert::AreEqual({}, errorMessage);
@@ -201,7 +212,10 @@ TEST_METHOD(SendReceiveLargeMessage) {
   future.wait();
   string result = future.get();
 
+  promise<void> closed;
+  ws->SetOnClose([&closed](CloseCode, const string &) { closed.set_value(); });
   ws->Close(CloseCode::Normal, "Closing after reading");
+  closed.get_future().wait();
   server->Stop();
 
   Assert::AreEqual({}, errorMessage);
@@ -253,7 +267,10 @@ TEST_METHOD(AdditionalHeaders) {
 
   Assert::AreEqual({"JSESSIONID=AD9A320CC4034641997FF903F1D10906"}, result);
 
+  promise<void> closed;
+  ws->SetOnClose([&closed](CloseCode, const string &) { closed.set_value(); });
   ws->Close(CloseCode::Normal, "No reason");
+  closed.get_future().wait();
   server->Stop();
 }
 
@@ -274,18 +291,19 @@ TEST_METHOD(SendReceiveSsl) {
   auto result = response.get_future();
   result.wait();
 
+  promise<void> closed;
+  ws->SetOnClose([&closed](CloseCode, const string &) { closed.set_value(); });
   ws->Close(CloseCode::Normal, "Closing after reading");
+  closed.get_future().wait();
   server->Stop();
 
   Assert::AreEqual({"suffixme_response"}, result.get());
 }
 
-// TODO: Use Test::WebSocketServer!!!
-BEGIN_TEST_METHOD_ATTRIBUTE(SendBinary)
-TEST_IGNORE()
-END_TEST_METHOD_ATTRIBUTE()
 TEST_METHOD(SendBinary) {
-  auto ws = IWebSocket::Make("ws://localhost:5555/");
+  auto server = make_shared<Test::WebSocketServer>(5556);
+  server->SetMessageFactory([](string &&message) { return message; });
+  auto ws = IWebSocket::Make("ws://localhost:5556/");
 
   std::vector<string> messages{
       // Empty
@@ -307,16 +325,13 @@ TEST_METHOD(SendBinary) {
   string errorMessage;
   promise<string> responsePromise;
   ws->SetOnMessage([&responsePromise](size_t size, const string &messageIn) {
-    // Ignore on-connect greeting.
-    if (messageIn == "hello")
-      return;
-
     responsePromise.set_value(messageIn);
   });
   ws->SetOnError([&errorMessage](IWebSocket::Error error) {
     errorMessage = error.Message;
   });
 
+  server->Start();
   ws->Connect();
 
   for (size_t i = 0; i < messages.size(); i++) {
@@ -330,9 +345,57 @@ TEST_METHOD(SendBinary) {
     Assert::AreEqual(messages[i], response);
   }
 
+  promise<void> closed;
+  ws->SetOnClose([&closed](CloseCode, const string &) { closed.set_value(); });
   ws->Close(CloseCode::Normal, "Closing after reading");
+  closed.get_future().wait();
+  server->Stop();
+
+  Assert::AreEqual({}, errorMessage);
+}
+
+TEST_METHOD(SendBinaryData) {
+  auto server = make_shared<Test::WebSocketServer>(5556);
+  server->SetMessageFactory([](string &&message) { return message; });
+  auto ws = IWebSocket::Make("ws://localhost:5556/");
+
+  // Larger than a read buffer, with every byte value.
+  string data(100000, '\0');
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i * 7 + i / 256);
+
+  string errorMessage;
+  bool gotBase64 = false;
+  promise<string> response;
+  ws->SetOnMessage([&gotBase64](size_t size, const string &messageIn) {
+    gotBase64 = true;
+  });
+  ws->SetOnBinaryMessage([&response](const IWebSocket::BinaryMessage &parts) {
+    string messageIn;
+    for (auto part : parts)
+      messageIn += part;
+    response.set_value(std::move(messageIn));
+  });
+  ws->SetOnError([&errorMessage](IWebSocket::Error error) {
+    errorMessage = error.Message;
+  });
+
+  server->Start();
+  ws->Connect();
+  ws->SendBinaryData(string{data});
+
+  auto result = response.get_future();
+  result.wait();
+
+  promise<void> closed;
+  ws->SetOnClose([&closed](CloseCode, const string &) { closed.set_value(); });
+  ws->Close(CloseCode::Normal, "Closing after reading");
+  closed.get_future().wait();
+  server->Stop();
 
   Assert::AreEqual({}, errorMessage);
+  Assert::IsFalse(gotBase64);
+  Assert::IsTrue(data == result.get());
 }
 
 TEST_METHOD(SendConsecutive) {
@@ -368,7 +431,10 @@ TEST_METHOD(SendConsecutive) {
   future.wait();
   string result = future.get();
 
+  promise<void> closed;
+  ws->SetOnClose([&closed](CloseCode, const string &) { closed.set_value(); });
   ws->Close(CloseCode::Normal, "Closing");
+  closed.get_future().wait();
   server->Stop();
 
   Assert::AreEqual({}, errorMessage);
@@ -3,6 +3,7 @@
 
 #include <CppUnitTest.h>
 #include <IWebSocket.h>
+#include <Test/WebSocketServer.h>
 
 #include <Windows.h>
 
@@ -11,9 +12,12 @@
 // Standard library includes
 #include <math.h>
 #include <atomic>
+#include <chrono>
 #include <future>
+#include <sstream>
 
 using namespace facebook::react;
+using namespace Microsoft::React;
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 using std::string;
@@ -91,5 +95,62 @@ TEST_METHOD(ProcessThreadsPerResource) {
       (threadCount.load() - startThreadCount) / resourceTotal;
   Assert::IsTrue(threadsPerResource <= expectedThreadsPerResource);
 }
+
+///
+/// Opens 1 to 1000 sockets to a local server, has each of them send a message,
+/// and waits for all the echoes. Logs how long that takes, and how many
+/// threads the process gained, for each number of sockets. The sockets share
+/// one pool of threads, so the number of threads must not grow with them.
+///
+TEST_METHOD(ScalesToManySockets) {
+  for (size_t socketCount : {1, 10, 100, 1000}) {
+    auto server = std::make_shared<Test::WebSocketServer>(5555);
+    server->SetMessageFactory([](string &&message) { return message; });
+    server->Start();
+
+    const int startThreadCount = GetCurrentThreadCount();
+    int threadCount = 0;
+    std::atomic_size_t echoes = 0;
+    std::promise<void> allEchoed;
+    bool echoed = false;
+    const auto start = std::chrono::steady_clock::now();
+
+    // WebSocket resources scope. Closes the sockets when it ends.
+    {
+      vector<unique_ptr<IWebSocket>> resources;
+      for (size_t i = 0; i < socketCount; i++) {
+        auto ws = IWebSocket::Make("ws://localhost:5555/");
+        ws->SetOnMessage([&echoes, &allEchoed, socketCount](
+                             size_t, const string &) {
+          if (++echoes == socketCount)
+            allEchoed.set_value();
+        });
+        ws->Connect();
+        ws->Send("some message");
+        resources.push_back(std::move(ws));
+      }
+
+      // Checked once the sockets are closed and the server stopped.
+      echoed =
+          allEchoed.get_future().wait_for(std::chrono::seconds(30)) ==
+          std::future_status::ready;
+      threadCount = GetCurrentThreadCount();
+    }
+
+    const auto seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    server->Stop();
+    Assert::IsTrue(echoed);
+
+    std::stringstream ss;
+    ss << "WebSocket(" << socketCount << "): tt=" << seconds
+       << " s; threads=" << threadCount - startThreadCount;
+    Logger::WriteMessage(ss.str().c_str());
+
+    // The shared pool, and the threads of the resolver and of the server.
+    Assert::IsTrue(threadCount - startThreadCount <= 8);
+  }
+}
 }
 ;
@@ -3,9 +3,13 @@
 
 #include <cstdlib>
 #include <ctime>
+#include <future>
 #include <iostream>
+#include <sstream>
+#include <thread>
 
 #include <CppUnitTest.h>
+#include <Test/PerfTestHelpers.h>
 #include "AsyncStorageTestClass.h"
 
 #include <AsyncStorage/AsyncStorageManager.h>
@@ -81,13 +85,14 @@ TEST_CLASS(AsyncStorageManagerTest) {
     const std::wstring strOfficeFullPath = strMicrosoftFullPath + L"\\Office";
     const std::wstring strStorageFolderFullPath =
         strOfficeFullPath + L"\\SDXStorage";
-    const std::wstring strStorageFileExtension = L".txt";
-    const std::wstring strStorageFileFullPath = strStorageFolderFullPath +
-        L"\\" + m_storageFileName + strStorageFileExtension;
     // full path should be like -
-    // C:\Users\<username>\AppData\Local\Microsoft\Office\SDXStorage\ReactNativeAsyncStorage.txt
+    // C:\Users\<username>\AppData\Local\Microsoft\Office\SDXStorage\ReactNativeAsyncStorage.kvlog
 
-    DeleteFileW(strStorageFileFullPath.c_str());
+    for (auto extension : {L".txt", L".kvlog", L".kvidx"}) {
+      const std::wstring strStorageFileFullPath =
+          strStorageFolderFullPath + L"\\" + m_storageFileName + extension;
+      DeleteFileW(strStorageFileFullPath.c_str());
+    }
   }
 
   TEST_METHOD_INITIALIZE(Setup) {
@@ -271,6 +276,197 @@ TEST_CLASS(AsyncStorageManagerTest) {
 
     lock.unlock();
   }
+
+  TEST_METHOD(AsyncStorageManagerTest_BatchedWrites) {
+    AsyncStorageManager kvManager(
+        this->m_storageFileName, std::chrono::milliseconds(50));
+    std::function<void(vector<folly::dynamic>)> callback =
+        storeCallbackArgAndNotify;
+
+    // Clear the storage.
+    std::unique_lock<std::recursive_mutex> lock(m);
+    kvManager.executeKVOperation(
+        AsyncStorageManager::AsyncStorageOperation::clear,
+        FollyDynamicConverter::stringVectorAsRetVal(emptyStringVector),
+        callback);
+    cv.wait(lock);
+
+    Assert::IsTrue(returnedValues[0] == dynamicNULL);
+
+    // The callbacks run on the consumer thread, in queue order, before the
+    // notifying callback of the last operation.
+    int succeeded = 0;
+    int failed = 0;
+    std::function<void(vector<folly::dynamic>)> countingCallback =
+        [&succeeded, &failed](vector<folly::dynamic> args) {
+          if (args[0] == dynamicNULL)
+            succeeded++;
+          else
+            failed++;
+        };
+
+    // Overwrites of the same key that end up in one batch.
+    int numOperations = 100;
+    for (int i = 0; i < numOperations; i++) {
+      vector<tuple<string, string>> setArgs = {
+          make_tuple(SAMPLE_KEY_1, std::to_string(i))};
+      folly::dynamic jsSetArgs = folly::dynamic::array;
+      jsSetArgs.push_back(
+          FollyDynamicConverter::tupleStringVectorAsRetVal(setArgs));
+      kvManager.executeKVOperation(
+          AsyncStorageManager::AsyncStorageOperation::multiSet,
+          jsSetArgs,
+          countingCallback);
+    }
+
+    // A failing operation does not fail the rest of its batch.
+    vector<tuple<string, string>> mergeArgs = {
+        make_tuple(SAMPLE_KEY_1, "{\"a\":1}")};
+    folly::dynamic jsMergeArgs = folly::dynamic::array;
+    jsMergeArgs.push_back(
+        FollyDynamicConverter::tupleStringVectorAsRetVal(mergeArgs));
+    kvManager.executeKVOperation(
+        AsyncStorageManager::AsyncStorageOperation::multiMerge,
+        jsMergeArgs,
+        countingCallback);
+
+    vector<tuple<string, string>> setArgs = {
+        make_tuple(SAMPLE_KEY_2, SAMPLE_VAL_2)};
+    folly::dynamic jsLastSetArg = folly::dynamic::array;
+    jsLastSetArg.push_back(
+        FollyDynamicConverter::tupleStringVectorAsRetVal(setArgs));
+    kvManager.executeKVOperation(
+        AsyncStorageManager::AsyncStorageOperation::multiSet,
+        jsLastSetArg,
+        callback);
+    cv.wait(lock);
+
+    Assert::IsTrue(returnedValues[0] == dynamicNULL);
+    Assert::AreEqual(numOperations, succeeded);
+    Assert::AreEqual(1, failed);
+
+    vector<string> getArgs = {SAMPLE_KEY_1};
+    folly::dynamic jsGetArgs = folly::dynamic::array;
+    jsGetArgs.push_back(FollyDynamicConverter::stringVectorAsRetVal(getArgs));
+    kvManager.executeKVOperation(
+        AsyncStorageManager::AsyncStorageOperation::multiGet,
+        jsGetArgs,
+        callback);
+
+    vector<tuple<string, string>> expectedTupleVals = {
+        make_tuple(SAMPLE_KEY_1, std::to_string(numOperations - 1))};
+    folly::dynamic jsRetTupleValues = folly::dynamic::array;
+    jsRetTupleValues.push_back(returnedValues[1]);
+    Assert::IsTrue(returnedValues[0] == dynamicNULL);
+    Assert::IsTrue(
+        FollyDynamicConverter::jsArgAsTupleStringVector(jsRetTupleValues) ==
+        expectedTupleVals);
+
+    // Clear the storage.
+    kvManager.executeKVOperation(
+        AsyncStorageManager::AsyncStorageOperation::clear,
+        FollyDynamicConverter::stringVectorAsRetVal(emptyStringVector),
+        callback);
+    cv.wait(lock);
+
+    Assert::IsTrue(returnedValues[0] == dynamicNULL);
+
+    lock.unlock();
+  }
+
+#ifdef PERF_TESTS
+  // Reads run on the calling threads while writes are queued to the
+  // consumer, so readers should not stall behind commits.
+  TEST_METHOD(AsyncStorageManagerTest_TimeMixedReadWrite) {
+    AsyncStorageManager kvManager(this->m_storageFileName);
+    constexpr int keyCount = 1024;
+    constexpr int threadCount = 4;
+    constexpr int operationsPerThread = 2000;
+
+    auto setArgsFor = [](const string &key, const string &value) {
+      vector<tuple<string, string>> setArgs = {make_tuple(key, value)};
+      folly::dynamic jsSetArgs = folly::dynamic::array;
+      jsSetArgs.push_back(
+          FollyDynamicConverter::tupleStringVectorAsRetVal(setArgs));
+      return jsSetArgs;
+    };
+
+    // Queued operations run in order, so once a write queued last has
+    // called back, all the writes before it are committed.
+    auto waitForWrites = [&kvManager, &setArgsFor]() {
+      std::promise<void> written;
+      kvManager.executeKVOperation(
+          AsyncStorageManager::AsyncStorageOperation::multiSet,
+          setArgsFor(SAMPLE_KEY_2, SAMPLE_VAL_2),
+          [&written](vector<folly::dynamic>) { written.set_value(); });
+      written.get_future().wait();
+    };
+
+    vector<tuple<string, string>> seedArgs;
+    for (int i = 0; i < keyCount; i++)
+      seedArgs.push_back(
+          make_tuple(SAMPLE_KEY_1 + std::to_string(i), SAMPLE_VAL_1));
+    folly::dynamic jsSeedArgs = folly::dynamic::array;
+    jsSeedArgs.push_back(
+        FollyDynamicConverter::tupleStringVectorAsRetVal(seedArgs));
+    kvManager.executeKVOperation(
+        AsyncStorageManager::AsyncStorageOperation::multiSet,
+        jsSeedArgs,
+        [](vector<folly::dynamic>) {});
+    waitForWrites();
+
+    std::function<void(vector<folly::dynamic>)> ignoreResult =
+        [](vector<folly::dynamic>) {};
+    for (int readPercent : {95, 50, 5}) {
+      LARGE_INTEGER elapsed{0};
+      AddTime(elapsed, [&]() {
+        vector<std::thread> threads;
+        for (int t = 0; t < threadCount; t++) {
+          threads.emplace_back([&, t]() {
+            for (int i = 0; i < operationsPerThread; i++) {
+              string key =
+                  SAMPLE_KEY_1 + std::to_string((i * 31 + t) % keyCount);
+              if (i % 100 < readPercent) {
+                folly::dynamic jsGetArgs = folly::dynamic::array;
+                vector<string> getArgs = {key};
+                jsGetArgs.push_back(
+                    FollyDynamicConverter::stringVectorAsRetVal(getArgs));
+                kvManager.executeKVOperation(
+                    AsyncStorageManager::AsyncStorageOperation::multiGet,
+                    jsGetArgs,
+                    ignoreResult);
+              } else {
+                kvManager.executeKVOperation(
+                    AsyncStorageManager::AsyncStorageOperation::multiSet,
+                    setArgsFor(key, SAMPLE_VAL_2 + std::to_string(i)),
+                    ignoreResult);
+              }
+            }
+          });
+        }
+        for (auto &thread : threads)
+          thread.join();
+        waitForWrites();
+      });
+
+      double time = ToSeconds(elapsed);
+      const int operations = threadCount * operationsPerThread;
+
+      std::stringstream ss;
+      ss << "reads=" << readPercent << "%: ops=" << operations
+         << "; tt=" << time << " s; throughput=" << operations / time
+         << " ops/s";
+      Logger::WriteMessage(ss.str().c_str());
+    }
+
+    std::promise<void> cleared;
+    kvManager.executeKVOperation(
+        AsyncStorageManager::AsyncStorageOperation::clear,
+        FollyDynamicConverter::stringVectorAsRetVal(emptyStringVector),
+        [&cleared](vector<folly::dynamic>) { cleared.set_value(); });
+    cleared.get_future().wait();
+  }
+#endif // PERF_TESTS
 };
 
 } // namespace Microsoft::React::Test
@@ -7,6 +7,8 @@
 #include <vector>
 
 #include <CppUnitTest.h>
+#include <Test/PerfTestHelpers.h>
+#include <folly/json.h>
 
 #include <AsyncStorage/KeyValueStorage.h>
 #include <AsyncStorage/StorageFileIO.h>
@@ -8826,6 +8828,370 @@ TEST_CLASS(AsyncStorageTest) {
 
     kvStorage->clear();
   }
+
+  TEST_METHOD(AsyncStorageTest_StaleIndex) {
+    auto kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    kvStorage->clear();
+    kvStorage->multiSet(TestData::BasicRW);
+    kvStorage = nullptr; // writes the index
+
+    const wstring indexPath = storageFilePath(L".kvidx");
+    const wstring savedIndexPath = indexPath + L".saved";
+    Assert::IsTrue(
+        CopyFileW(indexPath.c_str(), savedIndexPath.c_str(), FALSE) != 0);
+
+    kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    kvStorage->multiSet({make_tuple("key1", "newvalue1")});
+    kvStorage->multiRemove({"key2"});
+    kvStorage = nullptr;
+
+    // Simulates a crash after the writes: the index misses the last records,
+    // which have to be replayed on load.
+    Assert::IsTrue(MoveFileExW(
+                       savedIndexPath.c_str(),
+                       indexPath.c_str(),
+                       MOVEFILE_REPLACE_EXISTING) != 0);
+
+    kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    auto results = kvStorage->multiGet({"key0", "key1", "key2", "key3"});
+    vector<tuple<string, string>> expected = {make_tuple("key0", "value0"),
+                                              make_tuple("key1", "newvalue1"),
+                                              make_tuple("key3", "value3")};
+    Assert::IsTrue(results == expected);
+    Assert::AreEqual(static_cast<size_t>(9), kvStorage->getAllKeys().size());
+
+    kvStorage->clear();
+  }
+
+  TEST_METHOD(AsyncStorageTest_CorruptIndex) {
+    auto kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    kvStorage->clear();
+    kvStorage->multiSet(TestData::BasicRW);
+    kvStorage = nullptr; // writes the index
+
+    FILE *index = _wfopen(storageFilePath(L".kvidx").c_str(), L"wb");
+    Assert::IsNotNull(index);
+    const char garbage[] = "not an index, though longer than an index header";
+    fwrite(garbage, 1, sizeof(garbage) - 1, index);
+    fclose(index);
+
+    // The log is replayed, and the index is written again.
+    kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    Assert::IsTrue(kvStorage->multiGet(TestKeys::BasicRW) == TestData::BasicRW);
+    kvStorage->multiSet({make_tuple("key1", "newvalue1")});
+    kvStorage = nullptr;
+
+    kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    Assert::IsTrue(
+        kvStorage->multiGet({"key1"}) ==
+        vector<tuple<string, string>>{make_tuple("key1", "newvalue1")});
+    Assert::AreEqual(static_cast<size_t>(10), kvStorage->getAllKeys().size());
+
+    kvStorage->clear();
+  }
+
+  TEST_METHOD(AsyncStorageTest_TornRecordIsDropped) {
+    auto kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    kvStorage->clear();
+    kvStorage->multiSet(TestData::BasicRW);
+    kvStorage = nullptr;
+
+    // A record header whose key and value never made it to the disk.
+    FILE *log = _wfopen(storageFilePath(L".kvlog").c_str(), L"ab");
+    Assert::IsNotNull(log);
+    const char torn[] = "\x12\x34\x56\x78\x01\x04\x00\x00\x00\x40";
+    fwrite(torn, 1, sizeof(torn) - 1, log);
+    fclose(log);
+
+    kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    Assert::IsTrue(kvStorage->multiGet(TestKeys::BasicRW) == TestData::BasicRW);
+
+    vector<tuple<string, string>> setVector = {make_tuple("ABC", "123")};
+    kvStorage->multiSet(setVector);
+    kvStorage = nullptr;
+
+    kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    Assert::IsTrue(kvStorage->multiGet({"ABC"}) == setVector);
+    Assert::IsTrue(kvStorage->multiGet(TestKeys::BasicRW) == TestData::BasicRW);
+
+    kvStorage->clear();
+  }
+
+  TEST_METHOD(AsyncStorageTest_MigrateTextStorage) {
+    DeleteFileW(storageFilePath(L".kvlog").c_str());
+    DeleteFileW(storageFilePath(L".kvidx").c_str());
+    {
+      StorageFileIO textFile(this->m_storageFileName);
+      textFile.clear();
+      textFile.append(
+          "$key1\n%value1\n"
+          "$key2\n%first\\nline\\\\\n"
+          "$key1\nR\n"
+          "$key3\n%value3\n");
+    }
+
+    auto kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    auto allKeys = kvStorage->getAllKeys();
+    Assert::IsTrue(allKeys == vector<string>{"key2", "key3"});
+
+    auto results = kvStorage->multiGet({"key2"});
+    Assert::IsTrue(
+        results == vector<tuple<string, string>>{{"key2", "first\nline\\"}});
+    Assert::IsFalse(fileExists(storageFilePath(L".txt")));
+
+    kvStorage->clear();
+  }
+
+  TEST_METHOD(AsyncStorageTest_FailedMigrationRunsAgain) {
+    DeleteFileW(storageFilePath(L".kvlog").c_str());
+    DeleteFileW(storageFilePath(L".kvidx").c_str());
+    {
+      StorageFileIO textFile(this->m_storageFileName);
+      textFile.clear();
+      textFile.append("$key1\n%value1\n#corrupt\n");
+    }
+
+    auto kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    Assert::ExpectException<std::exception>(
+        [&kvStorage]() { kvStorage->getAllKeys(); });
+    kvStorage = nullptr;
+    Assert::IsFalse(fileExists(storageFilePath(L".kvlog")));
+    Assert::IsTrue(fileExists(storageFilePath(L".txt")));
+
+    {
+      StorageFileIO textFile(this->m_storageFileName);
+      textFile.clear();
+      textFile.append("$key1\n%value1\n$key2\n%value2\n");
+    }
+
+    kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    Assert::IsTrue(
+        kvStorage->multiGet({"key1", "key2"}) ==
+        vector<tuple<string, string>>{{"key1", "value1"}, {"key2", "value2"}});
+    Assert::IsFalse(fileExists(storageFilePath(L".txt")));
+
+    kvStorage->clear();
+  }
+
+  TEST_METHOD(AsyncStorageTest_Compaction) {
+    auto kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    kvStorage->clear();
+
+    const string value(1024, 'v');
+    const int iterations = 4096;
+    for (int i = 0; i < iterations; i++) {
+      kvStorage->multiSet({make_tuple("key", value + to_string(i))});
+    }
+    kvStorage = nullptr; // waits for a running compaction
+
+    Assert::IsTrue(
+        fileSize(storageFilePath(L".kvlog")) < iterations * value.size() / 2,
+        L"Overwritten records were not compacted");
+
+    kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    auto results = kvStorage->multiGet({"key"});
+    Assert::IsTrue(
+        results ==
+        vector<tuple<string, string>>{
+            {"key", value + to_string(iterations - 1)}});
+
+    kvStorage->clear();
+  }
+
+  TEST_METHOD(AsyncStorageTest_MergeIntoMissingKey) {
+    auto kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    kvStorage->clear();
+
+    vector<tuple<string, string>> mergeVector = {
+        make_tuple("key", R"({"a":1})")};
+    kvStorage->multiMerge(mergeVector);
+    Assert::IsTrue(kvStorage->multiGet({"key"}) == mergeVector);
+
+    kvStorage->clear();
+  }
+
+  TEST_METHOD(AsyncStorageTest_DeepMerge) {
+    auto kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    kvStorage->clear();
+
+    kvStorage->multiSet(
+        {make_tuple(
+             "user",
+             R"({"name":"A","prefs":{"theme":"dark","font":{"size":12}},)"
+             R"("tags":[1,2]})"),
+         make_tuple("other", R"({"x":1})")});
+    kvStorage->multiMerge(
+        {make_tuple("user", R"({"prefs":{"font":{"face":"Segoe"}}})"),
+         make_tuple("user", R"({"tags":[3],"prefs":{"theme":"light"}})"),
+         make_tuple("other", R"({"y":{"z":null}})")});
+
+    auto results = kvStorage->multiGet({"other", "user"});
+    Assert::AreEqual(static_cast<size_t>(2), results.size());
+    Assert::IsTrue(
+        folly::parseJson(get<1>(results[0])) ==
+        folly::parseJson(R"({"x":1,"y":{"z":null}})"));
+    Assert::IsTrue(
+        folly::parseJson(get<1>(results[1])) ==
+        folly::parseJson(
+            R"({"name":"A","prefs":{"theme":"light",)"
+            R"("font":{"size":12,"face":"Segoe"}},"tags":[3]})"));
+
+    kvStorage = nullptr;
+    kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    Assert::IsTrue(kvStorage->multiGet({"other", "user"}) == results);
+
+    kvStorage->clear();
+  }
+
+  TEST_METHOD(AsyncStorageTest_MergeNonObjectFailsBatch) {
+    auto kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    kvStorage->clear();
+
+    vector<tuple<string, string>> setVector = {
+        make_tuple("array", "[1]"), make_tuple("object", R"({"a":1})")};
+    kvStorage->multiSet(setVector);
+
+    Assert::ExpectException<std::exception>([&kvStorage]() {
+      kvStorage->multiMerge(
+          {make_tuple("object", R"({"b":2})"),
+           make_tuple("array", R"({"b":2})")});
+    });
+    Assert::ExpectException<std::exception>([&kvStorage]() {
+      kvStorage->multiMerge({make_tuple("object", "not json")});
+    });
+    Assert::IsTrue(kvStorage->multiGet({"array", "object"}) == setVector);
+
+    kvStorage->clear();
+  }
+
+  TEST_METHOD(AsyncStorageTest_BatchIsReadOnceCommitted) {
+    auto kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    kvStorage->clear();
+
+    vector<tuple<string, string>> committed = {
+        make_tuple("key0", "a"), make_tuple("key1", R"({"a":1})")};
+    kvStorage->multiSet(committed);
+
+    // Operations in the batch see what the batch changed before them, but
+    // readers only see the batch once it is committed.
+    kvStorage->beginBatch();
+    kvStorage->multiSet({make_tuple("key0", "b"), make_tuple("key2", "c")});
+    kvStorage->multiMerge({make_tuple("key1", R"({"b":2})")});
+    kvStorage->multiMerge({make_tuple("key1", R"({"c":3})")});
+    kvStorage->multiRemove({"key2"});
+    Assert::IsTrue(kvStorage->multiGet({"key0", "key1", "key2"}) == committed);
+    Assert::IsTrue(kvStorage->getAllKeys() == vector<string>{"key0", "key1"});
+    kvStorage->commitBatch();
+
+    vector<tuple<string, string>> expected = {
+        make_tuple("key0", "b"), make_tuple("key1", R"({"a":1,"b":2,"c":3})")};
+    auto results = kvStorage->multiGet({"key0", "key1", "key2"});
+    Assert::AreEqual(expected.size(), results.size());
+    Assert::IsTrue(get<1>(results[0]) == "b");
+    Assert::IsTrue(
+        folly::parseJson(get<1>(results[1])) ==
+        folly::parseJson(get<1>(expected[1])));
+
+    // A clear in a batch is not seen before the commit either.
+    kvStorage->beginBatch();
+    kvStorage->clear();
+    kvStorage->multiSet({make_tuple("key3", "d")});
+    Assert::IsTrue(kvStorage->multiGet({"key0", "key1"}) == results);
+    kvStorage->commitBatch();
+    Assert::IsTrue(kvStorage->getAllKeys() == vector<string>{"key3"});
+
+    kvStorage = nullptr;
+    kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    Assert::IsTrue(
+        kvStorage->multiGet({"key0", "key3"}) ==
+        vector<tuple<string, string>>{make_tuple("key3", "d")});
+
+    kvStorage->clear();
+  }
+
+#ifdef PERF_TESTS
+  // Compares native merges against what JS does without multiMerge: read the
+  // values, merge them, and write them back.
+  TEST_METHOD(AsyncStorageTest_TimeMultiMerge) {
+    auto kvStorage = make_shared<KeyValueStorage>(this->m_storageFileName);
+    kvStorage->clear();
+
+    constexpr uint32_t keyCount = 100;
+    constexpr uint32_t fieldCount = 1000;
+    constexpr uint32_t iterations = 20;
+
+    folly::dynamic largeObject = folly::dynamic::object;
+    for (uint32_t i = 0; i < fieldCount; i++) {
+      largeObject["field" + to_string(i)] =
+          folly::dynamic::object("value", i)("label", "label " + to_string(i));
+    }
+
+    vector<string> keys;
+    vector<tuple<string, string>> setVector;
+    for (uint32_t i = 0; i < keyCount; i++) {
+      keys.push_back("object" + to_string(i));
+      setVector.emplace_back(keys.back(), folly::toJson(largeObject));
+    }
+
+    auto patchBatch = [&keys](uint32_t iteration) {
+      vector<tuple<string, string>> patches;
+      for (auto const &key : keys) {
+        patches.emplace_back(
+            key,
+            folly::toJson(folly::dynamic::object(
+                "field" + to_string(iteration),
+                folly::dynamic::object("value", -1))));
+      }
+      return patches;
+    };
+
+    LARGE_INTEGER emulatedPath{0}, nativePath{0};
+
+    kvStorage->multiSet(setVector);
+    AddTime(emulatedPath, [&]() {
+      for (uint32_t i = 0; i < iterations; i++) {
+        auto patches = patchBatch(i);
+        auto values = kvStorage->multiGet(keys);
+        for (size_t k = 0; k < values.size(); k++) {
+          auto merged = folly::parseJson(get<1>(values[k]));
+          merged.merge_patch(folly::parseJson(get<1>(patches[k])));
+          get<1>(values[k]) = folly::toJson(merged);
+        }
+        kvStorage->multiSet(values);
+      }
+    });
+
+    kvStorage->clear();
+    kvStorage->multiSet(setVector);
+    AddTime(nativePath, [&]() {
+      for (uint32_t i = 0; i < iterations; i++) {
+        kvStorage->multiMerge(patchBatch(i));
+      }
+    });
+
+    PrintResult("multiGet + merge + multiSet", iterations, emulatedPath);
+    PrintResult("multiMerge", iterations, nativePath);
+
+    kvStorage->clear();
+  }
+#endif // PERF_TESTS
+
+ private:
+  wstring storageFilePath(const WCHAR *extension) {
+    return StorageFileIO::storageFilePath(this->m_storageFileName, extension);
+  }
+
+  static bool fileExists(const wstring &path) {
+    return GetFileAttributesW(path.c_str()) != INVALID_FILE_ATTRIBUTES;
+  }
+
+  static uint64_t fileSize(const wstring &path) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    Assert::IsTrue(
+        GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data) != 0);
+    return (static_cast<uint64_t>(data.nFileSizeHigh) << 32) |
+        data.nFileSizeLow;
+  }
 };
 
 } // namespace Microsoft::React::Test
@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <Base64.h>
+#include <CppUnitTest.h>
+
+using Microsoft::React::Base64Encoder;
+using Microsoft::React::DecodeBase64;
+using Microsoft::React::EncodeBase64;
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+using std::string;
+
+namespace {
+
+// Long enough for the vectorized steps, with every byte value.
+string MakeData(size_t size) {
+  string data(size, '\0');
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<char>(i * 7 + i / 256);
+  return data;
+}
+
+} // namespace
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(Base64Tests) {
+ public:
+  TEST_METHOD(EncodesWithPadding) {
+    Assert::AreEqual(string{""}, EncodeBase64(""));
+    Assert::AreEqual(string{"Zg=="}, EncodeBase64("f"));
+    Assert::AreEqual(string{"Zm8="}, EncodeBase64("fo"));
+    Assert::AreEqual(string{"Zm9v"}, EncodeBase64("foo"));
+    Assert::AreEqual(
+        string{"Zm9vYmFyZm9vYmFyZm9vYmFyZm9vYmFyIQ=="},
+        EncodeBase64("foobarfoobarfoobarfoobar!"));
+    Assert::AreEqual(string{"+/8="}, EncodeBase64("\xfb\xff"));
+  }
+
+  TEST_METHOD(EncodesPieces) {
+    auto data = MakeData(1000);
+    auto expected = EncodeBase64(data);
+
+    for (size_t pieceSize : {1, 2, 5, 16, 17, 100}) {
+      string result;
+      Base64Encoder encoder{result};
+      for (size_t i = 0; i < data.size(); i += pieceSize)
+        encoder.Write(&data[i], (std::min)(pieceSize, data.size() - i));
+      encoder.Finish();
+
+      Assert::AreEqual(expected, result);
+    }
+  }
+
+  TEST_METHOD(DecodesWhatItEncodes) {
+    for (size_t size = 0; size < 100; ++size) {
+      auto data = MakeData(size);
+      auto text = EncodeBase64(data);
+
+      string result;
+      Assert::IsTrue(DecodeBase64(text, result));
+      Assert::IsTrue(data == result);
+
+      // Without padding.
+      text.erase(text.find_last_not_of('=') + 1);
+      Assert::IsTrue(DecodeBase64(text, result));
+      Assert::IsTrue(data == result);
+    }
+  }
+
+  TEST_METHOD(RejectsInvalidText) {
+    auto text = EncodeBase64(MakeData(60));
+    string result;
+    for (size_t i : {0, 17, 40, 70}) {
+      for (char c : {'*', '=', '\n', '\x80'}) {
+        auto invalid = text;
+        invalid[i] = c;
+        Assert::IsFalse(DecodeBase64(invalid, result));
+      }
+    }
+
+    Assert::IsFalse(DecodeBase64("Zm9vY", result));
+    Assert::IsFalse(DecodeBase64("Zg===", result));
+  }
+};
+
+} // namespace Microsoft::React::Test
@@ -12,7 +12,7 @@ using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 using boost::system::error_code;
 using std::future;
-using std::make_unique;
+using std::make_shared;
 using std::promise;
 using std::string;
 
@@ -31,7 +31,7 @@ TEST_CLASS(BaseWebSocketTest){
   END_TEST_CLASS_ATTRIBUTE()
 
   TEST_METHOD(CreateAndSetHandlers){
-    auto ws = make_unique<TestWebSocket>(Url("ws://localhost"));
+    auto ws = make_shared<TestWebSocket>(Url("ws://localhost"));
 
     Assert::IsFalse(nullptr == ws);
     ws->SetOnConnect([]() {});
@@ -45,11 +45,20 @@ TEST_CLASS(BaseWebSocketTest){
   TEST_METHOD(ConnectSucceeds) {
     string errorMessage;
     bool connected = false;
-    auto ws = make_unique<TestWebSocket>(Url("ws://localhost"));
-    ws->SetOnError([&errorMessage](Error err) { errorMessage = err.Message; });
-    ws->SetOnConnect([&connected]() { connected = true; });
+    auto ws = make_shared<TestWebSocket>(Url("ws://localhost"));
+    promise<void> done;
+    ws->SetOnError([&errorMessage, &done](Error err) {
+      errorMessage = err.Message;
+      done.set_value();
+    });
+    ws->SetOnConnect([&connected, &done]() {
+      connected = true;
+      done.set_value();
+    });
 
     ws->Connect({}, {});
+    done.get_future().wait();
+    ws->Detach();
     ws->Close(CloseCode::Normal, {});
 
     Assert::AreEqual({}, errorMessage);
@@ -59,14 +68,23 @@ TEST_CLASS(BaseWebSocketTest){
   TEST_METHOD(ConnectFails) {
     string errorMessage;
     bool connected = false;
-    auto ws = make_unique<TestWebSocket>(Url("ws://localhost"));
-    ws->SetOnError([&errorMessage](Error err) { errorMessage = err.Message; });
-    ws->SetOnConnect([&connected]() { connected = true; });
+    auto ws = make_shared<TestWebSocket>(Url("ws://localhost"));
+    promise<void> done;
+    ws->SetOnError([&errorMessage, &done](Error err) {
+      errorMessage = err.Message;
+      done.set_value();
+    });
+    ws->SetOnConnect([&connected, &done]() {
+      connected = true;
+      done.set_value();
+    });
     ws->SetConnectResult([]() -> error_code {
       return make_error_code(errc::state_not_recoverable);
     });
 
     ws->Connect({}, {});
+    done.get_future().wait();
+    ws->Detach();
     ws->Close(CloseCode::Normal, {});
 
     Assert::AreNotEqual({}, errorMessage);
@@ -79,14 +97,23 @@ TEST_CLASS(BaseWebSocketTest){
   TEST_METHOD(HandshakeFails) {
     string errorMessage;
     bool connected = false;
-    auto ws = make_unique<TestWebSocket>(Url("ws://localhost"));
-    ws->SetOnError([&errorMessage](Error err) { errorMessage = err.Message; });
-    ws->SetOnConnect([&connected]() { connected = true; });
+    auto ws = make_shared<TestWebSocket>(Url("ws://localhost"));
+    promise<void> done;
+    ws->SetOnError([&errorMessage, &done](Error err) {
+      errorMessage = err.Message;
+      done.set_value();
+    });
+    ws->SetOnConnect([&connected, &done]() {
+      connected = true;
+      done.set_value();
+    });
     ws->SetHandshakeResult([](string, string) -> error_code {
       return make_error_code(errc::state_not_recoverable);
     });
 
     ws->Connect({}, {});
+    done.get_future().wait();
+    ws->Detach();
     ws->Close(CloseCode::Normal, {});
 
     Assert::AreNotEqual({}, errorMessage);
@@ -100,7 +127,7 @@ TEST_CLASS(BaseWebSocketTest){
     string errorMessage;
     promise<void> connected;
     bool closed = false;
-    auto ws = make_unique<TestWebSocket>(Url("ws://localhost"));
+    auto ws = make_shared<TestWebSocket>(Url("ws://localhost"));
     ws->SetOnError([&errorMessage](Error err) { errorMessage = err.Message; });
     ws->SetOnConnect([&connected]() { connected.set_value(); });
     ws->SetOnClose(
@@ -0,0 +1,326 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <Test/PerfTestHelpers.h>
+#include <Windows.h>
+#include <folly/json.h>
+#include <string>
+#include "../Chakra/ChakraDynamic.h"
+#include "../Chakra/ChakraHelpers.h"
+#include "../Chakra/ChakraValue.h"
+#include "Unicode.h"
+
+using facebook::react::ChakraJSException;
+using facebook::react::ChakraObject;
+using facebook::react::ChakraString;
+using facebook::react::ChakraValue;
+using facebook::react::dynamicToJsValue;
+using facebook::react::evaluateScript;
+using facebook::react::jsValueToDynamic;
+using facebook::react::MinimalChakraRuntime;
+using facebook::react::PropertyIdCache;
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+namespace {
+
+JsValueRef Evaluate(const char *script) {
+  return evaluateScript(
+      ChakraString(script), ChakraString("ChakraDynamicTests.js"));
+}
+
+// A bridge batch shaped like the ones MessageQueue.flushedQueue() returns
+// during an initial render: [moduleIds, methodIds, params, callId].
+constexpr const char *const recordedBatchScript =
+    "(function() {\n"
+    "  var moduleIds = [], methodIds = [], params = [];\n"
+    "  for (var i = 0; i < 500; i++) {\n"
+    "    moduleIds.push(12, 12, 12);\n"
+    "    methodIds.push(0, 2, 4);\n"
+    "    params.push([i * 2 + 3, 'RCTView', 1, {\n"
+    "      style: {flexDirection: 'row', margin: 4.5, opacity: 0.75},\n"
+    "      accessibilityLabel: 'item ' + i, testID: 'item-' + i}]);\n"
+    "    params.push([i * 2 + 3, 'RCTView', {backgroundColor: -16777216}]);\n"
+    "    params.push([1, null, null, [i * 2 + 3], [i], null]);\n"
+    "  }\n"
+    "  return [moduleIds, methodIds, params, 1234];\n"
+    "})();\n";
+
+// The payload InstanceImpl::DispatchEvent sends for a topScroll event.
+folly::dynamic ScrollEventArgs(int64_t tag, double offset) {
+  return folly::dynamic::array(
+      tag,
+      "topScroll",
+      folly::dynamic::object("target", tag)(
+          "contentOffset", folly::dynamic::object("x", 0)("y", offset))(
+          "contentSize", folly::dynamic::object("width", 400)("height", 8000))(
+          "layoutMeasurement",
+          folly::dynamic::object("width", 400)("height", 800))(
+          "zoomScale", 1));
+}
+
+uint32_t g_collections = 0;
+
+// gc() for scripts: collects garbage right away.
+JsValueRef CALLBACK CollectGarbage(
+    JsValueRef /*callee*/,
+    bool /*isConstructCall*/,
+    JsValueRef * /*arguments*/,
+    unsigned short /*argumentCount*/,
+    void * /*callbackState*/) {
+  JsContextRef context = JS_INVALID_REFERENCE;
+  JsRuntimeHandle runtime = JS_INVALID_RUNTIME_HANDLE;
+  if (JsGetCurrentContext(&context) == JsNoError &&
+      JsGetRuntime(context, &runtime) == JsNoError &&
+      JsCollectGarbage(runtime) == JsNoError) {
+    ++g_collections;
+  }
+
+  JsValueRef undefined = JS_INVALID_REFERENCE;
+  JsGetUndefinedValue(&undefined);
+  return undefined;
+}
+
+} // namespace
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(ChakraDynamicTests) {
+ private:
+  MinimalChakraRuntime m_chakraRuntime;
+
+  void AssertMatchesJsonPath(const char *script) {
+    ChakraValue value(Evaluate(script));
+    auto expected = folly::parseJson(value.toJSONString());
+    auto actual = value.toDynamic();
+    Assert::IsTrue(
+        expected == actual,
+        Microsoft::Common::Unicode::Utf8ToUtf16(folly::toJson(actual)).c_str());
+  }
+
+ public:
+  ChakraDynamicTests() : m_chakraRuntime(false /* multithreaded */) {}
+
+  TEST_METHOD(ScalarsMatchJsonPath) {
+    AssertMatchesJsonPath("[null, true, false, 0, -1, 42, 1.5, 'text']");
+    AssertMatchesJsonPath("['\\u00e9\\u4e2d\\ud83d\\ude00', '']");
+  }
+
+  TEST_METHOD(IntegralNumbersBecomeIntegers) {
+    auto result =
+        ChakraValue(Evaluate("[3, 3.0, -0, 3.25, 1e300]")).toDynamic();
+    Assert::IsTrue(result[0].isInt());
+    Assert::IsTrue(result[1].isInt());
+    Assert::IsTrue(result[2].isInt());
+    Assert::IsTrue(result[3].isDouble());
+    Assert::IsTrue(result[4].isDouble());
+  }
+
+  TEST_METHOD(LargeIntegersMatchJsonPath) {
+    const char *script =
+        "[2147483648, -2147483649, 4294967296, 9007199254740992,"
+        "  -4611686018427387904]";
+    AssertMatchesJsonPath(script);
+    for (const auto &number : ChakraValue(Evaluate(script)).toDynamic()) {
+      Assert::IsTrue(number.isInt());
+    }
+  }
+
+  TEST_METHOD(NonEnumerablePropertiesAreSkipped) {
+    AssertMatchesJsonPath(
+        "(function() {\n"
+        "  var value = {a: 1};\n"
+        "  Object.defineProperty(value, 'hidden', {value: 2});\n"
+        "  return [value, Object.create({inherited: 3})];\n"
+        "})();\n");
+  }
+
+  TEST_METHOD(UnrepresentableValuesMatchJsonPath) {
+    AssertMatchesJsonPath(
+        "({a: undefined, b: function() {}, c: NaN, d: Infinity,"
+        "  e: [undefined, function() {}, -Infinity], f: 1})");
+  }
+
+  TEST_METHOD(NestedObjectsMatchJsonPath) {
+    AssertMatchesJsonPath(
+        "({style: {flex: 1, transform: [{scale: 2}, {rotate: '45deg'}]},"
+        "  children: [[], {}, [[1], [2, [3]]]], empty: {}})");
+  }
+
+  TEST_METHOD(ToJSONIsHonored) {
+    AssertMatchesJsonPath(
+        "({date: new Date(0), custom: {toJSON: function() { return [7]; }}})");
+  }
+
+  TEST_METHOD(TypedArraysMatchJsonPath) {
+    AssertMatchesJsonPath(
+        "({u8: new Uint8Array([1, 255]), i16: new Int16Array([-2, 300]),"
+        "  f64: new Float64Array([0.5, 2]), buffer: new ArrayBuffer(4)})");
+  }
+
+  TEST_METHOD(RecordedBatchMatchesJsonPath) {
+    AssertMatchesJsonPath(recordedBatchScript);
+  }
+
+  TEST_METHOD(DeepNestingIsSupported) {
+    auto result = ChakraValue(Evaluate("(function() {\n"
+                                       "  var value = [];\n"
+                                       "  for (var i = 0; i < 2000; i++)\n"
+                                       "    value = [value];\n"
+                                       "  return value;\n"
+                                       "})();\n"))
+                      .toDynamic();
+
+    size_t depth = 0;
+    const folly::dynamic *current = &result;
+    while (!current->empty()) {
+      current = &(*current)[0];
+      ++depth;
+    }
+    Assert::AreEqual(static_cast<size_t>(2000), depth);
+  }
+
+  // The objects toJSON returns, and the keys of every object, are only
+  // referenced by the conversion while it walks them.
+  TEST_METHOD(ValuesSurviveGarbageCollection) {
+    JsValueRef gc = JS_INVALID_REFERENCE;
+    Assert::IsTrue(JsCreateFunction(CollectGarbage, nullptr, &gc) == JsNoError);
+    ChakraObject::getGlobalObject().setProperty("gc", ChakraValue(gc));
+
+    ChakraValue value(Evaluate(
+        "(function() {\n"
+        "  var items = [];\n"
+        "  for (var i = 0; i < 200; i++) {\n"
+        "    items.push({toJSON: function() {\n"
+        "      var replacement = {first: {toJSON: function() {\n"
+        "        gc();\n"
+        "        return 1;\n"
+        "      }}};\n"
+        "      for (var j = 0; j < 20; j++)\n"
+        "        replacement['key' + j] = [j, 'value ' + j];\n"
+        "      return replacement;\n"
+        "    }});\n"
+        "  }\n"
+        "  return items;\n"
+        "})();\n"));
+    auto expected = folly::parseJson(value.toJSONString());
+
+    g_collections = 0;
+    auto actual = value.toDynamic();
+    Assert::AreEqual(static_cast<uint32_t>(200), g_collections);
+    Assert::IsTrue(expected == actual);
+  }
+
+  TEST_METHOD(CyclesThrow) {
+    JsValueRef value = Evaluate("var a = {b: {}}; a.b.c = a; a;");
+    Assert::ExpectException<ChakraJSException>(
+        [value]() { jsValueToDynamic(value); });
+  }
+
+  TEST_METHOD(UndefinedRootThrows) {
+    JsValueRef value = Evaluate("undefined");
+    Assert::ExpectException<ChakraJSException>(
+        [value]() { jsValueToDynamic(value); });
+  }
+
+  TEST_METHOD(DynamicRoundTrips) {
+    folly::dynamic values = folly::dynamic::array(
+        nullptr,
+        true,
+        0,
+        -7,
+        int64_t{1} << 40,
+        2.5,
+        "text",
+        u8"\u00e9\u4e2d\U0001F600",
+        folly::dynamic::array(1, folly::dynamic::array(), "x"),
+        folly::dynamic::object("a", 1)(
+            "nested", folly::dynamic::object("b", false))(u8"\u00e9", 3),
+        ScrollEventArgs(42, 1234.5));
+
+    for (const auto &value : values) {
+      Assert::IsTrue(value == ChakraValue(dynamicToJsValue(value)).toDynamic());
+    }
+  }
+
+  TEST_METHOD(DeepDynamicIsSupported) {
+    folly::dynamic value = folly::dynamic::object();
+    for (int i = 0; i < 2000; ++i) {
+      value = i % 2 == 0 ? folly::dynamic::array(std::move(value))
+                         : folly::dynamic::object("child", std::move(value));
+    }
+
+    Assert::IsTrue(value == ChakraValue(dynamicToJsValue(value)).toDynamic());
+  }
+
+  TEST_METHOD(DynamicMatchesJsonPath) {
+    folly::dynamic value = ScrollEventArgs(42, 1234.5);
+    ChakraValue direct(dynamicToJsValue(value));
+    ChakraValue viaJson(
+        ChakraValue::fromJSON(ChakraString(folly::toJson(value).c_str())));
+    Assert::AreEqual(viaJson.toJSONString(), direct.toJSONString());
+  }
+
+  TEST_METHOD(PropertyIdsAreCached) {
+    PropertyIdCache::clear();
+    auto &cache = PropertyIdCache::forCurrentRuntime();
+    Assert::AreEqual(static_cast<size_t>(0), cache.size());
+
+    dynamicToJsValue(ScrollEventArgs(42, 0));
+    size_t size = cache.size();
+    // target, contentOffset, x, y, contentSize, width, height,
+    // layoutMeasurement, zoomScale
+    Assert::AreEqual(static_cast<size_t>(9), size);
+
+    dynamicToJsValue(ScrollEventArgs(43, 10));
+    Assert::AreEqual(size, cache.size());
+    Assert::IsTrue(cache.get("target") == cache.get("target"));
+  }
+
+#ifdef PERF_TESTS
+  TEST_METHOD(TimeScrollEventConversion) {
+    constexpr uint32_t iterations = 100000;
+    LARGE_INTEGER jsonPath{0}, directPath{0};
+
+    AddTime(jsonPath, [&]() {
+      for (uint32_t i = 0; i < iterations; ++i) {
+        auto json = folly::toJson(ScrollEventArgs(42, i));
+        ChakraValue::fromJSON(ChakraString(json.c_str()));
+      }
+    });
+
+    AddTime(directPath, [&]() {
+      for (uint32_t i = 0; i < iterations; ++i) {
+        dynamicToJsValue(ScrollEventArgs(42, i));
+      }
+    });
+
+    PrintResult("folly::toJson + JSON.parse", iterations, jsonPath);
+    PrintResult("dynamicToJsValue", iterations, directPath);
+  }
+
+  TEST_METHOD(TimeRecordedBatchConversion) {
+    constexpr uint32_t iterations = 200;
+    ChakraValue batch(Evaluate(recordedBatchScript));
+
+    LARGE_INTEGER jsonPath{0}, directPath{0};
+
+    AddTime(jsonPath, [&]() {
+      for (uint32_t i = 0; i < iterations; ++i) {
+        folly::parseJson(batch.toJSONString());
+      }
+    });
+
+    AddTime(directPath, [&]() {
+      for (uint32_t i = 0; i < iterations; ++i) {
+        batch.toDynamic();
+      }
+    });
+
+    PrintResult("JSON.stringify + folly::parseJson", iterations, jsonPath);
+    PrintResult("jsValueToDynamic", iterations, directPath);
+  }
+#endif // PERF_TESTS
+};
+
+} // namespace Microsoft::React::Test
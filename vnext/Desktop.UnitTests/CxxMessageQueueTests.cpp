@@ -0,0 +1,303 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <CxxMessageQueue.h>
+#include <Test/PerfTestHelpers.h>
+#include <Windows.h>
+#include <folly/AtomicIntrusiveLinkedList.h>
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using facebook::react::CxxMessageQueue;
+using facebook::react::detail::BinarySemaphore;
+using facebook::react::detail::EventFlag;
+using Microsoft::React::Test::AddTime;
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+using Microsoft::VisualStudio::CppUnitTestFramework::Logger;
+
+namespace {
+
+// Runs the queue on its own thread until the test object goes away.
+struct RunningQueue {
+  RunningQueue() : queue(std::make_shared<CxxMessageQueue>()) {}
+
+  ~RunningQueue() {
+    stop();
+  }
+
+  void start() {
+    thread = std::thread(CxxMessageQueue::getRunLoop(queue));
+  }
+
+  void stop() {
+    if (thread.joinable()) {
+      queue->quitSynchronous();
+      thread.join();
+    }
+  }
+
+  std::shared_ptr<CxxMessageQueue> queue;
+  std::thread thread;
+};
+
+#ifdef PERF_TESTS
+// The queue CxxMessageQueue used before it had lanes and pooled tasks, for
+// comparison.
+class LegacyQueue {
+ public:
+  ~LegacyQueue() {
+    queue_.sweep([](Task *t) { delete t; });
+  }
+
+  void runOnQueue(std::function<void()> &&func) {
+    if (queue_.insertHead(new Task{std::move(func)})) {
+      pending_.set();
+    }
+  }
+
+  void run() {
+    while (!stopped_) {
+      queue_.sweep([](Task *t) {
+        std::unique_ptr<Task> owned(t);
+        t->func();
+      });
+      pending_.wait();
+    }
+  }
+
+  void stop() {
+    stopped_ = true;
+    pending_.set();
+  }
+
+ private:
+  struct Task {
+    std::function<void()> func;
+    folly::AtomicIntrusiveLinkedListHook<Task> hook;
+  };
+
+  folly::AtomicIntrusiveLinkedList<Task, &Task::hook> queue_;
+  std::atomic_bool stopped_{false};
+  BinarySemaphore pending_;
+};
+
+struct ProducerResult {
+  LARGE_INTEGER elapsed{0};
+  LARGE_INTEGER latency{0};
+};
+
+// Has producerCount threads post taskCount tasks each, and measures how long
+// it takes until the last one ran, and the time from posting each task to
+// running it.
+template <typename Post>
+ProducerResult
+RunProducers(Post post, uint32_t producerCount, uint32_t taskCount) {
+  ProducerResult result;
+  uint32_t remaining = producerCount * taskCount;
+  EventFlag done;
+  std::atomic_bool go{false};
+
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < producerCount; ++p) {
+    producers.emplace_back([&]() {
+      while (!go) {
+        std::this_thread::yield();
+      }
+
+      for (uint32_t i = 0; i < taskCount; ++i) {
+        LARGE_INTEGER posted;
+        QueryPerformanceCounter(&posted);
+        post([&result, &remaining, &done, posted]() {
+          LARGE_INTEGER ran;
+          QueryPerformanceCounter(&ran);
+          result.latency.QuadPart += ran.QuadPart - posted.QuadPart;
+          if (--remaining == 0) {
+            done.set();
+          }
+        });
+      }
+    });
+  }
+
+  AddTime(result.elapsed, [&]() {
+    go = true;
+    done.wait();
+  });
+
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  return result;
+}
+#endif // PERF_TESTS
+
+} // namespace
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(CxxMessageQueueTests) {
+ public:
+  TEST_METHOD(RunsTasksInOrder) {
+    RunningQueue running;
+    std::vector<int> order;
+    for (int i = 0; i < 1000; ++i) {
+      running.queue->runOnQueue([&order, i]() { order.push_back(i); });
+    }
+    running.start();
+    running.queue->runOnQueueSync([]() {});
+
+    Assert::IsTrue(order.size() == 1000);
+    for (int i = 0; i < 1000; ++i) {
+      Assert::AreEqual(i, order[i]);
+    }
+  }
+
+  TEST_METHOD(RunsDelayedTasksByTime) {
+    RunningQueue running;
+    std::string order;
+    EventFlag done;
+    running.queue->runOnQueueDelayed(
+        [&order, &done]() {
+          order += "c";
+          done.set();
+        },
+        40);
+    running.queue->runOnQueueDelayed([&order]() { order += "b"; }, 10);
+    running.queue->runOnQueue([&order]() { order += "a"; });
+    running.start();
+
+    done.wait();
+    Assert::AreEqual(std::string{"abc"}, order);
+  }
+
+  TEST_METHOD(RunsIdleTasksLast) {
+    RunningQueue running;
+    std::string order;
+    running.queue->runOnQueueIdle([&order]() { order += "i"; });
+    running.queue->runOnQueueIdle([&order]() { order += "j"; });
+    running.queue->runOnQueue([&order]() { order += "a"; });
+    running.queue->runOnQueue([&order]() { order += "b"; });
+    running.start();
+
+    EventFlag done;
+    running.queue->runOnQueueIdle([&done]() { done.set(); });
+    done.wait();
+    Assert::AreEqual(std::string{"abij"}, order);
+  }
+
+  TEST_METHOD(RunsTimersDuringBursts) {
+    RunningQueue running;
+    running.start();
+
+    // Each task posts the next one, so the queue never runs out of tasks.
+    std::atomic_bool stopped{false};
+    std::function<void()> burst = [&]() {
+      if (!stopped) {
+        running.queue->runOnQueue([&burst]() { burst(); });
+      }
+    };
+    running.queue->runOnQueue([&burst]() { burst(); });
+
+    EventFlag fired;
+    running.queue->runOnQueueDelayed([&fired]() { fired.set(); }, 10);
+    Assert::IsTrue(fired.wait_until(
+        std::chrono::steady_clock::now() + std::chrono::seconds(5)));
+
+    // A task that was running when the burst stopped may post one more, so
+    // wait twice before burst goes away.
+    stopped = true;
+    running.queue->runOnQueueSync([]() {});
+    running.queue->runOnQueueSync([]() {});
+  }
+
+  TEST_METHOD(RunsTasksFromManyProducers) {
+    constexpr int producerCount = 4;
+    constexpr int taskCount = 10000;
+    RunningQueue running;
+    running.start();
+
+    std::vector<int> last(producerCount, -1);
+    bool ordered = true;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; ++p) {
+      producers.emplace_back([&, p]() {
+        for (int i = 0; i < taskCount; ++i) {
+          running.queue->runOnQueue([&, p, i]() {
+            ordered = ordered && last[p] == i - 1;
+            last[p] = i;
+          });
+        }
+      });
+    }
+    for (auto &producer : producers) {
+      producer.join();
+    }
+    running.queue->runOnQueueSync([]() {});
+
+    Assert::IsTrue(ordered);
+    for (int p = 0; p < producerCount; ++p) {
+      Assert::AreEqual(taskCount - 1, last[p]);
+    }
+  }
+
+  TEST_METHOD(DoesNotRunTasksAfterQuit) {
+    RunningQueue running;
+    running.start();
+    running.queue->runOnQueueSync([]() {});
+    running.stop();
+
+    bool ran = false;
+    running.queue->runOnQueue([&ran]() { ran = true; });
+    running.queue->runOnQueueIdle([&ran]() { ran = true; });
+    Assert::IsFalse(ran);
+  }
+
+#ifdef PERF_TESTS
+  TEST_METHOD(TimeProducers) {
+    constexpr uint32_t taskCount = 100000;
+    for (uint32_t producerCount : {1, 2, 4, 8}) {
+      std::string suffix = "(" + std::to_string(producerCount) + ")";
+
+      RunningQueue running;
+      running.start();
+      auto result = RunProducers(
+          [&running](std::function<void()> &&func) {
+            running.queue->runOnQueue(std::move(func));
+          },
+          producerCount,
+          taskCount);
+      PrintResult(
+          ("CxxMessageQueue" + suffix).c_str(),
+          producerCount * taskCount,
+          result);
+
+      LegacyQueue legacy;
+      std::thread thread([&legacy]() { legacy.run(); });
+      result = RunProducers(
+          [&legacy](std::function<void()> &&func) {
+            legacy.runOnQueue(std::move(func));
+          },
+          producerCount,
+          taskCount);
+      legacy.stop();
+      thread.join();
+      PrintResult(
+          ("LegacyQueue" + suffix).c_str(), producerCount * taskCount, result);
+    }
+  }
+
+  static void PrintResult(
+      const char *testName, uint32_t iterations, ProducerResult result) {
+    std::stringstream ss;
+    ss << FormatResult(testName, iterations, result.elapsed) << "; latency="
+       << ToSeconds(result.latency) / iterations * 1000000 << " us";
+    Logger::WriteMessage(ss.str().c_str());
+  }
+#endif // PERF_TESTS
+};
+
+} // namespace Microsoft::React::Test
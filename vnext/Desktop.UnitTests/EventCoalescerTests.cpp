@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <EventCoalescer.h>
+
+using facebook::react::EventCoalescer;
+using folly::dynamic;
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+namespace {
+
+bool PushEvent(
+    EventCoalescer &events,
+    int64_t viewTag,
+    const std::string &eventName,
+    int64_t value) {
+  std::optional<EventCoalescer::Key> key;
+  if (EventCoalescer::IsCoalescable(eventName))
+    key = EventCoalescer::Key{viewTag, eventName, 0};
+
+  return events.Push(
+      "receiveEvent",
+      dynamic::array(viewTag, eventName, dynamic::object("value", value)),
+      std::move(key));
+}
+
+std::string Describe(const EventCoalescer::Event &event) {
+  return std::to_string(event.params[0].getInt()) + ":" +
+      event.params[1].getString() + ":" +
+      std::to_string(event.params[2]["value"].getInt());
+}
+
+} // namespace
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(EventCoalescerTests) {
+ public:
+  TEST_METHOD(KeepsLatestPayload) {
+    EventCoalescer events;
+    Assert::IsTrue(PushEvent(events, 2, "topScroll", 1));
+    Assert::IsFalse(PushEvent(events, 2, "topScroll", 2));
+    Assert::IsFalse(PushEvent(events, 3, "topScroll", 3));
+    Assert::IsFalse(PushEvent(events, 2, "topScroll", 4));
+
+    auto drained = events.Drain();
+    Assert::IsTrue(drained.size() == 2);
+    Assert::AreEqual(std::string{"2:topScroll:4"}, Describe(drained[0]));
+    Assert::AreEqual(std::string{"3:topScroll:3"}, Describe(drained[1]));
+
+    auto counters = events.GetCounters();
+    Assert::IsTrue(counters.queued == 4);
+    Assert::IsTrue(counters.coalesced == 2);
+    Assert::IsTrue(counters.drained == 1);
+
+    // The next event starts a new batch.
+    Assert::IsTrue(PushEvent(events, 2, "topScroll", 5));
+  }
+
+  TEST_METHOD(DoesNotCoalesceOtherEvents) {
+    EventCoalescer events;
+    PushEvent(events, 2, "topChange", 1);
+    PushEvent(events, 2, "topChange", 2);
+
+    auto drained = events.Drain();
+    Assert::IsTrue(drained.size() == 2);
+    Assert::IsTrue(events.GetCounters().coalesced == 0);
+  }
+
+  TEST_METHOD(KeepsOrderAcrossOtherEvents) {
+    EventCoalescer events;
+    PushEvent(events, 2, "topScroll", 1);
+    PushEvent(events, 2, "topScrollEndDrag", 2);
+    PushEvent(events, 2, "topScroll", 3);
+    PushEvent(events, 2, "topScroll", 4);
+
+    auto drained = events.Drain();
+    Assert::IsTrue(drained.size() == 3);
+    Assert::AreEqual(std::string{"2:topScroll:1"}, Describe(drained[0]));
+    Assert::AreEqual(
+        std::string{"2:topScrollEndDrag:2"}, Describe(drained[1]));
+    Assert::AreEqual(std::string{"2:topScroll:4"}, Describe(drained[2]));
+  }
+
+  TEST_METHOD(CoalescesByKey) {
+    EventCoalescer events;
+    events.Push(
+        "receiveTouches",
+        dynamic::array("topTouchMove", dynamic::array(), dynamic::array(0)),
+        EventCoalescer::Key{-1, "topTouchMove", 0});
+    events.Push(
+        "receiveTouches",
+        dynamic::array("topTouchMove", dynamic::array(), dynamic::array(1)),
+        EventCoalescer::Key{-1, "topTouchMove", 1});
+    events.Push(
+        "receiveTouches",
+        dynamic::array("topTouchMove", dynamic::array(1), dynamic::array(0)),
+        EventCoalescer::Key{-1, "topTouchMove", 0});
+
+    auto drained = events.Drain();
+    Assert::IsTrue(drained.size() == 2);
+    Assert::AreEqual(std::string{"receiveTouches"}, drained[0].method);
+    Assert::IsTrue(drained[0].params[1].size() == 1);
+    Assert::IsTrue(drained[1].params[2][0].getInt() == 1);
+  }
+};
+
+} // namespace Microsoft::React::Test
@@ -0,0 +1,232 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <ImageCache.h>
+#include <Windows.h>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Microsoft::React::ImageCache;
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+namespace {
+
+ImageCache::Bytes MakeImage(size_t size, uint8_t value) {
+  return std::make_shared<const std::vector<uint8_t>>(size, value);
+}
+
+// Holds on to the downloads the cache starts, so that a test can complete
+// them when it needs to.
+struct FakeFetch {
+  std::vector<ImageCache::Request> requests;
+  std::vector<ImageCache::Callback> downloads;
+
+  ImageCache::Fetch Fetch() {
+    return [this](const ImageCache::Request &request,
+                  ImageCache::Callback &&done) {
+      requests.push_back(request);
+      downloads.push_back(std::move(done));
+    };
+  }
+};
+
+// Downloads every image right away, as an image of size bytes filled with
+// the last character of its URI.
+ImageCache::Fetch ImmediateFetch(size_t size, int &fetchCount) {
+  return [size, &fetchCount](
+             const ImageCache::Request &request, ImageCache::Callback &&done) {
+    ++fetchCount;
+    done(MakeImage(size, static_cast<uint8_t>(request.uri.back())));
+  };
+}
+
+std::string MakeTempDirectory() {
+  wchar_t name[64];
+  swprintf_s(
+      name,
+      L"ImageCacheTests%lu-%llu",
+      GetCurrentProcessId(),
+      GetTickCount64());
+  const auto directory = std::filesystem::temp_directory_path() / name;
+  std::filesystem::create_directories(directory);
+  return directory.u8string() + "\\";
+}
+
+} // namespace
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(ImageCacheTests) {
+ public:
+  TEST_METHOD(CoalescesConcurrentRequests) {
+    FakeFetch fetch;
+    auto cache = std::make_shared<ImageCache>(
+        ImageCache::Options{}, fetch.Fetch());
+
+    std::vector<ImageCache::Bytes> results;
+    for (int i = 0; i < 5; ++i) {
+      cache->Get({"http://localhost/a.png"}, [&results](ImageCache::Bytes b) {
+        results.push_back(std::move(b));
+      });
+    }
+    Assert::IsTrue(fetch.downloads.size() == 1);
+    Assert::IsTrue(results.empty());
+
+    auto image = MakeImage(10, 1);
+    fetch.downloads[0](image);
+    Assert::IsTrue(results.size() == 5);
+    for (const auto &result : results) {
+      Assert::IsTrue(result == image);
+    }
+
+    // Later requests are served from memory, before Get returns.
+    bool served = false;
+    cache->Get({"http://localhost/a.png"}, [&](ImageCache::Bytes b) {
+      served = b == image;
+    });
+    Assert::IsTrue(served);
+    Assert::IsTrue(fetch.downloads.size() == 1);
+  }
+
+  TEST_METHOD(KeysByMethodAndHeaders) {
+    FakeFetch fetch;
+    auto cache = std::make_shared<ImageCache>(
+        ImageCache::Options{}, fetch.Fetch());
+
+    ImageCache::Request request{"http://localhost/a.png"};
+    request.headers["Authorization"] = "Bearer 1";
+    cache->Get(request, [](ImageCache::Bytes) {});
+    fetch.downloads[0](MakeImage(10, 1));
+
+    ImageCache::Request sameRequest{"http://localhost/a.png", "GET"};
+    sameRequest.headers["authorization"] = "Bearer 1";
+    Assert::IsTrue(
+        cache->Query(sameRequest) == ImageCache::Location::Memory);
+
+    ImageCache::Request otherUser{"http://localhost/a.png"};
+    otherUser.headers["Authorization"] = "Bearer 2";
+    Assert::IsTrue(cache->Query(otherUser) == ImageCache::Location::None);
+    Assert::IsTrue(
+        cache->Query({"http://localhost/a.png"}) ==
+        ImageCache::Location::None);
+    Assert::IsTrue(
+        cache->Query({"http://localhost/a.png", "POST", request.headers}) ==
+        ImageCache::Location::None);
+  }
+
+  TEST_METHOD(EvictsLeastRecentlyUsedImages) {
+    ImageCache::Options options;
+    options.memoryCapacity = 100;
+    int fetchCount = 0;
+    auto cache = std::make_shared<ImageCache>(
+        options, ImmediateFetch(40, fetchCount));
+
+    cache->Get({"http://localhost/a"}, [](ImageCache::Bytes) {});
+    cache->Get({"http://localhost/b"}, [](ImageCache::Bytes) {});
+    Assert::IsNotNull(cache->Find({"http://localhost/a"}).get());
+    cache->Get({"http://localhost/c"}, [](ImageCache::Bytes) {});
+
+    Assert::AreEqual(size_t{80}, cache->MemorySize());
+    Assert::IsNotNull(cache->Find({"http://localhost/a"}).get());
+    Assert::IsNull(cache->Find({"http://localhost/b"}).get());
+    Assert::IsNotNull(cache->Find({"http://localhost/c"}).get());
+    Assert::AreEqual(3, fetchCount);
+
+    // Images larger than the cache are passed on without being cached.
+    ImageCache::Options smallOptions;
+    smallOptions.memoryCapacity = 20;
+    auto smallCache = std::make_shared<ImageCache>(
+        smallOptions, ImmediateFetch(40, fetchCount));
+    bool served = false;
+    smallCache->Get({"http://localhost/d"}, [&served](ImageCache::Bytes b) {
+      served = b && b->size() == 40;
+    });
+    Assert::IsTrue(served);
+    Assert::AreEqual(size_t{0}, smallCache->MemorySize());
+  }
+
+  TEST_METHOD(DoesNotCacheFailedDownloads) {
+    FakeFetch fetch;
+    auto cache = std::make_shared<ImageCache>(
+        ImageCache::Options{}, fetch.Fetch());
+
+    bool failed = false;
+    cache->Get({"http://localhost/a.png"}, [&failed](ImageCache::Bytes b) {
+      failed = !b;
+    });
+    fetch.downloads[0](nullptr);
+    Assert::IsTrue(failed);
+
+    cache->Get({"http://localhost/a.png"}, [](ImageCache::Bytes) {});
+    Assert::IsTrue(fetch.downloads.size() == 2);
+  }
+
+  TEST_METHOD(ReportsThrowingFetchAsFailedDownload) {
+    auto cache = std::make_shared<ImageCache>(
+        ImageCache::Options{},
+        [](const ImageCache::Request &, ImageCache::Callback &&) {
+          throw std::runtime_error("No network");
+        });
+
+    int failures = 0;
+    cache->Get({"http://localhost/a.png"}, [&failures](ImageCache::Bytes b) {
+      failures += b ? 0 : 1;
+    });
+    Assert::AreEqual(1, failures);
+    Assert::IsTrue(
+        cache->Query({"http://localhost/a.png"}) ==
+        ImageCache::Location::None);
+  }
+
+  TEST_METHOD(KeepsImagesOnDisk) {
+    ImageCache::Options options;
+    options.memoryCapacity = 50;
+    options.diskDirectory = MakeTempDirectory();
+    options.diskCapacity = 200;
+    int fetchCount = 0;
+
+    {
+      auto cache = std::make_shared<ImageCache>(
+          options, ImmediateFetch(40, fetchCount));
+      for (char name = 'a'; name <= 'f'; ++name) {
+        cache->Get(
+            {std::string{"http://localhost/"} + name},
+            [](ImageCache::Bytes) {});
+      }
+
+      Assert::IsTrue(
+          cache->Query({"http://localhost/f"}) == ImageCache::Location::Memory);
+      Assert::IsTrue(
+          cache->Query({"http://localhost/e"}) == ImageCache::Location::Disk);
+      Assert::IsTrue(
+          cache->Query({"http://localhost/a"}) == ImageCache::Location::None);
+      Assert::IsTrue(cache->DiskSize() <= options.diskCapacity);
+    }
+
+    // The images on disk are there for the next session.
+    auto cache = std::make_shared<ImageCache>(
+        options, ImmediateFetch(40, fetchCount));
+    Assert::IsTrue(
+        cache->Query({"http://localhost/e"}) == ImageCache::Location::Disk);
+
+    bool served = false;
+    cache->Get({"http://localhost/e"}, [&served](ImageCache::Bytes b) {
+      served = b && b->size() == 40 && b->front() == 'e';
+    });
+    Assert::IsTrue(served);
+    Assert::AreEqual(6, fetchCount);
+    Assert::IsTrue(
+        cache->Query({"http://localhost/e"}) == ImageCache::Location::Memory);
+
+    cache->Clear();
+    Assert::AreEqual(size_t{0}, cache->DiskSize());
+    Assert::IsTrue(
+        cache->Query({"http://localhost/e"}) == ImageCache::Location::None);
+    std::filesystem::remove_all(std::filesystem::u8path(options.diskDirectory));
+  }
+};
+
+} // namespace Microsoft::React::Test
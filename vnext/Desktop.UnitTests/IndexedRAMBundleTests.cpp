@@ -0,0 +1,274 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <IndexedRAMBundle.h>
+#include <MemoryMappedBuffer.h>
+#include <Test/PerfTestHelpers.h>
+#include <Windows.h>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../Chakra/ChakraHelpers.h"
+#include "../Chakra/ChakraUtils.h"
+#include "../Chakra/ChakraValue.h"
+#include "Unicode.h"
+
+using facebook::jsi::Buffer;
+using facebook::react::ChakraString;
+using facebook::react::evaluateScript;
+using facebook::react::FileMappingBigString;
+using facebook::react::MinimalChakraRuntime;
+using Microsoft::JSI::MakeMemoryMappedBuffer;
+using Microsoft::React::IndexedRAMBundle;
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+namespace {
+
+std::string MakeIndexedRAMBundle(
+    const std::string &startupCode,
+    const std::vector<std::string> &modules) {
+  std::string table;
+  std::string code = startupCode + '\0';
+  for (const std::string &module : modules) {
+    // Modules without code have an offset and a length of 0.
+    uint32_t entry[2] = {0, 0};
+    if (!module.empty()) {
+      entry[0] = static_cast<uint32_t>(code.length());
+      entry[1] = static_cast<uint32_t>(module.length() + 1);
+      code += module + '\0';
+    }
+    table.append(reinterpret_cast<const char *>(entry), sizeof(entry));
+  }
+
+  const uint32_t header[3] = {IndexedRAMBundle::MagicNumber,
+                              static_cast<uint32_t>(modules.size()),
+                              static_cast<uint32_t>(startupCode.length() + 1)};
+  return std::string(reinterpret_cast<const char *>(header), sizeof(header)) +
+      table + code;
+}
+
+std::string ToString(const Buffer &buffer) {
+  return std::string(
+      reinterpret_cast<const char *>(buffer.data()), buffer.size());
+}
+
+class StringBuffer final : public Buffer {
+ public:
+  explicit StringBuffer(std::string str) : m_string{std::move(str)} {}
+
+  size_t size() const override {
+    return m_string.size();
+  }
+
+  const uint8_t *data() const override {
+    return reinterpret_cast<const uint8_t *>(m_string.data());
+  }
+
+ private:
+  std::string m_string;
+};
+
+IndexedRAMBundle MakeBundle(std::string contents) {
+  return IndexedRAMBundle(std::make_shared<StringBuffer>(std::move(contents)));
+}
+
+} // namespace
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(IndexedRAMBundleTests) {
+ public:
+  TEST_METHOD(ReadsStartupCodeAndModules) {
+    const IndexedRAMBundle bundle = MakeBundle(MakeIndexedRAMBundle(
+        "var modules = {};", {"modules[0] = 0;", "", "modules[2] = 2;"}));
+
+    Assert::IsTrue(bundle.ModuleCount() == 3);
+
+    auto startupCode = bundle.StartupCode();
+    Assert::AreEqual(size_t{17}, startupCode->size());
+    Assert::AreEqual("var modules = {};", startupCode->c_str());
+
+    Assert::AreEqual(
+        std::string{"modules[0] = 0;"}, ToString(*bundle.ModuleCode(0)));
+    Assert::AreEqual("modules[2] = 2;", bundle.ModuleCodeString(2)->c_str());
+
+    auto module = bundle.getModule(2);
+    Assert::AreEqual(std::string{"2.js"}, module.name);
+    Assert::AreEqual(std::string{"modules[2] = 2;"}, module.code);
+  }
+
+  TEST_METHOD(ModuleCodePointsIntoTheBundle) {
+    auto contents = std::make_shared<StringBuffer>(
+        MakeIndexedRAMBundle("var modules = {};", {"modules[0] = 0;"}));
+    const IndexedRAMBundle bundle(contents);
+
+    auto module = bundle.ModuleCode(0);
+    Assert::IsTrue(module->data() > contents->data());
+    Assert::IsTrue(
+        module->data() + module->size() < contents->data() + contents->size());
+  }
+
+  TEST_METHOD(ThrowsForModulesWithoutCode) {
+    const IndexedRAMBundle bundle = MakeBundle(
+        MakeIndexedRAMBundle("var modules = {};", {"modules[0] = 0;", ""}));
+
+    Assert::ExpectException<IndexedRAMBundle::ModuleNotFound>(
+        [&bundle]() { bundle.ModuleCode(1); });
+    Assert::ExpectException<IndexedRAMBundle::ModuleNotFound>(
+        [&bundle]() { bundle.ModuleCodeString(2); });
+    Assert::ExpectException<IndexedRAMBundle::ModuleNotFound>(
+        [&bundle]() { bundle.getModule(0xffffffff); });
+  }
+
+  TEST_METHOD(RejectsOtherFiles) {
+    Assert::IsFalse(
+        IndexedRAMBundle::IsIndexedRAMBundle(StringBuffer{"var modules;"}));
+    Assert::IsFalse(IndexedRAMBundle::IsIndexedRAMBundle(StringBuffer{""}));
+
+    const std::string contents =
+        MakeIndexedRAMBundle("var modules = {};", {"modules[0] = 0;"});
+    Assert::IsTrue(
+        IndexedRAMBundle::IsIndexedRAMBundle(StringBuffer{contents}));
+
+    // Cut short anywhere, a bundle either fails to load or has no code for
+    // the modules past the end.
+    for (size_t length = 0; length < contents.length(); ++length) {
+      try {
+        const IndexedRAMBundle bundle = MakeBundle(contents.substr(0, length));
+        Assert::ExpectException<IndexedRAMBundle::ModuleNotFound>(
+            [&bundle]() { bundle.ModuleCode(0); });
+      } catch (const std::invalid_argument &) {
+      }
+    }
+  }
+
+  TEST_METHOD(RejectsHugeModuleCounts) {
+    // The module table would be 4 GB long, which wraps around to 0 in 32
+    // bits.
+    const uint32_t header[3] = {IndexedRAMBundle::MagicNumber, 0x20000000, 1};
+    std::string contents(
+        reinterpret_cast<const char *>(header), sizeof(header));
+    contents += '\0';
+
+    Assert::ExpectException<std::invalid_argument>(
+        [&contents]() { MakeBundle(contents); });
+  }
+
+  TEST_METHOD(ChecksFilesByTheirHeader) {
+    const std::wstring ramBundleFileName = WriteTempFile(
+        L"IndexedRAMBundle",
+        MakeIndexedRAMBundle("var modules = {};", {"modules[0] = 0;"}));
+    const std::wstring bundleFileName =
+        WriteTempFile(L"Bundle", "var modules = {};");
+    const std::wstring emptyFileName = WriteTempFile(L"Empty", "");
+
+    Assert::IsTrue(
+        IndexedRAMBundle::IsIndexedRAMBundle(ramBundleFileName.c_str()));
+    Assert::IsFalse(
+        IndexedRAMBundle::IsIndexedRAMBundle(bundleFileName.c_str()));
+    Assert::IsFalse(
+        IndexedRAMBundle::IsIndexedRAMBundle(emptyFileName.c_str()));
+    Assert::IsFalse(IndexedRAMBundle::IsIndexedRAMBundle(L"missing.bundle"));
+
+    DeleteFileW(ramBundleFileName.c_str());
+    DeleteFileW(bundleFileName.c_str());
+    DeleteFileW(emptyFileName.c_str());
+  }
+
+  static std::wstring WriteTempFile(
+      const wchar_t *prefix, const std::string &contents) {
+    wchar_t tempPath[MAX_PATH];
+    Assert::IsTrue(GetTempPathW(MAX_PATH, tempPath) != 0);
+    wchar_t fileName[MAX_PATH];
+    Assert::IsTrue(GetTempFileNameW(tempPath, prefix, 0, fileName) != 0);
+
+    FILE *file = nullptr;
+    Assert::AreEqual(0, _wfopen_s(&file, fileName, L"wb"));
+    Assert::AreEqual(
+        contents.size(), fwrite(contents.data(), 1, contents.size(), file));
+    fclose(file);
+    return fileName;
+  }
+
+#ifdef PERF_TESTS
+  TEST_METHOD(StartupTime) {
+    // A bundle about the size of a large app's, of which startup only
+    // requires one module in ten.
+    constexpr uint32_t moduleCount = 2000;
+    constexpr uint32_t requiredModuleCount = moduleCount / 10;
+    constexpr uint32_t iterations = 10;
+
+    const std::string startupCode =
+        "var factories = [], exports = [];\n"
+        "function __d(factory, id) { factories[id] = factory; }\n"
+        "function __r(id) {\n"
+        "  if (!exports[id]) {\n"
+        "    exports[id] = {};\n"
+        "    factories[id](exports[id]);\n"
+        "  }\n"
+        "  return exports[id];\n"
+        "}\n";
+    std::vector<std::string> modules;
+    std::string wholeBundle = startupCode;
+    for (uint32_t id = 0; id < moduleCount; ++id) {
+      std::ostringstream module;
+      module << "__d(function (exports) {\n";
+      for (int i = 0; i < 60; ++i) {
+        module << "  exports.value" << i << " = function (a, b) {\n"
+               << "    return a + b * " << i << " + '" << id << "';\n"
+               << "  };\n";
+      }
+      module << "}, " << id << ");\n";
+      modules.push_back(module.str());
+      wholeBundle += modules.back();
+    }
+
+    std::ostringstream requireCode;
+    requireCode << "for (var id = 0; id < " << requiredModuleCount
+                << "; ++id) __r(id);";
+    const std::string require = requireCode.str();
+
+    const std::wstring ramBundleFileName = WriteTempFile(
+        L"IndexedRAMBundle", MakeIndexedRAMBundle(startupCode, modules));
+    const std::wstring wholeBundleFileName =
+        WriteTempFile(L"WholeBundle", wholeBundle);
+
+    LARGE_INTEGER whole{0}, lazy{0};
+    for (uint32_t i = 0; i < iterations; ++i) {
+      MinimalChakraRuntime runtime(false /* multithreaded */);
+      AddTime(whole, [&]() {
+        evaluateScript(
+            FileMappingBigString::fromPath(
+                Microsoft::Common::Unicode::Utf16ToUtf8(wholeBundleFileName)),
+            ChakraString("bundle.js"));
+        evaluateScript(ChakraString(require.c_str()), ChakraString("require"));
+      });
+    }
+
+    for (uint32_t i = 0; i < iterations; ++i) {
+      MinimalChakraRuntime runtime(false /* multithreaded */);
+      AddTime(lazy, [&]() {
+        const IndexedRAMBundle bundle(
+            MakeMemoryMappedBuffer(ramBundleFileName.c_str()));
+        evaluateScript(bundle.StartupCode(), ChakraString("bundle.js"));
+        for (uint32_t id = 0; id < requiredModuleCount; ++id) {
+          evaluateScript(
+              bundle.ModuleCodeString(id),
+              ChakraString(IndexedRAMBundle::ModuleSourceURL(id).c_str()));
+        }
+        evaluateScript(ChakraString(require.c_str()), ChakraString("require"));
+      });
+    }
+
+    DeleteFileW(ramBundleFileName.c_str());
+    DeleteFileW(wholeBundleFileName.c_str());
+
+    PrintResult("whole bundle", iterations, whole);
+    PrintResult("indexed RAM bundle", iterations, lazy);
+  }
+#endif // PERF_TESTS
+};
+
+} // namespace Microsoft::React::Test
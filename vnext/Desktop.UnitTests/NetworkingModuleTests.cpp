@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <Modules/NetworkingModule.h>
+
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+namespace fs = std::filesystem;
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(NetworkingModuleTests) {
+ public:
+  TEST_METHOD(ResolvesResponseFileInDownloadDirectory) {
+    fs::path directory{L"C:\\Downloads"};
+    Assert::IsTrue(
+        NetworkingModule::ResolveResponseFile(directory, "image.png") ==
+        directory / L"image.png");
+  }
+
+  TEST_METHOD(RejectsResponseFilesOutsideDownloadDirectory) {
+    fs::path directory{L"C:\\Downloads"};
+    for (auto name : {"",
+                      ".",
+                      "..",
+                      "..\\image.png",
+                      "../image.png",
+                      "sub\\image.png",
+                      "\\image.png",
+                      "C:image.png",
+                      "C:\\image.png",
+                      "\\\\server\\share\\image.png"}) {
+      Assert::IsTrue(
+          NetworkingModule::ResolveResponseFile(directory, name).empty());
+    }
+  }
+};
+
+} // namespace Microsoft::React::Test
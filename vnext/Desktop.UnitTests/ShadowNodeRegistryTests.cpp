@@ -0,0 +1,215 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <ShadowNodeRegistry.h>
+#include <Test/PerfTestHelpers.h>
+#include <Windows.h>
+#include <map>
+#include <stdexcept>
+
+using facebook::react::shadow_ptr;
+using facebook::react::ShadowNode;
+using facebook::react::ShadowNodeRegistry;
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+namespace {
+
+struct TestShadowNode : ShadowNode {
+  void onDropViewInstance() override {}
+  void removeAllChildren() override {}
+  void AddView(ShadowNode &, int64_t) override {}
+  void RemoveChildAt(int64_t) override {}
+  void createView() override {}
+};
+
+// Owns the nodes a test adds to a registry. The nodes have no view manager,
+// so the registry does not destroy them.
+struct TestNodes {
+  ShadowNode *Make(int64_t tag, int64_t parent = -1) {
+    nodes.push_back(std::make_unique<TestShadowNode>());
+    nodes.back()->m_tag = tag;
+    nodes.back()->m_parent = parent;
+    return nodes.back().get();
+  }
+
+  std::vector<std::unique_ptr<TestShadowNode>> nodes;
+};
+
+#ifdef PERF_TESTS
+// The ShadowNodeRegistry storage used before nodes were kept in pages, for
+// comparison.
+struct MapRegistry {
+  void addNode(shadow_ptr &&node, int64_t tag) {
+    m_allNodes[tag] = std::move(node);
+  }
+
+  ShadowNode &getNode(int64_t tag) {
+    return *m_allNodes.at(tag);
+  }
+
+  void removeNode(int64_t tag) {
+    m_allNodes.erase(tag);
+  }
+
+  std::map<int64_t, shadow_ptr> m_allNodes;
+};
+#endif // PERF_TESTS
+
+} // namespace
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(ShadowNodeRegistryTests) {
+ public:
+  TEST_METHOD(AddsFindsAndRemovesNodes) {
+    TestNodes nodes;
+    ShadowNodeRegistry registry;
+    auto node = nodes.Make(2);
+    registry.addNode(shadow_ptr(node), 2);
+    registry.addNode(shadow_ptr(nodes.Make(3)), 3);
+
+    Assert::IsTrue(&registry.getNode(2) == node);
+    Assert::IsTrue(registry.findNode(3) != nullptr);
+    Assert::IsNull(registry.findNode(4));
+    Assert::IsNull(registry.findNode(-1));
+
+    registry.removeNode(2);
+    Assert::IsNull(registry.findNode(2));
+    Assert::IsTrue(registry.findNode(3) != nullptr);
+    // Removing a node that is not there does nothing.
+    registry.removeNode(2);
+
+    bool threw = false;
+    try {
+      registry.getNode(2);
+    } catch (const std::out_of_range &) {
+      threw = true;
+    }
+    Assert::IsTrue(threw);
+
+    // Adding a node with the same tag replaces it.
+    auto replacement = nodes.Make(3);
+    registry.addNode(shadow_ptr(replacement), 3);
+    Assert::IsTrue(registry.findNode(3) == replacement);
+  }
+
+  TEST_METHOD(KeepsTagsOutsidePages) {
+    TestNodes nodes;
+    ShadowNodeRegistry registry;
+    const int64_t tags[] = {0, 1023, 1024, int64_t{1} << 40, -5};
+    for (auto tag : tags) {
+      registry.addNode(shadow_ptr(nodes.Make(tag)), tag);
+    }
+    for (auto tag : tags) {
+      Assert::IsTrue(registry.getNode(tag).m_tag == tag);
+    }
+    for (auto tag : tags) {
+      registry.removeNode(tag);
+      Assert::IsNull(registry.findNode(tag));
+    }
+  }
+
+  TEST_METHOD(ReusesEmptyPages) {
+    TestNodes nodes;
+    ShadowNodeRegistry registry;
+
+    // Trees come and go, while tags keep growing.
+    int64_t nextTag = 2;
+    for (int tree = 0; tree < 5; ++tree) {
+      const int64_t first = nextTag;
+      for (int i = 0; i < 3000; ++i, ++nextTag) {
+        registry.addNode(shadow_ptr(nodes.Make(nextTag)), nextTag);
+      }
+      for (int64_t tag = first; tag < nextTag; ++tag) {
+        Assert::IsTrue(registry.getNode(tag).m_tag == tag);
+      }
+      for (int64_t tag = first; tag < nextTag; ++tag) {
+        registry.removeNode(tag);
+      }
+      Assert::IsNull(registry.findNode(first));
+      Assert::IsNull(registry.findNode(nextTag - 1));
+    }
+  }
+
+  TEST_METHOD(FindsParentRoot) {
+    TestNodes nodes;
+    ShadowNodeRegistry registry;
+    registry.addRootView(shadow_ptr(nodes.Make(11)), 11);
+    registry.addNode(shadow_ptr(nodes.Make(12, 11)), 12);
+    registry.addNode(shadow_ptr(nodes.Make(13, 12)), 13);
+
+    Assert::IsTrue(registry.getParentRootShadowNode(13)->m_tag == 11);
+    Assert::IsTrue(registry.getRoot(11).m_tag == 11);
+    Assert::IsTrue(registry.getAllRoots().size() == 1);
+
+    registry.removeRootView(11);
+    Assert::IsNull(registry.findNode(11));
+    Assert::IsNull(registry.getParentRootShadowNode(13));
+    Assert::IsTrue(registry.getAllRoots().empty());
+  }
+
+#ifdef PERF_TESTS
+  // Creates, looks up and deletes 50k-node trees, as an app that navigates
+  // between large screens does.
+  TEST_METHOD(TimeCreateLookupDelete) {
+    constexpr int64_t nodeCount = 50000;
+    constexpr int treeCount = 10;
+    TestNodes nodes;
+    for (int64_t i = 0; i < nodeCount; ++i) {
+      nodes.Make(0);
+    }
+
+    ShadowNodeRegistry registry;
+    MapRegistry mapRegistry;
+    LARGE_INTEGER pagedTimes[3]{}, mapTimes[3]{};
+    int64_t nextTag = 2;
+    for (int tree = 0; tree < treeCount; ++tree) {
+      const int64_t first = nextTag;
+      nextTag += nodeCount;
+      TimeTree(registry, nodes, first, pagedTimes);
+      TimeTree(mapRegistry, nodes, first, mapTimes);
+    }
+
+    const uint32_t iterations = nodeCount * treeCount;
+    PrintResult("ShadowNodeRegistry::addNode", iterations, pagedTimes[0]);
+    PrintResult("ShadowNodeRegistry::getNode", iterations, pagedTimes[1]);
+    PrintResult("ShadowNodeRegistry::removeNode", iterations, pagedTimes[2]);
+    PrintResult("std::map insert", iterations, mapTimes[0]);
+    PrintResult("std::map at", iterations, mapTimes[1]);
+    PrintResult("std::map erase", iterations, mapTimes[2]);
+  }
+
+  template <typename Registry>
+  static void TimeTree(
+      Registry &registry,
+      TestNodes &nodes,
+      int64_t first,
+      LARGE_INTEGER (&times)[3]) {
+    const int64_t count = static_cast<int64_t>(nodes.nodes.size());
+
+    AddTime(times[0], [&]() {
+      for (int64_t i = 0; i < count; ++i) {
+        registry.addNode(shadow_ptr(nodes.nodes[i].get()), first + i);
+      }
+    });
+
+    // Walk from every node to its parent, as layout and manageChildren do.
+    int64_t sum = 0;
+    AddTime(times[1], [&]() {
+      for (int64_t i = 0; i < count; ++i) {
+        sum += registry.getNode(first + i / 2).m_tag;
+      }
+    });
+    Assert::IsTrue(sum == 0);
+
+    AddTime(times[2], [&]() {
+      for (int64_t i = 0; i < count; ++i) {
+        registry.removeNode(first + i);
+      }
+    });
+  }
+#endif // PERF_TESTS
+};
+
+} // namespace Microsoft::React::Test
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <Modules/TimingModule.h>
+#include <atomic>
+#include <future>
+
+using namespace std::chrono_literals;
+
+using facebook::react::DateTime;
+using facebook::react::ThreadTimerBackend;
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+namespace {
+
+DateTime Now() {
+  return std::chrono::time_point_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now());
+}
+
+} // namespace
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(TimerBackendTests) {
+ public:
+  TEST_METHOD(ThreadBackendFiresAtDueTime) {
+    std::promise<DateTime> raised;
+    ThreadTimerBackend backend([&raised]() { raised.set_value(Now()); });
+
+    const DateTime dueTime = Now() + 50ms;
+    backend.Set(dueTime);
+
+    auto raisedAt = raised.get_future();
+    Assert::IsTrue(raisedAt.wait_for(5s) == std::future_status::ready);
+    Assert::IsTrue(raisedAt.get() >= dueTime);
+  }
+
+  TEST_METHOD(ThreadBackendSetReplacesDueTime) {
+    std::atomic<int> raisedCount{0};
+    ThreadTimerBackend backend([&raisedCount]() { ++raisedCount; });
+
+    backend.Set(Now() + 10min);
+    backend.Set(Now() + 10ms);
+    std::this_thread::sleep_for(200ms);
+    Assert::AreEqual(1, raisedCount.load());
+  }
+
+  TEST_METHOD(ThreadBackendStopCancels) {
+    std::atomic<int> raisedCount{0};
+    ThreadTimerBackend backend([&raisedCount]() { ++raisedCount; });
+
+    backend.Set(Now() + 50ms);
+    backend.Stop();
+    std::this_thread::sleep_for(200ms);
+    Assert::AreEqual(0, raisedCount.load());
+
+    // A due time in the past fires right away.
+    backend.Set(Now() - 10ms);
+    std::this_thread::sleep_for(200ms);
+    Assert::AreEqual(1, raisedCount.load());
+  }
+};
+
+} // namespace Microsoft::React::Test
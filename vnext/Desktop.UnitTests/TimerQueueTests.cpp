@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <Modules/TimingModule.h>
+#include <Test/PerfTestHelpers.h>
+#include <algorithm>
+#include <random>
+#include <tuple>
+
+using facebook::react::DateTime;
+using facebook::react::Timer;
+using facebook::react::TimerQueue;
+using facebook::react::TimeSpan;
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+namespace {
+
+Timer MakeTimer(uint64_t id, int64_t dueTime) {
+  return Timer{id, DateTime(TimeSpan(dueTime)), TimeSpan(16), false};
+}
+
+} // namespace
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(TimerQueueTests) {
+ public:
+  TEST_METHOD(PopsInDueTimeOrder) {
+    TimerQueue queue;
+    queue.Push(MakeTimer(1, 100));
+    queue.Push(MakeTimer(2, 20));
+    queue.Push(MakeTimer(3, 50));
+
+    Assert::AreEqual(static_cast<size_t>(3), queue.Size());
+    Assert::AreEqual(static_cast<uint64_t>(2), queue.Front().Id);
+    queue.Pop();
+    Assert::AreEqual(static_cast<uint64_t>(3), queue.Front().Id);
+    queue.Pop();
+    Assert::AreEqual(static_cast<uint64_t>(1), queue.Front().Id);
+    queue.Pop();
+    Assert::IsTrue(queue.IsEmpty());
+  }
+
+  TEST_METHOD(TimersDueTogetherKeepPushOrder) {
+    TimerQueue queue;
+    for (uint64_t id = 1; id <= 5; ++id)
+      queue.Push(MakeTimer(id, 10));
+
+    Assert::IsTrue(queue.Remove(3));
+    for (uint64_t id : {1, 2, 4, 5}) {
+      Assert::AreEqual(id, queue.Front().Id);
+      queue.Pop();
+    }
+    Assert::IsTrue(queue.IsEmpty());
+  }
+
+  TEST_METHOD(RemoveById) {
+    TimerQueue queue;
+    queue.Push(MakeTimer(1, 10));
+    queue.Push(MakeTimer(2, 10));
+    queue.Push(MakeTimer(3, 30));
+
+    Assert::IsFalse(queue.Remove(4));
+    Assert::IsTrue(queue.Remove(1));
+    Assert::IsFalse(queue.Remove(1));
+    Assert::AreEqual(static_cast<uint64_t>(2), queue.Front().Id);
+
+    // Removing the last timer of the front slot exposes the next slot.
+    Assert::IsTrue(queue.Remove(2));
+    Assert::AreEqual(static_cast<uint64_t>(3), queue.Front().Id);
+    Assert::IsTrue(queue.Remove(3));
+    Assert::IsTrue(queue.IsEmpty());
+  }
+
+  TEST_METHOD(PushReplacesTimerWithSameId) {
+    TimerQueue queue;
+    queue.Push(MakeTimer(1, 10));
+    queue.Push(MakeTimer(2, 20));
+    queue.Push(MakeTimer(1, 30));
+
+    Assert::AreEqual(static_cast<size_t>(2), queue.Size());
+    Assert::AreEqual(static_cast<uint64_t>(2), queue.Front().Id);
+    queue.Pop();
+    Assert::AreEqual(static_cast<uint64_t>(1), queue.Front().Id);
+    Assert::AreEqual(
+        DateTime(TimeSpan(30)).time_since_epoch().count(),
+        queue.Front().DueTime.time_since_epoch().count());
+  }
+
+  // Compares random pushes, removes and pops with a list ordered by
+  // (due time, push order).
+  TEST_METHOD(RandomOperationsMatchReference) {
+    std::mt19937 random(42);
+    TimerQueue queue;
+    std::vector<std::tuple<int64_t, uint64_t, uint64_t>> reference;
+    uint64_t sequence = 0;
+
+    auto eraseFromReference = [&reference](uint64_t id) {
+      auto found = std::find_if(
+          reference.begin(), reference.end(), [id](const auto &timer) {
+            return std::get<2>(timer) == id;
+          });
+      if (found == reference.end())
+        return false;
+      reference.erase(found);
+      return true;
+    };
+
+    for (int i = 0; i < 20000; ++i) {
+      const uint64_t id = random() % 200;
+      switch (random() % 4) {
+        case 0:
+        case 1: {
+          const int64_t dueTime = random() % 40;
+          eraseFromReference(id);
+          reference.emplace_back(dueTime, sequence++, id);
+          queue.Push(MakeTimer(id, dueTime));
+          break;
+        }
+        case 2:
+          Assert::AreEqual(eraseFromReference(id), queue.Remove(id));
+          break;
+        default:
+          if (!reference.empty()) {
+            auto front = std::min_element(reference.begin(), reference.end());
+            Assert::AreEqual(std::get<2>(*front), queue.Front().Id);
+            reference.erase(front);
+            queue.Pop();
+          }
+      }
+
+      Assert::AreEqual(reference.size(), queue.Size());
+      if (!reference.empty()) {
+        auto front = std::min_element(reference.begin(), reference.end());
+        Assert::AreEqual(std::get<2>(*front), queue.Front().Id);
+      }
+    }
+  }
+
+#ifdef PERF_TESTS
+  // Debounce-like load: 100k live timers spread over 10 seconds, half of them
+  // cancelled by id before the rest fire.
+  TEST_METHOD(TimeCreateCancelFire) {
+    constexpr uint32_t timerCount = 100000;
+    std::mt19937 random(42);
+    std::vector<int64_t> dueTimes(timerCount);
+    for (auto &dueTime : dueTimes)
+      dueTime = random() % 10000;
+
+    TimerQueue queue;
+    LARGE_INTEGER create{0}, cancel{0}, fire{0};
+
+    AddTime(create, [&]() {
+      for (uint32_t id = 0; id < timerCount; ++id)
+        queue.Push(MakeTimer(id, dueTimes[id]));
+    });
+
+    AddTime(cancel, [&]() {
+      for (uint32_t id = 0; id < timerCount; id += 2)
+        queue.Remove(id);
+    });
+
+    AddTime(fire, [&]() {
+      while (!queue.IsEmpty())
+        queue.Pop();
+    });
+
+    PrintResult("TimerQueue::Push", timerCount, create);
+    PrintResult("TimerQueue::Remove", timerCount / 2, cancel);
+    PrintResult("TimerQueue::Pop", timerCount / 2, fire);
+  }
+#endif // PERF_TESTS
+};
+
+} // namespace Microsoft::React::Test
@@ -0,0 +1,180 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <CppUnitTest.h>
+#include <UIBatchQueue.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using facebook::react::UIBatchQueue;
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+namespace {
+
+// Holds on to the callbacks the queue posts, so that a test can run them
+// when it needs to.
+struct FakeDispatcher {
+  std::vector<std::function<void()>> callbacks;
+
+  UIBatchQueue::Post Post() {
+    return [this](std::function<void()> &&callback) {
+      callbacks.push_back(std::move(callback));
+    };
+  }
+
+  // Runs the next callback. Returns false if there was none.
+  bool RunOne() {
+    if (callbacks.empty())
+      return false;
+
+    auto callback = std::move(callbacks.front());
+    callbacks.erase(callbacks.begin());
+    callback();
+    return true;
+  }
+};
+
+UIBatchQueue::WorkItems MakeBatch(
+    std::string &log,
+    const std::string &name,
+    int count,
+    std::chrono::milliseconds duration = {}) {
+  UIBatchQueue::WorkItems items;
+  for (int i = 1; i <= count; ++i) {
+    items.push_back([&log, name, i, duration]() {
+      std::this_thread::sleep_for(duration);
+      log += name + std::to_string(i) + " ";
+    });
+  }
+  return items;
+}
+
+} // namespace
+
+namespace Microsoft::React::Test {
+
+TEST_CLASS(UIBatchQueueTests) {
+ public:
+  TEST_METHOD(RunsEachBatchInOneCallbackWithoutBudget) {
+    FakeDispatcher dispatcher;
+    auto queue = std::make_shared<UIBatchQueue>(
+        dispatcher.Post(), std::chrono::microseconds{0});
+
+    std::string log;
+    queue->Submit(MakeBatch(log, "a", 3));
+    queue->Submit(MakeBatch(log, "b", 1));
+    Assert::IsTrue(dispatcher.callbacks.size() == 2);
+
+    Assert::IsTrue(dispatcher.RunOne());
+    Assert::AreEqual(std::string{"a1 a2 a3 "}, log);
+    Assert::IsTrue(dispatcher.RunOne());
+    Assert::AreEqual(std::string{"a1 a2 a3 b1 "}, log);
+
+    auto stats = queue->GetStats();
+    Assert::IsTrue(stats.callbacks == 2);
+    Assert::IsTrue(stats.itemCount.buckets[1] == 1);
+    Assert::IsTrue(stats.itemCount.buckets[2] == 1);
+  }
+
+  TEST_METHOD(SpreadsBatchesOverCallbacks) {
+    FakeDispatcher dispatcher;
+    auto queue = std::make_shared<UIBatchQueue>(
+        dispatcher.Post(), std::chrono::milliseconds{1});
+
+    // Every operation takes longer than the budget, so each callback runs
+    // exactly one.
+    std::string log;
+    queue->Submit(MakeBatch(log, "a", 3, std::chrono::milliseconds{2}));
+    queue->Submit(MakeBatch(log, "b", 1, std::chrono::milliseconds{2}));
+    Assert::IsTrue(dispatcher.callbacks.size() == 1);
+
+    Assert::IsTrue(dispatcher.RunOne());
+    Assert::AreEqual(std::string{"a1 "}, log);
+    Assert::IsTrue(dispatcher.RunOne());
+    Assert::IsTrue(dispatcher.RunOne());
+    Assert::AreEqual(std::string{"a1 a2 a3 "}, log);
+    Assert::IsTrue(dispatcher.RunOne());
+    Assert::AreEqual(std::string{"a1 a2 a3 b1 "}, log);
+    while (dispatcher.RunOne()) {
+    }
+
+    // Batches submitted after the queue drained schedule a new callback.
+    queue->Submit(MakeBatch(log, "c", 1));
+    Assert::IsTrue(dispatcher.RunOne());
+    Assert::AreEqual(std::string{"a1 a2 a3 b1 c1 "}, log);
+
+    auto stats = queue->GetStats();
+    Assert::IsTrue(stats.itemCount.buckets[1] == 2);
+    Assert::IsTrue(stats.itemCount.buckets[2] == 1);
+
+    // The first batch ran for at least 6 ms, which falls in [4096, 8192) us
+    // or later buckets.
+    uint64_t longBatches = 0;
+    for (size_t i = 13; i < UIBatchQueue::Histogram::BucketCount; ++i) {
+      longBatches += stats.durationUs.buckets[i];
+    }
+    Assert::IsTrue(longBatches >= 1);
+  }
+
+  TEST_METHOD(RunsSmallBatchesInOneCallback) {
+    FakeDispatcher dispatcher;
+    auto queue = std::make_shared<UIBatchQueue>(
+        dispatcher.Post(), std::chrono::seconds{1});
+
+    std::string log;
+    queue->Submit(MakeBatch(log, "a", 2));
+    queue->Submit(MakeBatch(log, "b", 2));
+    queue->Submit(MakeBatch(log, "c", 1));
+    Assert::IsTrue(dispatcher.callbacks.size() == 1);
+
+    Assert::IsTrue(dispatcher.RunOne());
+    Assert::AreEqual(std::string{"a1 a2 b1 b2 c1 "}, log);
+    Assert::IsTrue(dispatcher.callbacks.empty());
+    Assert::IsTrue(queue->GetStats().callbacks == 1);
+  }
+
+  TEST_METHOD(KeepsDrainingAfterAnOperationThrows) {
+    FakeDispatcher dispatcher;
+    auto queue = std::make_shared<UIBatchQueue>(
+        dispatcher.Post(), std::chrono::seconds{1});
+
+    std::string log;
+    auto items = MakeBatch(log, "a", 1);
+    items.push_back([]() { throw std::runtime_error("failed"); });
+    queue->Submit(std::move(items));
+    queue->Submit(MakeBatch(log, "b", 1));
+
+    Assert::ExpectException<std::runtime_error>(
+        [&dispatcher]() { dispatcher.RunOne(); });
+    Assert::AreEqual(std::string{"a1 "}, log);
+
+    Assert::IsTrue(dispatcher.RunOne());
+    Assert::AreEqual(std::string{"a1 b1 "}, log);
+    Assert::IsTrue(dispatcher.callbacks.empty());
+
+    // The queue is idle again, so a new batch schedules a callback.
+    queue->Submit(MakeBatch(log, "c", 1));
+    Assert::IsTrue(dispatcher.RunOne());
+    Assert::AreEqual(std::string{"a1 b1 c1 "}, log);
+  }
+
+  TEST_METHOD(HistogramBuckets) {
+    UIBatchQueue::Histogram histogram;
+    for (uint64_t value : {0, 1, 2, 3, 4, 1000}) {
+      histogram.Add(value);
+    }
+    histogram.Add(UINT64_MAX);
+
+    Assert::IsTrue(histogram.buckets[0] == 1);
+    Assert::IsTrue(histogram.buckets[1] == 1);
+    Assert::IsTrue(histogram.buckets[2] == 2);
+    Assert::IsTrue(histogram.buckets[3] == 1);
+    Assert::IsTrue(histogram.buckets[10] == 1);
+    Assert::IsTrue(
+        histogram.buckets[UIBatchQueue::Histogram::BucketCount - 1] == 1);
+  }
+};
+
+} // namespace Microsoft::React::Test
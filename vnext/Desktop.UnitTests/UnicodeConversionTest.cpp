@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include <CppUnitTest.h>
+#include <Test/PerfTestHelpers.h>
+#include <Windows.h>
+#include <random>
+#include <sstream>
 #include <string>
 #include "Unicode.h"
 #include "UnicodeTestStrings.h"
@@ -9,6 +13,73 @@
 using Microsoft::Common::Unicode::Utf16ToUtf8;
 using Microsoft::Common::Unicode::Utf8ToUtf16;
 using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+using Microsoft::VisualStudio::CppUnitTestFramework::Logger;
+
+namespace {
+
+// Conversions by the OS alone, which Utf8ToUtf16 and Utf16ToUtf8 must match.
+std::wstring ReferenceUtf8ToUtf16(const std::string &utf8) {
+  const int length = static_cast<int>(utf8.length());
+  std::wstring utf16(
+      ::MultiByteToWideChar(CP_UTF8, 0, utf8.data(), length, nullptr, 0),
+      L'\0');
+  ::MultiByteToWideChar(
+      CP_UTF8,
+      0,
+      utf8.data(),
+      length,
+      &utf16[0],
+      static_cast<int>(utf16.length()));
+  return utf16;
+}
+
+std::string ReferenceUtf16ToUtf8(const std::wstring &utf16) {
+  const int length = static_cast<int>(utf16.length());
+  std::string utf8(
+      ::WideCharToMultiByte(
+          CP_UTF8, 0, utf16.data(), length, nullptr, 0, nullptr, nullptr),
+      '\0');
+  ::WideCharToMultiByte(
+      CP_UTF8,
+      0,
+      utf16.data(),
+      length,
+      &utf8[0],
+      static_cast<int>(utf8.length()),
+      nullptr,
+      nullptr);
+  return utf8;
+}
+
+// Returns a copy of str with a few code units replaced by random ones, cut
+// short, or with part of it repeated, to put ill-formed sequences, truncated
+// sequences and ASCII runs at every offset.
+template <typename TString>
+TString Mutate(const TString &str, std::mt19937 &random) {
+  using TChar = typename TString::value_type;
+  TString mutated = str;
+  const int mutations = 1 + random() % 3;
+  for (int i = 0; i < mutations && !mutated.empty(); ++i) {
+    const size_t offset = random() % mutated.length();
+    switch (random() % 4) {
+      case 0:
+        mutated[offset] = static_cast<TChar>(random());
+        break;
+      case 1:
+        mutated.resize(offset);
+        break;
+      case 2:
+        mutated.insert(offset, mutated.substr(random() % mutated.length()));
+        break;
+      default:
+        mutated.insert(offset, random() % 40, static_cast<TChar>('a'));
+        break;
+    }
+  }
+  return mutated;
+}
+
+} // namespace
 
 namespace Microsoft::React::Test {
 
@@ -109,6 +180,109 @@ TEST_CLASS(UnicodeConversionTest) {
     }
   }
 
+  TEST_METHOD(NonAsciiAtEveryOffsetTest) {
+    // Puts each kind of sequence before, inside and after the runs of ASCII
+    // that are converted 16 code units at a time.
+    for (const char *sequence :
+         {"\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xed\xa3\xa9"}) {
+      for (size_t offset = 0; offset < 40; ++offset) {
+        std::string utf8(48, 'x');
+        utf8.insert(offset, sequence);
+        std::wstring utf16 = Utf8ToUtf16(utf8);
+        Assert::IsTrue(utf16 == ReferenceUtf8ToUtf16(utf8));
+        Assert::IsTrue(Utf16ToUtf8(utf16) == ReferenceUtf16ToUtf8(utf16));
+      }
+    }
+  }
+
+  TEST_METHOD(Utf8ToUtf16FuzzTest) {
+    std::mt19937 random(42);
+    for (const std::string &str : g_utf8TestStrings) {
+      for (int i = 0; i < 200; ++i) {
+        const std::string utf8 = Mutate(str, random);
+        if (!utf8.empty()) {
+          Assert::IsTrue(Utf8ToUtf16(utf8) == ReferenceUtf8ToUtf16(utf8));
+        }
+      }
+    }
+  }
+
+  TEST_METHOD(Utf16ToUtf8FuzzTest) {
+    std::mt19937 random(42);
+    for (const std::string &str : g_utf8TestStrings) {
+      const std::wstring original = Utf8ToUtf16(str);
+      for (int i = 0; i < 200; ++i) {
+        // Random code units are unpaired surrogates now and then.
+        const std::wstring utf16 = Mutate(original, random);
+        if (!utf16.empty()) {
+          Assert::IsTrue(Utf16ToUtf8(utf16) == ReferenceUtf16ToUtf8(utf16));
+        }
+      }
+    }
+  }
+
+#ifdef PERF_TESTS
+  TEST_METHOD(ConversionThroughputTest) {
+    constexpr uint32_t iterations = 100;
+
+    // An ASCII bundle-like string, and the corpus repeated to the same size.
+    std::string ascii;
+    while (ascii.length() < 1 << 20) {
+      ascii += "__d(function(g,r,i,a,m,e,d){var t=r(d[0]);m.exports=t;},";
+      ascii += std::to_string(ascii.length()) + ",[1,2,3]);\n";
+    }
+    std::string mixed;
+    while (mixed.length() < ascii.length()) {
+      for (const std::string &str : g_utf8TestStrings)
+        mixed += str;
+    }
+
+    for (const auto &test :
+         {std::make_pair("ascii", &ascii), std::make_pair("mixed", &mixed)}) {
+      const std::string &utf8 = *test.second;
+      const std::wstring utf16 = Utf8ToUtf16(utf8);
+      LARGE_INTEGER osToUtf16{0}, toUtf16{0}, osToUtf8{0}, toUtf8{0};
+
+      AddTime(osToUtf16, [&]() {
+        for (uint32_t i = 0; i < iterations; ++i)
+          ReferenceUtf8ToUtf16(utf8);
+      });
+      AddTime(toUtf16, [&]() {
+        for (uint32_t i = 0; i < iterations; ++i)
+          Utf8ToUtf16(utf8);
+      });
+      AddTime(osToUtf8, [&]() {
+        for (uint32_t i = 0; i < iterations; ++i)
+          ReferenceUtf16ToUtf8(utf16);
+      });
+      AddTime(toUtf8, [&]() {
+        for (uint32_t i = 0; i < iterations; ++i)
+          Utf16ToUtf8(utf16);
+      });
+
+      const size_t bytes = utf8.length() * iterations;
+      PrintThroughput(test.first, "OS to UTF-16", bytes, iterations, osToUtf16);
+      PrintThroughput(test.first, "to UTF-16", bytes, iterations, toUtf16);
+      PrintThroughput(test.first, "OS to UTF-8", bytes, iterations, osToUtf8);
+      PrintThroughput(test.first, "to UTF-8", bytes, iterations, toUtf8);
+    }
+  }
+
+  // Prints the result of a benchmark that converted bytes of UTF-8, or their
+  // UTF-16 equivalent, along with the throughput.
+  static void PrintThroughput(
+      const char *input,
+      const char *testName,
+      size_t bytes,
+      uint32_t iterations,
+      LARGE_INTEGER accu) {
+    std::stringstream ss;
+    ss << input << " " << FormatResult(testName, iterations, accu) << "; "
+       << bytes / ToSeconds(accu) / (1 << 20) << " MB/s";
+    Logger::WriteMessage(ss.str().c_str());
+  }
+#endif // PERF_TESTS
+
  private:
   constexpr static const char *SimpleTestStringNoBomUtf8 =
       "\x61\x62\x63"; // abc
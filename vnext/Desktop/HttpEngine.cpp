@@ -0,0 +1,648 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "HttpEngine.h"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <limits>
+
+using namespace boost::beast::http;
+
+using boost::asio::bind_executor;
+using boost::asio::io_context;
+using boost::asio::ip::tcp;
+using boost::system::error_code;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::unique_ptr;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+namespace Microsoft::React::Experimental {
+
+#pragma region HttpEngine::Exchange
+
+///
+// Sends one request and reads its response. Everything after Send runs on the
+// exchange's strand.
+///
+class HttpEngine::Exchange : public HttpEngine::Operation,
+                             public std::enable_shared_from_this<Exchange> {
+  HttpEngine &m_engine;
+  const string m_host;
+  const string m_port;
+  const string m_key;
+  Request m_request;
+  unique_ptr<BodySource> m_body;
+  const milliseconds m_timeout;
+  Handlers m_handlers;
+
+  boost::asio::strand<io_context::executor_type> m_strand;
+  boost::asio::steady_timer m_timer;
+  unique_ptr<Connection> m_conn;
+  boost::optional<request_serializer<string_body>> m_serializer;
+  boost::optional<response_parser<string_body>> m_parser;
+  int64_t m_bodySent{0};
+  bool m_reused{false};
+  bool m_sent{false};
+  bool m_paused{false};
+  bool m_done{false};
+
+  void Open(bool allowIdle);
+  void OnResolved(error_code ec, tcp::resolver::results_type results);
+  void OnConnected(error_code ec);
+  void Write();
+  void WriteBody();
+  void OnBodyWritten(error_code ec, size_t size);
+  void OnWritten(error_code ec);
+  void ReadHeader();
+  void OnReadHeader(error_code ec);
+  void ReadBody();
+  void OnReadBody(error_code ec);
+  bool Retry();
+  void Complete();
+  void Fail(const string &message, bool isTimeout);
+  void Close() noexcept;
+
+ public:
+  Exchange(
+      HttpEngine &engine,
+      string &&host,
+      string &&port,
+      Request &&request,
+      unique_ptr<BodySource> &&body,
+      milliseconds timeout,
+      Handlers &&handlers);
+
+  void Start();
+
+#pragma region HttpEngine::Operation members
+
+  void Abort() noexcept override;
+  void Resume() noexcept override;
+
+#pragma endregion HttpEngine::Operation members
+};
+
+HttpEngine::Exchange::Exchange(
+    HttpEngine &engine,
+    string &&host,
+    string &&port,
+    Request &&request,
+    unique_ptr<BodySource> &&body,
+    milliseconds timeout,
+    Handlers &&handlers)
+    : m_engine{engine},
+      m_host{std::move(host)},
+      m_port{std::move(port)},
+      m_key{m_host + ':' + m_port},
+      m_request{std::move(request)},
+      m_body{std::move(body)},
+      m_timeout{timeout},
+      m_handlers{std::move(handlers)},
+      m_strand{engine.m_context.get_executor()},
+      m_timer{engine.m_context} {
+  if (!m_body)
+    return;
+
+  m_request.body().clear();
+  const auto size = m_body->Size();
+  if (size < 0)
+    m_request.chunked(true);
+  else
+    m_request.content_length(size);
+}
+
+void HttpEngine::Exchange::Start() {
+  if (m_timeout.count() > 0) {
+    m_timer.expires_after(m_timeout);
+    m_timer.async_wait(
+        bind_executor(m_strand, [self = shared_from_this()](error_code ec) {
+          if (ec == boost::asio::error::operation_aborted)
+            return;
+
+          self->Fail("Request timed out", true /*isTimeout*/);
+        }));
+  }
+
+  boost::asio::post(
+      m_strand, [self = shared_from_this()]() { self->Open(true); });
+}
+
+void HttpEngine::Exchange::Open(bool allowIdle) {
+  if (m_done)
+    return;
+
+  if (allowIdle) {
+    m_conn = m_engine.TakeIdle(m_key);
+    if (m_conn) {
+      m_reused = true;
+      ++m_engine.m_connectionsReused;
+      return Write();
+    }
+  }
+
+  m_reused = false;
+  m_engine.Resolve(
+      m_host,
+      m_port,
+      [self = shared_from_this()](
+          error_code ec, tcp::resolver::results_type results) {
+        boost::asio::post(self->m_strand, [self, ec, results]() {
+          self->OnResolved(ec, results);
+        });
+      });
+}
+
+void HttpEngine::Exchange::OnResolved(
+    error_code ec,
+    tcp::resolver::results_type results) {
+  if (m_done)
+    return;
+
+  if (ec)
+    return Fail(ec.message(), false /*isTimeout*/);
+
+  m_conn = std::make_unique<Connection>(m_engine.m_context);
+  boost::asio::async_connect(
+      m_conn->socket,
+      results,
+      bind_executor(
+          m_strand,
+          [self = shared_from_this()](error_code ec, const tcp::endpoint &) {
+            self->OnConnected(ec);
+          }));
+}
+
+void HttpEngine::Exchange::OnConnected(error_code ec) {
+  if (m_done)
+    return;
+
+  if (ec)
+    return Fail(ec.message(), false /*isTimeout*/);
+
+  ++m_engine.m_connectionsOpened;
+
+  // Requests are written in whole headers and body parts, so do not wait to
+  // coalesce them.
+  error_code ignored;
+  m_conn->socket.set_option(tcp::no_delay(true), ignored);
+
+  Write();
+}
+
+void HttpEngine::Exchange::Write() {
+  if (!m_body) {
+    return async_write(
+        m_conn->socket,
+        m_request,
+        bind_executor(
+            m_strand, [self = shared_from_this()](error_code ec, size_t) {
+              self->OnWritten(ec);
+            }));
+  }
+
+  // Only the header comes from the request. The body follows in parts.
+  m_bodySent = 0;
+  m_serializer.emplace(m_request);
+  async_write_header(
+      m_conn->socket,
+      *m_serializer,
+      bind_executor(
+          m_strand, [self = shared_from_this()](error_code ec, size_t) {
+            if (ec)
+              return self->OnWritten(ec);
+
+            self->WriteBody();
+          }));
+}
+
+void HttpEngine::Exchange::WriteBody() {
+  if (m_done)
+    return;
+
+  std::string_view part;
+  if (!m_body->Next(part))
+    return Fail("Could not read the request body", false /*isTimeout*/);
+
+  const auto chunked = m_request.chunked();
+  if (part.empty() && !chunked)
+    return OnWritten({});
+
+  auto handler = bind_executor(
+      m_strand,
+      [self = shared_from_this(), size = part.size()](error_code ec, size_t) {
+        self->OnBodyWritten(ec, size);
+      });
+
+  const auto buffer = boost::asio::buffer(part.data(), part.size());
+  if (part.empty())
+    boost::asio::async_write(m_conn->socket, make_chunk_last(), handler);
+  else if (chunked)
+    boost::asio::async_write(m_conn->socket, make_chunk(buffer), handler);
+  else
+    boost::asio::async_write(m_conn->socket, buffer, handler);
+}
+
+void HttpEngine::Exchange::OnBodyWritten(error_code ec, size_t size) {
+  if (m_done)
+    return;
+
+  if (ec || size == 0)
+    return OnWritten(ec);
+
+  m_bodySent += size;
+  if (m_handlers.OnDataSent)
+    m_handlers.OnDataSent(m_bodySent, m_body->Size());
+
+  WriteBody();
+}
+
+void HttpEngine::Exchange::OnWritten(error_code ec) {
+  if (m_done)
+    return;
+
+  if (ec) {
+    if (Retry())
+      return;
+
+    return Fail(ec.message(), false /*isTimeout*/);
+  }
+
+  if (!m_sent) {
+    m_sent = true;
+    if (m_handlers.OnRequestSent)
+      m_handlers.OnRequestSent();
+  }
+
+  ReadHeader();
+}
+
+void HttpEngine::Exchange::ReadHeader() {
+  m_parser.emplace();
+  m_parser->body_limit((std::numeric_limits<std::uint64_t>::max)());
+
+  async_read_header(
+      m_conn->socket,
+      m_conn->buffer,
+      *m_parser,
+      bind_executor(
+          m_strand, [self = shared_from_this()](error_code ec, size_t) {
+            self->OnReadHeader(ec);
+          }));
+}
+
+void HttpEngine::Exchange::OnReadHeader(error_code ec) {
+  if (m_done)
+    return;
+
+  if (ec) {
+    if (!m_parser->got_some() && Retry())
+      return;
+
+    return Fail(ec.message(), false /*isTimeout*/);
+  }
+
+  if (m_handlers.OnHeader) {
+    auto length = m_parser->content_length();
+    m_handlers.OnHeader(
+        m_parser->get().base(), length ? static_cast<int64_t>(*length) : -1);
+  }
+
+  // The parser reserved room for the whole body, which parts handed out as
+  // they arrive never need.
+  if (m_handlers.OnData)
+    string{}.swap(m_parser->get().body());
+
+  ReadBody();
+}
+
+void HttpEngine::Exchange::ReadBody() {
+  if (m_parser->is_done())
+    return Complete();
+
+  async_read_some(
+      m_conn->socket,
+      m_conn->buffer,
+      *m_parser,
+      bind_executor(
+          m_strand, [self = shared_from_this()](error_code ec, size_t) {
+            self->OnReadBody(ec);
+          }));
+}
+
+void HttpEngine::Exchange::OnReadBody(error_code ec) {
+  if (m_done)
+    return;
+
+  if (ec)
+    return Fail(ec.message(), false /*isTimeout*/);
+
+  auto &body = m_parser->get().body();
+  if (m_handlers.OnData && !body.empty()) {
+    string part = std::move(body);
+    body.clear();
+    if (!m_handlers.OnData(std::move(part))) {
+      m_paused = true;
+      return;
+    }
+  }
+
+  ReadBody();
+}
+
+// A server may close a connection that sat in the pool at any time. If that
+// happened before it saw any of the request, send it again on a new
+// connection.
+bool HttpEngine::Exchange::Retry() {
+  if (!m_reused || (m_body && !m_body->Rewind()))
+    return false;
+
+  Close();
+  m_conn.reset();
+  Open(false /*allowIdle*/);
+  return true;
+}
+
+void HttpEngine::Exchange::Complete() {
+  m_done = true;
+  m_timer.cancel();
+
+  auto response = m_parser->release();
+  if (response.keep_alive())
+    m_engine.Recycle(m_key, std::move(m_conn));
+  else
+    Close();
+
+  if (m_handlers.OnResponse)
+    m_handlers.OnResponse(std::move(response));
+
+  m_handlers = {};
+}
+
+void HttpEngine::Exchange::Fail(const string &message, bool isTimeout) {
+  if (m_done)
+    return;
+
+  m_done = true;
+  m_timer.cancel();
+  Close();
+
+  if (m_handlers.OnError)
+    m_handlers.OnError(message, isTimeout);
+
+  m_handlers = {};
+}
+
+// Pending operations on the socket complete with operation_aborted. The
+// connection itself stays until the exchange goes away, as they may still
+// refer to its buffer.
+void HttpEngine::Exchange::Close() noexcept {
+  if (!m_conn)
+    return;
+
+  error_code ignored;
+  m_conn->socket.shutdown(tcp::socket::shutdown_both, ignored);
+  m_conn->socket.close(ignored);
+}
+
+void HttpEngine::Exchange::Abort() noexcept {
+  boost::asio::post(m_strand, [self = shared_from_this()]() {
+    if (self->m_done)
+      return;
+
+    self->m_done = true;
+    self->m_timer.cancel();
+    self->Close();
+    self->m_handlers = {};
+  });
+}
+
+void HttpEngine::Exchange::Resume() noexcept {
+  boost::asio::post(m_strand, [self = shared_from_this()]() {
+    if (self->m_done || !self->m_paused)
+      return;
+
+    self->m_paused = false;
+    self->ReadBody();
+  });
+}
+
+#pragma endregion HttpEngine::Exchange
+
+#pragma region HttpEngine
+
+HttpEngine::HttpEngine(Options options)
+    : HttpEngine{options, make_shared<IoThreadPool>(options.threadCount)} {}
+
+HttpEngine::HttpEngine(Options options, shared_ptr<IoThreadPool> pool)
+    : m_options{std::move(options)},
+      m_pool{std::move(pool)},
+      m_context{m_pool->Context()},
+      m_reaper{std::make_unique<boost::asio::steady_timer>(m_context)} {}
+
+HttpEngine::~HttpEngine() {
+  // The idle sockets and the reaper must go before the context they were
+  // opened on.
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_idle.clear();
+    m_reaper.reset();
+  }
+
+  // Joins the threads of a pool of the engine's own before the lookups that
+  // may still complete on them go.
+  m_pool.reset();
+}
+
+/*static*/ shared_ptr<HttpEngine> HttpEngine::Shared() {
+  // Never destroyed, like the pool it runs on.
+  static auto engine = new shared_ptr<HttpEngine>(
+      new HttpEngine{Options{}, IoThreadPool::Shared()});
+  return *engine;
+}
+
+shared_ptr<HttpEngine::Operation> HttpEngine::Send(
+    string host,
+    string port,
+    Request &&request,
+    milliseconds timeout,
+    Handlers &&handlers) {
+  return Send(
+      std::move(host),
+      std::move(port),
+      std::move(request),
+      nullptr,
+      timeout,
+      std::move(handlers));
+}
+
+shared_ptr<HttpEngine::Operation> HttpEngine::Send(
+    string host,
+    string port,
+    Request &&request,
+    unique_ptr<BodySource> &&body,
+    milliseconds timeout,
+    Handlers &&handlers) {
+  auto exchange = make_shared<Exchange>(
+      *this,
+      std::move(host),
+      std::move(port),
+      std::move(request),
+      std::move(body),
+      timeout,
+      std::move(handlers));
+  exchange->Start();
+
+  return exchange;
+}
+
+HttpEngine::Counters HttpEngine::GetCounters() const noexcept {
+  return {m_connectionsOpened, m_connectionsReused, m_dnsLookups};
+}
+
+unique_ptr<HttpEngine::Connection> HttpEngine::TakeIdle(const string &key) {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  auto pool = m_idle.find(key);
+  if (pool == m_idle.end())
+    return nullptr;
+
+  const auto now = steady_clock::now();
+  while (!pool->second.empty()) {
+    auto conn = std::move(pool->second.back());
+    pool->second.pop_back();
+    if (now - conn->idleSince < m_options.idleTimeout)
+      return conn;
+  }
+
+  return nullptr;
+}
+
+void HttpEngine::Recycle(const string &key, unique_ptr<Connection> &&conn) {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  auto &pool = m_idle[key];
+  if (pool.size() >= m_options.maxIdleConnectionsPerHost)
+    return;
+
+  conn->idleSince = steady_clock::now();
+  ScheduleReap(conn->idleSince + m_options.idleTimeout);
+  pool.push_back(std::move(conn));
+}
+
+// Requires m_mutex.
+void HttpEngine::ScheduleReap(steady_clock::time_point when) {
+  if (m_reaping || !m_reaper)
+    return;
+
+  m_reaping = true;
+  m_reaper->expires_at(when);
+  m_reaper->async_wait([this](error_code ec) {
+    if (ec == boost::asio::error::operation_aborted)
+      return;
+
+    Reap();
+  });
+}
+
+void HttpEngine::Reap() {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  m_reaping = false;
+
+  const auto now = steady_clock::now();
+  auto oldest = steady_clock::time_point::max();
+  for (auto pool = m_idle.begin(); pool != m_idle.end();) {
+    auto &conns = pool->second;
+    conns.erase(
+        std::remove_if(
+            conns.begin(),
+            conns.end(),
+            [this, now](const unique_ptr<Connection> &conn) {
+              return now - conn->idleSince >= m_options.idleTimeout;
+            }),
+        conns.end());
+
+    if (conns.empty()) {
+      pool = m_idle.erase(pool);
+      continue;
+    }
+
+    for (const auto &conn : conns) {
+      oldest = (std::min)(oldest, conn->idleSince);
+    }
+    ++pool;
+  }
+
+  if (!m_idle.empty())
+    ScheduleReap(oldest + m_options.idleTimeout);
+}
+
+void HttpEngine::Resolve(
+    const string &host,
+    const string &port,
+    Resolved &&resolved) {
+  auto key = host + ':' + port;
+  std::unique_lock<std::mutex> lock{m_mutex};
+  auto &entry = m_hosts[key];
+  if (entry.resolving) {
+    entry.waiters.push_back(std::move(resolved));
+    return;
+  }
+
+  if (!entry.results.empty() && steady_clock::now() < entry.expires) {
+    auto results = entry.results;
+    lock.unlock();
+    resolved({}, std::move(results));
+    return;
+  }
+
+  entry.resolving = true;
+  entry.waiters.push_back(std::move(resolved));
+  lock.unlock();
+
+  ++m_dnsLookups;
+  auto resolver = make_shared<tcp::resolver>(m_context);
+  resolver->async_resolve(
+      host,
+      port,
+      [this, resolver, key = std::move(key)](
+          error_code ec, tcp::resolver::results_type results) {
+        OnResolved(key, ec, std::move(results));
+      });
+}
+
+void HttpEngine::OnResolved(
+    const string &key,
+    error_code ec,
+    tcp::resolver::results_type results) {
+  std::vector<Resolved> waiters;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto &entry = m_hosts[key];
+    waiters = std::move(entry.waiters);
+    if (ec) {
+      m_hosts.erase(key);
+    } else {
+      entry.resolving = false;
+      entry.results = results;
+      entry.expires = steady_clock::now() + m_options.dnsTimeToLive;
+    }
+  }
+
+  for (auto &waiter : waiters) {
+    waiter(ec, results);
+  }
+}
+
+#pragma endregion HttpEngine
+
+} // namespace Microsoft::React::Experimental
@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "IoThreadPool.h"
+
+namespace Microsoft::React::Experimental {
+
+///
+// Sends HTTP requests from the threads of an IoThreadPool.
+//
+// Connections that the server keeps alive go back to a per-host pool, so
+// later requests to the same host skip connecting. Host names resolve once
+// per time-to-live, and requests that need a name being resolved wait for
+// that lookup instead of starting another one.
+///
+class HttpEngine {
+ public:
+  using Request =
+      boost::beast::http::request<boost::beast::http::string_body>;
+  using Response =
+      boost::beast::http::response<boost::beast::http::string_body>;
+  using ResponseHeader = boost::beast::http::response_header<>;
+
+  struct Options {
+    // The threads of the engine's own pool. The shared engine runs on the
+    // shared IoThreadPool instead.
+    size_t threadCount{2};
+    size_t maxIdleConnectionsPerHost{6};
+    std::chrono::seconds idleTimeout{30};
+    std::chrono::seconds dnsTimeToLive{60};
+  };
+
+  // A request body that is read in parts as it is sent, instead of being
+  // held in the request.
+  struct BodySource {
+    virtual ~BodySource() noexcept {}
+
+    // -1 when the size is not known up front. Such bodies are sent with
+    // chunked transfer encoding.
+    virtual int64_t Size() const noexcept = 0;
+
+    // Sets part to the next part of the body, which stays valid until the
+    // next call, or to an empty part at the end. Returns false on errors.
+    virtual bool Next(std::string_view &part) noexcept = 0;
+
+    // Starts over, to send the body again on another connection. Returns
+    // false if the body cannot be read again.
+    virtual bool Rewind() noexcept = 0;
+  };
+
+  // Called on an engine thread. At most one of OnResponse and OnError is
+  // called, and neither is called after the operation was aborted.
+  struct Handlers {
+    // Called as parts of a BodySource are sent.
+    std::function<void(int64_t sent, int64_t total)> OnDataSent;
+
+    std::function<void()> OnRequestSent;
+
+    // Called once the status line and headers have arrived. contentLength is
+    // -1 when the server did not say.
+    std::function<void(const ResponseHeader &, int64_t contentLength)>
+        OnHeader;
+
+    // When set, receives the body in parts of up to 64 KB as they arrive,
+    // and the body passed to OnResponse is empty. Returning false stops
+    // reading the body until the operation is resumed.
+    std::function<bool(std::string &&part)> OnData;
+
+    std::function<void(Response &&)> OnResponse;
+    std::function<void(const std::string &message, bool isTimeout)> OnError;
+  };
+
+  struct Operation {
+    virtual ~Operation() noexcept {}
+
+    // Stops the request, without calling its handlers.
+    virtual void Abort() noexcept = 0;
+
+    // Reads the rest of the body after OnData returned false.
+    virtual void Resume() noexcept = 0;
+  };
+
+  struct Counters {
+    uint64_t connectionsOpened{0};
+    uint64_t connectionsReused{0};
+    uint64_t dnsLookups{0};
+  };
+
+  // Runs on a pool of the engine's own.
+  explicit HttpEngine(Options options);
+
+  // Stops the threads of the engine's own pool, if it has one. Operations
+  // must not outlive the engine.
+  ~HttpEngine();
+
+  // The engine the HTTP resources share, which runs on the pool web sockets
+  // use. It lives until the process exits.
+  static std::shared_ptr<HttpEngine> Shared();
+
+  // A timeout of zero waits for the response for as long as it takes.
+  std::shared_ptr<Operation> Send(
+      std::string host,
+      std::string port,
+      Request &&request,
+      std::chrono::milliseconds timeout,
+      Handlers &&handlers);
+
+  // Sends the body from body, and ignores the body of request.
+  std::shared_ptr<Operation> Send(
+      std::string host,
+      std::string port,
+      Request &&request,
+      std::unique_ptr<BodySource> &&body,
+      std::chrono::milliseconds timeout,
+      Handlers &&handlers);
+
+  Counters GetCounters() const noexcept;
+
+ private:
+  class Exchange;
+
+  struct Connection {
+    explicit Connection(boost::asio::io_context &context) : socket{context} {}
+
+    boost::asio::ip::tcp::socket socket;
+    boost::beast::flat_buffer buffer;
+    std::chrono::steady_clock::time_point idleSince;
+  };
+
+  using Resolved = std::function<void(
+      boost::system::error_code,
+      boost::asio::ip::tcp::resolver::results_type)>;
+
+  struct HostEntry {
+    boost::asio::ip::tcp::resolver::results_type results;
+    std::chrono::steady_clock::time_point expires;
+    // Set while a lookup runs, with everyone waiting for it.
+    std::vector<Resolved> waiters;
+    bool resolving{false};
+  };
+
+  HttpEngine(Options options, std::shared_ptr<IoThreadPool> pool);
+
+  std::unique_ptr<Connection> TakeIdle(const std::string &key);
+  void Recycle(const std::string &key, std::unique_ptr<Connection> &&conn);
+  void ScheduleReap(std::chrono::steady_clock::time_point when);
+  void Reap();
+  void Resolve(const std::string &host, const std::string &port, Resolved &&);
+  void OnResolved(
+      const std::string &key,
+      boost::system::error_code ec,
+      boost::asio::ip::tcp::resolver::results_type results);
+
+  const Options m_options;
+  std::shared_ptr<IoThreadPool> m_pool;
+  boost::asio::io_context &m_context;
+
+  std::mutex m_mutex;
+  std::unordered_map<std::string, std::vector<std::unique_ptr<Connection>>>
+      m_idle;
+  std::unordered_map<std::string, HostEntry> m_hosts;
+
+  // Closes the idle connections that outlived the idle timeout, whichever
+  // host they are for. Set while a sweep is scheduled.
+  std::unique_ptr<boost::asio::steady_timer> m_reaper;
+  bool m_reaping{false};
+
+  std::atomic<uint64_t> m_connectionsOpened{0};
+  std::atomic<uint64_t> m_connectionsReused{0};
+  std::atomic<uint64_t> m_dnsLookups{0};
+};
+
+} // namespace Microsoft::React::Experimental
@@ -5,26 +5,349 @@
 
 #include "HttpResource.h"
 
+#include <Base64.h>
 #include <Utils.h>
-#include <boost/beast/core/buffers_to_string.hpp>
 #include <boost/beast/version.hpp>
 
-using namespace boost::asio::ip;
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
 using namespace boost::beast::http;
 
+using facebook::react::MessageQueueThread;
 using folly::dynamic;
 using std::make_unique;
+using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
 
-using boostecr = boost::system::error_code const &;
+namespace fs = std::filesystem;
 
 namespace Microsoft::React {
 namespace Experimental {
+
+namespace {
+
+// Text that arrived but was not delivered yet stays below this size. Reading
+// the body waits for the callback queue to catch up.
+constexpr size_t MaxPendingText = 256 * 1024;
+
+// Returns the length of the longest prefix of text that does not end inside
+// a UTF-8 sequence.
+size_t CompleteUtf8Length(const string &text) noexcept {
+  size_t end = text.size();
+  for (size_t trail = 0; end > 0 && trail < 4; --end, ++trail) {
+    const auto c = static_cast<unsigned char>(text[end - 1]);
+    if ((c & 0xC0) == 0x80)
+      continue;
+
+    size_t length = 1;
+    if ((c & 0xE0) == 0xC0)
+      length = 2;
+    else if ((c & 0xF0) == 0xE0)
+      length = 3;
+    else if ((c & 0xF8) == 0xF0)
+      length = 4;
+
+    return trail + 1 >= length ? text.size() : end - 1;
+  }
+
+  return text.size();
+}
+
+// Request bodies go out in parts of this size.
+constexpr size_t BodyPartSize = 64 * 1024;
+
+// Hands out slices of a body held in memory, without copying it.
+class StringSource : public HttpEngine::BodySource {
+  const string m_body;
+  size_t m_offset{0};
+
+ public:
+  explicit StringSource(string &&body) noexcept : m_body{std::move(body)} {}
+
+  int64_t Size() const noexcept override {
+    return static_cast<int64_t>(m_body.size());
+  }
+
+  bool Next(std::string_view &part) noexcept override {
+    part = std::string_view{m_body}.substr(m_offset, BodyPartSize);
+    m_offset += part.size();
+    return true;
+  }
+
+  bool Rewind() noexcept override {
+    m_offset = 0;
+    return true;
+  }
+};
+
+// Reads a body from a file as it is sent, so that it is never held in memory
+// whole. The request announces the size the file had when it was opened, so
+// exactly that many bytes are sent even if the file changes meanwhile.
+class FileSource : public HttpEngine::BodySource {
+  std::ifstream m_file;
+  int64_t m_size{-1};
+  int64_t m_remaining{-1};
+  std::unique_ptr<char[]> m_buffer;
+
+ public:
+  explicit FileSource(const fs::path &path)
+      : m_file{path, std::ios::binary},
+        m_buffer{std::make_unique<char[]>(BodyPartSize)} {
+    std::error_code ec;
+    auto size = fs::file_size(path, ec);
+    if (!ec)
+      m_size = static_cast<int64_t>(size);
+    m_remaining = m_size;
+  }
+
+  bool IsOpen() const noexcept {
+    return m_file.is_open();
+  }
+
+  int64_t Size() const noexcept override {
+    return m_size;
+  }
+
+  bool Next(std::string_view &part) noexcept override {
+    auto count = static_cast<std::streamsize>(BodyPartSize);
+    if (m_remaining >= 0)
+      count = std::min(count, static_cast<std::streamsize>(m_remaining));
+
+    m_file.read(m_buffer.get(), count);
+    if (m_file.bad())
+      return false;
+
+    // A file that shrank since it was opened cannot fill the announced size.
+    auto read = m_file.gcount();
+    if (m_remaining >= 0) {
+      if (read < count)
+        return false;
+      m_remaining -= read;
+    }
+
+    part = {m_buffer.get(), static_cast<size_t>(read)};
+    return true;
+  }
+
+  bool Rewind() noexcept override {
+    m_file.clear();
+    m_file.seekg(0);
+    m_remaining = m_size;
+    return static_cast<bool>(m_file);
+  }
+};
+
+// Replaces the %XX escapes in a URI with the bytes they stand for. Anything
+// else, including a % that does not start an escape, is kept as it is.
+string PercentDecode(std::string_view text) {
+  auto hexValue = [](char c) -> int {
+    if (c >= '0' && c <= '9')
+      return c - '0';
+    if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+    return -1;
+  };
+
+  string decoded;
+  decoded.reserve(text.size());
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '%' && i + 2 < text.size() &&
+        hexValue(text[i + 1]) >= 0 && hexValue(text[i + 2]) >= 0) {
+      decoded += static_cast<char>(
+          hexValue(text[i + 1]) * 16 + hexValue(text[i + 2]));
+      i += 2;
+    } else {
+      decoded += text[i];
+    }
+  }
+
+  return decoded;
+}
+
+// Request bodies from files come as file:// URIs, whose paths are
+// percent-encoded UTF-8, or as plain paths.
+fs::path PathFromUri(const string &uri) {
+  constexpr std::string_view scheme = "file://";
+  std::string_view path{uri};
+  if (path.substr(0, scheme.size()) != scheme)
+    return fs::u8path(path.begin(), path.end());
+
+  path.remove_prefix(scheme.size());
+
+  // file:///C:/dir/file names a path that starts at the drive letter.
+  if (path.size() > 2 && path[0] == '/' && path[2] == ':')
+    path.remove_prefix(1);
+
+  return fs::u8path(PercentDecode(path));
+}
+
+} // namespace
+
+#pragma region HttpResource::Transfer
+
+void HttpResource::Transfer::Post(std::function<void()> &&func) {
+  if (callbackQueue)
+    callbackQueue->runOnQueue(std::move(func));
+  else
+    func();
+}
+
+// Runs on an engine thread. Returns false to stop reading the body until the
+// pending text was delivered.
+bool HttpResource::Transfer::OnData(string &&part) {
+  if (mode == Mode::File) {
+    file.write(part.data(), part.size());
+    if (!file) {
+      Fail("Could not write to " + filePath);
+      return false;
+    }
+  } else if (mode == Mode::Progress) {
+    body += part;
+  }
+
+  bool more = true;
+  bool queue = false;
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    loaded += part.size();
+    if (mode == Mode::Text) {
+      pending += part;
+      more = pending.size() < MaxPendingText;
+      paused = !more;
+    }
+
+    queue = !deliveryQueued;
+    deliveryQueued = true;
+  }
+
+  if (queue)
+    Post([self = shared_from_this()]() { self->Deliver(false); });
+
+  return more;
+}
+
+// Runs on the callback queue. Text that ends inside a UTF-8 sequence waits
+// for the rest of it, unless this is the last delivery.
+void HttpResource::Transfer::Deliver(bool last) {
+  string text;
+  int64_t loadedNow;
+  int64_t totalNow;
+  shared_ptr<HttpEngine::Operation> resume;
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    deliveryQueued = false;
+    const auto length = last ? pending.size() : CompleteUtf8Length(pending);
+    text = pending.substr(0, length);
+    pending.erase(0, length);
+    loadedNow = loaded;
+    totalNow = total;
+
+    // Until SendRequest knows the operation, it resumes it itself.
+    if (paused && operation) {
+      paused = false;
+      resume = operation;
+    }
+  }
+
+  if (!cancelled) {
+    if (mode == Mode::Text) {
+      if (!text.empty() && handlers.incrementalData)
+        handlers.incrementalData(text, loadedNow, totalNow);
+    } else if (handlers.dataProgress) {
+      handlers.dataProgress(loadedNow, totalNow);
+    }
+  }
+
+  if (resume)
+    resume->Resume();
+}
+
+// Runs on an engine thread. At most one progress event is queued at a time.
+void HttpResource::Transfer::OnDataSent(int64_t sentNow, int64_t totalNow) {
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    sent = sentNow;
+    sentTotal = totalNow;
+    if (sendProgressQueued)
+      return;
+
+    sendProgressQueued = true;
+  }
+
+  Post([self = shared_from_this()]() {
+    int64_t sent;
+    int64_t total;
+    {
+      std::lock_guard<std::mutex> lock{self->mutex};
+      self->sendProgressQueued = false;
+      sent = self->sent;
+      total = self->sentTotal;
+    }
+
+    if (!self->cancelled && self->handlers.dataSent)
+      self->handlers.dataSent(sent, total);
+  });
+}
+
+// Runs on an engine thread.
+void HttpResource::Transfer::Fail(const string &message) {
+  failed = true;
+  if (mode == Mode::File) {
+    file.close();
+    std::error_code ignored;
+    fs::remove(fs::u8path(filePath), ignored);
+  }
+
+  // Until SendRequest knows the operation, it aborts it itself.
+  shared_ptr<HttpEngine::Operation> op;
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    op = operation;
+    if (!op)
+      abortRequested = true;
+  }
+  if (op)
+    op->Abort();
+
+  Post([self = shared_from_this(), message]() {
+    if (!self->cancelled && self->handlers.error)
+      self->handlers.error(message);
+  });
+}
+
+#pragma endregion HttpResource::Transfer
+
 #pragma region HttpResource members
 
-HttpResource::HttpResource() noexcept
-    : m_resolver{m_context}, m_socket{m_context} {}
+HttpResource::HttpResource(
+    shared_ptr<HttpEngine> engine,
+    shared_ptr<MessageQueueThread> callbackQueue) noexcept
+    : m_engine{std::move(engine)}, m_callbackQueue{std::move(callbackQueue)} {}
+
+HttpResource::~HttpResource() noexcept {
+  Cancel();
+}
+
+void HttpResource::Cancel() noexcept {
+  if (!m_transfer)
+    return;
+
+  m_transfer->cancelled = true;
+  shared_ptr<HttpEngine::Operation> op;
+  {
+    std::lock_guard<std::mutex> lock{m_transfer->mutex};
+    op = std::move(m_transfer->operation);
+  }
+  if (op)
+    op->Abort();
+
+  m_transfer = nullptr;
+}
 
 void HttpResource::SendRequest(
     const string &method,
@@ -35,25 +358,83 @@ void HttpResource::SendRequest(
     bool useIncrementalUpdates,
     int64_t timeout,
     std::function<void(int64_t)> &&callback) noexcept {
-  // Enforce supported args
-  assert(responseType == "text" || responseType == "base64");
-  assert(!useIncrementalUpdates);
-
-  // ISS:2306365 - Callback with the requestId
+  Cancel();
 
   // Validate verb.
   unique_ptr<Url> url;
   try {
     url = make_unique<Url>(urlString);
   } catch (...) {
-    m_errorHandler("Malformed URL");
+    if (m_handlers.error)
+      m_handlers.error("Malformed URL");
+    return;
+  }
+
+  // ISS:2306365 - Support HTTPS.
+  if (url->scheme != "http") {
+    if (m_handlers.error)
+      m_handlers.error("Unsupported URL scheme: " + url->scheme);
     return;
   }
-  request<string_body> req;
+
+  unique_ptr<HttpEngine::BodySource> body;
+  if (!bodyData.empty()) {
+    if (!bodyData["string"].empty()) {
+      body = make_unique<StringSource>(
+          std::move(bodyData["string"].getString()));
+    } else if (!bodyData["base64"].empty()) {
+      string decoded;
+      if (!DecodeBase64(bodyData["base64"].getString(), decoded)) {
+        if (m_handlers.error)
+          m_handlers.error("Invalid base64 request body");
+        return;
+      }
+      body = make_unique<StringSource>(std::move(decoded));
+    } else if (!bodyData["uri"].empty()) {
+      auto file = make_unique<FileSource>(
+          PathFromUri(bodyData["uri"].getString()));
+      if (!file->IsOpen()) {
+        if (m_handlers.error)
+          m_handlers.error("Could not open " + bodyData["uri"].getString());
+        return;
+      }
+      body = std::move(file);
+    } else {
+      // Empty request
+    }
+  }
+
+  auto transfer = std::make_shared<Transfer>();
+  transfer->handlers = m_handlers;
+  transfer->callbackQueue = m_callbackQueue;
+  transfer->base64 = responseType == "base64";
+  if (responseType == "file") {
+    transfer->mode = Transfer::Mode::File;
+    transfer->filePath = m_responseFile;
+    transfer->file.open(
+        fs::u8path(m_responseFile), std::ios::binary | std::ios::trunc);
+    if (!transfer->file) {
+      if (m_handlers.error)
+        m_handlers.error("Could not open " + m_responseFile);
+      return;
+    }
+  } else if (useIncrementalUpdates) {
+    transfer->mode = responseType == "text" ? Transfer::Mode::Text
+                                            : Transfer::Mode::Progress;
+  }
+  if (!useIncrementalUpdates)
+    transfer->handlers.dataProgress = nullptr;
+
+  HttpEngine::Request req;
   req.version(11 /*HTTP 1.1*/);
   req.method(string_to_verb(method));
   req.target(url->Target());
-  req.set(field::host, url->host); // ISS:2306365 - Determine/append port.
+  if (url->port.empty()) {
+    req.set(field::host, url->host);
+    url->port = "80";
+  } else {
+    req.set(field::host, url->host + ':' + url->port);
+  }
   req.set(field::user_agent, BOOST_BEAST_VERSION_STRING);
 
   for (const auto &header : headers) {
@@ -61,115 +442,173 @@ void HttpResource::SendRequest(
     req.set(header.first, header.second);
   }
 
-  if (!bodyData.empty()) {
-    if (!bodyData["string"].empty()) {
-    } else if (!bodyData["base64"].empty()) {
-    } else if (!bodyData["uri"].empty()) {
-      assert(false); // Not implemented.
-    } else {
-      // Empty request
+  // The engine sets the length of bodies it sends.
+  if (!body)
+    req.prepare_payload();
+
+  HttpEngine::Handlers handlers;
+  handlers.OnDataSent = [transfer](int64_t sent, int64_t total) {
+    transfer->OnDataSent(sent, total);
+  };
+  handlers.OnRequestSent = [transfer]() {
+    transfer->Post([transfer]() {
+      if (!transfer->cancelled && transfer->handlers.request)
+        transfer->handlers.request();
+    });
+  };
+  handlers.OnHeader = [transfer](
+                          const HttpEngine::ResponseHeader &header,
+                          int64_t contentLength) {
+    {
+      std::lock_guard<std::mutex> lock{transfer->mutex};
+      transfer->total = contentLength;
+    }
+
+    Headers responseHeaders;
+    for (const auto &field : header) {
+      auto &value = responseHeaders[string{field.name_string().data(),
+                                           field.name_string().size()}];
+      if (!value.empty())
+        value += ", ";
+      value.append(field.value().data(), field.value().size());
     }
+
+    transfer->Post([transfer,
+                    statusCode = static_cast<int64_t>(header.result_int()),
+                    responseHeaders = std::move(responseHeaders)]() {
+      if (!transfer->cancelled && transfer->handlers.responseReceived)
+        transfer->handlers.responseReceived(statusCode, responseHeaders);
+    });
+  };
+  if (transfer->mode != Transfer::Mode::Whole) {
+    handlers.OnData = [transfer](string &&part) {
+      return transfer->OnData(std::move(part));
+    };
   }
+  handlers.OnResponse = [transfer](HttpEngine::Response &&response) {
+    if (transfer->failed)
+      return;
+
+    string body;
+    switch (transfer->mode) {
+      case Transfer::Mode::Whole:
+        body = std::move(response.body());
+        break;
+      case Transfer::Mode::Progress:
+        body = std::move(transfer->body);
+        break;
+      case Transfer::Mode::File:
+        transfer->file.close();
+        if (!transfer->file)
+          return transfer->Fail("Could not write to " + transfer->filePath);
+        body = transfer->filePath;
+        break;
+      case Transfer::Mode::Text:
+        break;
+    }
+
+    // Off the callback queue, which runs JavaScript.
+    if (transfer->base64)
+      body = EncodeBase64(body);
+
+    transfer->Post([transfer, body = std::move(body)]() {
+      if (transfer->mode != Transfer::Mode::Whole)
+        transfer->Deliver(true /*last*/);
+
+      if (!transfer->cancelled && transfer->handlers.response)
+        transfer->handlers.response(body);
+    });
+  };
+  handlers.OnError = [transfer](const string &message, bool) {
+    if (transfer->failed)
+      return;
+
+    if (transfer->mode == Transfer::Mode::File) {
+      transfer->file.close();
+      std::error_code ignored;
+      fs::remove(fs::u8path(transfer->filePath), ignored);
+    }
 
-  m_context.restart();
-
-  // Send/Receive request.
-  m_resolver.async_resolve(
-      url->host,
-      url->port,
-      [this, &req](boostecr ec, tcp::resolver::results_type results) {
-        if (ec) {
-          if (m_errorHandler)
-            m_errorHandler(ec.message());
-        } else {
-          boost::asio::async_connect(
-              m_socket,
-              results.begin(),
-              results.end(),
-              [this, &req](boostecr ec, const basic_resolver_iterator<tcp> &) {
-                if (ec) {
-                  if (m_errorHandler)
-                    m_errorHandler(ec.message());
-                } else {
-                  async_write(
-                      m_socket, move(req), [this](boostecr ec, size_t size) {
-                        if (ec) {
-                          if (m_errorHandler)
-                            m_errorHandler(ec.message());
-                        } else {
-                          if (m_requestHandler)
-                            m_requestHandler();
-
-                          async_read(
-                              m_socket,
-                              m_buffer,
-                              m_response,
-                              [this](boostecr ec, size_t size) {
-                                if (ec) {
-                                  if (m_errorHandler)
-                                    m_errorHandler(ec.message());
-                                } else {
-                                  if (m_responseHandler)
-                                    m_responseHandler(
-                                        boost::beast::buffers_to_string(
-                                            m_buffer.data()));
-
-                                  boost::system::error_code bec;
-                                  m_socket.shutdown(
-                                      tcp::socket::shutdown_both, bec);
-                                  if (bec &&
-                                      boost::system::errc::not_connected !=
-                                          bec) // not_connected may happen. Not
-                                  // an actual error.
-                                  {
-                                    if (m_errorHandler)
-                                      m_errorHandler(bec.message());
-
-                                    // ISS:2306365 - Callback?
-                                  }
-                                }
-                              }); // async_read
-                        }
-                      }); // async_write
-                }
-              }); // async_connect
-        }
-      }); // async_resolve
-
-  m_context.run();
+    // ISS:2306365 - Deal with timeout conditions.
+    transfer->Post([transfer, message]() {
+      if (!transfer->cancelled && transfer->handlers.error)
+        transfer->handlers.error(message);
+    });
+  };
+
+  m_transfer = transfer;
+  auto op = m_engine->Send(
+      std::move(url->host),
+      std::move(url->port),
+      std::move(req),
+      std::move(body),
+      std::chrono::milliseconds{timeout},
+      std::move(handlers));
+
+  bool abort = false;
+  bool resume = false;
+  {
+    std::lock_guard<std::mutex> lock{transfer->mutex};
+    transfer->operation = op;
+    abort = transfer->abortRequested;
+    resume = !abort && transfer->paused && !transfer->deliveryQueued;
+    if (resume)
+      transfer->paused = false;
+  }
+  if (abort)
+    op->Abort();
+  else if (resume)
+    op->Resume();
 }
 
 void HttpResource::AbortRequest() noexcept {
-  m_context.stop();
-
-  if (m_socket.is_open()) {
-    boost::system::error_code bec;
-    m_socket.shutdown(tcp::socket::shutdown_both, bec);
-    if (bec && boost::system::errc::not_connected != bec) {
-      if (m_errorHandler)
-        m_errorHandler(bec.message());
-    }
-  }
+  Cancel();
 }
 
 void HttpResource::ClearCookies() noexcept {
   assert(false); // Not yet implemented.
 }
 
+void HttpResource::SetResponseFile(string &&path) noexcept {
+  m_responseFile = std::move(path);
+}
+
 #pragma region Handler setters
 
 void HttpResource::SetOnRequest(std::function<void()> &&handler) noexcept {
-  m_requestHandler = move(handler);
+  m_handlers.request = move(handler);
+}
+
+void HttpResource::SetOnDataSent(
+    std::function<void(int64_t sent, int64_t total)> &&handler) noexcept {
+  m_handlers.dataSent = move(handler);
+}
+
+void HttpResource::SetOnResponseReceived(
+    std::function<void(int64_t statusCode, const Headers &headers)>
+        &&handler) noexcept {
+  m_handlers.responseReceived = move(handler);
+}
+
+void HttpResource::SetOnIncrementalData(
+    std::function<void(const string &data, int64_t loaded, int64_t total)>
+        &&handler) noexcept {
+  m_handlers.incrementalData = move(handler);
+}
+
+void HttpResource::SetOnDataProgress(
+    std::function<void(int64_t loaded, int64_t total)> &&handler) noexcept {
+  m_handlers.dataProgress = move(handler);
 }
 
 void HttpResource::SetOnResponse(
     std::function<void(const std::string &)> &&handler) noexcept {
-  m_responseHandler = move(handler);
+  m_handlers.response = move(handler);
 }
 
 void HttpResource::SetOnError(
     std::function<void(const std::string &)> &&handler) noexcept {
-  m_errorHandler = move(handler);
+  m_handlers.error = move(handler);
 }
 
 #pragma endregion Handler setters
@@ -181,7 +620,13 @@ void HttpResource::SetOnError(
 #pragma region IHttpResource static members
 
 /*static*/ unique_ptr<IHttpResource> IHttpResource::Make() noexcept {
-  return unique_ptr<IHttpResource>(new Experimental::HttpResource());
+  return Make(nullptr);
+}
+
+/*static*/ unique_ptr<IHttpResource> IHttpResource::Make(
+    shared_ptr<MessageQueueThread> callbackQueue) noexcept {
+  return unique_ptr<IHttpResource>(new Experimental::HttpResource(
+      Experimental::HttpEngine::Shared(), std::move(callbackQueue)));
 }
 
 #pragma endregion IHttpResource static members
@@ -4,30 +4,83 @@
 #pragma once
 
 #include <IHttpResource.h>
+#include "HttpEngine.h"
 
-#include <boost/asio/connect.hpp>
-#include <boost/asio/ip/tcp.hpp>
-#include <boost/beast/core/flat_buffer.hpp>
-#include <boost/beast/http.hpp>
+#include <fstream>
 
 namespace Microsoft::React::Experimental {
 
 class HttpResource : public IHttpResource {
-  boost::asio::io_context m_context;
-  boost::asio::ip::tcp::resolver m_resolver;
-  boost::asio::ip::tcp::socket m_socket;
+  struct Handlers {
+    std::function<void(int64_t, int64_t)> dataSent;
+    std::function<void()> request;
+    std::function<void(int64_t, const Headers &)> responseReceived;
+    std::function<void(const std::string &, int64_t, int64_t)>
+        incrementalData;
+    std::function<void(int64_t, int64_t)> dataProgress;
+    std::function<void(const std::string &)> response;
+    std::function<void(const std::string &)> error;
+  };
 
-  // TODO: Remove?
-  boost::beast::flat_buffer m_buffer;
-  boost::beast::http::request<boost::beast::http::empty_body> m_request;
-  boost::beast::http::response<boost::beast::http::string_body> m_response;
+  // The state of one request, shared with the engine's handlers. It outlives
+  // the resource, so that a response that arrives as the resource goes away
+  // finds the request cancelled instead of freed.
+  struct Transfer : std::enable_shared_from_this<Transfer> {
+    enum class Mode {
+      Whole, // The body is delivered once it is complete.
+      Text, // Text is delivered as it arrives.
+      Progress, // The body is delivered once it is complete, with progress.
+      File, // The body is written to a file, with progress.
+    };
 
-  std::function<void()> m_requestHandler;
-  std::function<void(const std::string &)> m_responseHandler;
-  std::function<void(const std::string &)> m_errorHandler;
+    Mode mode{Mode::Whole};
+    bool base64{false};
+    Handlers handlers;
+    std::shared_ptr<facebook::react::MessageQueueThread> callbackQueue;
+    std::atomic_bool cancelled{false};
+
+    // Only the engine's handlers use these, one at a time.
+    std::string body;
+    std::ofstream file;
+    std::string filePath;
+    bool failed{false};
+
+    // Parts of the body and progress that arrived, but were not delivered
+    // yet. At most one delivery is queued at a time.
+    std::mutex mutex;
+    std::string pending;
+    int64_t loaded{0};
+    int64_t total{-1};
+    bool deliveryQueued{false};
+    bool paused{false};
+    std::shared_ptr<HttpEngine::Operation> operation;
+    bool abortRequested{false}; // By Fail, before operation was known.
+    int64_t sent{0};
+    int64_t sentTotal{-1};
+    bool sendProgressQueued{false};
+
+    void Post(std::function<void()> &&func);
+    bool OnData(std::string &&part);
+    void OnDataSent(int64_t sentNow, int64_t totalNow);
+    void Deliver(bool last);
+    void Fail(const std::string &message);
+  };
+
+  std::shared_ptr<HttpEngine> m_engine;
+  std::shared_ptr<facebook::react::MessageQueueThread> m_callbackQueue;
+  Handlers m_handlers;
+  std::string m_responseFile;
+  std::shared_ptr<Transfer> m_transfer;
+
+  void Cancel() noexcept;
 
  public:
-  HttpResource() noexcept;
+  HttpResource(
+      std::shared_ptr<HttpEngine> engine,
+      std::shared_ptr<facebook::react::MessageQueueThread>
+          callbackQueue) noexcept;
+
+  ~HttpResource() noexcept override;
 
 #pragma region IHttpResource members
 
@@ -43,7 +96,20 @@ class HttpResource : public IHttpResource {
   void AbortRequest() noexcept override;
   void ClearCookies() noexcept override;
 
+  void SetResponseFile(std::string &&path) noexcept override;
+
+  void SetOnDataSent(std::function<void(int64_t sent, int64_t total)>
+                        &&handler) noexcept override;
   void SetOnRequest(std::function<void()> &&handler) noexcept override;
+  void SetOnResponseReceived(
+      std::function<void(int64_t statusCode, const Headers &headers)>
+          &&handler) noexcept override;
+  void SetOnIncrementalData(
+      std::function<
+          void(const std::string &data, int64_t loaded, int64_t total)>
+          &&handler) noexcept override;
+  void SetOnDataProgress(std::function<void(int64_t loaded, int64_t total)>
+                             &&handler) noexcept override;
   void SetOnResponse(
       std::function<void(const std::string &)> &&handler) noexcept override;
   void SetOnError(
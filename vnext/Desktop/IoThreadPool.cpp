@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "IoThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+using std::shared_ptr;
+
+namespace Microsoft::React {
+
+namespace {
+
+std::atomic<size_t> s_sharedThreadCount{2};
+
+} // namespace
+
+IoThreadPool::IoThreadPool(size_t threadCount)
+    : m_context{static_cast<int>(threadCount)},
+      m_work{boost::asio::make_work_guard(m_context)} {
+  for (size_t i = 0; i < threadCount; ++i) {
+    m_threads.emplace_back([this]() { m_context.run(); });
+  }
+}
+
+IoThreadPool::~IoThreadPool() {
+  m_work.reset();
+  m_context.stop();
+
+  for (auto &thread : m_threads) {
+    if (thread.get_id() == std::this_thread::get_id())
+      thread.detach();
+    else
+      thread.join();
+  }
+}
+
+/*static*/ shared_ptr<IoThreadPool> IoThreadPool::Shared() {
+  // Never destroyed. Joining the pool's threads while the process exits or
+  // the DLL unloads could deadlock.
+  static auto pool = new shared_ptr<IoThreadPool>(
+      std::make_shared<IoThreadPool>(s_sharedThreadCount.load()));
+  return *pool;
+}
+
+/*static*/ void IoThreadPool::SetSharedThreadCount(
+    size_t threadCount) noexcept {
+  s_sharedThreadCount = (std::max)(threadCount, size_t{1});
+}
+
+boost::asio::io_context &IoThreadPool::Context() noexcept {
+  return m_context;
+}
+
+} // namespace Microsoft::React
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Microsoft::React {
+
+///
+// A few threads that run one io_context, for I/O objects that would
+// otherwise each need a thread of their own. Objects that must not run
+// their handlers concurrently use a strand on the context.
+///
+class IoThreadPool {
+  boost::asio::io_context m_context;
+  boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+      m_work;
+  std::vector<std::thread> m_threads;
+
+ public:
+  explicit IoThreadPool(size_t threadCount);
+
+  // Stops the pool's threads. Objects that use the context must not outlive
+  // the pool.
+  ~IoThreadPool();
+
+  ///
+  // The pool that web sockets and the shared HttpEngine run on. It starts
+  // with the number of threads set with SetSharedThreadCount, if that was
+  // called before, or two otherwise. It lives until the process exits.
+  ///
+  static std::shared_ptr<IoThreadPool> Shared();
+
+  // Has no effect once the shared pool was started.
+  static void SetSharedThreadCount(size_t threadCount) noexcept;
+
+  boost::asio::io_context &Context() noexcept;
+};
+
+} // namespace Microsoft::React
@@ -8,9 +8,13 @@
 #include <cxxreact/Instance.h>
 #include <cxxreact/JsArgumentHelpers.h>
 
+#include <cassert>
+
+using facebook::react::MessageQueueThread;
 using folly::dynamic;
 using std::map;
 using std::move;
+using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
 using std::vector;
@@ -21,32 +25,130 @@ namespace Microsoft::React {
 
 const char *NetworkingModule::name = "Networking";
 
-int64_t NetworkingModule::s_lastRequestId = 0;
+std::atomic<int64_t> NetworkingModule::s_lastRequestId = 0;
 
 #pragma endregion
 
-NetworkingModule::NetworkingModule() {}
-
-IHttpResource *NetworkingModule::GetResource(int64_t requestId) noexcept {
-  IHttpResource *ptr = nullptr;
-  if (m_resources.find(requestId) == std::end(m_resources)) {
-    auto rc = IHttpResource::Make();
-    rc->SetOnError([this, requestId](const string &message) {
-      // ISS:2306365 - Deal with timeout conditions.
-      OnRequestError(requestId, move(message), false /*isTimeOut*/);
-    });
-    rc->SetOnRequest([this, requestId]() { OnRequestSuccess(requestId); });
-    rc->SetOnResponse([this, requestId](const string &message) {
-      OnDataReceived(requestId, message);
-    });
-
-    ptr = rc.get();
-    m_resources.emplace(requestId, move(rc));
-  } else {
-    ptr = m_resources.at(requestId).get();
+NetworkingModule::NetworkingModule(
+    shared_ptr<MessageQueueThread> nativeQueue,
+    std::filesystem::path downloadDirectory)
+    : m_nativeQueue{move(nativeQueue)},
+      m_downloadDirectory{move(downloadDirectory)} {
+  assert(m_nativeQueue);
+
+  if (m_downloadDirectory.empty()) {
+    std::error_code ec;
+    auto temp = std::filesystem::temp_directory_path(ec);
+    if (!ec)
+      m_downloadDirectory = temp / "ReactNativeDownloads";
+  }
+}
+
+NetworkingModule::~NetworkingModule() {
+  // Waits for a handler that runs on the native queue.
+  std::lock_guard<std::mutex> lock{m_lifetime->mutex};
+  m_lifetime->alive = false;
+}
+
+/*static*/ std::filesystem::path NetworkingModule::ResolveResponseFile(
+    const std::filesystem::path &directory,
+    const string &name) noexcept {
+  if (directory.empty())
+    return {};
+
+  // Rejects roots, drives, separators, and the . and .. entries, so that the
+  // file cannot end up outside directory.
+  std::filesystem::path file;
+  try {
+    file = std::filesystem::u8path(name);
+  } catch (const std::exception &) {
+    return {};
   }
+  if (file.empty() || file != file.filename() || file == "." || file == "..")
+    return {};
 
-  return ptr;
+  return directory / file;
+}
+
+// Wraps a handler of a resource, so that it does nothing once the module is
+// gone.
+template <typename Handler>
+auto NetworkingModule::Bind(Handler &&handler) noexcept {
+  return [lifetime = m_lifetime, handler = std::forward<Handler>(handler)](
+             auto &&... args) {
+    std::lock_guard<std::mutex> lock{lifetime->mutex};
+    if (lifetime->alive)
+      handler(std::forward<decltype(args)>(args)...);
+  };
+}
+
+shared_ptr<IHttpResource> NetworkingModule::CreateResource(
+    int64_t requestId,
+    const string &url,
+    bool useIncrementalUpdates) noexcept {
+  shared_ptr<IHttpResource> rc = IHttpResource::Make(m_nativeQueue);
+  rc->SetOnError(Bind([this, requestId](const string &message) {
+    // ISS:2306365 - Deal with timeout conditions.
+    OnRequestError(requestId, move(message), false /*isTimeOut*/);
+    ReleaseResource(requestId);
+  }));
+  rc->SetOnDataSent(Bind([this, requestId](int64_t sent, int64_t total) {
+    SendEvent("didSendNetworkData", dynamic::array(requestId, sent, total));
+  }));
+  rc->SetOnResponseReceived(Bind(
+      [this, requestId, url](
+          int64_t statusCode, const IHttpResource::Headers &headers) {
+        dynamic headersObject = dynamic::object();
+        for (const auto &header : headers) {
+          headersObject[header.first] = header.second;
+        }
+        OnResponseReceived(requestId, statusCode, headersObject, url);
+      }));
+  rc->SetOnIncrementalData(Bind(
+      [this, requestId](const string &data, int64_t loaded, int64_t total) {
+        SendEvent(
+            "didReceiveNetworkIncrementalData",
+            dynamic::array(requestId, data, loaded, total));
+      }));
+  rc->SetOnDataProgress(Bind([this, requestId](int64_t loaded, int64_t total) {
+    SendEvent(
+        "didReceiveNetworkDataProgress",
+        dynamic::array(requestId, loaded, total));
+  }));
+  rc->SetOnResponse(
+      Bind([this, requestId, useIncrementalUpdates](const string &data) {
+        // Incremental text was already sent as it arrived.
+        if (!useIncrementalUpdates || !data.empty())
+          OnDataReceived(requestId, data);
+        OnRequestSuccess(requestId);
+        ReleaseResource(requestId);
+      }));
+
+  std::lock_guard<std::mutex> lock{m_resourcesMutex};
+  m_resources.emplace(requestId, rc);
+  return rc;
+}
+
+shared_ptr<IHttpResource> NetworkingModule::GetResource(
+    int64_t requestId) noexcept {
+  std::lock_guard<std::mutex> lock{m_resourcesMutex};
+  auto rc = m_resources.find(requestId);
+  return rc == m_resources.end() ? nullptr : rc->second;
+}
+
+// The resource may be calling the handler this runs from. The handler stays
+// alive until it returns.
+void NetworkingModule::ReleaseResource(int64_t requestId) noexcept {
+  shared_ptr<IHttpResource> rc;
+  {
+    std::lock_guard<std::mutex> lock{m_resourcesMutex};
+    auto found = m_resources.find(requestId);
+    if (found == m_resources.end())
+      return;
+
+    rc = move(found->second);
+    m_resources.erase(found);
+  }
 }
 
 void NetworkingModule::OnDataReceived(
@@ -113,28 +215,67 @@ NetworkingModule::getMethods() {
                   }
                 }
 
-                int64_t requestId = 0; // ISS:2306365 - Manage requestIds.
-                GetResource(requestId)->SendRequest(
+                int64_t requestId = ++s_lastRequestId;
+                cb({requestId});
+
+                auto url = params["url"].asString();
+                auto incremental = params["incrementalUpdates"].asBool();
+                auto responseType = params["responseType"].asString();
+
+                // Response type "file" writes the body to responseFilePath,
+                // in the download directory.
+                std::filesystem::path responseFile;
+                if (responseType == "file") {
+                  auto name = params["responseFilePath"];
+                  if (name.isString())
+                    responseFile = ResolveResponseFile(
+                        m_downloadDirectory, name.getString());
+                  if (responseFile.empty()) {
+                    OnRequestError(
+                        requestId,
+                        "responseFilePath must be a file name",
+                        false /*isTimeOut*/);
+                    return;
+                  }
+
+                  std::error_code ec;
+                  std::filesystem::create_directories(m_downloadDirectory, ec);
+                  if (ec) {
+                    OnRequestError(
+                        requestId,
+                        "Could not create " + m_downloadDirectory.u8string(),
+                        false /*isTimeOut*/);
+                    return;
+                  }
+                }
+
+                // The resource may finish, and be released, before
+                // SendRequest returns.
+                auto resource = CreateResource(requestId, url, incremental);
+                if (!responseFile.empty())
+                  resource->SetResponseFile(responseFile.u8string());
+
+                resource->SendRequest(
                     params["method"].asString(),
-                    params["url"].asString(),
+                    url,
                     headers,
-                    params["data"],
-                    params["responseType"].asString(),
-                    params["incrementalUpdates"].asBool(),
+                    std::move(params["data"]),
+                    responseType,
+                    incremental,
                     params["timeout"].asInt(),
-                    [](int64_t) {} // ISS:2306365 - Convert from 'cb' parameter.
-                );
-                // ISS:2306365 - Callback?
+                    [](int64_t) {});
               }),
           Method(
               "abortRequest",
               [this](dynamic args) noexcept {
                 int64_t requestId = facebook::xplat::jsArgAsInt(args, 0);
-                GetResource(requestId)->AbortRequest();
+                if (auto resource = GetResource(requestId)) {
+                  resource->AbortRequest();
+                  ReleaseResource(requestId);
+                }
               }),
-          Method("clearCookies", [this](dynamic args) noexcept {
-            int64_t requestId = facebook::xplat::jsArgAsInt(args, 0);
-            GetResource(requestId)->ClearCookies();
+          Method("clearCookies", [](dynamic args) noexcept {
+            IHttpResource::Make()->ClearCookies();
           })};
 }
 
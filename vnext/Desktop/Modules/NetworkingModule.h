@@ -5,15 +5,48 @@
 
 #include <IHttpResource.h>
 #include <cxxreact/CxxModule.h>
+#include <cxxreact/MessageQueueThread.h>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
 
 namespace Microsoft::React {
 // NetworkingModule
 // provides the 'Networking' native module backing RCTNetworking.js
+//
+// Beyond RCTNetworking.js, sendRequest accepts responseType "file" with a
+// responseFilePath parameter. The body is then written to a file of that name
+// in the download directory, and the response data is the full path of the
+// file. responseFilePath must be a plain file name; requests that name any
+// other path fail without touching the file system.
 class NetworkingModule : public facebook::xplat::module::CxxModule {
-  static int64_t s_lastRequestId;
-  std::unordered_map<int64_t, std::unique_ptr<IHttpResource>> m_resources;
+  // Shared with the handlers of the resources, which may run after the module
+  // is gone. The destructor clears alive.
+  struct Lifetime {
+    std::mutex mutex;
+    bool alive{true};
+  };
+
+  static std::atomic<int64_t> s_lastRequestId;
+  std::shared_ptr<facebook::react::MessageQueueThread> m_nativeQueue;
+  std::shared_ptr<Lifetime> m_lifetime{std::make_shared<Lifetime>()};
+  std::filesystem::path m_downloadDirectory;
+
+  // Requests finish on the native queue.
+  std::mutex m_resourcesMutex;
+  std::unordered_map<int64_t, std::shared_ptr<IHttpResource>> m_resources;
+
+  template <typename Handler>
+  auto Bind(Handler &&handler) noexcept;
 
-  IHttpResource *GetResource(int64_t requestId) noexcept;
+  std::shared_ptr<IHttpResource> CreateResource(
+      int64_t requestId,
+      const std::string &url,
+      bool useIncrementalUpdates) noexcept;
+  std::shared_ptr<IHttpResource> GetResource(int64_t requestId) noexcept;
+  void ReleaseResource(int64_t requestId) noexcept;
   void OnDataReceived(int64_t requestId, const std::string &data) noexcept;
   void OnRequestError(
       int64_t requestId,
@@ -28,7 +61,20 @@ class NetworkingModule : public facebook::xplat::module::CxxModule {
   void SendEvent(std::string &&eventName, folly::dynamic &&parameters);
 
  public:
-  NetworkingModule();
+  // Request events are sent from nativeQueue, which must not be null.
+  // Response files go to downloadDirectory, which is created when needed. By
+  // default, it is ReactNativeDownloads in the temp directory.
+  NetworkingModule(
+      std::shared_ptr<facebook::react::MessageQueueThread> nativeQueue,
+      std::filesystem::path downloadDirectory = {});
+
+  ~NetworkingModule() override;
+
+  // The path that responseFilePath name stands for in directory, or an empty
+  // path when name is not a plain file name.
+  static std::filesystem::path ResolveResponseFile(
+      const std::filesystem::path &directory,
+      const std::string &name) noexcept;
 
 #pragma region CxxModule members
 
@@ -21,72 +21,262 @@ using namespace folly;
 namespace facebook {
 namespace react {
 
-bool operator<(const Timer &leftTimer, const Timer &rightTimer) {
-  return rightTimer.DueTime < leftTimer.DueTime;
-}
-
-bool operator==(const Timer &leftTimer, const uint64_t id) {
-  return id == leftTimer.Id;
-}
-
 void TimerQueue::Push(Timer timer) {
-  m_timerVector.push_back(timer);
-  std::push_heap(m_timerVector.begin(), m_timerVector.end());
+  auto existing = m_timers.find(timer.Id);
+  if (existing != m_timers.end())
+    RemoveTimer(existing);
+
+  Slot *&slot = m_slots[timer.DueTime.time_since_epoch().count()];
+  if (!slot) {
+    auto newSlot = std::make_unique<Slot>(Slot{timer.DueTime, {}, 0, 0, 0});
+    slot = newSlot.get();
+    m_heap.emplace_back();
+    Place(std::move(newSlot), m_heap.size() - 1);
+    SiftUp(m_heap.size() - 1);
+  }
+
+  m_timers[timer.Id] = Location{slot, slot->Timers.size()};
+  slot->Timers.push_back(timer);
+  ++slot->Live;
 }
 
 void TimerQueue::Pop() {
-  std::pop_heap(m_timerVector.begin(), m_timerVector.end());
-  m_timerVector.pop_back();
+  const Slot &slot = *m_heap.front();
+  RemoveTimer(m_timers.find(slot.Timers[slot.Head].Id));
 }
 
 Timer &TimerQueue::Front() {
-  return m_timerVector.front();
+  Slot &slot = *m_heap.front();
+  return slot.Timers[slot.Head];
 }
 
 const Timer &TimerQueue::Front() const {
-  return m_timerVector.front();
+  const Slot &slot = *m_heap.front();
+  return slot.Timers[slot.Head];
 }
 
 bool TimerQueue::Remove(uint64_t id) {
-  // TODO: This is very inefficient, but doing this with a heap is inherently
-  // hard. If performance is not good
-  //	enough for the scenarios then a different structure is probably needed.
-  auto found = std::find(m_timerVector.begin(), m_timerVector.end(), id);
-  if (found != m_timerVector.end()) {
-    m_timerVector.erase(found);
-  } else {
+  auto found = m_timers.find(id);
+  if (found == m_timers.end())
     return false;
-  }
-  std::make_heap(m_timerVector.begin(), m_timerVector.end());
+
+  RemoveTimer(found);
   return true;
 }
 
 bool TimerQueue::IsEmpty() const {
-  return m_timerVector.empty();
+  return m_heap.empty();
+}
+
+size_t TimerQueue::Size() const {
+  return m_timers.size();
+}
+
+void TimerQueue::RemoveTimer(
+    std::unordered_map<uint64_t, Location>::iterator timer) noexcept {
+  Slot &slot = *timer->second.TimerSlot;
+  const size_t index = timer->second.Index;
+  m_timers.erase(timer);
+
+  if (--slot.Live == 0)
+    RemoveSlot(slot);
+  else if (index == slot.Head)
+    SkipCancelled(slot);
+}
+
+void TimerQueue::SkipCancelled(Slot &slot) noexcept {
+  // A timer is live while its id still maps to its position in the slot.
+  // The slot has live timers left, so this stops before running off its end.
+  for (;;) {
+    ++slot.Head;
+    auto found = m_timers.find(slot.Timers[slot.Head].Id);
+    if (found != m_timers.end() && found->second.TimerSlot == &slot &&
+        found->second.Index == slot.Head)
+      return;
+  }
+}
+
+void TimerQueue::RemoveSlot(Slot &slot) noexcept {
+  const size_t index = slot.HeapIndex;
+  m_slots.erase(slot.DueTime.time_since_epoch().count());
+
+  // Move the last slot into the hole, which destroys the removed one, and
+  // restore the heap around it.
+  std::unique_ptr<Slot> last = std::move(m_heap.back());
+  m_heap.pop_back();
+  if (index == m_heap.size())
+    return;
+
+  Place(std::move(last), index);
+  if (index > 0 &&
+      m_heap[index]->DueTime < m_heap[(index - 1) / Arity]->DueTime)
+    SiftUp(index);
+  else
+    SiftDown(index);
+}
+
+void TimerQueue::SiftUp(size_t index) noexcept {
+  std::unique_ptr<Slot> slot = std::move(m_heap[index]);
+  while (index > 0) {
+    const size_t parent = (index - 1) / Arity;
+    if (!(slot->DueTime < m_heap[parent]->DueTime))
+      break;
+
+    Place(std::move(m_heap[parent]), index);
+    index = parent;
+  }
+  Place(std::move(slot), index);
+}
+
+void TimerQueue::SiftDown(size_t index) noexcept {
+  std::unique_ptr<Slot> slot = std::move(m_heap[index]);
+  const size_t size = m_heap.size();
+  for (;;) {
+    const size_t first = index * Arity + 1;
+    if (first >= size)
+      break;
+
+    const size_t end = first + Arity < size ? first + Arity : size;
+    size_t smallest = first;
+    for (size_t child = first + 1; child < end; ++child) {
+      if (m_heap[child]->DueTime < m_heap[smallest]->DueTime)
+        smallest = child;
+    }
+    if (!(m_heap[smallest]->DueTime < slot->DueTime))
+      break;
+
+    Place(std::move(m_heap[smallest]), index);
+    index = smallest;
+  }
+  Place(std::move(slot), index);
+}
+
+void TimerQueue::Place(std::unique_ptr<Slot> slot, size_t index) noexcept {
+  slot->HeapIndex = index;
+  m_heap[index] = std::move(slot);
+}
+
+#ifdef _WIN32
+ThreadpoolTimerBackend::ThreadpoolTimerBackend(
+    std::function<void()> &&onTimerRaised)
+    : m_onTimerRaised(std::move(onTimerRaised)) {}
+
+ThreadpoolTimerBackend::~ThreadpoolTimerBackend() {
+  if (m_threadpoolTimer) {
+    Stop();
+    WaitForThreadpoolTimerCallbacks(m_threadpoolTimer, true);
+    CloseThreadpoolTimer(m_threadpoolTimer);
+  }
 }
 
-/*static*/ void Timing::ThreadpoolTimerCallback(
+/*static*/ void ThreadpoolTimerBackend::ThreadpoolTimerCallback(
     PTP_CALLBACK_INSTANCE,
     PVOID Parameter,
     PTP_TIMER) noexcept {
-  static_cast<Timing *>(Parameter)->OnTimerRaised();
+  static_cast<ThreadpoolTimerBackend *>(Parameter)->m_onTimerRaised();
 }
 
+void ThreadpoolTimerBackend::Set(DateTime dueTime) noexcept {
+  FILETIME FileDueTime;
+  ULARGE_INTEGER ulDueTime;
+  auto now = std::chrono::system_clock::now();
+  auto now_ms = std::chrono::time_point_cast<std::chrono::milliseconds>(now);
+  TimeSpan period = dueTime - now_ms;
+  ulDueTime.QuadPart = (ULONGLONG) - (period.count() * 10000);
+  FileDueTime.dwHighDateTime = ulDueTime.HighPart;
+  FileDueTime.dwLowDateTime = ulDueTime.LowPart;
+
+  if (!m_threadpoolTimer) {
+    m_threadpoolTimer = CreateThreadpoolTimer(
+        &ThreadpoolTimerBackend::ThreadpoolTimerCallback,
+        static_cast<PVOID>(this),
+        NULL);
+    assert(m_threadpoolTimer && "CreateThreadpoolTimer failed.");
+  }
+
+  SetThreadpoolTimer(m_threadpoolTimer, &FileDueTime, 0, 0);
+}
+
+void ThreadpoolTimerBackend::Stop() noexcept {
+  // Cancel pending callbacks
+  if (m_threadpoolTimer)
+    SetThreadpoolTimer(m_threadpoolTimer, NULL, 0, 0);
+}
+#endif
+
+ThreadTimerBackend::ThreadTimerBackend(std::function<void()> &&onTimerRaised)
+    : m_onTimerRaised(std::move(onTimerRaised)),
+      m_thread([this]() { Run(); }) {}
+
+ThreadTimerBackend::~ThreadTimerBackend() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_exiting = true;
+  }
+  m_dueTimeChanged.notify_one();
+  m_thread.join();
+}
+
+void ThreadTimerBackend::Set(DateTime dueTime) noexcept {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dueTime = dueTime;
+  }
+  m_dueTimeChanged.notify_one();
+}
+
+void ThreadTimerBackend::Stop() noexcept {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_dueTime = DateTime::max();
+}
+
+void ThreadTimerBackend::Run() noexcept {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_exiting) {
+    // Wake up on every change and look at the due time again, so Set and
+    // Stop take effect while waiting.
+    if (m_dueTime == DateTime::max()) {
+      m_dueTimeChanged.wait(lock);
+    } else if (std::chrono::system_clock::now() < m_dueTime) {
+      const DateTime dueTime = m_dueTime;
+      m_dueTimeChanged.wait_until(lock, dueTime);
+    } else {
+      m_dueTime = DateTime::max();
+      lock.unlock();
+      m_onTimerRaised();
+      lock.lock();
+    }
+  }
+}
+
+std::unique_ptr<ITimerBackend> CreateDefaultTimerBackend(
+    std::function<void()> &&onTimerRaised) {
+#ifdef _WIN32
+  return std::make_unique<ThreadpoolTimerBackend>(std::move(onTimerRaised));
+#else
+  return std::make_unique<ThreadTimerBackend>(std::move(onTimerRaised));
+#endif
+}
+
+Timing::Timing(
+    const std::shared_ptr<facebook::react::MessageQueueThread> &nativeThread,
+    const TimerBackendFactory &createBackend)
+    : m_timerBackend(createBackend([this]() { OnTimerRaised(); })),
+      m_nativeThread(nativeThread) {}
+
 void Timing::OnTimerRaised() noexcept {
   if (auto inst = m_wkInstance.lock()) {
     if (auto nativeThread = m_nativeThread.lock()) {
       // Make sure we execute it on native thread for native modules
       // Capture weak_ptr "this" because callback will be executed on native
       // thread even if "this" is destroyed.
-      nativeThread->runOnQueue([weakThis = std::weak_ptr<Timing>(
-                                    shared_from_this())]() {
+      nativeThread->runOnQueue([weakThis = weak_from_this()]() {
         auto strongThis = weakThis.lock();
         if (!strongThis) {
           return;
         }
 
-        if ((!strongThis->m_threadpoolTimer) ||
-            strongThis->m_timerQueue.IsEmpty()) {
+        if (strongThis->m_timerQueue.IsEmpty()) {
           return;
         }
 
@@ -219,27 +409,7 @@ void Timing::SetInstance(
 
 void Timing::SetKernelTimer(DateTime dueTime) noexcept {
   m_dueTime = dueTime;
-  FILETIME FileDueTime;
-  ULARGE_INTEGER ulDueTime;
-  auto now = std::chrono::system_clock::now();
-  auto now_ms = std::chrono::time_point_cast<std::chrono::milliseconds>(now);
-  TimeSpan period = dueTime - now_ms;
-  ulDueTime.QuadPart = (ULONGLONG) - (period.count() * 10000);
-  FileDueTime.dwHighDateTime = ulDueTime.HighPart;
-  FileDueTime.dwLowDateTime = ulDueTime.LowPart;
-
-  if (!m_threadpoolTimer) {
-    InitializeKernelTimer();
-  }
-
-  SetThreadpoolTimer(m_threadpoolTimer, &FileDueTime, 0, 0);
-}
-
-void Timing::InitializeKernelTimer() noexcept {
-  // Create ThreadPoolTimer
-  m_threadpoolTimer = CreateThreadpoolTimer(
-      &Timing::ThreadpoolTimerCallback, static_cast<PVOID>(this), NULL);
-  assert(m_threadpoolTimer && "CreateThreadpoolTimer failed.");
+  m_timerBackend->Set(dueTime);
 }
 
 void Timing::deleteTimer(uint64_t id) noexcept {
@@ -251,8 +421,7 @@ void Timing::deleteTimer(uint64_t id) noexcept {
 }
 
 void Timing::StopKernelTimer() noexcept {
-  // Cancel pending callbacks
-  SetThreadpoolTimer(m_threadpoolTimer, NULL, 0, 0);
+  m_timerBackend->Stop();
   m_dueTime = DateTime::max();
 }
 
@@ -262,11 +431,8 @@ void Timing::setSendIdleEvents(bool /*sendIdleEvents*/) noexcept {
 }
 
 Timing::~Timing() {
-  if (m_threadpoolTimer) {
-    StopKernelTimer();
-    WaitForThreadpoolTimerCallbacks(m_threadpoolTimer, true);
-    CloseThreadpoolTimer(m_threadpoolTimer);
-  }
+  // Wait for a running callback before the members it uses go away.
+  m_timerBackend.reset();
 }
 
 TimingModule::TimingModule(std::shared_ptr<Timing> &&timing)
@@ -8,10 +8,17 @@
 #include <cxxreact/MessageQueueThread.h>
 
 #include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 namespace facebook {
 namespace react {
@@ -32,14 +39,10 @@ struct Timer {
   bool Repeat;
 };
 
-// operator for push_heap and pop_heap
-bool operator<(const Timer &leftTimer, const Timer &rightTimer);
-
-// operator for find
-bool operator==(const Timer &leftTimer, const uint64_t id);
-
-// This class is a implementation of max heap to store Timer objects.
-// The front timer has the smallest due time.
+// This class keeps Timer objects ordered by due time and supports cancelling
+// a timer by id in O(log n). Timers due in the same millisecond are coalesced
+// into one slot, a node of an indexed 4-ary min heap, and keep the order they
+// were pushed in within it. The front timer has the smallest due time.
 // Example:
 //           TimerQueue tq;
 //           tq.Push(Timer{1234, now()+100ms, 100ms, false});
@@ -49,19 +52,101 @@ bool operator==(const Timer &leftTimer, const uint64_t id);
 //           printf("%u", tq.Front().Id); // print 1236
 class TimerQueue {
  public:
+  // Pushing a timer with the id of a queued one replaces it.
   void Push(Timer timer);
   void Pop();
   Timer &Front();
   const Timer &Front() const;
   bool Remove(uint64_t id);
   bool IsEmpty() const;
+  size_t Size() const;
 
  private:
-  // This vector is maintained as a max heap, where the front Timer has the
-  // smallest due time.
-  std::vector<Timer> m_timerVector;
+  struct Slot {
+    DateTime DueTime;
+    // Cancelled timers stay in Timers until the slot is popped, but never
+    // at or before Head.
+    std::vector<Timer> Timers;
+    size_t Head;
+    size_t Live;
+    size_t HeapIndex;
+  };
+
+  struct Location {
+    Slot *TimerSlot;
+    size_t Index;
+  };
+
+  static constexpr size_t Arity = 4;
+
+  void RemoveTimer(
+      std::unordered_map<uint64_t, Location>::iterator timer) noexcept;
+  void SkipCancelled(Slot &slot) noexcept;
+  void RemoveSlot(Slot &slot) noexcept;
+  void SiftUp(size_t index) noexcept;
+  void SiftDown(size_t index) noexcept;
+  void Place(std::unique_ptr<Slot> slot, size_t index) noexcept;
+
+  // Min heap of slots by due time.
+  std::vector<std::unique_ptr<Slot>> m_heap;
+  std::unordered_map<DateTime::rep, Slot *> m_slots;
+  std::unordered_map<uint64_t, Location> m_timers;
 };
 
+// The one-shot kernel timer Timing sets for its front timer. Set replaces any
+// earlier due time. The callback passed to the backend may run on any thread;
+// the backend's destructor cancels it and waits for a running callback.
+class ITimerBackend {
+ public:
+  virtual ~ITimerBackend() = default;
+  virtual void Set(DateTime dueTime) noexcept = 0;
+  virtual void Stop() noexcept = 0;
+};
+
+using TimerBackendFactory = std::function<std::unique_ptr<ITimerBackend>(
+    std::function<void()> &&onTimerRaised)>;
+
+#ifdef _WIN32
+// Backend built on a Win32 threadpool timer.
+class ThreadpoolTimerBackend : public ITimerBackend {
+ public:
+  ThreadpoolTimerBackend(std::function<void()> &&onTimerRaised);
+  ~ThreadpoolTimerBackend() override;
+  void Set(DateTime dueTime) noexcept override;
+  void Stop() noexcept override;
+
+ private:
+  static VOID CALLBACK ThreadpoolTimerCallback(
+      PTP_CALLBACK_INSTANCE Instance,
+      PVOID Parameter,
+      PTP_TIMER Timer) noexcept;
+  std::function<void()> m_onTimerRaised;
+  PTP_TIMER m_threadpoolTimer = NULL;
+};
+#endif
+
+// Portable backend that waits for the due time on a dedicated thread.
+class ThreadTimerBackend : public ITimerBackend {
+ public:
+  ThreadTimerBackend(std::function<void()> &&onTimerRaised);
+  ~ThreadTimerBackend() override;
+  void Set(DateTime dueTime) noexcept override;
+  void Stop() noexcept override;
+
+ private:
+  void Run() noexcept;
+  std::function<void()> m_onTimerRaised;
+  std::mutex m_mutex;
+  std::condition_variable m_dueTimeChanged;
+  DateTime m_dueTime{DateTime::max()};
+  bool m_exiting{false};
+  std::thread m_thread;
+};
+
+// Creates the threadpool backend on Windows and the thread backend elsewhere.
+std::unique_ptr<ITimerBackend> CreateDefaultTimerBackend(
+    std::function<void()> &&onTimerRaised);
+
 // Helper class which implements createTimer, deleteTimer and setSendIdleEvents
 // for actual TimingModule Example:
 //           Timing timing;
@@ -70,8 +155,8 @@ class TimerQueue {
 class Timing : public std::enable_shared_from_this<Timing> {
  public:
   Timing(
-      const std::shared_ptr<facebook::react::MessageQueueThread> &nativeThread)
-      : m_nativeThread(nativeThread) {}
+      const std::shared_ptr<facebook::react::MessageQueueThread> &nativeThread,
+      const TimerBackendFactory &createBackend = CreateDefaultTimerBackend);
   ~Timing();
   void createTimer(
       std::weak_ptr<facebook::react::Instance> instance,
@@ -83,19 +168,14 @@ class Timing : public std::enable_shared_from_this<Timing> {
   void setSendIdleEvents(bool sendIdleEvents) noexcept;
 
  private:
-  static VOID CALLBACK ThreadpoolTimerCallback(
-      PTP_CALLBACK_INSTANCE Instance,
-      PVOID Parameter,
-      PTP_TIMER Timer) noexcept;
   void OnTimerRaised() noexcept;
   void SetInstance(std::weak_ptr<facebook::react::Instance> instance) noexcept;
   void SetKernelTimer(DateTime dueTime) noexcept;
-  void InitializeKernelTimer() noexcept;
   void TimersChanged() noexcept;
   void StopKernelTimer() noexcept;
   bool KernelTimerIsAboutToFire() noexcept;
   TimerQueue m_timerQueue;
-  PTP_TIMER m_threadpoolTimer = NULL;
+  std::unique_ptr<ITimerBackend> m_timerBackend;
   DateTime m_dueTime;
 
   std::weak_ptr<facebook::react::Instance> m_wkInstance;
@@ -7,6 +7,7 @@
 
 #include <cxxreact/Instance.h>
 #include <cxxreact/JsArgumentHelpers.h>
+#include "../ReactWindowsCore/Base64.h"
 #include "../ReactWindowsCore/Utils.h"
 #include "Unicode.h"
 
@@ -132,6 +133,21 @@ IWebSocket *WebSocketModule::GetOrCreateWebSocket(int64_t id, string &&url) {
       dynamic args = dynamic::object("id", id)("data", message)("type", "text");
       this->SendEvent("websocketMessage", std::move(args));
     });
+    ws->SetOnBinaryMessage([this, id](const IWebSocket::BinaryMessage &parts) {
+      size_t size = 0;
+      for (auto part : parts)
+        size += part.size();
+
+      string data;
+      Base64Encoder encoder{data, size};
+      for (auto part : parts)
+        encoder.Write(part.data(), part.size());
+      encoder.Finish();
+
+      dynamic args = dynamic::object("id", id)("data", std::move(data))(
+          "type", "binary");
+      this->SendEvent("websocketMessage", std::move(args));
+    });
     ws->SetOnClose(
         [this, id](IWebSocket::CloseCode code, const string &reason) {
           dynamic args = dynamic::object("id", id)(
@@ -8,15 +8,13 @@
 
 #include "WebSocket.h"
 
-#include <boost/archive/iterators/base64_from_binary.hpp>
-#include <boost/archive/iterators/binary_from_base64.hpp>
-#include <boost/archive/iterators/ostream_iterator.hpp>
-#include <boost/archive/iterators/transform_width.hpp>
+#include <boost/asio/bind_executor.hpp>
 #include <boost/asio/connect.hpp>
 #include <boost/beast/core/buffers_to_string.hpp>
+#include <future>
+#include "Base64.h"
 #include "Unicode.h"
 
-using namespace boost::archive::iterators;
 using namespace boost::asio;
 using namespace boost::beast;
 
@@ -41,20 +39,27 @@ template <
     typename Stream,
     typename Resolver>
 BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::BaseWebSocket(Url &&url)
-    : m_url{std::move(url)} {}
+    : m_url{std::move(url)},
+      m_pool{IoThreadPool::Shared()},
+      m_context{m_pool->Context()},
+      m_strand{m_context.get_executor()} {}
 
 template <
     typename Protocol,
     typename SocketLayer,
     typename Stream,
     typename Resolver>
-BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::~BaseWebSocket() {
-  if (!m_context.stopped()) {
-    if (!m_closeRequested)
-      Close(CloseCode::GoingAway, "Terminating instance");
-    else if (!m_closeInProgress)
-      PerformClose();
-  }
+template <typename Handler>
+auto BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::Bind(
+    Handler &&handler) {
+  // The reference goes away with the wrapper, even if the handler throws, or
+  // never runs.
+  return bind_executor(
+      m_strand,
+      [self = this->shared_from_this(),
+       handler = std::forward<Handler>(handler)](auto &&... args) mutable {
+        handler(std::forward<decltype(args)>(args)...);
+      });
 }
 
 template <
@@ -77,7 +82,7 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::Handshake(
         }
       },
       // Handshake handler
-      [this](boostecr ec) {
+      Bind([this](boostecr ec) {
         if (ec) {
           if (m_errorHandler)
             m_errorHandler({ec.message(), ErrorType::Handshake});
@@ -100,10 +105,10 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::Handshake(
             PerformPing();
 
           // Perform close, if requested.
-          if (m_closeRequested && !m_closeInProgress)
+          if (m_closePending && !m_closeInProgress)
             PerformClose();
         }
-      }); // async_handshake_ex
+      })); // async_handshake_ex
 }
 
 template <
@@ -118,42 +123,49 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::PerformRead() {
   }
 
   // Check if there are more bytes available than a header length (2).
-  m_stream->async_read(m_bufferIn, [this](boostecr ec, size_t size) {
+  m_stream->async_read(m_bufferIn, Bind([this](boostecr ec, size_t size) {
     if (error::operation_aborted == ec) {
       // Nothing to do.
     } else if (ec) {
       if (m_errorHandler)
         m_errorHandler({ec.message(), ErrorType::Receive});
     } else {
-      string message{buffers_to_string(m_bufferIn.data())};
-
-      if (m_stream->got_binary()) {
-        // ISS:2906983
-        typedef base64_from_binary<transform_width<const char *, 6, 8>>
-            encode_base64;
-
-        // NOTE: Encoding the base64 string makes the message's length different
-        // from the 'size' argument.
-        std::ostringstream os;
-        std::copy(
-            encode_base64(message.c_str()),
-            encode_base64(message.c_str() + size),
-            ostream_iterator<char>(os));
-        message = os.str();
-
-        auto padSize = ((4 - message.length()) % 4) % 4;
-        message.append(padSize, '=');
-      }
+      if (!m_stream->got_binary()) {
+        if (m_readHandler)
+          m_readHandler(size, buffers_to_string(m_bufferIn.data()));
+      } else if (m_binaryReadHandler || m_readHandler) {
+        // The buffers of the message, without joining them.
+        BinaryMessage parts;
+        auto buffers = m_bufferIn.data();
+        for (auto it = buffer_sequence_begin(buffers);
+             it != buffer_sequence_end(buffers);
+             ++it) {
+          const_buffer part = *it;
+          parts.emplace_back(
+              static_cast<const char *>(part.data()), part.size());
+        }
 
-      if (m_readHandler)
-        m_readHandler(size, std::move(message));
+        if (m_binaryReadHandler) {
+          m_binaryReadHandler(parts);
+        } else {
+          // NOTE: Encoding the base64 string makes the message's length
+          // different from the 'size' argument.
+          string message;
+          Base64Encoder encoder{message, size};
+          for (auto part : parts)
+            encoder.Write(part.data(), part.size());
+          encoder.Finish();
+
+          m_readHandler(size, std::move(message));
+        }
+      }
 
       m_bufferIn.consume(size);
     } // if (ec)
 
     // Enqueue another read.
     PerformRead();
-  }); // async_read
+  })); // async_read
 }
 
 template <
@@ -166,8 +178,8 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::PerformWrite() {
   assert(!m_writeInProgress);
   m_writeInProgress = true;
 
-  std::pair<string, bool> request = m_writeRequests.front();
-  m_writeRequests.pop();
+  // Stays queued until written, so that the buffer outlives the write.
+  auto &request = m_writeRequests.front();
 
   m_stream->binary(request.second);
 
@@ -177,7 +189,7 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::PerformWrite() {
     m_stream->write_buffer_size(request.first.length());
 
   m_stream->async_write(
-      buffer(request.first), [this](boostecr ec, size_t size) {
+      buffer(request.first), Bind([this](boostecr ec, size_t size) {
         if (ec) {
           if (m_errorHandler)
             m_errorHandler({ec.message(), ErrorType::Send});
@@ -186,11 +198,12 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::PerformWrite() {
             m_writeHandler(size);
         }
 
+        m_writeRequests.pop();
         m_writeInProgress = false;
 
         if (!m_writeRequests.empty())
           PerformWrite();
-      });
+      }));
 }
 
 template <
@@ -205,7 +218,7 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::PerformPing() {
 
   --m_pingRequests;
 
-  m_stream->async_ping(websocket::ping_data(), [this](boostecr ec) {
+  m_stream->async_ping(websocket::ping_data(), Bind([this](boostecr ec) {
     if (ec) {
       if (m_errorHandler)
         m_errorHandler({ec.message(), ErrorType::Ping});
@@ -216,7 +229,7 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::PerformPing() {
 
     if (m_pingRequests > 0)
       PerformPing();
-  });
+  }));
 }
 
 template <
@@ -229,7 +242,7 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::PerformClose() {
   m_readyState = ReadyState::Closing;
 
   m_stream->async_close(
-      ToBeastCloseCode(m_closeCodeRequest), [this](boostecr ec) {
+      ToBeastCloseCode(m_closeCodeRequest), Bind([this](boostecr ec) {
         if (ec) {
           if (m_errorHandler)
             m_errorHandler({ec.message(), ErrorType::Close});
@@ -239,24 +252,7 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::PerformClose() {
           if (m_closeHandler)
             m_closeHandler(m_closeCodeRequest, m_closeReasonRequest);
         }
-      });
-
-  // Synchronize context thread.
-  Stop();
-}
-
-template <
-    typename Protocol,
-    typename SocketLayer,
-    typename Stream,
-    typename Resolver>
-void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::Stop() {
-  if (m_workGuard)
-    m_workGuard->reset();
-
-  if (m_contextThread.joinable() &&
-      std::this_thread::get_id() != m_contextThread.get_id())
-    m_contextThread.join();
+      }));
 }
 
 template <
@@ -265,14 +261,14 @@ template <
     typename Stream,
     typename Resolver>
 void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::EnqueueWrite(
-    const string &message,
+    string &&message,
     bool binary) {
-  post(m_context, [this, message = std::move(message), binary]() {
+  post(m_strand, Bind([this, message = std::move(message), binary]() mutable {
     m_writeRequests.emplace(std::move(message), binary);
 
     if (!m_writeInProgress && ReadyState::Open == m_readyState)
       PerformWrite();
-  });
+  }));
 }
 
 template <
@@ -374,12 +370,13 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::Connect(
     }
   }
 
-  Resolver resolver(m_context);
-  resolver.async_resolve(
+  // The resolver must live until the lookup completes.
+  auto resolver = std::make_shared<Resolver>(m_context);
+  resolver->async_resolve(
       m_url.host,
       m_url.port,
-      [this, options = std::move(options)](
-          boostecr ec, typename Resolver::results_type results) {
+      Bind([this, resolver, options = std::move(options)](
+               boostecr ec, typename Resolver::results_type results) {
         if (ec) {
           if (m_errorHandler)
             m_errorHandler({ec.message(), ErrorType::Resolution});
@@ -392,22 +389,16 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::Connect(
             m_stream->lowest_layer(),
             results.begin(),
             results.end(),
-            [this, options = std::move(options)](
-                boostecr ec, const basic_resolver_iterator<Protocol> &) {
+            Bind([this, options = std::move(options)](
+                     boostecr ec, const basic_resolver_iterator<Protocol> &) {
               if (ec) {
                 if (m_errorHandler)
                   m_errorHandler({ec.message(), ErrorType::Connection});
               } else {
                 Handshake(std::move(options));
               }
-            }); // async_connect
-      }); // async_resolve
-
-  m_contextThread = std::thread([this]() {
-    m_workGuard = make_unique<executor_work_guard<io_context::executor_type>>(
-        make_work_guard(m_context));
-    m_context.run();
-  });
+            })); // async_connect
+      })); // async_resolve
 } // void Connect
 
 template <
@@ -418,19 +409,19 @@ template <
 void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::Close(
     CloseCode code,
     const string &reason) {
-  if (m_closeRequested)
+  if (m_closeRequested.exchange(true))
     return;
 
-  m_closeRequested = true;
-  m_closeCodeRequest = code;
-  m_closeReasonRequest = std::move(reason);
+  // Give priority to Connect(). Once the handshake is performed, its handler
+  // closes the stream.
+  post(m_strand, Bind([this, code, reason]() {
+    m_closeCodeRequest = code;
+    m_closeReasonRequest = reason;
+    m_closePending = true;
 
-  assert(!m_closeInProgress);
-  // Give priority to Connect().
-  if (m_handshakePerformed)
-    PerformClose();
-  else
-    Stop(); // Synchronize the context thread.
+    if (m_handshakePerformed && !m_closeInProgress)
+      PerformClose();
+  }));
 }
 
 template <
@@ -440,7 +431,7 @@ template <
     typename Resolver>
 void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::Send(
     const string &message) {
-  EnqueueWrite(std::move(message), false);
+  EnqueueWrite(string{message}, false);
 }
 
 template <
@@ -450,20 +441,8 @@ template <
     typename Resolver>
 void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::SendBinary(
     const string &base64String) {
-  m_stream->binary(true);
-
   string message;
-  try {
-    typedef transform_width<binary_from_base64<string::const_iterator>, 8, 6>
-        decode_base64;
-
-    // A correctly formed base64 string should have from 0 to three '=' trailing
-    // characters. Skip those.
-    size_t padSize = std::count(base64String.begin(), base64String.end(), '=');
-    message = string(
-        decode_base64(base64String.begin()),
-        decode_base64(base64String.end() - padSize));
-  } catch (const std::exception &) {
+  if (!DecodeBase64(base64String, message)) {
     if (m_errorHandler)
       m_errorHandler({"", ErrorType::Send});
 
@@ -473,6 +452,16 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::SendBinary(
   EnqueueWrite(std::move(message), true);
 }
 
+template <
+    typename Protocol,
+    typename SocketLayer,
+    typename Stream,
+    typename Resolver>
+void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::SendBinaryData(
+    string &&data) {
+  EnqueueWrite(std::move(data), true);
+}
+
 template <
     typename Protocol,
     typename SocketLayer,
@@ -483,8 +472,11 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::Ping() {
     return;
 
   ++m_pingRequests;
-  if (!m_pingInProgress && ReadyState::Open == m_readyState)
-    PerformPing();
+  post(m_strand, Bind([this]() {
+    if (m_pingRequests > 0 && !m_pingInProgress &&
+        ReadyState::Open == m_readyState)
+      PerformPing();
+  }));
 }
 
 #pragma endregion IWebSocket members
@@ -531,6 +523,16 @@ void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::SetOnMessage(
   m_readHandler = handler;
 }
 
+template <
+    typename Protocol,
+    typename SocketLayer,
+    typename Stream,
+    typename Resolver>
+void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::
+    SetOnBinaryMessage(function<void(const BinaryMessage &)> &&handler) {
+  m_binaryReadHandler = handler;
+}
+
 template <
     typename Protocol,
     typename SocketLayer,
@@ -563,6 +565,38 @@ BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::GetReadyState() const {
 
 #pragma endregion Handler setters
 
+template <
+    typename Protocol,
+    typename SocketLayer,
+    typename Stream,
+    typename Resolver>
+void BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>::Detach() {
+  auto detach = [self = this->shared_from_this()]() {
+    self->m_connectHandler = nullptr;
+    self->m_pingHandler = nullptr;
+    self->m_writeHandler = nullptr;
+    self->m_readHandler = nullptr;
+    self->m_binaryReadHandler = nullptr;
+    self->m_closeHandler = nullptr;
+    self->m_errorHandler = nullptr;
+  };
+
+  // A pool thread must not wait for the strand. The handler that runs may be
+  // one of those dropped, and the strand may wait for this thread, such as
+  // when the pool has a single thread.
+  if (m_context.get_executor().running_in_this_thread()) {
+    post(m_strand, std::move(detach));
+    return;
+  }
+
+  std::promise<void> detached;
+  post(m_strand, [&detached, detach = std::move(detach)]() {
+    detach();
+    detached.set_value();
+  });
+  detached.get_future().wait();
+}
+
 #pragma endregion BaseWebSocket members
 
 #pragma region WebSocket members
@@ -589,20 +623,101 @@ SecureWebSocket::SecureWebSocket(Url &&url) : BaseWebSocket(std::move(url)) {
 void SecureWebSocket::Handshake(const IWebSocket::Options &options) {
   this->m_stream->next_layer().async_handshake(
       ssl::stream_base::client,
-      [this, options = std::move(options)](boostecr ec) {
+      Bind([this, options = std::move(options)](boostecr ec) {
         if (ec && this->m_errorHandler) {
           this->m_errorHandler(
               {ec.message(), IWebSocket::ErrorType::Connection});
         } else {
           BaseWebSocket::Handshake(std::move(options));
         }
-      });
+      }));
 }
 
 #pragma endregion SecureWebSocket members
 
 #pragma region IWebSocket static members
 
+namespace {
+
+/// <summary>
+/// What <c>IWebSocket::Make</c> hands out. Closes the socket when destroyed,
+/// without waiting for the close handshake; the socket itself lives on until
+/// its last handler has run.
+/// </summary>
+template <typename Socket>
+class WebSocketHandle : public IWebSocket {
+  std::shared_ptr<Socket> m_socket;
+
+ public:
+  WebSocketHandle(Url &&url)
+      : m_socket{std::make_shared<Socket>(std::move(url))} {}
+
+  ~WebSocketHandle() override {
+    m_socket->Close(CloseCode::GoingAway, "Terminating instance");
+    m_socket->Detach();
+  }
+
+  void Connect(const Protocols &protocols, const Options &options) override {
+    m_socket->Connect(protocols, options);
+  }
+
+  void Ping() override {
+    m_socket->Ping();
+  }
+
+  void Send(const string &message) override {
+    m_socket->Send(message);
+  }
+
+  void SendBinary(const string &base64String) override {
+    m_socket->SendBinary(base64String);
+  }
+
+  void SendBinaryData(string &&data) override {
+    m_socket->SendBinaryData(std::move(data));
+  }
+
+  void Close(CloseCode code, const string &reason) override {
+    m_socket->Close(code, reason);
+  }
+
+  ReadyState GetReadyState() const override {
+    return m_socket->GetReadyState();
+  }
+
+  void SetOnConnect(function<void()> &&handler) override {
+    m_socket->SetOnConnect(std::move(handler));
+  }
+
+  void SetOnPing(function<void()> &&handler) override {
+    m_socket->SetOnPing(std::move(handler));
+  }
+
+  void SetOnSend(function<void(size_t)> &&handler) override {
+    m_socket->SetOnSend(std::move(handler));
+  }
+
+  void SetOnMessage(function<void(size_t, const string &)> &&handler) override {
+    m_socket->SetOnMessage(std::move(handler));
+  }
+
+  void SetOnBinaryMessage(
+      function<void(const BinaryMessage &)> &&handler) override {
+    m_socket->SetOnBinaryMessage(std::move(handler));
+  }
+
+  void SetOnClose(
+      function<void(CloseCode, const string &)> &&handler) override {
+    m_socket->SetOnClose(std::move(handler));
+  }
+
+  void SetOnError(function<void(Error &&)> &&handler) override {
+    m_socket->SetOnError(std::move(handler));
+  }
+};
+
+} // namespace
+
 /*static*/ unique_ptr<IWebSocket> IWebSocket::Make(const string &urlString) {
   Url url(urlString);
 
@@ -610,12 +725,12 @@ void SecureWebSocket::Handshake(const IWebSocket::Options &options) {
     if (url.port.empty())
       url.port = "80";
 
-    return unique_ptr<IWebSocket>(new WebSocket(std::move(url)));
+    return make_unique<WebSocketHandle<WebSocket>>(std::move(url));
   } else if (url.scheme == "wss") {
     if (url.port.empty())
       url.port = "443";
 
-    return unique_ptr<IWebSocket>(new SecureWebSocket(std::move(url)));
+    return make_unique<WebSocketHandle<SecureWebSocket>>(std::move(url));
   } else
     throw std::exception(
         (string("Incorrect url protocol: ") + url.scheme).c_str());
@@ -775,7 +890,7 @@ async_connect(
     Iterator begin,
     Iterator end,
     BOOST_ASIO_MOVE_ARG(IteratorConnectHandler) handler) {
-  handler(s.ConnectResult(), {});
+  handler(s.ConnectResult(), Iterator{});
 }
 
 } // namespace boost::asio
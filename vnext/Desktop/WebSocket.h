@@ -3,11 +3,13 @@
 
 #pragma once
 
+#include <boost/asio/strand.hpp>
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/websocket/ssl.hpp>
+#include <memory>
 #include <queue>
-#include <thread>
 #include "IWebSocket.h"
+#include "IoThreadPool.h"
 #include "Utils.h"
 
 namespace Microsoft::React {
@@ -17,26 +19,34 @@ template <
     typename SocketLayer = boost::asio::basic_stream_socket<Protocol>,
     typename Stream = boost::beast::websocket::stream<SocketLayer>,
     typename Resolver = boost::asio::ip::basic_resolver<Protocol>>
-class BaseWebSocket : public IWebSocket {
+class BaseWebSocket
+    : public IWebSocket,
+      public std::enable_shared_from_this<
+          BaseWebSocket<Protocol, SocketLayer, Stream, Resolver>> {
   std::function<void()> m_connectHandler;
   std::function<void()> m_pingHandler;
   std::function<void(std::size_t)> m_writeHandler;
   std::function<void(std::size_t, const std::string &)> m_readHandler;
+  std::function<void(const BinaryMessage &)> m_binaryReadHandler;
   std::function<void(CloseCode, const std::string &)> m_closeHandler;
 
   Url m_url;
   ReadyState m_readyState{ReadyState::Connecting};
   boost::beast::multi_buffer m_bufferIn;
-  std::thread m_contextThread;
 
   /// <remarks>
-  /// Must be modified exclusively from the context thread.
+  /// Must be modified exclusively from <c>m_strand</c>.
   /// </remarks>
   std::queue<std::pair<std::string, bool>> m_writeRequests;
 
   std::atomic_size_t m_pingRequests{0};
+
+  /// <remarks>
+  /// Must be accessed exclusively from <c>m_strand</c>.
+  /// </remarks>
   CloseCode m_closeCodeRequest{CloseCode::None};
   std::string m_closeReasonRequest;
+  bool m_closePending{false};
 
   // Internal status flags.
   std::atomic_bool m_handshakePerformed{false};
@@ -54,11 +64,11 @@ class BaseWebSocket : public IWebSocket {
   /// <param name="binary">
   /// Indicates whether the payload should be treated as binary data, or text.
   /// </param>
-  void EnqueueWrite(const std::string &message, bool binary);
+  void EnqueueWrite(std::string &&message, bool binary);
 
   /// <summary>
-  /// Dequeues a message from <c>m_writeRequests</c> and sends it
-  /// asynchronously.
+  /// Sends the message at the front of <c>m_writeRequests</c> asynchronously,
+  /// and dequeues it once written.
   /// </summary>
   void PerformWrite();
 
@@ -80,42 +90,40 @@ class BaseWebSocket : public IWebSocket {
   /// <summary>
   /// Set the ready state to <c>Closing</c>.
   /// Post a close request for this stream.
-  /// Stop this instance to drop any future read or write requests.
   /// </summary>
   void PerformClose();
 
-  /// <summary>
-  /// Synchronizes the context thread and allows the io_context to stop
-  /// dispatching tasks.
-  /// </summary>
-  void Stop();
-
   boost::beast::websocket::close_code ToBeastCloseCode(
       IWebSocket::CloseCode closeCode);
 
  protected:
+  std::shared_ptr<IoThreadPool> m_pool;
+
   /// <summary>
   /// See
   /// https://www.boost.org/doc/libs/1_68_0/doc/html/boost_asio/reference/io_context.html.
   ///
-  /// Dispatches tasks posted either by <see cref="m_stream" />
-  /// or arbitrary lambdas using <c>boost::asio::post</c>.
+  /// The context of the pool that all web sockets share.
   /// </summary>
-  /// <remarks>
-  /// Tasks will be run in the thread that calls this object's <c>run</c>
-  /// method.
-  /// </remarks>
-  boost::asio::io_context m_context;
+  boost::asio::io_context &m_context;
+
+  /// <summary>
+  /// Runs the handlers of this instance one at a time, and in order, on the
+  /// threads of <c>m_pool</c>.
+  /// </summary>
+  boost::asio::strand<boost::asio::io_context::executor_type> m_strand;
 
-  std::unique_ptr<
-      boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>
-      m_workGuard;
   std::unique_ptr<Stream> m_stream;
   std::function<void(Error &&)> m_errorHandler;
 
   BaseWebSocket(Url &&url);
 
-  ~BaseWebSocket() override;
+  /// <summary>
+  /// Wraps a completion handler to run on <c>m_strand</c>, and to keep this
+  /// instance alive until it ran, or was dropped.
+  /// </summary>
+  template <typename Handler>
+  auto Bind(Handler &&handler);
 
   /// <summary>
   /// Finalizes the connection setup to the remote endpoint.
@@ -155,6 +163,11 @@ class BaseWebSocket : public IWebSocket {
   /// </summary>
   void SendBinary(const std::string &base64String) override;
 
+  /// <summary>
+  /// <see cref="IWebSocket::SendBinaryData" />
+  /// </summary>
+  void SendBinaryData(std::string &&data) override;
+
   /// <summary>
   /// <see cref="IWebSocket::Close" />
   /// </summary>
@@ -183,6 +196,12 @@ class BaseWebSocket : public IWebSocket {
   void SetOnMessage(
       std::function<void(std::size_t, const std::string &)> &&handler) override;
 
+  /// <summary>
+  /// <see cref="IWebSocket::SetOnBinaryMessage" />
+  /// </summary>
+  void SetOnBinaryMessage(
+      std::function<void(const BinaryMessage &)> &&handler) override;
+
   /// <summary>
   /// <see cref="IWebSocket::SetOnClose" />
   /// </summary>
@@ -195,6 +214,17 @@ class BaseWebSocket : public IWebSocket {
   void SetOnError(std::function<void(Error &&)> &&handler) override;
 
 #pragma endregion IWebSocket
+
+  /// <summary>
+  /// Drops the handlers set on this instance, so that none of them is called
+  /// once this returns. When called from a thread of the pool, such as from
+  /// a handler, drops them after the work queued so far has run instead.
+  /// </summary>
+  /// <remarks>
+  /// Waits for the handler that runs, if any, but never on a thread of the
+  /// pool.
+  /// </remarks>
+  void Detach();
 };
 
 class WebSocket : public BaseWebSocket<> {
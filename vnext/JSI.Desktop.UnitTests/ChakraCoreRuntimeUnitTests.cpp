@@ -1,5 +1,7 @@
 #include "JsiRuntimeUnitTests.h"
 
+#include "BaseScriptStoreImpl.h"
+#include "JSI/Shared/ChakraRuntime.h"
 #include "JSI/Shared/ChakraRuntimeArgs.h"
 #include "JSI/Shared/ChakraRuntimeFactory.h"
 #include "MemoryTracker.h"
@@ -10,34 +12,229 @@
 
 #include <gtest/gtest.h>
 
+#include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+using facebook::jsi::Buffer;
 using facebook::jsi::JsiRuntimeUnitTests;
+using facebook::jsi::Object;
+using facebook::jsi::PreparedJavaScript;
+using facebook::jsi::PropNameID;
 using facebook::jsi::Runtime;
 using facebook::jsi::RuntimeFactory;
+using facebook::jsi::ScriptStore;
+using facebook::jsi::ScriptVersion_t;
+using facebook::jsi::String;
+using facebook::jsi::StringBuffer;
+using facebook::jsi::VersionedBuffer;
+using facebook::react::BasePreparedScriptStoreImpl;
+using facebook::react::BufferStore;
 using facebook::react::CreateMemoryTracker;
 using facebook::react::MessageQueueThread;
+using Microsoft::JSI::ChakraRuntime;
 using Microsoft::JSI::ChakraRuntimeArgs;
 using Microsoft::JSI::makeChakraRuntime;
+using Microsoft::JSI::PropertyIdCacheStatistics;
 using Microsoft::React::Test::TestMessageQueueThread;
 
-// TODO (yicyao): #2729 We need to add tests for ChakraCoreRuntime specific
-// behaviors such as ScriptStore. This may require us to bring back JSITestBase.
+// Tests of behaviors that only ChakraRuntime has, such as its property ID
+// caches, its script stores, and preparing scripts off the JS thread, are
+// ChakraRuntimeTest tests. JsiRuntimeUnitTests.cpp holds the tests that every
+// JSI runtime passes, which run here for each of runtimeGenerators().
+
+namespace {
+
+ChakraRuntimeArgs MakeRuntimeArgs() {
+  ChakraRuntimeArgs args{};
+
+  args.jsQueue = std::make_shared<TestMessageQueueThread>();
+
+  std::shared_ptr<MessageQueueThread> memoryTrackerCallbackQueue =
+      std::make_shared<TestMessageQueueThread>();
+
+  args.memoryTracker =
+      CreateMemoryTracker(std::move(memoryTrackerCallbackQueue));
+
+  return args;
+}
+
+// Keeps the persisted buffers in memory, so that runtimes created one after
+// the other by a test share their prepared scripts.
+class MemoryBufferStore : public BufferStore {
+ public:
+  std::unique_ptr<const Buffer> getBuffer(
+      const std::string &bufferId) noexcept override {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto buffer = m_buffers.find(bufferId);
+    if (buffer == m_buffers.end())
+      return nullptr;
+    return std::make_unique<StringBuffer>(buffer->second);
+  }
+
+  bool persistBuffer(
+      const std::string &bufferId,
+      std::unique_ptr<const Buffer> buffer) noexcept override {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buffers[bufferId] = std::string(
+        reinterpret_cast<const char *>(buffer->data()), buffer->size());
+    ++m_persistCount;
+    return true;
+  }
+
+  size_t PersistCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_persistCount;
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::map<std::string, std::string> m_buffers;
+  size_t m_persistCount{0};
+};
+
+class FixedVersionScriptStore : public ScriptStore {
+ public:
+  VersionedBuffer getVersionedScript(const std::string &) noexcept override {
+    return {nullptr, 0};
+  }
+
+  ScriptVersion_t getScriptVersion(const std::string &) noexcept override {
+    return 1;
+  }
+};
+
+std::unique_ptr<Runtime> MakePreparingRuntime(
+    const std::shared_ptr<MemoryBufferStore> &bufferStore,
+    bool prepareScriptsInBackground) {
+  ChakraRuntimeArgs args = MakeRuntimeArgs();
+  args.scriptStore = std::make_unique<FixedVersionScriptStore>();
+  args.preparedScriptStore =
+      std::make_unique<BasePreparedScriptStoreImpl>(bufferStore);
+  args.prepareScriptsInBackground = prepareScriptsInBackground;
+  return makeChakraRuntime(std::move(args));
+}
+
+double EvaluateAnswer(Runtime &runtime) {
+  runtime.evaluateJavaScript(
+      std::make_shared<StringBuffer>("var answer = 6 * 7;"), "answer.js");
+  return runtime.global().getProperty(runtime, "answer").getNumber();
+}
+
+PropertyIdCacheStatistics GetStatistics(Runtime &runtime) {
+  return static_cast<ChakraRuntime &>(runtime).GetPropertyIdCacheStatistics();
+}
+
+} // namespace
 
 std::vector<RuntimeFactory> runtimeGenerators() {
   return {[]() -> std::unique_ptr<Runtime> {
-    ChakraRuntimeArgs args{};
+            return makeChakraRuntime(MakeRuntimeArgs());
+          },
+          // Also run the tests without the property ID caches.
+          []() -> std::unique_ptr<Runtime> {
+            ChakraRuntimeArgs args = MakeRuntimeArgs();
+            args.propertyIdCacheSize = 0;
+            return makeChakraRuntime(std::move(args));
+          }};
+}
+
+TEST(ChakraRuntimeTest, CachesPropertyIds) {
+  auto runtime = makeChakraRuntime(MakeRuntimeArgs());
+  Runtime &rt = *runtime;
+  const PropertyIdCacheStatistics initial = GetStatistics(rt);
+
+  PropNameID length = PropNameID::forAscii(rt, "length");
+  EXPECT_TRUE(
+      PropNameID::compare(rt, length, PropNameID::forAscii(rt, "length")));
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(PropNameID::compare(
+        rt,
+        length,
+        PropNameID::forString(rt, String::createFromAscii(rt, "length"))));
+  }
+
+  // Each of the UTF-8 and UTF-16 caches missed once and hit once.
+  const PropertyIdCacheStatistics statistics = GetStatistics(rt);
+  EXPECT_EQ(initial.Size + 2, statistics.Size);
+  EXPECT_EQ(initial.Misses + 2, statistics.Misses);
+  EXPECT_EQ(initial.Hits + 2, statistics.Hits);
+
+  // Cached property IDs name the same properties as new ones.
+  Object object(rt);
+  object.setProperty(rt, String::createFromAscii(rt, "length"), 3);
+  EXPECT_EQ(3, object.getProperty(rt, length).getNumber());
+  EXPECT_EQ(3, object.getProperty(rt, "length").getNumber());
+}
+
+TEST(ChakraRuntimeTest, BoundsPropertyIdCache) {
+  ChakraRuntimeArgs args = MakeRuntimeArgs();
+  args.propertyIdCacheSize = 2;
+  auto runtime = makeChakraRuntime(std::move(args));
+  Runtime &rt = *runtime;
+
+  ASSERT_EQ(0u, GetStatistics(rt).Size);
+
+  // Names created before the cache fills stay cached; later ones are not.
+  for (const char *name : {"a", "b", "c", "d", "a", "b", "c", "d"})
+    PropNameID::forAscii(rt, name);
+
+  const PropertyIdCacheStatistics statistics = GetStatistics(rt);
+  EXPECT_EQ(2u, statistics.Size);
+  EXPECT_EQ(2u, statistics.Hits);
+  EXPECT_EQ(6u, statistics.Misses);
 
-    args.jsQueue = std::make_shared<TestMessageQueueThread>();
+  // Names that are not cached still get their property IDs.
+  EXPECT_TRUE(PropNameID::compare(
+      rt, PropNameID::forAscii(rt, "d"), PropNameID::forAscii(rt, "d")));
+}
+
+// Unlike evaluateJavaScript, prepareJavaScript does not need the JS thread.
+TEST(ChakraRuntimeTest, PreparesJavaScriptOnAnotherThread) {
+  auto runtime = makeChakraRuntime(MakeRuntimeArgs());
+  Runtime &rt = *runtime;
+
+  std::shared_ptr<const PreparedJavaScript> prepared;
+  std::thread([&rt, &prepared]() {
+    prepared = rt.prepareJavaScript(
+        std::make_shared<StringBuffer>(
+            "function multiply(a, b) { return a * b; }"
+            "var product = multiply(6, 7);"),
+        "prepared.js");
+  }).join();
+
+  rt.evaluatePreparedJavaScript(prepared);
+  EXPECT_EQ(42, rt.global().getProperty(rt, "product").getNumber());
+}
+
+TEST(ChakraRuntimeTest, GeneratesPreparedScriptBeforeEvaluating) {
+  auto bufferStore = std::make_shared<MemoryBufferStore>();
+
+  auto runtime = MakePreparingRuntime(bufferStore, false);
+  EXPECT_EQ(42, EvaluateAnswer(*runtime));
+  EXPECT_EQ(1u, bufferStore->PersistCount());
+  runtime.reset();
+
+  runtime = MakePreparingRuntime(bufferStore, false);
+  EXPECT_EQ(42, EvaluateAnswer(*runtime));
+  EXPECT_EQ(1u, bufferStore->PersistCount());
+}
 
-    std::shared_ptr<MessageQueueThread> memoryTrackerCallbackQueue =
-        std::make_shared<TestMessageQueueThread>();
+TEST(ChakraRuntimeTest, GeneratesPreparedScriptInBackground) {
+  auto bufferStore = std::make_shared<MemoryBufferStore>();
 
-    args.memoryTracker =
-        CreateMemoryTracker(std::move(memoryTrackerCallbackQueue));
+  // The runtime waits for the background generation when it is destroyed.
+  auto runtime = MakePreparingRuntime(bufferStore, true);
+  EXPECT_EQ(42, EvaluateAnswer(*runtime));
+  runtime.reset();
+  EXPECT_EQ(1u, bufferStore->PersistCount());
 
-    return makeChakraRuntime(std::move(args));
-  }};
+  // The next runtime evaluates the prepared script, and leaves it as it is.
+  runtime = MakePreparingRuntime(bufferStore, true);
+  EXPECT_EQ(42, EvaluateAnswer(*runtime));
+  runtime.reset();
+  EXPECT_EQ(1u, bufferStore->PersistCount());
 }
 
 INSTANTIATE_TEST_CASE_P(
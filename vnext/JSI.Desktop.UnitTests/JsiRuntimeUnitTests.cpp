@@ -7,6 +7,10 @@
 
 #include <gtest/gtest.h>
 
+#ifdef PERF_TESTS
+#include <Test/PerfTestHelpers.h>
+#endif
+
 #include <stdlib.h>
 
 // Note: We cannot use unistd.h here because it is a Unix header.
@@ -15,9 +19,11 @@
 #include <chrono>
 
 #include <functional>
+#include <sstream>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 using namespace facebook::jsi;
 using namespace Microsoft::Common::Utilities;
@@ -28,6 +34,119 @@ TEST_P(JsiRuntimeUnitTests, RuntimeTest) {
   EXPECT_EQ(rt.global().getProperty(rt, "x").getNumber(), 1);
 }
 
+TEST_P(JsiRuntimeUnitTests, PreparedJavaScriptTest) {
+  auto prepared = rt.prepareJavaScript(
+      std::make_shared<StringBuffer>(
+          "function add(a, b) { return a + b; } var sum = add(1, 2);"),
+      "prepared.js");
+  rt.evaluatePreparedJavaScript(prepared);
+  EXPECT_EQ(rt.global().getProperty(rt, "sum").getNumber(), 3);
+  EXPECT_EQ(eval("add(2, 3)").getNumber(), 5);
+
+  // A prepared script can be evaluated more than once.
+  eval("sum = 0");
+  rt.evaluatePreparedJavaScript(prepared);
+  EXPECT_EQ(rt.global().getProperty(rt, "sum").getNumber(), 3);
+}
+
+#ifdef PERF_TESTS
+namespace {
+
+// Shaped like a bundle: many module factories, of which only a few run at
+// startup.
+std::string MakeBundleLikeScript(int moduleCount) {
+  std::ostringstream script;
+  script << "var modules = [];";
+  for (int i = 0; i < moduleCount; ++i) {
+    script << "modules[" << i << "] = function (exports) {"
+           << "  var values = [" << i << ", " << i << " * 2];"
+           << "  exports.value = values.map(function (x) { return x + " << i
+           << "; });"
+           << "  exports.name = 'module" << i << "';"
+           << "};";
+  }
+  script << "var exports = {};"
+         << "for (var i = 0; i < modules.length; i += 10) modules[i](exports);";
+  return script.str();
+}
+
+} // namespace
+
+using Microsoft::React::Test::AddTime;
+using Microsoft::React::Test::PrintResult;
+
+TEST_P(JsiRuntimeUnitTests, PrepareJavaScriptPerfTest) {
+  constexpr uint32_t iterations = 20;
+  auto script = std::make_shared<StringBuffer>(MakeBundleLikeScript(4000));
+  LARGE_INTEGER evaluate{0}, prepare{0}, evaluatePrepared{0};
+
+  // Each iteration uses a new runtime, so that no parsing work is shared.
+  for (uint32_t i = 0; i < iterations; ++i) {
+    auto runtime = factory();
+    AddTime(evaluate, [&]() {
+      runtime->evaluateJavaScript(script, "bundle.js");
+    });
+  }
+
+  for (uint32_t i = 0; i < iterations; ++i) {
+    auto runtime = factory();
+    std::shared_ptr<const PreparedJavaScript> prepared;
+    AddTime(prepare, [&]() {
+      prepared = runtime->prepareJavaScript(script, "bundle.js");
+    });
+    AddTime(evaluatePrepared, [&]() {
+      runtime->evaluatePreparedJavaScript(prepared);
+    });
+  }
+
+  PrintResult("evaluateJavaScript", iterations, evaluate);
+  PrintResult("prepareJavaScript", iterations, prepare);
+  PrintResult("evaluatePreparedJavaScript", iterations, evaluatePrepared);
+}
+
+// The names the bridge and TurboModules create property names for on every
+// call.
+TEST_P(JsiRuntimeUnitTests, PropNameIDPerfTest) {
+  constexpr uint32_t iterations = 200000;
+  const std::vector<std::string> names = {"length",
+                                          "__fbBatchedBridge",
+                                          "callFunctionReturnFlushedQueue",
+                                          "invokeCallbackAndReturnFlushedQueue",
+                                          "flushedQueue",
+                                          "nativeModuleProxy",
+                                          "getConstants",
+                                          "createView"};
+  std::vector<String> nameStrings;
+  Object object(rt);
+  for (const auto &name : names) {
+    nameStrings.push_back(String::createFromAscii(rt, name));
+    object.setProperty(rt, name.c_str(), 1);
+  }
+
+  LARGE_INTEGER forAscii{0}, getProperty{0};
+  double sum = 0;
+
+  AddTime(forAscii, [&]() {
+    for (uint32_t i = 0; i < iterations; ++i) {
+      for (const auto &name : names)
+        PropNameID::forAscii(rt, name);
+    }
+  });
+
+  AddTime(getProperty, [&]() {
+    for (uint32_t i = 0; i < iterations; ++i) {
+      for (const auto &name : nameStrings)
+        sum += object.getProperty(rt, name).getNumber();
+    }
+  });
+
+  EXPECT_EQ(sum, static_cast<double>(iterations) * names.size());
+  const auto its = static_cast<uint32_t>(iterations * names.size());
+  PrintResult("PropNameID::forAscii", its, forAscii);
+  PrintResult("Object::getProperty(String)", its, getProperty);
+}
+#endif // PERF_TESTS
+
 TEST_P(JsiRuntimeUnitTests, PropNameIDTest) {
   // This is a little weird to test, because it doesn't really exist
   // in JS yet.  All I can do is create them, compare them, and
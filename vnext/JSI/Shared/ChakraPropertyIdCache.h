@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "ChakraObjectRef.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Microsoft::JSI {
+
+// Interns the property IDs a runtime creates by name, so that the names JSI
+// code creates over and over ("length", "__fbBatchedBridge", method names)
+// skip the Unicode conversion and the lookup in the engine. TChar is char for
+// UTF-8 names and wchar_t for UTF-16 names.
+//
+// Names are cached as they are first seen until the cache holds capacity
+// names. The names a session uses most are created early, and code creating
+// arbitrary names (such as the keys of a map) cannot pin an unbounded number
+// of property IDs. A cache must be cleared while a context of the runtime is
+// current, because releasing a property ID requires one.
+template <typename TChar>
+class ChakraPropertyIdCache {
+ public:
+  using StringView = std::basic_string_view<TChar>;
+
+  explicit ChakraPropertyIdCache(size_t capacity) noexcept
+      : m_capacity{capacity} {}
+
+  ChakraPropertyIdCache(const ChakraPropertyIdCache &) = delete;
+  ChakraPropertyIdCache &operator=(const ChakraPropertyIdCache &) = delete;
+
+  // Returns the cached property ID of name, or the one create() returns.
+  template <typename TCreate>
+  ChakraObjectRef Get(StringView name, const TCreate &create) {
+    auto cached = m_ids.find(name);
+    if (cached != m_ids.end()) {
+      ++m_hits;
+      return cached->second;
+    }
+
+    ++m_misses;
+    ChakraObjectRef id = create();
+    if (m_ids.size() < m_capacity) {
+      // m_names owns the characters the keys of m_ids point to.
+      m_ids.emplace(StringView{m_names.emplace_back(name)}, id);
+    }
+    return id;
+  }
+
+  void Clear() noexcept {
+    m_ids.clear();
+    m_names.clear();
+  }
+
+  size_t Size() const noexcept {
+    return m_ids.size();
+  }
+
+  uint64_t Hits() const noexcept {
+    return m_hits;
+  }
+
+  uint64_t Misses() const noexcept {
+    return m_misses;
+  }
+
+ private:
+  size_t m_capacity;
+  std::deque<std::basic_string<TChar>> m_names;
+  std::unordered_map<StringView, ChakraObjectRef> m_ids;
+  uint64_t m_hits{0};
+  uint64_t m_misses{0};
+};
+
+} // namespace Microsoft::JSI
@@ -8,8 +8,11 @@
 
 #include <MemoryTracker.h>
 #include <cxxreact/MessageQueueThread.h>
+#include <cxxreact/SystraceSection.h>
 #include <jsi/ScriptStore.h>
 
+#include <algorithm>
+#include <chrono>
 #include <climits>
 #include <mutex>
 #include <sstream>
@@ -54,7 +57,9 @@ std::vector<JsValueRef> constructJsFunctionArguments(
 } // namespace
 
 ChakraRuntime::ChakraRuntime(ChakraRuntimeArgs &&args) noexcept
-    : m_args{std::move(args)} {
+    : m_args{std::move(args)},
+      m_utf8PropertyIds{m_args.propertyIdCacheSize},
+      m_utf16PropertyIds{m_args.propertyIdCacheSize} {
   JsRuntimeAttributes runtimeAttributes = JsRuntimeAttributeNone;
 
   if (!m_args.enableJITCompilation) {
@@ -84,8 +89,15 @@ ChakraRuntime::ChakraRuntime(ChakraRuntimeArgs &&args) noexcept
 }
 
 ChakraRuntime::~ChakraRuntime() noexcept {
+  for (auto &preparedScript : m_backgroundPreparedScripts)
+    preparedScript.wait();
+
   stopDebuggingIfNeeded();
 
+  // Releasing the cached property IDs requires the context to be current.
+  m_utf8PropertyIds.Clear();
+  m_utf16PropertyIds.Clear();
+
   VerifyChakraErrorElseThrow(JsSetCurrentContext(JS_INVALID_REFERENCE));
   m_context.Invalidate();
 
@@ -94,6 +106,15 @@ ChakraRuntime::~ChakraRuntime() noexcept {
   VerifyChakraErrorElseThrow(JsDisposeRuntime(m_runtime));
 }
 
+PropertyIdCacheStatistics ChakraRuntime::GetPropertyIdCacheStatistics() const
+    noexcept {
+  PropertyIdCacheStatistics statistics;
+  statistics.Size = m_utf8PropertyIds.Size() + m_utf16PropertyIds.Size();
+  statistics.Hits = m_utf8PropertyIds.Hits() + m_utf16PropertyIds.Hits();
+  statistics.Misses = m_utf8PropertyIds.Misses() + m_utf16PropertyIds.Misses();
+  return statistics;
+}
+
 #pragma region Functions_inherited_from_Runtime
 
 facebook::jsi::Value ChakraRuntime::evaluateJavaScript(
@@ -142,10 +163,25 @@ facebook::jsi::Value ChakraRuntime::evaluateJavaScript(
       scriptSignature, runtimeSignature, nullptr);
 
   std::shared_ptr<const facebook::jsi::Buffer> sharedPreparedScript;
+  const char *preparedScriptPath = "loaded";
   if (preparedScript) {
     sharedPreparedScript =
         std::shared_ptr<const facebook::jsi::Buffer>(std::move(preparedScript));
+  } else if (runtimeArgs().prepareScriptsInBackground) {
+    // Serializing the script before evaluating it costs this launch more than
+    // the prepared script saves it, so leave the prepared script to the next.
+    facebook::react::SystraceSection s(
+        "ChakraRuntime::evaluateJavaScript",
+        "sourceURL",
+        sourceURL,
+        "preparedScript",
+        "background");
+    generatePreparedScriptInBackground(
+        sharedScriptBuffer, scriptSignature, runtimeSignature);
+    return evaluateJavaScriptSimple(*sharedScriptBuffer, sourceURL);
   } else {
+    facebook::react::SystraceSection s(
+        "ChakraRuntime::generatePreparedScript", "sourceURL", sourceURL);
     auto genPreparedScript =
         generatePreparedScript(sourceURL, *sharedScriptBuffer);
     if (!genPreparedScript)
@@ -157,8 +193,16 @@ facebook::jsi::Value ChakraRuntime::evaluateJavaScript(
         std::move(genPreparedScript));
     runtimeArgs().preparedScriptStore->persistPreparedScript(
         sharedPreparedScript, scriptSignature, runtimeSignature, nullptr);
+    preparedScriptPath = "generated";
   }
 
+  facebook::react::SystraceSection s(
+      "ChakraRuntime::evaluateJavaScript",
+      "sourceURL",
+      sourceURL,
+      "preparedScript",
+      preparedScriptPath);
+
   // We are pinning the buffers which are backing the external array buffers to
   // the duration of this. This is not good if the external array buffers have a
   // reduced liftime compared to the runtime itself. But, it's ok for the script
@@ -172,20 +216,83 @@ facebook::jsi::Value ChakraRuntime::evaluateJavaScript(
     return facebook::jsi::Value::undefined();
   }
 
-  // If we reach here, fall back to simple evaluation.
+  // If we reach here, the prepared script was rejected; replace it for the
+  // next launch if we can do so without delaying this one.
+  if (runtimeArgs().prepareScriptsInBackground) {
+    generatePreparedScriptInBackground(
+        sharedScriptBuffer, scriptSignature, runtimeSignature);
+  }
+
+  // Fall back to simple evaluation.
   return evaluateJavaScriptSimple(*sharedScriptBuffer, sourceURL);
 }
 
 std::shared_ptr<const facebook::jsi::PreparedJavaScript>
 ChakraRuntime::prepareJavaScript(
-    const std::shared_ptr<const facebook::jsi::Buffer> &,
-    std::string) {
-  throw facebook::jsi::JSINativeException("Not implemented!");
+    const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
+    std::string sourceURL) {
+  if (!buffer)
+    throw facebook::jsi::JSINativeException("Script buffer is empty!");
+
+  facebook::react::SystraceSection s(
+      "ChakraRuntime::prepareJavaScript", "sourceURL", sourceURL);
+
+  // Go through the prepared script store when the script can be versioned, as
+  // evaluateJavaScript does.
+  const uint64_t scriptVersion =
+      runtimeArgs().scriptStore && runtimeArgs().preparedScriptStore
+      ? runtimeArgs().scriptStore->getScriptVersion(sourceURL)
+      : 0;
+  facebook::jsi::ScriptSignature scriptSignature = {sourceURL, scriptVersion};
+  facebook::jsi::JSRuntimeSignature runtimeSignature = {description().c_str(),
+                                                        getRuntimeVersion()};
+
+  std::shared_ptr<const facebook::jsi::Buffer> bytecodeBuffer;
+  if (scriptVersion != 0) {
+    bytecodeBuffer = runtimeArgs().preparedScriptStore->tryGetPreparedScript(
+        scriptSignature, runtimeSignature, nullptr);
+  }
+
+  if (!bytecodeBuffer) {
+    bytecodeBuffer = generatePreparedScriptOnAnyThread(sourceURL, *buffer);
+    if (bytecodeBuffer && scriptVersion != 0) {
+      runtimeArgs().preparedScriptStore->persistPreparedScript(
+          bytecodeBuffer, scriptSignature, runtimeSignature, nullptr);
+    }
+  }
+
+  return std::make_shared<ChakraPreparedJavaScript>(
+      std::move(sourceURL), buffer, std::move(bytecodeBuffer));
 }
 
 facebook::jsi::Value ChakraRuntime::evaluatePreparedJavaScript(
-    const std::shared_ptr<const facebook::jsi::PreparedJavaScript> &) {
-  throw facebook::jsi::JSINativeException("Not implemented!");
+    const std::shared_ptr<const facebook::jsi::PreparedJavaScript> &js) {
+  auto preparedScript =
+      std::dynamic_pointer_cast<const ChakraPreparedJavaScript>(js);
+  if (!preparedScript)
+    throw facebook::jsi::JSINativeException(
+        "Prepared script was not prepared by ChakraRuntime!");
+
+  facebook::react::SystraceSection s(
+      "ChakraRuntime::evaluatePreparedJavaScript",
+      "sourceURL",
+      preparedScript->SourceURL());
+
+  if (preparedScript->BytecodeBuffer()) {
+    // See the note on pinning in evaluateJavaScript.
+    m_pinnedPreparedScripts.push_back(preparedScript->BytecodeBuffer());
+    m_pinnedScripts.push_back(preparedScript->SourceBuffer());
+
+    if (evaluateSerializedScript(
+            *preparedScript->SourceBuffer(),
+            *preparedScript->BytecodeBuffer(),
+            preparedScript->SourceURL())) {
+      return facebook::jsi::Value::undefined();
+    }
+  }
+
+  return evaluateJavaScriptSimple(
+      *preparedScript->SourceBuffer(), preparedScript->SourceURL());
 }
 
 facebook::jsi::Object ChakraRuntime::global() {
@@ -225,8 +332,9 @@ facebook::jsi::Runtime::PointerValue *ChakraRuntime::clonePropNameID(
 facebook::jsi::PropNameID ChakraRuntime::createPropNameIDFromAscii(
     const char *str,
     size_t length) {
-  ChakraObjectRef propId = GetPropertyId(std::string_view{str, length});
-  return MakePointer<facebook::jsi::PropNameID>(std::move(propId));
+  const std::string_view name{str, length};
+  return MakePointer<facebook::jsi::PropNameID>(
+      m_utf8PropertyIds.Get(name, [name]() { return GetPropertyId(name); }));
 }
 
 facebook::jsi::PropNameID ChakraRuntime::createPropNameIDFromUtf8(
@@ -241,9 +349,16 @@ facebook::jsi::PropNameID ChakraRuntime::createPropNameIDFromString(
   // We don not use the functions:
   //   std::string ChakraRuntime::utf8(const String& str), and
   //   std::string ToStdString(const ChakraObjectRef &jsString)
-  // here to avoud excessive Unicode conversions.
-  std::wstring propName = ToStdWstring(GetChakraObjectRef(str));
-  return MakePointer<facebook::jsi::PropNameID>(GetPropertyId(propName));
+  // here to avoud excessive Unicode conversions. We look the string up in
+  // place, and only copy it when its property ID is not cached.
+  const wchar_t *utf16 = nullptr;
+  size_t length = 0;
+  VerifyChakraErrorElseThrow(
+      JsStringToPointer(GetChakraObjectRef(str), &utf16, &length));
+
+  const std::wstring_view name{utf16, length};
+  return MakePointer<facebook::jsi::PropNameID>(m_utf16PropertyIds.Get(
+      name, [name]() { return GetPropertyId(std::wstring{name}); }));
 }
 
 std::string ChakraRuntime::utf8(const facebook::jsi::PropNameID &id) {
@@ -486,13 +601,13 @@ uint8_t *ChakraRuntime::data(const facebook::jsi::ArrayBuffer &arrBuf) {
 size_t ChakraRuntime::size(const facebook::jsi::ArrayBuffer &arrBuf) {
   assert(isArrayBuffer(arrBuf));
 
-  constexpr const uint8_t propName[] = {
-      'b', 'y', 't', 'e', 'l', 'e', 'n', 'g', 't', 'h'};
+  uint8_t *buffer = nullptr;
+  unsigned int size = 0;
 
-  facebook::jsi::PropNameID propId = createPropNameIDFromUtf8(
-      propName, Common::Utilities::ArraySize(propName));
+  VerifyJsErrorElseThrow(
+      JsGetArrayBufferStorage(GetChakraObjectRef(arrBuf), &buffer, &size));
 
-  return static_cast<size_t>(getProperty(arrBuf, propId).asNumber());
+  return size;
 }
 
 facebook::jsi::Value ChakraRuntime::getValueAtIndex(
@@ -945,6 +1060,76 @@ void ChakraRuntime::setupMemoryTracker() noexcept {
   }
 }
 
+/*static*/ std::unique_ptr<const facebook::jsi::Buffer>
+ChakraRuntime::generatePreparedScriptOnAnyThread(
+    const std::string &sourceURL,
+    const facebook::jsi::Buffer &sourceBuffer) noexcept {
+  JsContextRef currentContext = JS_INVALID_REFERENCE;
+  if (JsGetCurrentContext(&currentContext) == JsNoError &&
+      currentContext != JS_INVALID_REFERENCE)
+    return generatePreparedScript(sourceURL, sourceBuffer);
+
+  // A runtime may only be used on one thread at a time, and the runtime of a
+  // ChakraRuntime is used on its JS thread, so serialize the script with a
+  // runtime of our own.
+  JsRuntimeHandle runtime = JS_INVALID_RUNTIME_HANDLE;
+  if (JsCreateRuntime(
+          JsRuntimeAttributeDisableBackgroundWork, nullptr, &runtime) !=
+      JsNoError)
+    return nullptr;
+
+  std::unique_ptr<const facebook::jsi::Buffer> preparedScript;
+  JsContextRef context = JS_INVALID_REFERENCE;
+  if (JsCreateContext(runtime, &context) == JsNoError &&
+      JsSetCurrentContext(context) == JsNoError) {
+    preparedScript = generatePreparedScript(sourceURL, sourceBuffer);
+    JsSetCurrentContext(JS_INVALID_REFERENCE);
+  }
+  JsDisposeRuntime(runtime);
+
+  return preparedScript;
+}
+
+void ChakraRuntime::generatePreparedScriptInBackground(
+    std::shared_ptr<const facebook::jsi::Buffer> sourceBuffer,
+    const facebook::jsi::ScriptSignature &scriptSignature,
+    const facebook::jsi::JSRuntimeSignature &runtimeSignature) {
+  // Forget the generations that have finished, so that a long lived runtime
+  // doesn't keep a future for every script it has evaluated.
+  m_backgroundPreparedScripts.erase(
+      std::remove_if(
+          m_backgroundPreparedScripts.begin(),
+          m_backgroundPreparedScripts.end(),
+          [](const std::future<void> &preparedScript) {
+            return preparedScript.wait_for(std::chrono::seconds(0)) ==
+                std::future_status::ready;
+          }),
+      m_backgroundPreparedScripts.end());
+
+  m_backgroundPreparedScripts.push_back(std::async(
+      std::launch::async,
+      [preparedScriptStore = runtimeArgs().preparedScriptStore.get(),
+       sourceBuffer = std::move(sourceBuffer),
+       scriptSignature,
+       runtimeSignature]() noexcept {
+        facebook::react::SystraceSection s(
+            "ChakraRuntime::generatePreparedScriptInBackground",
+            "sourceURL",
+            scriptSignature.url);
+
+        std::shared_ptr<const facebook::jsi::Buffer> preparedScript =
+            generatePreparedScriptOnAnyThread(
+                scriptSignature.url, *sourceBuffer);
+        if (preparedScript) {
+          preparedScriptStore->persistPreparedScript(
+              std::move(preparedScript),
+              scriptSignature,
+              runtimeSignature,
+              nullptr);
+        }
+      }));
+}
+
 JsValueRef CALLBACK ChakraRuntime::HostFunctionCall(
     JsValueRef callee,
     bool isConstructCall,
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "ChakraObjectRef.h"
+#include "ChakraPropertyIdCache.h"
 #include "ChakraRuntimeArgs.h"
 
 #include "jsi/jsi.h"
@@ -18,6 +19,7 @@
 #include "jsrt.h"
 #endif
 
+#include <future>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -29,17 +31,62 @@ class DebugService {};
 
 namespace Microsoft::JSI {
 
+// The bytecode of a script and the source it was generated from. Chakra reads
+// the source of a function when the function is first called, so the source
+// has to outlive the evaluated bytecode. The bytecode is null when the script
+// could not be serialized, and then the source is evaluated instead.
+class ChakraPreparedJavaScript final
+    : public facebook::jsi::PreparedJavaScript {
+ public:
+  ChakraPreparedJavaScript(
+      std::string sourceURL,
+      std::shared_ptr<const facebook::jsi::Buffer> sourceBuffer,
+      std::shared_ptr<const facebook::jsi::Buffer> bytecodeBuffer) noexcept
+      : m_sourceURL{std::move(sourceURL)},
+        m_sourceBuffer{std::move(sourceBuffer)},
+        m_bytecodeBuffer{std::move(bytecodeBuffer)} {}
+
+  const std::string &SourceURL() const noexcept {
+    return m_sourceURL;
+  }
+
+  const std::shared_ptr<const facebook::jsi::Buffer> &SourceBuffer() const
+      noexcept {
+    return m_sourceBuffer;
+  }
+
+  const std::shared_ptr<const facebook::jsi::Buffer> &BytecodeBuffer() const
+      noexcept {
+    return m_bytecodeBuffer;
+  }
+
+ private:
+  std::string m_sourceURL;
+  std::shared_ptr<const facebook::jsi::Buffer> m_sourceBuffer;
+  std::shared_ptr<const facebook::jsi::Buffer> m_bytecodeBuffer;
+};
+
+// Totals of the UTF-8 and UTF-16 property ID caches of a runtime.
+struct PropertyIdCacheStatistics {
+  size_t Size = 0;
+  uint64_t Hits = 0;
+  uint64_t Misses = 0;
+};
+
 class ChakraRuntime : public facebook::jsi::Runtime {
  public:
   ChakraRuntime(ChakraRuntimeArgs &&args) noexcept;
   ~ChakraRuntime() noexcept;
 
+  PropertyIdCacheStatistics GetPropertyIdCacheStatistics() const noexcept;
+
 #pragma region Functions_inherited_from_Runtime
 
   facebook::jsi::Value evaluateJavaScript(
       const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
       const std::string &sourceURL) override;
 
+  // Unlike the other functions, prepareJavaScript may be called on any thread.
   std::shared_ptr<const facebook::jsi::PreparedJavaScript> prepareJavaScript(
       const std::shared_ptr<const facebook::jsi::Buffer> &buffer,
       std::string sourceURL) override;
@@ -388,9 +435,23 @@ class ChakraRuntime : public facebook::jsi::Runtime {
   }
 
   // Miscellaneous
-  std::unique_ptr<const facebook::jsi::Buffer> generatePreparedScript(
+  // Serializes the script with the context that is current on the calling
+  // thread.
+  static std::unique_ptr<const facebook::jsi::Buffer> generatePreparedScript(
       const std::string &sourceURL,
       const facebook::jsi::Buffer &sourceBuffer) noexcept;
+  // Serializes the script with the context that is current on the calling
+  // thread, or with a runtime of its own if there is none.
+  static std::unique_ptr<const facebook::jsi::Buffer>
+  generatePreparedScriptOnAnyThread(
+      const std::string &sourceURL,
+      const facebook::jsi::Buffer &sourceBuffer) noexcept;
+  // Generates the prepared script on a worker thread and persists it to the
+  // prepared script store.
+  void generatePreparedScriptInBackground(
+      std::shared_ptr<const facebook::jsi::Buffer> sourceBuffer,
+      const facebook::jsi::ScriptSignature &scriptSignature,
+      const facebook::jsi::JSRuntimeSignature &runtimeSignature);
   facebook::jsi::Value evaluateJavaScriptSimple(
       const facebook::jsi::Buffer &buffer,
       const std::string &sourceURL);
@@ -414,6 +475,11 @@ class ChakraRuntime : public facebook::jsi::Runtime {
   JsRuntimeHandle m_runtime;
   ChakraObjectRef m_context;
 
+  // Property IDs created by createPropNameIDFromAscii/Utf8, and by
+  // createPropNameIDFromString and the functions taking a jsi::String name.
+  ChakraPropertyIdCache<char> m_utf8PropertyIds;
+  ChakraPropertyIdCache<wchar_t> m_utf16PropertyIds;
+
   // Note: For simplicity, We are pinning the script and serialized script
   // buffers in the facebook::jsi::Runtime instance assuming as these buffers
   // are needed to stay alive for the lifetime of the facebook::jsi::Runtime
@@ -430,6 +496,10 @@ class ChakraRuntime : public facebook::jsi::Runtime {
   std::vector<std::shared_ptr<const facebook::jsi::Buffer>>
       m_pinnedPreparedScripts;
 
+  // Prepared scripts being generated in the background. They use the prepared
+  // script store, so the destructor waits for them.
+  std::vector<std::future<void>> m_backgroundPreparedScripts;
+
   static constexpr const char *const s_proxyGetHostObjectTargetPropName =
       "$$ProxyGetHostObjectTarget$$";
   static constexpr const char *const s_proxyIsHostObjectPropName =
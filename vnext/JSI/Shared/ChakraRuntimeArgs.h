@@ -41,10 +41,20 @@ struct ChakraRuntimeArgs {
 
   std::shared_ptr<facebook::react::MessageQueueThread> jsQueue;
 
+  // Maximum number of property names whose property IDs are cached, for UTF-8
+  // and UTF-16 names each. Zero disables the caches.
+  size_t propertyIdCacheSize{4096};
+
   // Script store which manages script and prepared script storage and
   // versioning.
   std::unique_ptr<facebook::jsi::ScriptStore> scriptStore;
   std::unique_ptr<facebook::jsi::PreparedScriptStore> preparedScriptStore;
+
+  // When the prepared script store has no prepared script for a script,
+  // evaluate its source right away and generate the prepared script on a
+  // background thread for the next launch, instead of generating it before
+  // evaluating.
+  bool prepareScriptsInBackground{false};
 };
 
 } // namespace Microsoft::JSI
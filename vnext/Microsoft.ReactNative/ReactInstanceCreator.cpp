@@ -65,6 +65,8 @@ ReactInstanceCreator::getInstance() {
   settings.UseJsi = m_instanceSettings.UseJsi();
   settings.UseLiveReload = m_instanceSettings.UseLiveReload();
   settings.UseWebDebugger = m_instanceSettings.UseWebDebugger();
+  settings.UIBatchFrameBudgetMs = m_instanceSettings.UIBatchFrameBudgetMs();
+  settings.EnableImageDiskCache = m_instanceSettings.EnableImageDiskCache();
 
   reactInstance->Start(reactInstance, settings);
 
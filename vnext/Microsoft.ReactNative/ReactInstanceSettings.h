@@ -55,6 +55,20 @@ struct ReactInstanceSettings : ReactInstanceSettingsT<ReactInstanceSettings> {
     m_enableDeveloperMenu = value;
   }
 
+  uint32_t UIBatchFrameBudgetMs() {
+    return m_uiBatchFrameBudgetMs;
+  }
+  void UIBatchFrameBudgetMs(uint32_t value) {
+    m_uiBatchFrameBudgetMs = value;
+  }
+
+  bool EnableImageDiskCache() {
+    return m_enableImageDiskCache;
+  }
+  void EnableImageDiskCache(bool value) {
+    m_enableImageDiskCache = value;
+  }
+
   hstring ByteCodeFileUri() {
     return m_byteCodeFileUri;
   }
@@ -99,6 +113,8 @@ struct ReactInstanceSettings : ReactInstanceSettingsT<ReactInstanceSettings> {
   bool m_useJsi{TRUE};
   bool m_enableJITCompilation{TRUE};
   bool m_enableByteCodeCaching{FALSE};
+  uint32_t m_uiBatchFrameBudgetMs{0};
+  bool m_enableImageDiskCache{FALSE};
 
   hstring m_byteCodeFileUri{};
   hstring m_debugHost{};
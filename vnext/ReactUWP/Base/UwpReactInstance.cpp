@@ -25,6 +25,7 @@
 #include <Views/DatePickerViewManager.h>
 #include <Views/FlyoutViewManager.h>
 #include <Views/Image/ImageViewManager.h>
+#include <Views/Image/ReactImage.h>
 #include <Views/PickerViewManager.h>
 #include <Views/PopupViewManager.h>
 #include <Views/RawTextViewManager.h>
@@ -292,7 +293,11 @@ void UwpReactInstance::Start(
       std::make_shared<react::uwp::UIMessageQueueThread>(m_uiDispatcher);
   m_batchingNativeThread =
       std::make_shared<react::uwp::BatchingUIMessageQueueThread>(
-          m_uiDispatcher);
+          m_uiDispatcher,
+          std::chrono::milliseconds(settings.UIBatchFrameBudgetMs));
+
+  if (settings.EnableImageDiskCache)
+    react::uwp::EnableImageDiskCache();
 
   // Objects that must be created on the UI thread
   m_deviceInfo = std::make_shared<DeviceInfo>(spThis);
@@ -547,6 +552,21 @@ void UwpReactInstance::DispatchEvent(
     m_instanceWrapper->DispatchEvent(viewTag, eventName, std::move(eventData));
 }
 
+void UwpReactInstance::DispatchTouchEvent(
+    std::string eventName,
+    folly::dynamic &&touches,
+    folly::dynamic &&changedIndices) {
+  if (!IsInError())
+    m_instanceWrapper->DispatchTouchEvent(
+        std::move(eventName), std::move(touches), std::move(changedIndices));
+}
+
+facebook::react::EventCoalescer::Counters UwpReactInstance::GetEventCounters()
+    const noexcept {
+  return m_instanceWrapper ? m_instanceWrapper->GetEventCounters()
+                           : facebook::react::EventCoalescer::Counters{};
+}
+
 void UwpReactInstance::CallJsFunction(
     std::string &&moduleName,
     std::string &&method,
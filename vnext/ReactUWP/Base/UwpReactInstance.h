@@ -63,6 +63,12 @@ class UwpReactInstance
       int64_t viewTag,
       std::string eventName,
       folly::dynamic &&eventData) override;
+  void DispatchTouchEvent(
+      std::string eventName,
+      folly::dynamic &&touches,
+      folly::dynamic &&changedIndices) override;
+  facebook::react::EventCoalescer::Counters GetEventCounters() const
+      noexcept override;
   void CallJsFunction(
       std::string &&moduleName,
       std::string &&method,
@@ -2,8 +2,6 @@
 // Licensed under the MIT License.
 
 // NYI:
-//   implement image cache
-//   implement prefetch functionality
 //   implement multi source (parse out most suitable image source from array of
 //   sources)
 #include "pch.h"
@@ -109,20 +107,77 @@ void ImageViewManagerModule::ImageViewManagerModuleImpl::getSize(
   GetImageSizeAsync(uri, successCallback, errorCallback);
 }
 
+winrt::fire_and_forget PrefetchImageAsync(
+    std::string uriString,
+    facebook::xplat::module::CxxModule::Callback successCallback,
+    facebook::xplat::module::CxxModule::Callback errorCallback) {
+  ImageSource source;
+  source.uri = uriString;
+
+  try {
+    winrt::Uri uri{Microsoft::Common::Unicode::Utf8ToUtf16(uriString)};
+    winrt::hstring scheme{uri.SchemeName()};
+    if (scheme != L"http" && scheme != L"https") {
+      // Nothing to download.
+      successCallback({true});
+      co_return;
+    }
+  } catch (winrt::hresult_error const &) {
+    errorCallback({});
+    co_return;
+  }
+
+  // Reading the image from the disk cache must not block the module queue.
+  co_await winrt::resume_background();
+
+  GetImageCache()->Get(
+      MakeImageCacheRequest(source),
+      [successCallback, errorCallback](
+          Microsoft::React::ImageCache::Bytes bytes) {
+        if (bytes)
+          successCallback({true});
+        else
+          errorCallback({});
+      });
+}
+
 void ImageViewManagerModule::ImageViewManagerModuleImpl::prefetchImage(
-    std::string /*uri*/,
+    std::string uri,
     Callback successCallback,
-    Callback /*errorCallback*/) {
-  // NotYetImplemented
-  successCallback({});
+    Callback errorCallback) {
+  PrefetchImageAsync(uri, successCallback, errorCallback);
 }
 
 void ImageViewManagerModule::ImageViewManagerModuleImpl::queryCache(
     const folly::dynamic &requests,
     Callback successCallback,
     Callback /*errorCallback*/) {
-  // NotYetImplemented
-  successCallback({folly::dynamic::object()});
+  auto cache = GetImageCache();
+  folly::dynamic result = folly::dynamic::object();
+  if (!requests.isArray()) {
+    successCallback({result});
+    return;
+  }
+
+  for (const auto &request : requests) {
+    if (!request.isString())
+      continue;
+
+    ImageSource source;
+    source.uri = request.getString();
+    switch (cache->Query(MakeImageCacheRequest(source))) {
+      case Microsoft::React::ImageCache::Location::Memory:
+        result[source.uri] = "memory";
+        break;
+      case Microsoft::React::ImageCache::Location::Disk:
+        result[source.uri] = "disk";
+        break;
+      default:
+        break;
+    }
+  }
+
+  successCallback({result});
 }
 
 //
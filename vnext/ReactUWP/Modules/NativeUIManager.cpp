@@ -4,6 +4,7 @@
 #include "pch.h"
 
 #include "NativeUIManager.h"
+#include "YogaStyleProps.h"
 
 #include <ReactRootView.h>
 #include <Views/ShadowNodeBase.h>
@@ -88,6 +89,10 @@ void NativeUIManager::DirtyYogaNode(int64_t tag) {
   }
 }
 
+void NativeUIManager::MarkExternalLayoutDirty(int64_t tag) {
+  m_externalLayoutDirtyTags.insert(tag);
+}
+
 void NativeUIManager::AddBatchCompletedCallback(
     std::function<void()> callback) {
   m_batchCompletedCallbacks.push_back(std::move(callback));
@@ -195,14 +200,20 @@ void NativeUIManager::AddRootView(
   m_tagsToXamlReactControl.emplace(
       shadowNode.m_tag, xamlRootView->GetXamlReactControl());
 
-  m_tagsToYogaNodes.emplace(shadowNode.m_tag, make_yoga_node());
+  auto result = m_tagsToYogaNodes.emplace(shadowNode.m_tag, make_yoga_node());
+  if (result.second)
+    m_yogaNodesToTags.emplace(result.first->second.get(), shadowNode.m_tag);
+  m_dirtyRootTags.insert(shadowNode.m_tag);
 
   auto element = view.as<winrt::FrameworkElement>();
   element.Tag(winrt::PropertyValue::CreateInt64(shadowNode.m_tag));
 
   // Add listener to size change so we can redo the layout when that happens
   m_sizeChangedVector.push_back(view.as<winrt::FrameworkElement>().SizeChanged(
-      winrt::auto_revoke, [this](auto &&, auto &&) { DoLayout(); }));
+      winrt::auto_revoke, [this, tag = shadowNode.m_tag](auto &&, auto &&) {
+        m_dirtyRootTags.insert(tag);
+        DoLayout();
+      }));
 }
 
 void NativeUIManager::destroy() {
@@ -211,6 +222,7 @@ void NativeUIManager::destroy() {
 
 void NativeUIManager::removeRootView(facebook::react::ShadowNode &shadow) {
   m_tagsToXamlReactControl.erase(shadow.m_tag);
+  m_dirtyRootTags.erase(shadow.m_tag);
   RemoveView(shadow, true);
 }
 
@@ -365,6 +377,88 @@ static void SetYogaValueAutoHelper(
   }
 }
 
+// Maps a keyword style value to the Yoga enum value it names. Null, and any
+// value that is not one of keywords (e.g. a keyword a newer version of React
+// Native added), stand for the default value of the prop.
+template <typename TEnum>
+static TEnum KeywordOrDefault(
+    const folly::dynamic &value,
+    TEnum defaultValue,
+    std::initializer_list<std::pair<YogaStyleValue, TEnum>> keywords) {
+  if (value.isNull())
+    return defaultValue;
+
+  if (value.isString()) {
+    if (auto keyword = YogaStyleValues.find(value.getString())) {
+      for (const auto &entry : keywords) {
+        if (entry.first == *keyword)
+          return entry.second;
+      }
+    }
+  }
+
+  return defaultValue;
+}
+
+static void SetPosition(
+    const YGNodeRef yogaNode,
+    const YGEdge edge,
+    const folly::dynamic &value) {
+  YGValue result = YGValueOrDefault(
+      value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
+
+  SetYogaValueHelper(
+      yogaNode,
+      edge,
+      result,
+      YGNodeStyleSetPosition,
+      YGNodeStyleSetPositionPercent);
+}
+
+static void SetMargin(
+    const YGNodeRef yogaNode,
+    const YGEdge edge,
+    const folly::dynamic &value) {
+  YGValue result = YGValueOrDefault(
+      value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
+
+  SetYogaValueAutoHelper(
+      yogaNode,
+      edge,
+      result,
+      YGNodeStyleSetMargin,
+      YGNodeStyleSetMarginPercent,
+      YGNodeStyleSetMarginAuto);
+}
+
+static void SetPadding(
+    ShadowNodeBase &shadowNode,
+    const YGNodeRef yogaNode,
+    const YGEdge edge,
+    const folly::dynamic &value) {
+  if (shadowNode.ImplementsPadding())
+    return;
+
+  YGValue result = YGValueOrDefault(
+      value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
+
+  SetYogaValueHelper(
+      yogaNode,
+      edge,
+      result,
+      YGNodeStyleSetPadding,
+      YGNodeStyleSetPaddingPercent);
+}
+
+static void SetBorder(
+    const YGNodeRef yogaNode,
+    const YGEdge edge,
+    const folly::dynamic &value) {
+  float result = NumberOrDefault(value, 0.0f /*default*/);
+
+  YGNodeStyleSetBorder(yogaNode, edge, result);
+}
+
 static void StyleYogaNode(
     ShadowNodeBase &shadowNode,
     const YGNodeRef yogaNode,
@@ -376,520 +470,287 @@ static void StyleYogaNode(
     const std::string &key = pair.first.getString();
     const auto &value = pair.second;
 
-    if (key == "flexDirection") {
-      YGFlexDirection direction = YGFlexDirectionColumn;
-
-      if (value == "column" || value.isNull())
-        direction = YGFlexDirectionColumn;
-      else if (value == "row")
-        direction = YGFlexDirectionRow;
-      else if (value == "column-reverse")
-        direction = YGFlexDirectionColumnReverse;
-      else if (value == "row-reverse")
-        direction = YGFlexDirectionRowReverse;
-      else
-        assert(false);
-
-      YGNodeStyleSetFlexDirection(yogaNode, direction);
-    } else if (key == "justifyContent") {
-      YGJustify justify = YGJustifyFlexStart;
-
-      if (value == "flex-start" || value.isNull())
-        justify = YGJustifyFlexStart;
-      else if (value == "flex-end")
-        justify = YGJustifyFlexEnd;
-      else if (value == "center")
-        justify = YGJustifyCenter;
-      else if (value == "space-between")
-        justify = YGJustifySpaceBetween;
-      else if (value == "space-around")
-        justify = YGJustifySpaceAround;
-      else if (value == "space-evenly")
-        justify = YGJustifySpaceEvenly;
-      else
-        assert(false);
-
-      YGNodeStyleSetJustifyContent(yogaNode, justify);
-    } else if (key == "flexWrap") {
-      YGWrap wrap = YGWrapNoWrap;
-
-      if (value == "nowrap" || value.isNull())
-        wrap = YGWrapNoWrap;
-      else if (value == "wrap")
-        wrap = YGWrapWrap;
-      else
-        assert(false);
-
-      YGNodeStyleSetFlexWrap(yogaNode, wrap);
-    } else if (key == "alignItems") {
-      YGAlign align = YGAlignStretch;
-
-      if (value == "stretch" || value.isNull())
-        align = YGAlignStretch;
-      else if (value == "flex-start")
-        align = YGAlignFlexStart;
-      else if (value == "flex-end")
-        align = YGAlignFlexEnd;
-      else if (value == "center")
-        align = YGAlignCenter;
-      else if (value == "baseline")
-        align = YGAlignBaseline;
-      else
-        assert(false);
-
-      YGNodeStyleSetAlignItems(yogaNode, align);
-    } else if (key == "alignSelf") {
-      YGAlign align = YGAlignAuto;
-
-      if (value == "auto" || value.isNull())
-        align = YGAlignAuto;
-      if (value == "stretch")
-        align = YGAlignStretch;
-      else if (value == "flex-start")
-        align = YGAlignFlexStart;
-      else if (value == "flex-end")
-        align = YGAlignFlexEnd;
-      else if (value == "center")
-        align = YGAlignCenter;
-      else if (value == "baseline")
-        align = YGAlignBaseline;
-      else
-        assert(false);
-
-      YGNodeStyleSetAlignSelf(yogaNode, align);
-    } else if (key == "alignContent") {
-      YGAlign align = YGAlignFlexStart;
-
-      if (value == "stretch")
-        align = YGAlignStretch;
-      else if (value == "flex-start" || value.isNull())
-        align = YGAlignFlexStart;
-      else if (value == "flex-end")
-        align = YGAlignFlexEnd;
-      else if (value == "center")
-        align = YGAlignCenter;
-      else if (value == "space-between")
-        align = YGAlignSpaceBetween;
-      else if (value == "space-around")
-        align = YGAlignSpaceAround;
-      else
-        assert(false);
+    // Most props of a view are not layout props, so they are rejected by one
+    // hash and compare.
+    const YogaStyleProp *prop = YogaStyleProps.find(key);
+    if (prop == nullptr)
+      continue;
 
-      YGNodeStyleSetAlignContent(yogaNode, align);
-    } else if (key == "flex") {
-      float result = NumberOrDefault(value, 0.0f /*default*/);
-
-      YGNodeStyleSetFlex(yogaNode, result);
-    } else if (key == "flexGrow") {
-      float result = NumberOrDefault(value, 0.0f /*default*/);
-
-      YGNodeStyleSetFlexGrow(yogaNode, result);
-    } else if (key == "flexShrink") {
-      float result = NumberOrDefault(value, 0.0f /*default*/);
-
-      YGNodeStyleSetFlexShrink(yogaNode, result);
-    } else if (key == "flexBasis") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaUnitValueAutoHelper(
-          yogaNode,
-          result,
-          YGNodeStyleSetFlexBasis,
-          YGNodeStyleSetFlexBasisPercent,
-          YGNodeStyleSetFlexBasisAuto);
-    } else if (key == "position") {
-      YGPositionType position = YGPositionTypeRelative;
-
-      if (value == "relative" || value.isNull())
-        position = YGPositionTypeRelative;
-      else if (value == "absolute")
-        position = YGPositionTypeAbsolute;
-      else
-        assert(false);
-
-      YGNodeStyleSetPositionType(yogaNode, position);
-    } else if (key == "overflow") {
-      YGOverflow overflow = YGOverflowVisible;
-      if (value == "visible" || value.isNull())
-        overflow = YGOverflowVisible;
-      else if (value == "hidden")
-        overflow = YGOverflowHidden;
-      else if (value == "scroll")
-        overflow = YGOverflowScroll;
-
-      YGNodeStyleSetOverflow(yogaNode, overflow);
-    } else if (key == "display") {
-      YGDisplay display = YGDisplayFlex;
-      if (value == "flex" || value.isNull())
-        display = YGDisplayFlex;
-      else if (value == "none")
-        display = YGDisplayNone;
-
-      YGNodeStyleSetDisplay(yogaNode, display);
-    } else if (key == "direction") {
-      YGDirection direction = YGDirectionInherit;
-      if (value == "inherit" || value.isNull())
-        direction = YGDirectionInherit;
-      else if (value == "ltr" || value.isNull())
-        direction = YGDirectionLTR;
-      else if (value == "rtl")
-        direction = YGDirectionRTL;
-
-      YGNodeStyleSetDirection(yogaNode, direction);
-    } else if (key == "aspectRatio") {
-      float result = NumberOrDefault(value, 1.0f /*default*/);
-
-      YGNodeStyleSetAspectRatio(yogaNode, result);
-    } else if (key == "left") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueHelper(
-          yogaNode,
-          YGEdgeLeft,
-          result,
-          YGNodeStyleSetPosition,
-          YGNodeStyleSetPositionPercent);
-    } else if (key == "top") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueHelper(
-          yogaNode,
-          YGEdgeTop,
-          result,
-          YGNodeStyleSetPosition,
-          YGNodeStyleSetPositionPercent);
-    } else if (key == "right") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueHelper(
-          yogaNode,
-          YGEdgeRight,
-          result,
-          YGNodeStyleSetPosition,
-          YGNodeStyleSetPositionPercent);
-    } else if (key == "bottom") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueHelper(
-          yogaNode,
-          YGEdgeBottom,
-          result,
-          YGNodeStyleSetPosition,
-          YGNodeStyleSetPositionPercent);
-    } else if (key == "end") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueHelper(
-          yogaNode,
-          YGEdgeEnd,
-          result,
-          YGNodeStyleSetPosition,
-          YGNodeStyleSetPositionPercent);
-    } else if (key == "start") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueHelper(
-          yogaNode,
-          YGEdgeStart,
-          result,
-          YGNodeStyleSetPosition,
-          YGNodeStyleSetPositionPercent);
-    } else if (key == "width") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaUnitValueAutoHelper(
-          yogaNode,
-          result,
-          YGNodeStyleSetWidth,
-          YGNodeStyleSetWidthPercent,
-          YGNodeStyleSetWidthAuto);
-    } else if (key == "minWidth") {
-      YGValue result =
-          YGValueOrDefault(value, YGValue{0.0f, YGUnitPoint} /*default*/);
-
-      SetYogaUnitValueHelper(
-          yogaNode,
-          result,
-          YGNodeStyleSetMinWidth,
-          YGNodeStyleSetMinWidthPercent);
-    } else if (key == "maxWidth") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaUnitValueHelper(
-          yogaNode,
-          result,
-          YGNodeStyleSetMaxWidth,
-          YGNodeStyleSetMaxWidthPercent);
-    } else if (key == "height") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaUnitValueAutoHelper(
-          yogaNode,
-          result,
-          YGNodeStyleSetHeight,
-          YGNodeStyleSetHeightPercent,
-          YGNodeStyleSetHeightAuto);
-    } else if (key == "minHeight") {
-      YGValue result =
-          YGValueOrDefault(value, YGValue{0.0f, YGUnitPoint} /*default*/);
-
-      SetYogaUnitValueHelper(
-          yogaNode,
-          result,
-          YGNodeStyleSetMinHeight,
-          YGNodeStyleSetMinHeightPercent);
-    } else if (key == "maxHeight") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaUnitValueHelper(
-          yogaNode,
-          result,
-          YGNodeStyleSetMaxHeight,
-          YGNodeStyleSetMaxHeightPercent);
-    } else if (key == "margin") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueAutoHelper(
-          yogaNode,
-          YGEdgeAll,
-          result,
-          YGNodeStyleSetMargin,
-          YGNodeStyleSetMarginPercent,
-          YGNodeStyleSetMarginAuto);
-    } else if (key == "marginLeft") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueAutoHelper(
-          yogaNode,
-          YGEdgeLeft,
-          result,
-          YGNodeStyleSetMargin,
-          YGNodeStyleSetMarginPercent,
-          YGNodeStyleSetMarginAuto);
-    } else if (key == "marginStart") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueAutoHelper(
-          yogaNode,
-          YGEdgeStart,
-          result,
-          YGNodeStyleSetMargin,
-          YGNodeStyleSetMarginPercent,
-          YGNodeStyleSetMarginAuto);
-    } else if (key == "marginTop") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueAutoHelper(
-          yogaNode,
-          YGEdgeTop,
-          result,
-          YGNodeStyleSetMargin,
-          YGNodeStyleSetMarginPercent,
-          YGNodeStyleSetMarginAuto);
-    } else if (key == "marginRight") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueAutoHelper(
-          yogaNode,
-          YGEdgeRight,
-          result,
-          YGNodeStyleSetMargin,
-          YGNodeStyleSetMarginPercent,
-          YGNodeStyleSetMarginAuto);
-    } else if (key == "marginEnd") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueAutoHelper(
-          yogaNode,
-          YGEdgeEnd,
-          result,
-          YGNodeStyleSetMargin,
-          YGNodeStyleSetMarginPercent,
-          YGNodeStyleSetMarginAuto);
-    } else if (key == "marginBottom") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueAutoHelper(
-          yogaNode,
-          YGEdgeBottom,
-          result,
-          YGNodeStyleSetMargin,
-          YGNodeStyleSetMarginPercent,
-          YGNodeStyleSetMarginAuto);
-    } else if (key == "marginHorizontal") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueAutoHelper(
-          yogaNode,
-          YGEdgeHorizontal,
-          result,
-          YGNodeStyleSetMargin,
-          YGNodeStyleSetMarginPercent,
-          YGNodeStyleSetMarginAuto);
-    } else if (key == "marginVertical") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueAutoHelper(
-          yogaNode,
-          YGEdgeVertical,
-          result,
-          YGNodeStyleSetMargin,
-          YGNodeStyleSetMarginPercent,
-          YGNodeStyleSetMarginAuto);
-    } else if (key == "padding") {
-      if (!shadowNode.ImplementsPadding()) {
-        YGValue result = YGValueOrDefault(
-            value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-        SetYogaValueHelper(
+    switch (*prop) {
+      case YogaStyleProp::FlexDirection:
+        YGNodeStyleSetFlexDirection(
             yogaNode,
-            YGEdgeAll,
-            result,
-            YGNodeStyleSetPadding,
-            YGNodeStyleSetPaddingPercent);
-      }
-    } else if (key == "paddingLeft") {
-      if (!shadowNode.ImplementsPadding()) {
-        YGValue result = YGValueOrDefault(
-            value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-        SetYogaValueHelper(
+            KeywordOrDefault(
+                value,
+                YGFlexDirectionColumn,
+                {{YogaStyleValue::Column, YGFlexDirectionColumn},
+                 {YogaStyleValue::Row, YGFlexDirectionRow},
+                 {YogaStyleValue::ColumnReverse, YGFlexDirectionColumnReverse},
+                 {YogaStyleValue::RowReverse, YGFlexDirectionRowReverse}}));
+        break;
+      case YogaStyleProp::JustifyContent:
+        YGNodeStyleSetJustifyContent(
             yogaNode,
-            YGEdgeLeft,
-            result,
-            YGNodeStyleSetPadding,
-            YGNodeStyleSetPaddingPercent);
-      }
-    } else if (key == "paddingStart") {
-      if (!shadowNode.ImplementsPadding()) {
-        YGValue result = YGValueOrDefault(
-            value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-        SetYogaValueHelper(
+            KeywordOrDefault(
+                value,
+                YGJustifyFlexStart,
+                {{YogaStyleValue::FlexStart, YGJustifyFlexStart},
+                 {YogaStyleValue::FlexEnd, YGJustifyFlexEnd},
+                 {YogaStyleValue::Center, YGJustifyCenter},
+                 {YogaStyleValue::SpaceBetween, YGJustifySpaceBetween},
+                 {YogaStyleValue::SpaceAround, YGJustifySpaceAround},
+                 {YogaStyleValue::SpaceEvenly, YGJustifySpaceEvenly}}));
+        break;
+      case YogaStyleProp::FlexWrap:
+        YGNodeStyleSetFlexWrap(
             yogaNode,
-            YGEdgeStart,
-            result,
-            YGNodeStyleSetPadding,
-            YGNodeStyleSetPaddingPercent);
-      }
-    } else if (key == "paddingTop") {
-      if (!shadowNode.ImplementsPadding()) {
-        YGValue result = YGValueOrDefault(
-            value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-        SetYogaValueHelper(
+            KeywordOrDefault(
+                value,
+                YGWrapNoWrap,
+                {{YogaStyleValue::NoWrap, YGWrapNoWrap},
+                 {YogaStyleValue::Wrap, YGWrapWrap}}));
+        break;
+      case YogaStyleProp::AlignItems:
+        YGNodeStyleSetAlignItems(
             yogaNode,
-            YGEdgeTop,
-            result,
-            YGNodeStyleSetPadding,
-            YGNodeStyleSetPaddingPercent);
-      }
-    } else if (key == "paddingRight") {
-      YGValue result = YGValueOrDefault(
-          value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-      SetYogaValueHelper(
-          yogaNode,
-          YGEdgeRight,
-          result,
-          YGNodeStyleSetPadding,
-          YGNodeStyleSetPaddingPercent);
-    } else if (key == "paddingEnd") {
-      if (!shadowNode.ImplementsPadding()) {
-        YGValue result = YGValueOrDefault(
-            value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-        SetYogaValueHelper(
+            KeywordOrDefault(
+                value,
+                YGAlignStretch,
+                {{YogaStyleValue::Stretch, YGAlignStretch},
+                 {YogaStyleValue::FlexStart, YGAlignFlexStart},
+                 {YogaStyleValue::FlexEnd, YGAlignFlexEnd},
+                 {YogaStyleValue::Center, YGAlignCenter},
+                 {YogaStyleValue::Baseline, YGAlignBaseline}}));
+        break;
+      case YogaStyleProp::AlignSelf:
+        YGNodeStyleSetAlignSelf(
             yogaNode,
-            YGEdgeEnd,
-            result,
-            YGNodeStyleSetPadding,
-            YGNodeStyleSetPaddingPercent);
-      }
-    } else if (key == "paddingBottom") {
-      if (!shadowNode.ImplementsPadding()) {
-        YGValue result = YGValueOrDefault(
-            value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-        SetYogaValueHelper(
+            KeywordOrDefault(
+                value,
+                YGAlignAuto,
+                {{YogaStyleValue::Auto, YGAlignAuto},
+                 {YogaStyleValue::Stretch, YGAlignStretch},
+                 {YogaStyleValue::FlexStart, YGAlignFlexStart},
+                 {YogaStyleValue::FlexEnd, YGAlignFlexEnd},
+                 {YogaStyleValue::Center, YGAlignCenter},
+                 {YogaStyleValue::Baseline, YGAlignBaseline}}));
+        break;
+      case YogaStyleProp::AlignContent:
+        YGNodeStyleSetAlignContent(
             yogaNode,
-            YGEdgeBottom,
-            result,
-            YGNodeStyleSetPadding,
-            YGNodeStyleSetPaddingPercent);
-      }
-    } else if (key == "paddingHorizontal") {
-      if (!shadowNode.ImplementsPadding()) {
-        YGValue result = YGValueOrDefault(
-            value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-        SetYogaValueHelper(
+            KeywordOrDefault(
+                value,
+                YGAlignFlexStart,
+                {{YogaStyleValue::Stretch, YGAlignStretch},
+                 {YogaStyleValue::FlexStart, YGAlignFlexStart},
+                 {YogaStyleValue::FlexEnd, YGAlignFlexEnd},
+                 {YogaStyleValue::Center, YGAlignCenter},
+                 {YogaStyleValue::SpaceBetween, YGAlignSpaceBetween},
+                 {YogaStyleValue::SpaceAround, YGAlignSpaceAround}}));
+        break;
+      case YogaStyleProp::Flex:
+        YGNodeStyleSetFlex(yogaNode, NumberOrDefault(value, 0.0f /*default*/));
+        break;
+      case YogaStyleProp::FlexGrow:
+        YGNodeStyleSetFlexGrow(
+            yogaNode, NumberOrDefault(value, 0.0f /*default*/));
+        break;
+      case YogaStyleProp::FlexShrink:
+        YGNodeStyleSetFlexShrink(
+            yogaNode, NumberOrDefault(value, 0.0f /*default*/));
+        break;
+      case YogaStyleProp::FlexBasis:
+        SetYogaUnitValueAutoHelper(
             yogaNode,
-            YGEdgeHorizontal,
-            result,
-            YGNodeStyleSetPadding,
-            YGNodeStyleSetPaddingPercent);
-      }
-    } else if (key == "paddingVertical") {
-      if (!shadowNode.ImplementsPadding()) {
-        YGValue result = YGValueOrDefault(
-            value, YGValue{YGUndefined, YGUnitPoint} /*default*/);
-
-        SetYogaValueHelper(
+            YGValueOrDefault(
+                value, YGValue{YGUndefined, YGUnitPoint} /*default*/),
+            YGNodeStyleSetFlexBasis,
+            YGNodeStyleSetFlexBasisPercent,
+            YGNodeStyleSetFlexBasisAuto);
+        break;
+      case YogaStyleProp::Position:
+        YGNodeStyleSetPositionType(
             yogaNode,
-            YGEdgeVertical,
-            result,
-            YGNodeStyleSetPadding,
-            YGNodeStyleSetPaddingPercent);
-      }
-    } else if (key == "borderWidth") {
-      float result = NumberOrDefault(value, 0.0f /*default*/);
-
-      YGNodeStyleSetBorder(yogaNode, YGEdgeAll, result);
-    } else if (key == "borderLeftWidth") {
-      float result = NumberOrDefault(value, 0.0f /*default*/);
-
-      YGNodeStyleSetBorder(yogaNode, YGEdgeLeft, result);
-    } else if (key == "borderStartWidth") {
-      float result = NumberOrDefault(value, 0.0f /*default*/);
-
-      YGNodeStyleSetBorder(yogaNode, YGEdgeStart, result);
-    } else if (key == "borderTopWidth") {
-      float result = NumberOrDefault(value, 0.0f /*default*/);
-
-      YGNodeStyleSetBorder(yogaNode, YGEdgeTop, result);
-    } else if (key == "borderRightWidth") {
-      float result = NumberOrDefault(value, 0.0f /*default*/);
-
-      YGNodeStyleSetBorder(yogaNode, YGEdgeRight, result);
-    } else if (key == "borderEndWidth") {
-      float result = NumberOrDefault(value, 0.0f /*default*/);
-
-      YGNodeStyleSetBorder(yogaNode, YGEdgeEnd, result);
-    } else if (key == "borderBottomWidth") {
-      float result = NumberOrDefault(value, 0.0f /*default*/);
-
-      YGNodeStyleSetBorder(yogaNode, YGEdgeBottom, result);
+            KeywordOrDefault(
+                value,
+                YGPositionTypeRelative,
+                {{YogaStyleValue::Relative, YGPositionTypeRelative},
+                 {YogaStyleValue::Absolute, YGPositionTypeAbsolute}}));
+        break;
+      case YogaStyleProp::Overflow:
+        YGNodeStyleSetOverflow(
+            yogaNode,
+            KeywordOrDefault(
+                value,
+                YGOverflowVisible,
+                {{YogaStyleValue::Visible, YGOverflowVisible},
+                 {YogaStyleValue::Hidden, YGOverflowHidden},
+                 {YogaStyleValue::Scroll, YGOverflowScroll}}));
+        break;
+      case YogaStyleProp::Display:
+        YGNodeStyleSetDisplay(
+            yogaNode,
+            KeywordOrDefault(
+                value,
+                YGDisplayFlex,
+                {{YogaStyleValue::Flex, YGDisplayFlex},
+                 {YogaStyleValue::None, YGDisplayNone}}));
+        break;
+      case YogaStyleProp::Direction:
+        YGNodeStyleSetDirection(
+            yogaNode,
+            KeywordOrDefault(
+                value,
+                YGDirectionInherit,
+                {{YogaStyleValue::Inherit, YGDirectionInherit},
+                 {YogaStyleValue::Ltr, YGDirectionLTR},
+                 {YogaStyleValue::Rtl, YGDirectionRTL}}));
+        break;
+      case YogaStyleProp::AspectRatio:
+        YGNodeStyleSetAspectRatio(
+            yogaNode, NumberOrDefault(value, 1.0f /*default*/));
+        break;
+      case YogaStyleProp::Left:
+        SetPosition(yogaNode, YGEdgeLeft, value);
+        break;
+      case YogaStyleProp::Top:
+        SetPosition(yogaNode, YGEdgeTop, value);
+        break;
+      case YogaStyleProp::Right:
+        SetPosition(yogaNode, YGEdgeRight, value);
+        break;
+      case YogaStyleProp::Bottom:
+        SetPosition(yogaNode, YGEdgeBottom, value);
+        break;
+      case YogaStyleProp::End:
+        SetPosition(yogaNode, YGEdgeEnd, value);
+        break;
+      case YogaStyleProp::Start:
+        SetPosition(yogaNode, YGEdgeStart, value);
+        break;
+      case YogaStyleProp::Width:
+        SetYogaUnitValueAutoHelper(
+            yogaNode,
+            YGValueOrDefault(
+                value, YGValue{YGUndefined, YGUnitPoint} /*default*/),
+            YGNodeStyleSetWidth,
+            YGNodeStyleSetWidthPercent,
+            YGNodeStyleSetWidthAuto);
+        break;
+      case YogaStyleProp::MinWidth:
+        SetYogaUnitValueHelper(
+            yogaNode,
+            YGValueOrDefault(value, YGValue{0.0f, YGUnitPoint} /*default*/),
+            YGNodeStyleSetMinWidth,
+            YGNodeStyleSetMinWidthPercent);
+        break;
+      case YogaStyleProp::MaxWidth:
+        SetYogaUnitValueHelper(
+            yogaNode,
+            YGValueOrDefault(
+                value, YGValue{YGUndefined, YGUnitPoint} /*default*/),
+            YGNodeStyleSetMaxWidth,
+            YGNodeStyleSetMaxWidthPercent);
+        break;
+      case YogaStyleProp::Height:
+        SetYogaUnitValueAutoHelper(
+            yogaNode,
+            YGValueOrDefault(
+                value, YGValue{YGUndefined, YGUnitPoint} /*default*/),
+            YGNodeStyleSetHeight,
+            YGNodeStyleSetHeightPercent,
+            YGNodeStyleSetHeightAuto);
+        break;
+      case YogaStyleProp::MinHeight:
+        SetYogaUnitValueHelper(
+            yogaNode,
+            YGValueOrDefault(value, YGValue{0.0f, YGUnitPoint} /*default*/),
+            YGNodeStyleSetMinHeight,
+            YGNodeStyleSetMinHeightPercent);
+        break;
+      case YogaStyleProp::MaxHeight:
+        SetYogaUnitValueHelper(
+            yogaNode,
+            YGValueOrDefault(
+                value, YGValue{YGUndefined, YGUnitPoint} /*default*/),
+            YGNodeStyleSetMaxHeight,
+            YGNodeStyleSetMaxHeightPercent);
+        break;
+      case YogaStyleProp::Margin:
+        SetMargin(yogaNode, YGEdgeAll, value);
+        break;
+      case YogaStyleProp::MarginLeft:
+        SetMargin(yogaNode, YGEdgeLeft, value);
+        break;
+      case YogaStyleProp::MarginStart:
+        SetMargin(yogaNode, YGEdgeStart, value);
+        break;
+      case YogaStyleProp::MarginTop:
+        SetMargin(yogaNode, YGEdgeTop, value);
+        break;
+      case YogaStyleProp::MarginRight:
+        SetMargin(yogaNode, YGEdgeRight, value);
+        break;
+      case YogaStyleProp::MarginEnd:
+        SetMargin(yogaNode, YGEdgeEnd, value);
+        break;
+      case YogaStyleProp::MarginBottom:
+        SetMargin(yogaNode, YGEdgeBottom, value);
+        break;
+      case YogaStyleProp::MarginHorizontal:
+        SetMargin(yogaNode, YGEdgeHorizontal, value);
+        break;
+      case YogaStyleProp::MarginVertical:
+        SetMargin(yogaNode, YGEdgeVertical, value);
+        break;
+      case YogaStyleProp::Padding:
+        SetPadding(shadowNode, yogaNode, YGEdgeAll, value);
+        break;
+      case YogaStyleProp::PaddingLeft:
+        SetPadding(shadowNode, yogaNode, YGEdgeLeft, value);
+        break;
+      case YogaStyleProp::PaddingStart:
+        SetPadding(shadowNode, yogaNode, YGEdgeStart, value);
+        break;
+      case YogaStyleProp::PaddingTop:
+        SetPadding(shadowNode, yogaNode, YGEdgeTop, value);
+        break;
+      case YogaStyleProp::PaddingRight:
+        SetPadding(shadowNode, yogaNode, YGEdgeRight, value);
+        break;
+      case YogaStyleProp::PaddingEnd:
+        SetPadding(shadowNode, yogaNode, YGEdgeEnd, value);
+        break;
+      case YogaStyleProp::PaddingBottom:
+        SetPadding(shadowNode, yogaNode, YGEdgeBottom, value);
+        break;
+      case YogaStyleProp::PaddingHorizontal:
+        SetPadding(shadowNode, yogaNode, YGEdgeHorizontal, value);
+        break;
+      case YogaStyleProp::PaddingVertical:
+        SetPadding(shadowNode, yogaNode, YGEdgeVertical, value);
+        break;
+      case YogaStyleProp::BorderWidth:
+        SetBorder(yogaNode, YGEdgeAll, value);
+        break;
+      case YogaStyleProp::BorderLeftWidth:
+        SetBorder(yogaNode, YGEdgeLeft, value);
+        break;
+      case YogaStyleProp::BorderStartWidth:
+        SetBorder(yogaNode, YGEdgeStart, value);
+        break;
+      case YogaStyleProp::BorderTopWidth:
+        SetBorder(yogaNode, YGEdgeTop, value);
+        break;
+      case YogaStyleProp::BorderRightWidth:
+        SetBorder(yogaNode, YGEdgeRight, value);
+        break;
+      case YogaStyleProp::BorderEndWidth:
+        SetBorder(yogaNode, YGEdgeEnd, value);
+        break;
+      case YogaStyleProp::BorderBottomWidth:
+        SetBorder(yogaNode, YGEdgeBottom, value);
+        break;
     }
   }
 }
@@ -909,6 +770,7 @@ void NativeUIManager::CreateView(
     auto result = m_tagsToYogaNodes.emplace(node.m_tag, make_yoga_node());
     if (result.second == true) {
       YGNodeRef yogaNode = result.first->second.get();
+      m_yogaNodesToTags.emplace(yogaNode, node.m_tag);
       StyleYogaNode(node, yogaNode, props);
 
       YGMeasureFunc func = pViewManager->GetYogaCustomMeasureFunc();
@@ -967,8 +829,13 @@ void NativeUIManager::RemoveView(
     }
   }
 
-  m_tagsToYogaNodes.erase(node.m_tag);
+  auto yogaNode = m_tagsToYogaNodes.find(node.m_tag);
+  if (yogaNode != m_tagsToYogaNodes.end()) {
+    m_yogaNodesToTags.erase(yogaNode->second.get());
+    m_tagsToYogaNodes.erase(yogaNode);
+  }
   m_tagsToYogaContext.erase(node.m_tag);
+  m_externalLayoutDirtyTags.erase(node.m_tag);
 }
 
 void NativeUIManager::ReplaceView(facebook::react::ShadowNode &shadowNode) {
@@ -1006,24 +873,27 @@ void NativeUIManager::UpdateView(
   }
 }
 
-void NativeUIManager::UpdateExtraLayout(int64_t tag) {
+void NativeUIManager::UpdateExtraLayout() {
   // For nodes that are not self-measure, there may be styles applied that are
   // applying padding. Here we make sure Yoga knows about that padding so yoga
   // layout is aware of what rendering intends to do with it.  (net: buttons
   // with padding shouldn't have clipped content anymore)
-  ShadowNodeBase *shadowNode =
-      static_cast<ShadowNodeBase *>(m_host->FindShadowNodeForTag(tag));
-  if (shadowNode == nullptr)
-    return;
-
-  if (shadowNode->IsExternalLayoutDirty()) {
-    YGNodeRef yogaNode = GetYogaNode(tag);
-    if (yogaNode)
+  // Only the nodes that marked themselves dirty are visited. Updating the
+  // Yoga node of one marks its root dirty, so the root gets laid out.
+  const auto tags = std::move(m_externalLayoutDirtyTags);
+  m_externalLayoutDirtyTags.clear();
+  for (int64_t tag : tags) {
+    ++m_layoutStatistics.ExternalLayoutNodesVisited;
+    ShadowNodeBase *shadowNode =
+        static_cast<ShadowNodeBase *>(m_host->FindShadowNodeForTag(tag));
+    if (shadowNode == nullptr || !shadowNode->IsExternalLayoutDirty())
+      continue;
+
+    // Nodes whose Yoga node is not created yet are retried next time.
+    if (YGNodeRef yogaNode = GetYogaNode(tag))
       shadowNode->DoExtraLayoutPrep(yogaNode);
-  }
-
-  for (int64_t child : shadowNode->m_children) {
-    UpdateExtraLayout(child);
+    else
+      m_externalLayoutDirtyTags.insert(tag);
   }
 }
 
@@ -1038,13 +908,17 @@ void NativeUIManager::DoLayout() {
   }
   // Values need to be cleared from the vector before next call to DoLayout.
   m_extraLayoutNodes.clear();
+  UpdateExtraLayout();
+
   auto &rootTags = m_host->GetAllRootTags();
   for (int64_t rootTag : rootTags) {
-    UpdateExtraLayout(rootTag);
+    YGNodeRef rootNode = GetYogaNode(rootTag);
+    const bool sizeChanged = m_dirtyRootTags.erase(rootTag) != 0;
+    if (!sizeChanged && !YGNodeIsDirty(rootNode))
+      continue;
 
     ShadowNodeBase &rootShadowNode =
         static_cast<ShadowNodeBase &>(m_host->GetShadowNodeForTag(rootTag));
-    YGNodeRef rootNode = GetYogaNode(rootTag);
     auto rootElement = rootShadowNode.GetView().as<winrt::FrameworkElement>();
 
     float actualWidth = static_cast<float>(rootElement.ActualWidth());
@@ -1052,27 +926,58 @@ void NativeUIManager::DoLayout() {
 
     // TODO: Real direction (VSO 1697992: RTL Layout)
     YGNodeCalculateLayout(rootNode, actualWidth, actualHeight, YGDirectionLTR);
+    ++m_layoutStatistics.RootsLaidOut;
 
-    for (auto &tagToYogaNode : m_tagsToYogaNodes) {
-      int64_t tag = tagToYogaNode.first;
-      YGNodeRef yogaNode = tagToYogaNode.second.get();
-
-      if (!YGNodeGetHasNewLayout(yogaNode))
-        continue;
-      YGNodeSetHasNewLayout(yogaNode, false);
+    ApplyLayout(rootNode);
+  }
+}
 
-      float left = YGNodeLayoutGetLeft(yogaNode);
-      float top = YGNodeLayoutGetTop(yogaNode);
-      float width = YGNodeLayoutGetWidth(yogaNode);
-      float height = YGNodeLayoutGetHeight(yogaNode);
+void ApplyNewLayouts(
+    YGNodeRef rootNode,
+    LayoutStatistics &statistics,
+    const std::function<bool(YGNodeRef)> &apply) {
+  // Yoga sets HasNewLayout on the nodes it laid out again. When it reuses the
+  // cached layout of a node it does not visit the node's children, so the
+  // walk does not need to look below a node without a new layout.
+  std::vector<YGNodeRef> pendingNodes{rootNode};
+  while (!pendingNodes.empty()) {
+    YGNodeRef yogaNode = pendingNodes.back();
+    pendingNodes.pop_back();
+    ++statistics.NodesVisited;
+
+    if (!YGNodeGetHasNewLayout(yogaNode))
+      continue;
+    YGNodeSetHasNewLayout(yogaNode, false);
+
+    const uint32_t childCount = YGNodeGetChildCount(yogaNode);
+    for (uint32_t i = 0; i < childCount; ++i)
+      pendingNodes.push_back(YGNodeGetChild(yogaNode, i));
+
+    if (apply(yogaNode))
+      ++statistics.NodesApplied;
+  }
+}
 
-      ShadowNodeBase &shadowNode =
-          static_cast<ShadowNodeBase &>(m_host->GetShadowNodeForTag(tag));
-      auto view = shadowNode.GetView();
-      auto pViewManager = shadowNode.GetViewManager();
-      pViewManager->SetLayoutProps(shadowNode, view, left, top, width, height);
+void NativeUIManager::ApplyLayout(YGNodeRef rootNode) {
+  ApplyNewLayouts(rootNode, m_layoutStatistics, [this](YGNodeRef yogaNode) {
+    auto tagIter = m_yogaNodesToTags.find(yogaNode);
+    if (tagIter == m_yogaNodesToTags.end()) {
+      assert(false);
+      return false;
     }
-  }
+
+    float left = YGNodeLayoutGetLeft(yogaNode);
+    float top = YGNodeLayoutGetTop(yogaNode);
+    float width = YGNodeLayoutGetWidth(yogaNode);
+    float height = YGNodeLayoutGetHeight(yogaNode);
+
+    ShadowNodeBase &shadowNode = static_cast<ShadowNodeBase &>(
+        m_host->GetShadowNodeForTag(tagIter->second));
+    auto view = shadowNode.GetView();
+    auto pViewManager = shadowNode.GetViewManager();
+    pViewManager->SetLayoutProps(shadowNode, view, left, top, width, height);
+    return true;
+  });
 }
 
 winrt::Windows::Foundation::Rect GetRectOfElementInParentCoords(
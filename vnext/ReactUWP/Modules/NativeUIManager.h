@@ -12,8 +12,11 @@
 #include <folly/dynamic.h>
 #include <yoga/yoga.h>
 
+#include <functional>
 #include <map>
 #include <memory>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace react {
@@ -29,6 +32,24 @@ struct YogaNodeDeleter {
 
 typedef std::unique_ptr<YGNode, YogaNodeDeleter> YogaNodePtr;
 
+// Totals over all DoLayout passes. A node is visited when the layout walk
+// looks at it and applied when its new layout is pushed to its view. External
+// layout nodes are the shadow nodes looked at for DoExtraLayoutPrep.
+struct LayoutStatistics {
+  uint64_t RootsLaidOut = 0;
+  uint64_t NodesVisited = 0;
+  uint64_t NodesApplied = 0;
+  uint64_t ExternalLayoutNodesVisited = 0;
+};
+
+// Calls apply on the nodes under rootNode that Yoga laid out again, and
+// clears their HasNewLayout flags. apply returns whether it applied the
+// layout.
+void ApplyNewLayouts(
+    YGNodeRef rootNode,
+    LayoutStatistics &statistics,
+    const std::function<bool(YGNodeRef)> &apply);
+
 class NativeUIManager : public facebook::react::INativeUIManager {
  public:
   NativeUIManager();
@@ -84,6 +105,11 @@ class NativeUIManager : public facebook::react::INativeUIManager {
 
   // Other public functions
   void DirtyYogaNode(int64_t tag);
+  // Has the next layout call DoExtraLayoutPrep on the shadow node of tag.
+  void MarkExternalLayoutDirty(int64_t tag);
+  const LayoutStatistics &GetLayoutStatistics() const {
+    return m_layoutStatistics;
+  }
   void AddBatchCompletedCallback(std::function<void()> callback);
 
   // For unparented node like Flyout, XamlRoot should be set to handle
@@ -98,7 +124,8 @@ class NativeUIManager : public facebook::react::INativeUIManager {
 
  private:
   void DoLayout();
-  void UpdateExtraLayout(int64_t tag);
+  void ApplyLayout(YGNodeRef rootNode);
+  void UpdateExtraLayout();
   YGNodeRef GetYogaNode(int64_t tag) const;
 
   std::weak_ptr<react::uwp::IXamlReactControl> GetParentXamlReactControl(
@@ -109,11 +136,18 @@ class NativeUIManager : public facebook::react::INativeUIManager {
   bool m_inBatch = false;
 
   std::map<int64_t, YogaNodePtr> m_tagsToYogaNodes;
+  std::unordered_map<YGNodeRef, int64_t> m_yogaNodesToTags;
+  // Roots whose size changed since their last layout. Other changes are
+  // tracked by Yoga, which marks the root node dirty.
+  std::set<int64_t> m_dirtyRootTags;
+  LayoutStatistics m_layoutStatistics;
   std::map<int64_t, std::unique_ptr<YogaContext>> m_tagsToYogaContext;
   std::vector<winrt::Windows::UI::Xaml::FrameworkElement::SizeChanged_revoker>
       m_sizeChangedVector;
   std::vector<std::function<void()>> m_batchCompletedCallbacks;
   std::vector<int64_t> m_extraLayoutNodes;
+  // Nodes whose external layout changed since the last layout.
+  std::set<int64_t> m_externalLayoutDirtyTags;
 
   std::map<int64_t, std::weak_ptr<IXamlReactControl>> m_tagsToXamlReactControl;
 };
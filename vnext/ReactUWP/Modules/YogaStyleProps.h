@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Utils/StaticStringMap.h"
+
+namespace react {
+namespace uwp {
+
+// The style props NativeUIManager applies to Yoga nodes.
+enum class YogaStyleProp : uint8_t {
+  FlexDirection,
+  JustifyContent,
+  FlexWrap,
+  AlignItems,
+  AlignSelf,
+  AlignContent,
+  Flex,
+  FlexGrow,
+  FlexShrink,
+  FlexBasis,
+  Position,
+  Overflow,
+  Display,
+  Direction,
+  AspectRatio,
+  Left,
+  Top,
+  Right,
+  Bottom,
+  End,
+  Start,
+  Width,
+  MinWidth,
+  MaxWidth,
+  Height,
+  MinHeight,
+  MaxHeight,
+  Margin,
+  MarginLeft,
+  MarginStart,
+  MarginTop,
+  MarginRight,
+  MarginEnd,
+  MarginBottom,
+  MarginHorizontal,
+  MarginVertical,
+  Padding,
+  PaddingLeft,
+  PaddingStart,
+  PaddingTop,
+  PaddingRight,
+  PaddingEnd,
+  PaddingBottom,
+  PaddingHorizontal,
+  PaddingVertical,
+  BorderWidth,
+  BorderLeftWidth,
+  BorderStartWidth,
+  BorderTopWidth,
+  BorderRightWidth,
+  BorderEndWidth,
+  BorderBottomWidth,
+};
+
+constexpr StaticStringMapEntry<YogaStyleProp> YogaStylePropEntries[] = {
+    {"flexDirection", YogaStyleProp::FlexDirection},
+    {"justifyContent", YogaStyleProp::JustifyContent},
+    {"flexWrap", YogaStyleProp::FlexWrap},
+    {"alignItems", YogaStyleProp::AlignItems},
+    {"alignSelf", YogaStyleProp::AlignSelf},
+    {"alignContent", YogaStyleProp::AlignContent},
+    {"flex", YogaStyleProp::Flex},
+    {"flexGrow", YogaStyleProp::FlexGrow},
+    {"flexShrink", YogaStyleProp::FlexShrink},
+    {"flexBasis", YogaStyleProp::FlexBasis},
+    {"position", YogaStyleProp::Position},
+    {"overflow", YogaStyleProp::Overflow},
+    {"display", YogaStyleProp::Display},
+    {"direction", YogaStyleProp::Direction},
+    {"aspectRatio", YogaStyleProp::AspectRatio},
+    {"left", YogaStyleProp::Left},
+    {"top", YogaStyleProp::Top},
+    {"right", YogaStyleProp::Right},
+    {"bottom", YogaStyleProp::Bottom},
+    {"end", YogaStyleProp::End},
+    {"start", YogaStyleProp::Start},
+    {"width", YogaStyleProp::Width},
+    {"minWidth", YogaStyleProp::MinWidth},
+    {"maxWidth", YogaStyleProp::MaxWidth},
+    {"height", YogaStyleProp::Height},
+    {"minHeight", YogaStyleProp::MinHeight},
+    {"maxHeight", YogaStyleProp::MaxHeight},
+    {"margin", YogaStyleProp::Margin},
+    {"marginLeft", YogaStyleProp::MarginLeft},
+    {"marginStart", YogaStyleProp::MarginStart},
+    {"marginTop", YogaStyleProp::MarginTop},
+    {"marginRight", YogaStyleProp::MarginRight},
+    {"marginEnd", YogaStyleProp::MarginEnd},
+    {"marginBottom", YogaStyleProp::MarginBottom},
+    {"marginHorizontal", YogaStyleProp::MarginHorizontal},
+    {"marginVertical", YogaStyleProp::MarginVertical},
+    {"padding", YogaStyleProp::Padding},
+    {"paddingLeft", YogaStyleProp::PaddingLeft},
+    {"paddingStart", YogaStyleProp::PaddingStart},
+    {"paddingTop", YogaStyleProp::PaddingTop},
+    {"paddingRight", YogaStyleProp::PaddingRight},
+    {"paddingEnd", YogaStyleProp::PaddingEnd},
+    {"paddingBottom", YogaStyleProp::PaddingBottom},
+    {"paddingHorizontal", YogaStyleProp::PaddingHorizontal},
+    {"paddingVertical", YogaStyleProp::PaddingVertical},
+    {"borderWidth", YogaStyleProp::BorderWidth},
+    {"borderLeftWidth", YogaStyleProp::BorderLeftWidth},
+    {"borderStartWidth", YogaStyleProp::BorderStartWidth},
+    {"borderTopWidth", YogaStyleProp::BorderTopWidth},
+    {"borderRightWidth", YogaStyleProp::BorderRightWidth},
+    {"borderEndWidth", YogaStyleProp::BorderEndWidth},
+    {"borderBottomWidth", YogaStyleProp::BorderBottomWidth},
+};
+
+constexpr StaticStringMap<YogaStyleProp, 128> YogaStyleProps(
+    93350 /*seed*/,
+    YogaStylePropEntries);
+static_assert(YogaStyleProps.isPerfect(), "Pick a new seed for YogaStyleProps");
+
+// The keyword values of the enum style props, interned so each prop only
+// switches over small integers.
+enum class YogaStyleValue : uint8_t {
+  Column,
+  Row,
+  ColumnReverse,
+  RowReverse,
+  FlexStart,
+  FlexEnd,
+  Center,
+  SpaceBetween,
+  SpaceAround,
+  SpaceEvenly,
+  NoWrap,
+  Wrap,
+  Stretch,
+  Baseline,
+  Auto,
+  Relative,
+  Absolute,
+  Visible,
+  Hidden,
+  Scroll,
+  Flex,
+  None,
+  Inherit,
+  Ltr,
+  Rtl,
+};
+
+constexpr StaticStringMapEntry<YogaStyleValue> YogaStyleValueEntries[] = {
+    {"column", YogaStyleValue::Column},
+    {"row", YogaStyleValue::Row},
+    {"column-reverse", YogaStyleValue::ColumnReverse},
+    {"row-reverse", YogaStyleValue::RowReverse},
+    {"flex-start", YogaStyleValue::FlexStart},
+    {"flex-end", YogaStyleValue::FlexEnd},
+    {"center", YogaStyleValue::Center},
+    {"space-between", YogaStyleValue::SpaceBetween},
+    {"space-around", YogaStyleValue::SpaceAround},
+    {"space-evenly", YogaStyleValue::SpaceEvenly},
+    {"nowrap", YogaStyleValue::NoWrap},
+    {"wrap", YogaStyleValue::Wrap},
+    {"stretch", YogaStyleValue::Stretch},
+    {"baseline", YogaStyleValue::Baseline},
+    {"auto", YogaStyleValue::Auto},
+    {"relative", YogaStyleValue::Relative},
+    {"absolute", YogaStyleValue::Absolute},
+    {"visible", YogaStyleValue::Visible},
+    {"hidden", YogaStyleValue::Hidden},
+    {"scroll", YogaStyleValue::Scroll},
+    {"flex", YogaStyleValue::Flex},
+    {"none", YogaStyleValue::None},
+    {"inherit", YogaStyleValue::Inherit},
+    {"ltr", YogaStyleValue::Ltr},
+    {"rtl", YogaStyleValue::Rtl},
+};
+
+constexpr StaticStringMap<YogaStyleValue, 64> YogaStyleValues(
+    477 /*seed*/,
+    YogaStyleValueEntries);
+static_assert(
+    YogaStyleValues.isPerfect(),
+    "Pick a new seed for YogaStyleValues");
+
+} // namespace uwp
+} // namespace react
@@ -51,6 +51,7 @@ void ContentControlShadowNode::createView() {
             winrt::Windows::UI::Xaml::DependencyObject const &sender,
             winrt::Windows::UI::Xaml::DependencyProperty const &dp) {
           m_paddingDirty = true;
+          MarkExternalLayoutDirty();
         });
   }
 }
@@ -11,15 +11,22 @@ namespace react {
 namespace uwp {
 
 BatchingUIMessageQueueThread::BatchingUIMessageQueueThread(
-    winrt::Windows::UI::Core::CoreDispatcher dispatcher)
-    : m_uiDispatcher(dispatcher) {}
+    winrt::Windows::UI::Core::CoreDispatcher dispatcher,
+    std::chrono::milliseconds frameBudget)
+    : m_batches(std::make_shared<facebook::react::UIBatchQueue>(
+          [dispatcher](std::function<void()> &&func) {
+            dispatcher.RunAsync(
+                winrt::Windows::UI::Core::CoreDispatcherPriority::Normal,
+                [func{std::move(func)}]() { func(); });
+          },
+          frameBudget)) {}
 
 BatchingUIMessageQueueThread::~BatchingUIMessageQueueThread() {}
 
 void BatchingUIMessageQueueThread::runOnQueue(std::function<void()> &&func) {
   threadCheck();
   ensureQueue();
-  m_queue->emplace_back(std::move(func));
+  m_queue.emplace_back(std::move(func));
 
 //#define TRACK_UI_CALLS
 #ifdef TRACK_UI_CALLS
@@ -46,25 +53,20 @@ void BatchingUIMessageQueueThread::threadCheck() {
 }
 
 void BatchingUIMessageQueueThread::ensureQueue() {
-  if (m_queue == nullptr) {
-    m_queue = std::make_unique<WorkItemQueue>();
-    m_queue->reserve(2048);
+  if (m_queue.empty()) {
+    m_queue.reserve(2048);
   }
 }
 
 void BatchingUIMessageQueueThread::onBatchComplete() {
   threadCheck();
-  std::shared_ptr<WorkItemQueue> queue = m_queue;
-  m_queue = nullptr;
-  if (queue) {
-    m_uiDispatcher.RunAsync(
-        winrt::Windows::UI::Core::CoreDispatcherPriority::Normal,
-        [queue{std::move(queue)}]() {
-          for (auto &func : *queue) {
-            func();
-          }
-        });
-  }
+  m_batches->Submit(std::move(m_queue));
+  m_queue.clear();
+}
+
+facebook::react::UIBatchQueue::Stats
+BatchingUIMessageQueueThread::GetBatchStats() const {
+  return m_batches->GetStats();
 }
 
 void BatchingUIMessageQueueThread::runOnQueueSync(
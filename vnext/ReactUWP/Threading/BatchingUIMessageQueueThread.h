@@ -4,12 +4,16 @@
 #pragma once
 
 #include <ReactWindowsCore/BatchingMessageQueueThread.h>
+#include <ReactWindowsCore/UIBatchQueue.h>
 #include <winrt/Windows.UI.Core.h>
 
+#include <chrono>
+
 namespace react {
 namespace uwp {
 
-// Executes the function on the provided UI Dispatcher
+// Executes the function on the provided UI Dispatcher. With a frame budget,
+// large batches are spread over several dispatcher callbacks.
 class BatchingUIMessageQueueThread
     : public facebook::react::BatchingMessageQueueThread {
  public:
@@ -18,7 +22,8 @@ class BatchingUIMessageQueueThread
       delete;
 
   BatchingUIMessageQueueThread(
-      winrt::Windows::UI::Core::CoreDispatcher dispatcher);
+      winrt::Windows::UI::Core::CoreDispatcher dispatcher,
+      std::chrono::milliseconds frameBudget = {});
   virtual ~BatchingUIMessageQueueThread();
 
   virtual void runOnQueue(std::function<void()> &&func);
@@ -27,15 +32,15 @@ class BatchingUIMessageQueueThread
 
   void onBatchComplete() override;
 
+  facebook::react::UIBatchQueue::Stats GetBatchStats() const;
+
  private:
   void ensureQueue();
   void threadCheck();
 
  private:
-  winrt::Windows::UI::Core::CoreDispatcher m_uiDispatcher{nullptr};
-
-  typedef std::vector<std::function<void()>> WorkItemQueue;
-  std::shared_ptr<WorkItemQueue> m_queue;
+  std::shared_ptr<facebook::react::UIBatchQueue> m_batches;
+  facebook::react::UIBatchQueue::WorkItems m_queue;
 
 #if DEBUG
   DWORD m_expectedThreadId = 0;
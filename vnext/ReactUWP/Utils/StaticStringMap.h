@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace react {
+namespace uwp {
+
+template <typename T>
+struct StaticStringMapEntry {
+  std::string_view key;
+  T value;
+};
+
+// Map from a fixed set of strings to values, built at compile time as a
+// perfect hash table: the seed is chosen so that every key hashes to its own
+// slot, and a lookup costs one hash of the key and one string comparison.
+// Declare instances constexpr and static_assert on isPerfect(), so that a key
+// added later that collides under the seed breaks the build instead of
+// shadowing another key; pick a new seed (or a larger TSize) when it does.
+template <typename T, size_t TSize>
+class StaticStringMap {
+  static_assert((TSize & (TSize - 1)) == 0, "TSize must be a power of two");
+
+ public:
+  template <size_t N>
+  constexpr StaticStringMap(
+      uint32_t seed,
+      const StaticStringMapEntry<T> (&entries)[N])
+      : m_seed(seed) {
+    static_assert(N <= TSize, "Too many entries for the table size");
+    for (const auto &entry : entries) {
+      auto &slot = m_slots[Index(entry.key)];
+      if (!slot.key.empty() || entry.key.empty())
+        m_perfect = false;
+      slot = entry;
+    }
+  }
+
+  constexpr bool isPerfect() const {
+    return m_perfect;
+  }
+
+  // Returns the value of key, or nullptr if key is not in the map.
+  const T *find(std::string_view key) const {
+    const auto &slot = m_slots[Index(key)];
+    if (slot.key.empty() || slot.key != key)
+      return nullptr;
+    return &slot.value;
+  }
+
+ private:
+  // FNV-1a, with the high bits folded into the slot index.
+  constexpr size_t Index(std::string_view key) const {
+    uint32_t hash = 2166136261u ^ m_seed;
+    for (char c : key) {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 16777619u;
+    }
+    return (hash ^ (hash >> 16)) & (TSize - 1);
+  }
+
+  uint32_t m_seed;
+  std::array<StaticStringMapEntry<T>, TSize> m_slots{};
+  bool m_perfect = true;
+};
+
+} // namespace uwp
+} // namespace react
@@ -6,19 +6,27 @@
 #include "ReactImage.h"
 
 #include <winrt/Windows.Security.Cryptography.h>
+#include <winrt/Windows.Storage.h>
+#include <winrt/Windows.System.Threading.h>
 #include <winrt/Windows.Web.Http.h>
 
+#include <atomic>
+
 #include "Unicode.h"
 
 namespace winrt {
 using namespace Windows::Foundation;
+using namespace Windows::Security::Cryptography;
+using namespace Windows::Storage;
 using namespace Windows::Storage::Streams;
+using namespace Windows::System::Threading;
 using namespace Windows::UI;
 using namespace Windows::UI::Xaml::Media;
 using namespace Windows::Web::Http;
 } // namespace winrt
 
 using Microsoft::Common::Unicode::Utf8ToUtf16;
+using Microsoft::React::ImageCache;
 
 #if _MSC_VER <= 1913
 // VC 19 (2015-2017.6) cannot optimize co_await/cppwinrt usage
@@ -114,41 +122,143 @@ winrt::fire_and_forget ReactImage::Source(ImageSource source) {
   }
 } // namespace uwp
 
-winrt::IAsyncOperation<winrt::InMemoryRandomAccessStream> GetImageStreamAsync(
-    ImageSource source) {
+namespace {
+
+winrt::fire_and_forget FetchImageAsync(
+    winrt::HttpClient httpClient,
+    ImageCache::Request request,
+    ImageCache::Callback done) {
+  ImageCache::Bytes bytes;
   try {
-    co_await winrt::resume_background();
+    winrt::HttpRequestMessage message{
+        winrt::HttpMethod{Utf8ToUtf16(request.method)},
+        winrt::Uri{Utf8ToUtf16(request.uri)}};
+
+    for (const auto &header : request.headers) {
+      const std::string &name{header.first};
+      const std::string &value{header.second};
+
+      if (_stricmp(name.c_str(), "authorization") == 0) {
+        message.Headers().TryAppendWithoutValidation(
+            Utf8ToUtf16(name), Utf8ToUtf16(value));
+      } else {
+        message.Headers().Append(Utf8ToUtf16(name), Utf8ToUtf16(value));
+      }
+    }
 
-    auto httpMethod{source.method.empty()
-                        ? winrt::HttpMethod::Get()
-                        : winrt::HttpMethod{Utf8ToUtf16(source.method)}};
+    winrt::HttpResponseMessage response{
+        co_await httpClient.SendRequestAsync(message)};
 
-    winrt::Uri uri{Utf8ToUtf16(source.uri)};
-    winrt::HttpRequestMessage request{httpMethod, uri};
+    if (response.StatusCode() == winrt::HttpStatusCode::Ok) {
+      winrt::IBuffer buffer{co_await response.Content().ReadAsBufferAsync()};
+      winrt::com_array<uint8_t> data;
+      winrt::CryptographicBuffer::CopyToByteArray(buffer, data);
+      bytes = std::make_shared<const std::vector<uint8_t>>(
+          data.begin(), data.end());
+    }
+  } catch (...) {
+    // Such as a URI or header that is not valid UTF-8. done must still be
+    // called, or the image stays pending for everyone who asks for it later.
+  }
 
-    if (!source.headers.empty()) {
-      for (auto &header : source.headers.items()) {
-        const std::string &name{header.first.getString()};
-        const std::string &value{header.second.getString()};
+  done(std::move(bytes));
+}
 
-        if (_stricmp(name.c_str(), "authorization") == 0) {
-          request.Headers().TryAppendWithoutValidation(
-              Utf8ToUtf16(name), Utf8ToUtf16(value));
-        } else {
-          request.Headers().Append(Utf8ToUtf16(name), Utf8ToUtf16(value));
-        }
-      }
-    }
+std::string ImageCacheDirectory() {
+  try {
+    return winrt::to_string(
+               winrt::ApplicationData::Current().LocalCacheFolder().Path()) +
+        "\\ImageCache\\";
+  } catch (winrt::hresult_error const &) {
+    // Not a packaged app. Images are only cached in memory.
+    return {};
+  }
+}
 
+// Resumes a coroutine with the bytes of an image once the cache has them,
+// without blocking a thread while they are downloaded. The coroutine resumes
+// on the thread pool, as the cache may call back before await_suspend
+// returns.
+struct ImageCacheAwaiter {
+  std::shared_ptr<ImageCache> cache;
+  ImageCache::Request request;
+  ImageCache::Bytes bytes;
+
+  bool await_ready() {
+    bytes = cache->Find(request);
+    return bytes != nullptr;
+  }
+
+  void await_suspend(std::experimental::coroutine_handle<> handle) {
+    cache->Get(request, [this, handle](ImageCache::Bytes result) {
+      bytes = std::move(result);
+      winrt::ThreadPool::RunAsync(
+          [handle](winrt::IAsyncAction const &) { handle(); });
+    });
+  }
+
+  ImageCache::Bytes await_resume() {
+    return std::move(bytes);
+  }
+};
+
+std::atomic_bool s_diskCacheEnabled{false};
+
+} // namespace
+
+void EnableImageDiskCache() noexcept {
+  s_diskCacheEnabled = true;
+}
+
+std::shared_ptr<ImageCache> GetImageCache() {
+  // Never destroyed, so that its HttpClient is not released as the process
+  // exits.
+  static auto cache = new std::shared_ptr<ImageCache>([] {
+    ImageCache::Options options;
+    if (s_diskCacheEnabled)
+      options.diskDirectory = ImageCacheDirectory();
+
+    // One client for every image, so that connections to a server are reused.
     winrt::HttpClient httpClient;
-    winrt::HttpResponseMessage response{
-        co_await httpClient.SendRequestAsync(request)};
+    return std::make_shared<ImageCache>(
+        std::move(options),
+        [httpClient](
+            const ImageCache::Request &request, ImageCache::Callback &&done) {
+          FetchImageAsync(httpClient, request, std::move(done));
+        });
+  }());
+  return *cache;
+}
 
-    if (response.StatusCode() == winrt::HttpStatusCode::Ok) {
-      winrt::IInputStream inputStream{
-          co_await response.Content().ReadAsInputStreamAsync()};
+ImageCache::Request MakeImageCacheRequest(const ImageSource &source) {
+  ImageCache::Request request;
+  request.uri = source.uri;
+  if (!source.method.empty()) {
+    request.method = source.method;
+  }
+
+  if (source.headers.isObject()) {
+    for (auto &header : source.headers.items()) {
+      request.headers.emplace(
+          header.first.getString(), header.second.getString());
+    }
+  }
+
+  return request;
+}
+
+winrt::IAsyncOperation<winrt::InMemoryRandomAccessStream> GetImageStreamAsync(
+    ImageSource source) {
+  try {
+    co_await winrt::resume_background();
+
+    ImageCache::Bytes bytes = co_await ImageCacheAwaiter{
+        GetImageCache(), MakeImageCacheRequest(source)};
+
+    if (bytes) {
       winrt::InMemoryRandomAccessStream memoryStream;
-      co_await winrt::RandomAccessStream::CopyAsync(inputStream, memoryStream);
+      co_await memoryStream.WriteAsync(
+          winrt::CryptographicBuffer::CreateFromByteArray(*bytes));
       memoryStream.Seek(0);
 
       return memoryStream;
@@ -11,6 +11,7 @@
 #include <winrt/Windows.UI.Xaml.Media.h>
 #include <winrt/Windows.UI.Xaml.h>
 
+#include <ImageCache.h>
 #include <folly/dynamic.h>
 
 namespace react {
@@ -70,6 +71,17 @@ struct ReactImage : winrt::Windows::UI::Xaml::Controls::CanvasT<ReactImage> {
 };
 
 // Helper functions
+
+// The cache the images of Image components and of the ImageLoader module are
+// downloaded through, shared by every instance in the process.
+std::shared_ptr<Microsoft::React::ImageCache> GetImageCache();
+
+// Keeps the images of the cache on disk as well, from one session to the
+// next. Only takes effect before the cache is first used.
+void EnableImageDiskCache() noexcept;
+Microsoft::React::ImageCache::Request MakeImageCacheRequest(
+    const ImageSource &source);
+
 winrt::Windows::Foundation::IAsyncOperation<
     winrt::Windows::Storage::Streams::InMemoryRandomAccessStream>
 GetImageStreamAsync(ImageSource source);
@@ -93,6 +93,15 @@ void ShadowNodeBase::ReparentView(XamlView view) {
   ReplaceView(view);
 }
 
+void ShadowNodeBase::MarkExternalLayoutDirty() {
+  if (const auto instance = GetViewManager()->GetReactInstance().lock()) {
+    if (const auto nativeUIManager =
+            static_cast<NativeUIManager *>(instance->NativeUIManager())) {
+      nativeUIManager->MarkExternalLayoutDirty(m_tag);
+    }
+  }
+}
+
 winrt::Windows::UI::Composition::CompositionPropertySet
 ShadowNodeBase::EnsureTransformPS() {
   if (m_transformPS == nullptr) {
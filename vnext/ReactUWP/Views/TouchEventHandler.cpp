@@ -366,12 +366,9 @@ void TouchEventHandler::DispatchTouchEvent(
   const char *eventName = GetTouchEventTypeName(eventType);
   if (eventName == nullptr)
     return;
-  folly::dynamic params = folly::dynamic::array(
-      eventName, std::move(touches), std::move(changedIndices));
-
   auto instance = m_wkReactInstance.lock();
-  instance->CallJsFunction(
-      "RCTEventEmitter", "receiveTouches", std::move(params));
+  instance->DispatchTouchEvent(
+      eventName, std::move(touches), std::move(changedIndices));
 }
 
 const char *TouchEventHandler::GetPointerDeviceTypeName(
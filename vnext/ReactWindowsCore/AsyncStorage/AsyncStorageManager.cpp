@@ -10,10 +10,12 @@ using namespace facebook::xplat;
 namespace facebook {
 namespace react {
 const folly::dynamic noError;
-const std::vector<folly::dynamic> noErrorVector = {noError};
 
-AsyncStorageManager::AsyncStorageManager(const WCHAR *storageFileName)
+AsyncStorageManager::AsyncStorageManager(
+    const WCHAR *storageFileName,
+    std::chrono::milliseconds maxBatchLatency)
     : m_aofKVStorage{make_unique<KeyValueStorage>(storageFileName)},
+      m_maxBatchLatency{maxBatchLatency},
       m_stopConsumer{false},
       m_consumerTask{std::async(
           std::launch::async,
@@ -43,21 +45,54 @@ void AsyncStorageManager::putRequestOnQueue(
 
 void AsyncStorageManager::consumeSetRequest() noexcept {
   while (!m_stopConsumer) {
-    std::unique_lock<std::mutex> uniqueMutex(m_setQueueMutex);
-    m_storageQueueConditionVariable.wait(uniqueMutex, [this] {
-      return m_stopConsumer || !m_asyncQueue.empty();
-    });
-
-    if (!m_asyncQueue.empty()) {
-      std::unique_ptr<AsyncRequestQueueArguments> arguments =
-          std::move(m_asyncQueue.front());
-      m_asyncQueue.pop();
+    std::queue<std::unique_ptr<AsyncRequestQueueArguments>> batch;
+    {
+      std::unique_lock<std::mutex> uniqueMutex(m_setQueueMutex);
+      m_storageQueueConditionVariable.wait(uniqueMutex, [this] {
+        return m_stopConsumer || !m_asyncQueue.empty();
+      });
+
+      if (m_asyncQueue.empty())
+        continue;
+
+      if (m_maxBatchLatency > std::chrono::milliseconds::zero()) {
+        m_storageQueueConditionVariable.wait_for(
+            uniqueMutex, m_maxBatchLatency, [this] {
+              return m_stopConsumer.load();
+            });
+      }
+
+      std::swap(batch, m_asyncQueue);
+    }
 
-      uniqueMutex.unlock();
+    // Each operation only fails on its own; the callbacks wait for the
+    // commit, which fails every operation of the batch if it does not go
+    // through.
+    std::vector<std::pair<module::CxxModule::Callback, folly::dynamic>>
+        results;
+    results.reserve(batch.size());
+    m_aofKVStorage->beginBatch();
+    for (; !batch.empty(); batch.pop()) {
+      auto &arguments = batch.front();
+      folly::dynamic error = noError;
+      try {
+        executeAsyncKVOperation(arguments->m_operation, arguments->m_args);
+      } catch (std::exception &e) {
+        error = makeError(e.what());
+      }
+      results.emplace_back(std::move(arguments->m_jsCallback), error);
+    }
 
-      executeAsyncKVOperation(
-          arguments->m_operation, arguments->m_args, arguments->m_jsCallback);
+    try {
+      m_aofKVStorage->commitBatch();
+    } catch (std::exception &e) {
+      folly::dynamic error = makeError(e.what());
+      for (auto &result : results)
+        result.second = error;
     }
+
+    for (auto &result : results)
+      result.first({result.second});
   }
 }
 
@@ -92,34 +127,26 @@ void AsyncStorageManager::executeKVOperation(
 
 void AsyncStorageManager::executeAsyncKVOperation(
     AsyncStorageOperation operation,
-    const dynamic &args,
-    const module::CxxModule::Callback &jsCallback) noexcept {
-  try {
-    switch (operation) {
-      case AsyncStorageOperation::multiSet:
-        multiSetInternal(args, jsCallback);
-        break;
-
-      case AsyncStorageOperation::multiRemove:
-        multiRemoveInternal(args, jsCallback);
-        break;
-
-      case AsyncStorageOperation::clear:
-        clearInternal(args, jsCallback);
-        break;
-
-      case AsyncStorageOperation::multiMerge:
-        multiMergeInternal(args, jsCallback);
-        break;
-
-      default:
-        [this, jsCallback] {
-          jsCallback({makeError("Invalid AsyncStorage operation")});
-        };
-        break;
-    }
-  } catch (std::exception &e) {
-    jsCallback({makeError(e.what())});
+    const dynamic &args) {
+  switch (operation) {
+    case AsyncStorageOperation::multiSet:
+      multiSetInternal(args);
+      break;
+
+    case AsyncStorageOperation::multiRemove:
+      multiRemoveInternal(args);
+      break;
+
+    case AsyncStorageOperation::clear:
+      clearInternal(args);
+      break;
+
+    case AsyncStorageOperation::multiMerge:
+      multiMergeInternal(args);
+      break;
+
+    default:
+      throw std::exception("Invalid AsyncStorage operation");
   }
 }
 
@@ -134,35 +161,23 @@ void AsyncStorageManager::multiGetInternal(
   jsCallback({noError, jsRetVal});
 }
 
-void AsyncStorageManager::multiSetInternal(
-    const dynamic &args,
-    const module::CxxModule::Callback &jsCallback) {
+void AsyncStorageManager::multiSetInternal(const dynamic &args) {
   m_aofKVStorage->multiSet(
       FollyDynamicConverter::jsArgAsTupleStringVector(args));
-  jsCallback(noErrorVector);
 }
 
-void AsyncStorageManager::multiRemoveInternal(
-    const dynamic &args,
-    const module::CxxModule::Callback &jsCallback) {
+void AsyncStorageManager::multiRemoveInternal(const dynamic &args) {
   m_aofKVStorage->multiRemove(FollyDynamicConverter::jsArgAsStringVector(args));
-  jsCallback(noErrorVector);
 }
 
-void AsyncStorageManager::clearInternal(
-    const dynamic &args,
-    const module::CxxModule::Callback &jsCallback) {
+void AsyncStorageManager::clearInternal(const dynamic &args) {
   UNREFERENCED_PARAMETER(args);
   m_aofKVStorage->clear();
-  jsCallback(noErrorVector);
 }
 
-void AsyncStorageManager::multiMergeInternal(
-    const dynamic &args,
-    const module::CxxModule::Callback &jsCallback) {
+void AsyncStorageManager::multiMergeInternal(const dynamic &args) {
   m_aofKVStorage->multiMerge(
       FollyDynamicConverter::jsArgAsTupleStringVector(args));
-  jsCallback(noErrorVector);
 }
 
 void AsyncStorageManager::getAllKeysInternal(
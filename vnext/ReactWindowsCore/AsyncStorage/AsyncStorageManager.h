@@ -8,15 +8,27 @@
 #include <cxxreact/CxxModule.h>
 #include <folly/dynamic.h>
 
+#include <chrono>
 #include <condition_variable>
 #include <future>
 #include <queue>
 
 namespace facebook {
 namespace react {
+// Runs AsyncStorage operations for the AsyncStorage module. Reads run on the
+// calling thread. Writes are queued to a consumer thread, which takes every
+// queued write at once and commits them to the storage as one batch: each
+// key changed by the batch is written once, with one append and one flush,
+// and the callbacks run after that commit. Reads only see a batch once it is
+// committed, and a batch whose commit fails is dropped. maxBatchLatency lets
+// the consumer wait that long after a write arrives for more to join its
+// batch.
 class AsyncStorageManager {
  public:
-  AsyncStorageManager(const WCHAR *storageFileName);
+  AsyncStorageManager(
+      const WCHAR *storageFileName,
+      std::chrono::milliseconds maxBatchLatency =
+          std::chrono::milliseconds::zero());
   ~AsyncStorageManager();
 
   enum class AsyncStorageOperation {
@@ -48,21 +60,23 @@ class AsyncStorageManager {
   };
 
  private:
+  std::unique_ptr<KeyValueStorage> m_aofKVStorage;
+  const std::chrono::milliseconds m_maxBatchLatency;
   std::atomic_bool m_stopConsumer;
   std::mutex m_setQueueMutex;
   std::condition_variable m_storageQueueConditionVariable;
-  std::future<void> m_consumerTask;
   std::queue<std::unique_ptr<AsyncStorageManager::AsyncRequestQueueArguments>>
       m_asyncQueue;
-  std::unique_ptr<KeyValueStorage> m_aofKVStorage;
+  // Declared last, so the consumer only starts once the members it uses are
+  // constructed.
+  std::future<void> m_consumerTask;
 
  private:
   folly::dynamic makeError(std::string &&strErrorMessage) noexcept;
 
   void executeAsyncKVOperation(
       AsyncStorageOperation operation,
-      const folly::dynamic &args,
-      const xplat::module::CxxModule::Callback &jsCallback) noexcept;
+      const folly::dynamic &args);
 
   void consumeSetRequest() noexcept;
   void putRequestOnQueue(
@@ -73,18 +87,10 @@ class AsyncStorageManager {
   void multiGetInternal(
       const folly::dynamic &args,
       const xplat::module::CxxModule::Callback &jsCallback);
-  void multiSetInternal(
-      const folly::dynamic &args,
-      const xplat::module::CxxModule::Callback &jsCallback);
-  void multiRemoveInternal(
-      const folly::dynamic &args,
-      const xplat::module::CxxModule::Callback &jsCallback);
-  void clearInternal(
-      const folly::dynamic &args,
-      const xplat::module::CxxModule::Callback &jsCallback);
-  void multiMergeInternal(
-      const folly::dynamic &args,
-      const xplat::module::CxxModule::Callback &jsCallback);
+  void multiSetInternal(const folly::dynamic &args);
+  void multiRemoveInternal(const folly::dynamic &args);
+  void clearInternal(const folly::dynamic &args);
+  void multiMergeInternal(const folly::dynamic &args);
   void getAllKeysInternal(
       const folly::dynamic &args,
       const xplat::module::CxxModule::Callback &jsCallback);
@@ -4,113 +4,429 @@
 #include "pch.h"
 
 #include <AsyncStorage/KeyValueStorage.h>
+#include <folly/json.h>
 
 using namespace std;
 
 namespace facebook {
 namespace react {
 
-KeyValueStorage::KeyValueStorage(const WCHAR *storageFileName)
-    : m_fileIOHelper{make_unique<StorageFileIO>(storageFileName)},
-      m_kvMap{map<string, string>()} {
-  // start the load procedure
-  m_storageFileLoaded = CreateEventEx(
+namespace {
+
+constexpr uint32_t IndexMagic = 0x494b4e52; // "RNKI"
+constexpr uint32_t IndexVersion = 1;
+
+// The index file is this header followed by count uint64_t record offsets,
+// sorted by the key of the record they point to.
+struct IndexHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t generation; // of the log the offsets point into
+  uint64_t logSize; // records past this offset are not indexed
+  uint64_t count;
+  uint32_t crc; // of the offsets
+  uint32_t reserved;
+};
+static_assert(sizeof(IndexHeader) == 40, "IndexHeader must not be padded");
+
+bool fileExists(const wstring &path) {
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  return GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data) != 0;
+}
+
+// Returns whether the log at path holds no records, which is also the case
+// when it does not exist.
+bool logIsEmpty(const wstring &path) {
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  if (GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data) == 0)
+    return true;
+  return data.nFileSizeHigh == 0 &&
+      data.nFileSizeLow <= StorageLog::HeaderSize;
+}
+
+HANDLE createManualResetEvent() {
+  HANDLE event = CreateEventEx(
       nullptr,
       nullptr,
       CREATE_EVENT_MANUAL_RESET,
       SYNCHRONIZE | EVENT_MODIFY_STATE);
-  if (m_storageFileLoaded == NULL)
+  if (event == NULL)
     StorageFileIO::throwLastErrorMessage();
+  return event;
+}
+
+void waitForEvent(HANDLE event) {
+  using namespace std::chrono;
+  using namespace std::chrono_literals;
 
-  m_storageFileLoader = async(launch::async, &KeyValueStorage::load, this);
+  const auto dwMilliseconds =
+      static_cast<DWORD>(duration_cast<milliseconds>(30s).count());
+  if (WaitForSingleObject(event, dwMilliseconds) != WAIT_OBJECT_0)
+    StorageFileIO::throwLastErrorMessage();
 }
 
-void KeyValueStorage::load() {
-  bool saveRequired = false; // this flag is used to indicate whether the file
-                             // needs to be cleaned up.
-
-  string currentKey;
-  string unescapedLine;
-
-  std::string line;
-  line.reserve(EstimatedValueSize);
-
-  m_fileIOHelper->resetLine();
-
-  while (m_fileIOHelper->getLine(line)) {
-    if (line.size() > 0) {
-      char prefix = line.at(0);
-      line.erase(0, 1);
-      unescapeString(line); // get the line without the prefix ($, %, R) and
-                            // unescapes the \n and \ chars
-      switch (prefix) { // switch on first char in line
-        case KeyPrefix:
-          currentKey = line;
-          break;
+const uint64_t *indexEntries(const MappedStorageFile &index) {
+  return reinterpret_cast<const uint64_t *>(
+      index.data() + sizeof(IndexHeader));
+}
 
-        case ValuePrefix:
-          if (m_kvMap.count(currentKey))
-            saveRequired = true;
-          m_kvMap[currentKey] = line;
-          break;
+// Returns whether index lists the live records of the mapped log.
+bool readIndexHeader(
+    const MappedStorageFile &index,
+    const MappedStorageFile &log,
+    IndexHeader &header) {
+  uint64_t generation;
+  if (index.size() < sizeof(IndexHeader) ||
+      !StorageLog::parseHeader(log.data(), log.size(), generation))
+    return false;
+
+  memcpy(&header, index.data(), sizeof(IndexHeader));
+  if (header.magic != IndexMagic || header.version != IndexVersion ||
+      header.generation != generation || header.logSize > log.size() ||
+      header.logSize < StorageLog::HeaderSize)
+    return false;
+
+  const uint64_t entriesSize = index.size() - sizeof(IndexHeader);
+  if (header.count != entriesSize / sizeof(uint64_t) ||
+      entriesSize % sizeof(uint64_t) != 0)
+    return false;
+
+  return StorageLog::crc32(
+             indexEntries(index), static_cast<size_t>(entriesSize)) ==
+      header.crc;
+}
 
-        case RemovePrefix:
-          saveRequired = true;
-          m_kvMap.erase(currentKey);
-          break;
+// Calls apply for every valid record from offset on and returns the offset
+// the first torn or corrupt record starts at.
+template <typename Fn>
+uint64_t replayLog(const MappedStorageFile &log, uint64_t offset, Fn &&apply) {
+  StorageLog::Record record;
+  while (uint64_t size =
+             StorageLog::parseRecord(log.data(), log.size(), offset, record)) {
+    apply(record, offset, size);
+    offset += size;
+  }
+  return offset;
+}
+
+// Merges source into target like AsyncStorage.mergeItem: members that are
+// objects on both sides are merged recursively, all others are replaced.
+void mergeObjects(folly::dynamic &target, folly::dynamic &&source) {
+  if (!target.isObject() || !source.isObject())
+    throw std::exception("Values to merge must be JSON objects.");
+
+  for (auto &member : source.items()) {
+    auto existing = target.find(member.first);
+    if (existing != target.items().end() && existing->second.isObject() &&
+        member.second.isObject()) {
+      mergeObjects(existing->second, std::move(member.second));
+    } else {
+      target.insert(member.first, std::move(member.second));
+    }
+  }
+}
+
+} // namespace
+
+KeyValueStorage::KeyValueStorage(const WCHAR *storageFileName)
+    : m_storageFileName{storageFileName ? storageFileName : L""},
+      m_logPath{StorageFileIO::storageFilePath(storageFileName, L".kvlog")},
+      m_indexPath{StorageFileIO::storageFilePath(storageFileName, L".kvidx")},
+      m_textPath{StorageFileIO::storageFilePath(storageFileName, L".txt")} {
+  // start the load procedure
+  m_indexLoaded = createManualResetEvent();
+  m_storageFileLoaded = createManualResetEvent();
 
-        default:
-          throw std::exception(
-              "Corrupt storage file. Unexpected prefix on line.");
+  m_storageFileLoader =
+      async(launch::async, &KeyValueStorage::load, this).share();
+}
+
+KeyValueStorage::~KeyValueStorage() {
+  m_storageFileLoader.wait();
+  if (m_compaction.valid())
+    m_compaction.wait();
+
+  try {
+    m_storageFileLoader.get();
+
+    // Persisting the index lets the next load skip the replay of the log.
+    lock_guard<mutex> lock(m_mutex);
+    commitPending(false /* flush */);
+    writeIndex();
+  } catch (const std::exception &) {
+    // The index is an optimization; the log alone is authoritative.
+  }
+
+  CloseHandle(m_indexLoaded);
+  CloseHandle(m_storageFileLoaded);
+}
+
+void KeyValueStorage::load() {
+  try {
+    // The text file is deleted once its keys are in the log, so a text file
+    // next to an empty log is one whose migration did not complete.
+    if (fileExists(m_textPath) && logIsEmpty(m_logPath))
+      migrateTextStorage();
+
+    auto log = make_unique<StorageLog>(m_logPath);
+
+    auto mappedLog = make_unique<MappedStorageFile>(m_logPath);
+    auto mappedIndex = make_unique<MappedStorageFile>(m_indexPath);
+
+    decltype(m_kvMap) kvMap;
+    uint64_t liveBytes = 0;
+    auto apply = [&kvMap, &liveBytes](
+                     const StorageLog::Record &record,
+                     uint64_t offset,
+                     uint64_t size) {
+      auto it = kvMap.find(record.key);
+      if (it != kvMap.end()) {
+        liveBytes -=
+            StorageLog::recordSize(it->first.size(), it->second.value.size());
+        if (record.type == StorageLog::RecordType::Remove) {
+          kvMap.erase(it);
+          return;
+        }
+        it->second = Entry{string(record.value), offset};
+      } else if (record.type == StorageLog::RecordType::Set) {
+        kvMap.emplace(
+            string(record.key), Entry{string(record.value), offset});
+      } else {
+        return;
+      }
+      liveBytes += size;
+    };
+
+    IndexHeader index;
+    bool indexValid = readIndexHeader(*mappedIndex, *mappedLog, index);
+    uint64_t logEnd = StorageLog::HeaderSize;
+
+    if (indexValid) {
+      // Only the records appended after the index was written need to be
+      // replayed before multiGet can binary search the index.
+      decltype(m_tail) tail;
+      logEnd = replayLog(
+          *mappedLog,
+          index.logSize,
+          [&tail](const StorageLog::Record &record, uint64_t, uint64_t) {
+            auto &value = tail[string(record.key)];
+            if (record.type == StorageLog::RecordType::Set)
+              value = string(record.value);
+            else
+              value.reset();
+          });
+
+      {
+        lock_guard<mutex> lock(m_mutex);
+        m_tail = std::move(tail);
+        m_mappedLog = std::move(mappedLog);
+        m_mappedIndex = std::move(mappedIndex);
+      }
+      if (!SetEvent(m_indexLoaded))
+        StorageFileIO::throwLastErrorMessage();
+
+      // The mapped files stay alive until they are reset below, under the
+      // lock, so they can be read here without it.
+      const MappedStorageFile &logFile = *m_mappedLog;
+      const uint64_t *entries = indexEntries(*m_mappedIndex);
+      for (uint64_t i = 0; i < index.count; i++) {
+        StorageLog::Record record;
+        uint64_t size = StorageLog::parseRecord(
+            logFile.data(), logFile.size(), entries[i], record);
+        if (size == 0 || record.type != StorageLog::RecordType::Set) {
+          indexValid = false;
           break;
+        }
+        kvMap.emplace_hint(
+            kvMap.end(),
+            string(record.key),
+            Entry{string(record.value), entries[i]});
+        liveBytes += size;
       }
+
+      if (indexValid) {
+        replayLog(logFile, index.logSize, apply);
+      } else {
+        kvMap.clear();
+        liveBytes = 0;
+        logEnd = replayLog(logFile, StorageLog::HeaderSize, apply);
+      }
+    } else {
+      logEnd = replayLog(*mappedLog, StorageLog::HeaderSize, apply);
+
+      // writeIndex below cannot replace a file that is still mapped.
+      mappedLog.reset();
+      mappedIndex.reset();
     }
-  }
 
-  if (saveRequired) // cleanup the AOF by dumping the in memory map
-  {
-    m_fileIOHelper->clear();
-    stringstream cleanedUpFile;
+    lock_guard<mutex> lock(m_mutex);
+    m_mappedLog.reset();
+    m_mappedIndex.reset();
+    m_tail.clear();
+
+    // Drop a record torn by a crash, so appends do not land behind it.
+    if (logEnd < log->size())
+      log->truncate(logEnd);
 
-    for (auto const &entry : m_kvMap) // convert in memory map to a string
     {
-      string key = entry.first;
-      string value = entry.second;
+      unique_lock<shared_mutex> indexLock(m_indexMutex);
+      m_kvMap = std::move(kvMap);
+    }
+    m_liveBytes = liveBytes;
+    m_log = std::move(log);
+    m_loaded = true;
+
+    if (indexValid)
+      m_indexedLogSize = index.logSize;
+    writeIndex();
+  } catch (...) {
+    SetEvent(m_indexLoaded);
+    SetEvent(m_storageFileLoaded);
+    throw;
+  }
 
-      escapeString(key);
-      escapeString(value);
+  SetEvent(m_indexLoaded);
+  if (!SetEvent(m_storageFileLoaded))
+    StorageFileIO::throwLastErrorMessage();
+}
 
-      cleanedUpFile << KeyPrefix << key << '\n' << ValuePrefix << value << '\n';
+void KeyValueStorage::migrateTextStorage() {
+  map<string, string> kvMap;
+  {
+    StorageFileIO textFile(m_storageFileName.c_str());
+
+    string currentKey;
+    string line;
+    line.reserve(EstimatedValueSize);
+
+    textFile.resetLine();
+    while (textFile.getLine(line)) {
+      if (line.size() > 0) {
+        char prefix = line.at(0);
+        line.erase(0, 1);
+        unescapeString(line); // get the line without the prefix ($, %, R) and
+                              // unescapes the \n and \ chars
+        switch (prefix) { // switch on first char in line
+          case KeyPrefix:
+            currentKey = line;
+            break;
+
+          case ValuePrefix:
+            kvMap[currentKey] = line;
+            break;
+
+          case RemovePrefix:
+            kvMap.erase(currentKey);
+            break;
+
+          default:
+            throw std::exception(
+                "Corrupt storage file. Unexpected prefix on line.");
+            break;
+        }
+      }
     }
+  }
 
-    m_fileIOHelper->append(cleanedUpFile.str());
+  string records;
+  for (auto const &entry : kvMap) {
+    StorageLog::appendRecord(
+        records, StorageLog::RecordType::Set, entry.first, entry.second);
   }
 
-  if (!SetEvent(m_storageFileLoaded))
+  // Write the log next to its final path and move it into place once it is
+  // complete, so a migration that fails or is cut short leaves no log behind
+  // and runs again on the next load.
+  const wstring migrationPath = m_logPath + L".migration";
+  DeleteFileW(migrationPath.c_str());
+  {
+    StorageLog log(migrationPath);
+    log.append(records);
+    log.flush();
+  }
+  if (!MoveFileExW(
+          migrationPath.c_str(),
+          m_logPath.c_str(),
+          MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
     StorageFileIO::throwLastErrorMessage();
+
+  // The log now holds the keys, so a text file that could not be deleted is
+  // ignored from here on.
+  DeleteFileW(m_textPath.c_str());
 }
 
 void KeyValueStorage::waitForStorageLoadComplete() {
-  using namespace std::chrono;
-  using namespace std::chrono_literals;
+  waitForEvent(m_storageFileLoaded);
+  m_storageFileLoader.get();
+}
 
-  const auto dwMilliseconds =
-      static_cast<DWORD>(duration_cast<milliseconds>(30s).count());
-  if (WaitForSingleObject(m_storageFileLoaded, dwMilliseconds) != WAIT_OBJECT_0)
-    StorageFileIO::throwLastErrorMessage();
+bool KeyValueStorage::multiGetFromIndex(
+    const vector<string> &keys,
+    vector<tuple<string, string>> &result) {
+  if (!m_mappedIndex || !m_mappedLog)
+    return false;
 
-  if (m_storageFileLoader.valid())
-    m_storageFileLoader.get();
+  const uint8_t *log = m_mappedLog->data();
+  const uint64_t logSize = m_mappedLog->size();
+  const uint64_t *entries = indexEntries(*m_mappedIndex);
+  const uint64_t count =
+      (m_mappedIndex->size() - sizeof(IndexHeader)) / sizeof(uint64_t);
+
+  for (auto const &k : keys) {
+    auto tailEntry = m_tail.find(k);
+    if (tailEntry != m_tail.end()) {
+      if (tailEntry->second)
+        result.emplace_back(k, *tailEntry->second);
+      continue;
+    }
+
+    uint64_t low = 0;
+    uint64_t high = count;
+    while (low < high) {
+      const uint64_t mid = low + (high - low) / 2;
+      StorageLog::Record record;
+      if (!StorageLog::parseRecord(
+              log, logSize, entries[mid], record, false /* verify */))
+        return false;
+
+      const int comparison = record.key.compare(k);
+      if (comparison < 0) {
+        low = mid + 1;
+      } else if (comparison > 0) {
+        high = mid;
+      } else {
+        if (!StorageLog::parseRecord(log, logSize, entries[mid], record))
+          return false;
+        result.emplace_back(k, string(record.value));
+        break;
+      }
+    }
+  }
+
+  return true;
 }
 
 vector<tuple<string, string>> KeyValueStorage::multiGet(
     const vector<string> &keys) {
-  waitForStorageLoadComplete();
+  waitForEvent(m_indexLoaded);
 
   vector<tuple<string, string>> result;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_loaded && multiGetFromIndex(keys, result))
+      return result;
+  }
+
+  waitForStorageLoadComplete();
+
+  // Readers only share the index with each other and with the parts of a
+  // write that do not modify it, like the log IO of a commit.
+  shared_lock<shared_mutex> indexLock(m_indexMutex);
+  result.clear();
   for (auto const &k : keys) {
-    if (m_kvMap.find(k) != m_kvMap.end()) {
-      result.emplace_back(k, m_kvMap[k]);
+    auto entry = m_kvMap.find(k);
+    if (entry != m_kvMap.end()) {
+      result.emplace_back(k, entry->second.value);
     }
   }
 
@@ -121,99 +437,367 @@ void KeyValueStorage::multiSet(
     const vector<tuple<string, string>> &keyValuePairs) {
   waitForStorageLoadComplete();
 
-  stringstream appendEntry;
-  bool fUpdateStorageFile = false;
+  lock_guard<mutex> lock(m_mutex);
+  setEntries(keyValuePairs);
+}
 
-  for (auto const &kvTuple : keyValuePairs) {
-    string key = get<0>(kvTuple);
-    string value = get<1>(kvTuple);
+// Returns the value of key with the pending changes applied, or nullptr if
+// it has none. Requires m_mutex.
+const string *KeyValueStorage::currentValue(const string &key) const {
+  auto change = m_pending.find(key);
+  if (change != m_pending.end())
+    return change->second ? &*change->second : nullptr;
+  if (m_pendingClear)
+    return nullptr;
+
+  auto entry = m_kvMap.find(key);
+  return entry != m_kvMap.end() ? &entry->second.value : nullptr;
+}
 
-    // check if we need to modify the storage file
-    // 1. if key does not exist
-    // 2. if keys exists and value is different
-    if (m_kvMap.find(key) == m_kvMap.end() || m_kvMap[key] != value) {
-      // update the in-memory map
-      m_kvMap[key] = value;
-      fUpdateStorageFile = true;
-      escapeString(key);
-      escapeString(value);
-      appendEntry << KeyPrefix << key << '\n' << ValuePrefix << value << '\n';
-    }
-  }
+// Requires m_mutex.
+void KeyValueStorage::setEntries(
+    const vector<tuple<string, string>> &keyValuePairs) {
+  for (auto const &kvTuple : keyValuePairs)
+    m_pending[get<0>(kvTuple)] = get<1>(kvTuple);
 
-  if (fUpdateStorageFile) {
-    // write the new keys to the file
-    m_fileIOHelper->append(appendEntry.str());
-  }
+  if (!m_batching)
+    commitPending(false /* flush */);
 }
 
 void KeyValueStorage::multiRemove(const vector<string> &keys) {
   waitForStorageLoadComplete();
-  stringstream ss;
 
-  for (auto const &k : keys) {
-    ss << KeyPrefix << k << '\n' << RemovePrefix << '\n';
-    m_kvMap.erase(k);
-  }
+  lock_guard<mutex> lock(m_mutex);
+  for (auto const &k : keys)
+    m_pending[k].reset();
 
-  m_fileIOHelper->append(ss.str());
+  if (!m_batching)
+    commitPending(false /* flush */);
 }
 
 void KeyValueStorage::multiMerge(
     const vector<tuple<string, string>> &keyValuePairs) {
-  throw std::exception("Error: not implemented.");
+  waitForStorageLoadComplete();
+
+  lock_guard<mutex> lock(m_mutex);
+
+  // Values are only parsed when there is something to merge them into, and
+  // stay parsed while a batch merges into the same key repeatedly. Every
+  // merge is done before anything is written, so a value that is not a JSON
+  // object fails the whole batch.
+  struct MergedValue {
+    string json;
+    folly::dynamic parsed;
+    bool isParsed;
+  };
+  map<string, MergedValue, less<>> merged;
+
+  for (auto const &kvTuple : keyValuePairs) {
+    const string &key = get<0>(kvTuple);
+    const string &value = get<1>(kvTuple);
+
+    auto pending = merged.find(key);
+    if (pending == merged.end()) {
+      const string *current = currentValue(key);
+      if (!current) {
+        merged.emplace(key, MergedValue{value, nullptr, false});
+        continue;
+      }
+      pending =
+          merged.emplace(key, MergedValue{*current, nullptr, false}).first;
+    }
+
+    MergedValue &target = pending->second;
+    if (!target.isParsed) {
+      target.parsed = folly::parseJson(target.json);
+      target.isParsed = true;
+    }
+    mergeObjects(target.parsed, folly::parseJson(value));
+  }
+
+  vector<tuple<string, string>> entries;
+  entries.reserve(merged.size());
+  for (auto &entry : merged) {
+    MergedValue &value = entry.second;
+    entries.emplace_back(
+        entry.first,
+        value.isParsed ? folly::toJson(value.parsed) : std::move(value.json));
+  }
+
+  // Only the merged values are appended to the log.
+  setEntries(entries);
 }
 
 void KeyValueStorage::clear() {
   waitForStorageLoadComplete();
 
-  m_kvMap.clear();
-  m_fileIOHelper->clear();
+  lock_guard<mutex> lock(m_mutex);
+  m_pending.clear();
+  m_pendingClear = true;
+
+  if (!m_batching)
+    commitPending(false /* flush */);
+}
+
+void KeyValueStorage::beginBatch() {
+  lock_guard<mutex> lock(m_mutex);
+  m_batching = true;
+}
+
+void KeyValueStorage::commitBatch() {
+  waitForStorageLoadComplete();
+
+  lock_guard<mutex> lock(m_mutex);
+  m_batching = false;
+  commitPending(true /* flush */);
 }
 
 vector<string> KeyValueStorage::getAllKeys() {
   waitForStorageLoadComplete();
 
+  shared_lock<shared_mutex> indexLock(m_indexMutex);
   vector<string> keys;
+  keys.reserve(m_kvMap.size());
   for (auto const &i : m_kvMap) {
     keys.push_back(i.first);
   }
   return keys;
 }
 
-void KeyValueStorage::escapeString(string &rawString) {
-  int cSpecialChars = 0;
-  for (auto const &c : rawString) {
-    if (c == '\n' || c == '\\')
-      cSpecialChars++;
+StorageLog &KeyValueStorage::log() {
+  // Only missing if a compaction failed to reopen the log it replaced.
+  if (!m_log)
+    throw std::exception("Storage file is not open.");
+  return *m_log;
+}
+
+// Writes the final state of every key changed since the last commit with a
+// single append, and only then applies the changes to m_kvMap. The changes
+// are dropped whether or not they make it to the log, so a failed commit is
+// not written by a later one. Requires m_mutex.
+void KeyValueStorage::commitPending(bool flush) {
+  auto pending = std::move(m_pending);
+  m_pending.clear();
+  const bool pendingClear = m_pendingClear;
+  m_pendingClear = false;
+
+  if (pendingClear) {
+    log().reset();
+    {
+      unique_lock<shared_mutex> indexLock(m_indexMutex);
+      m_kvMap.clear();
+    }
+    m_liveBytes = 0;
+    DeleteFileW(m_indexPath.c_str());
+    m_indexedLogSize = 0;
+
+    if (m_compacting) {
+      m_compactionCancelled = true;
+      m_compactionBacklog.clear();
+    }
+  }
+
+  // Only keys that are new, get a different value or are removed are
+  // written.
+  const uint64_t offset = log().size();
+  string records;
+  vector<pair<decltype(pending)::value_type *, uint64_t>> changes;
+  changes.reserve(pending.size());
+
+  for (auto &change : pending) {
+    auto entry = m_kvMap.find(change.first);
+    if (change.second) {
+      if (entry != m_kvMap.end() && entry->second.value == *change.second)
+        continue;
+      changes.emplace_back(&change, offset + records.size());
+      StorageLog::appendRecord(
+          records, StorageLog::RecordType::Set, change.first, *change.second);
+    } else if (entry != m_kvMap.end()) {
+      changes.emplace_back(&change, offset + records.size());
+      StorageLog::appendRecord(
+          records, StorageLog::RecordType::Remove, change.first, {});
+    }
+  }
+
+  if (records.empty()) {
+    if (flush && pendingClear)
+      log().flush();
+    return;
+  }
+
+  try {
+    log().append(records);
+    if (flush)
+      log().flush();
+  } catch (const std::exception &) {
+    // Cut off whatever part of the records did get written, so that the
+    // next commit does not leave them behind its own records.
+    try {
+      log().truncate(offset);
+    } catch (const std::exception &) {
+    }
+    throw;
+  }
+
+  {
+    unique_lock<shared_mutex> indexLock(m_indexMutex);
+    for (auto const &change : changes) {
+      const string &key = change.first->first;
+      auto &value = change.first->second;
+      auto entry = m_kvMap.find(key);
+      if (entry != m_kvMap.end())
+        m_liveBytes -=
+            StorageLog::recordSize(key.size(), entry->second.value.size());
+
+      if (!value) {
+        m_kvMap.erase(entry);
+        continue;
+      }
+
+      m_liveBytes += StorageLog::recordSize(key.size(), value->size());
+      if (entry != m_kvMap.end())
+        entry->second = Entry{std::move(*value), change.second};
+      else
+        m_kvMap.emplace(key, Entry{std::move(*value), change.second});
+    }
+  }
+
+  if (m_compacting && !m_compactionCancelled)
+    m_compactionBacklog.append(records);
+
+  compactIfNeeded();
+}
+
+// Requires m_mutex.
+void KeyValueStorage::writeIndex() {
+  // m_kvMap only holds committed entries, whose records are in the log.
+  if (!m_loaded || m_indexedLogSize == log().size())
+    return;
+
+  // The offsets must not point past what is on the disk.
+  log().flush();
+
+  string index(sizeof(IndexHeader) + m_kvMap.size() * sizeof(uint64_t), '\0');
+  char *entries = &index[sizeof(IndexHeader)];
+  for (auto const &entry : m_kvMap) {
+    memcpy(entries, &entry.second.offset, sizeof(uint64_t));
+    entries += sizeof(uint64_t);
   }
 
-  if (cSpecialChars == 0)
+  IndexHeader header = {};
+  header.magic = IndexMagic;
+  header.version = IndexVersion;
+  header.generation = log().generation();
+  header.logSize = log().size();
+  header.count = m_kvMap.size();
+  header.crc = StorageLog::crc32(
+      index.data() + sizeof(IndexHeader), index.size() - sizeof(IndexHeader));
+  memcpy(&index[0], &header, sizeof(IndexHeader));
+
+  StorageLog::replaceFile(m_indexPath, index);
+  m_indexedLogSize = header.logSize;
+}
+
+// Requires m_mutex.
+void KeyValueStorage::compactIfNeeded() {
+  const uint64_t deadBytes =
+      log().size() - StorageLog::HeaderSize - m_liveBytes;
+  if (m_compacting || deadBytes < CompactionThreshold ||
+      deadBytes < m_liveBytes)
     return;
 
-  auto originalLength = rawString.length();
-  string::size_type spaceToReserve{originalLength + cSpecialChars};
-  rawString.reserve(spaceToReserve);
-  rawString.resize(spaceToReserve);
-
-  char *read = &rawString[originalLength];
-  char *write = &rawString[originalLength] + cSpecialChars;
-
-  for (size_t i = 0; i < originalLength + 1; i++) {
-    if (*read == '\\') {
-      *write = '\\';
-      write--;
-      *write = '\\';
-    } else if (*read == '\n') {
-      *write = 'n';
-      write--;
-      *write = '\\';
-    } else {
-      *write = *read;
+  vector<pair<string, string>> snapshot;
+  snapshot.reserve(m_kvMap.size());
+  for (auto const &entry : m_kvMap)
+    snapshot.emplace_back(entry.first, entry.second.value);
+
+  m_compacting = true;
+  m_compactionCancelled = false;
+  m_compactionBacklog.clear();
+
+  // The previous compaction has released m_compacting, so this does not
+  // block on it for long.
+  m_compaction = async(
+      launch::async, &KeyValueStorage::compact, this, std::move(snapshot));
+}
+
+// Writes the live entries to a new log next to the current one while writes
+// continue, then replays the records appended in the meantime and swaps the
+// files under the lock.
+void KeyValueStorage::compact(vector<pair<string, string>> snapshot) {
+  const wstring compactedPath = m_logPath + L".tmp";
+
+  try {
+    DeleteFileW(compactedPath.c_str());
+    auto compacted = make_unique<StorageLog>(compactedPath);
+
+    map<string, uint64_t, less<>> offsets;
+    string records;
+    for (auto const &entry : snapshot) {
+      offsets.emplace_hint(
+          offsets.end(), entry.first, compacted->size() + records.size());
+      StorageLog::appendRecord(
+          records, StorageLog::RecordType::Set, entry.first, entry.second);
+
+      if (records.size() >= CompactionWriteSize) {
+        compacted->append(records);
+        records.clear();
+      }
+    }
+    compacted->append(records);
+    snapshot.clear();
+
+    lock_guard<mutex> lock(m_mutex);
+    if (m_compactionCancelled) {
+      compacted.reset();
+      DeleteFileW(compactedPath.c_str());
+      m_compacting = false;
+      return;
+    }
+
+    const uint64_t backlogOffset = compacted->append(m_compactionBacklog);
+    const auto backlog =
+        reinterpret_cast<const uint8_t *>(m_compactionBacklog.data());
+    StorageLog::Record record;
+    uint64_t offset = 0;
+    while (uint64_t size = StorageLog::parseRecord(
+               backlog, m_compactionBacklog.size(), offset, record)) {
+      if (record.type == StorageLog::RecordType::Set) {
+        offsets[string(record.key)] = backlogOffset + offset;
+      } else {
+        auto removed = offsets.find(record.key);
+        if (removed != offsets.end())
+          offsets.erase(removed);
+      }
+      offset += size;
+    }
+
+    compacted->flush();
+    compacted.reset();
+
+    m_log.reset();
+    m_indexedLogSize = 0;
+    const BOOL replaced = MoveFileExW(
+        compactedPath.c_str(), m_logPath.c_str(), MOVEFILE_REPLACE_EXISTING);
+    const DWORD error = GetLastError();
+    m_log = make_unique<StorageLog>(m_logPath);
+    if (!replaced) {
+      SetLastError(error);
+      StorageFileIO::throwLastErrorMessage();
     }
 
-    write--;
-    read--;
+    for (auto &entry : m_kvMap)
+      entry.second.offset = offsets.at(entry.first);
+
+    m_compacting = false;
+    m_compactionBacklog = string();
+    writeIndex();
+  } catch (const std::exception &) {
+    // Compaction is retried by the next write; the current log stays valid.
+    lock_guard<mutex> lock(m_mutex);
+    m_compacting = false;
+    m_compactionBacklog = string();
+    DeleteFileW(compactedPath.c_str());
   }
 }
 
@@ -6,15 +6,28 @@
 #include <future>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <vector>
 
 #include <AsyncStorage/StorageFileIO.h>
+#include <AsyncStorage/StorageLog.h>
 
 namespace facebook {
 namespace react {
+
+// Key/value store backed by a binary StorageLog (<name>.kvlog) and an offset
+// index (<name>.kvidx) that lists the live record of every key, sorted by
+// key. The index is rewritten on shutdown and after each compaction, so at
+// startup only the records appended after it was written have to be
+// replayed before multiGet can answer from the mapped files; the in-memory
+// map is filled in the background. A text storage file written by earlier
+// versions (<name>.txt) is migrated on first use.
 class KeyValueStorage {
  public:
   KeyValueStorage(const WCHAR *storageFileName);
+  ~KeyValueStorage();
 
   std::vector<std::tuple<std::string, std::string>> multiGet(
       const std::vector<std::string> &keys);
@@ -26,26 +39,88 @@ class KeyValueStorage {
   void clear();
   std::vector<std::string> getAllKeys();
 
+  // Between beginBatch and commitBatch the write operations are only staged.
+  // commitBatch then appends the final state of each changed key to the log
+  // with one write and flushes it, so a key overwritten several times in the
+  // batch is only written once. multiGet and getAllKeys only see the batch
+  // once it is committed. If the commit fails, the batch is dropped, except
+  // for a clear(), which is committed first.
+  void beginBatch();
+  void commitBatch();
+
  private:
-  static const uint32_t EstimatedKeySize = 100; // in chars
   static const uint32_t EstimatedValueSize = 200;
   static const char KeyPrefix = '$';
   static const char ValuePrefix = '%';
   static const char RemovePrefix = 'R';
 
+  // The log is compacted in the background once it holds this many bytes of
+  // overwritten or removed records and they outweigh the live ones.
+  static const uint64_t CompactionThreshold = 1024 * 1024;
+  static const size_t CompactionWriteSize = 256 * 1024;
+
+  struct Entry {
+    std::string value;
+    uint64_t offset; // of the record holding value in the log
+  };
+
  private:
-  std::map<std::string, std::string> m_kvMap;
-  std::unique_ptr<StorageFileIO> m_fileIOHelper;
+  // m_mutex serializes writers, including their log IO and compaction.
+  // m_kvMap holds the committed state, and is also guarded by m_indexMutex:
+  // commits hold it exclusively only while they modify the map, so multiGet
+  // and getAllKeys, which hold it shared, are not blocked by disk writes.
+  std::mutex m_mutex;
+  std::shared_mutex m_indexMutex;
+  std::map<std::string, Entry, std::less<>> m_kvMap;
+  uint64_t m_liveBytes{0};
+  bool m_loaded{false};
+
+  // Changes staged since the last commit: the new value of each changed key,
+  // or nullopt if it was removed.
+  std::map<std::string, std::optional<std::string>, std::less<>> m_pending;
+  bool m_pendingClear{false};
+  bool m_batching{false};
+
+  const std::wstring m_storageFileName;
+  const std::wstring m_logPath;
+  const std::wstring m_indexPath;
+  const std::wstring m_textPath;
+  std::unique_ptr<StorageLog> m_log;
+  uint64_t m_indexedLogSize{0}; // log size covered by the index file
+
+  // Used to answer multiGet until the in-memory map is loaded.
+  std::unique_ptr<MappedStorageFile> m_mappedLog;
+  std::unique_ptr<MappedStorageFile> m_mappedIndex;
+  std::map<std::string, std::optional<std::string>, std::less<>> m_tail;
+
+  bool m_compacting{false};
+  bool m_compactionCancelled{false};
+  std::string m_compactionBacklog;
+  std::future<void> m_compaction;
+
+  HANDLE m_indexLoaded;
   HANDLE m_storageFileLoaded;
-  std::future<void> m_storageFileLoader;
+  std::shared_future<void> m_storageFileLoader;
 
  private:
-  static void escapeString(std::string &unescapedString);
   static void unescapeString(std::string &escapedString);
 
  private:
   void load();
+  void migrateTextStorage();
   void waitForStorageLoadComplete();
+  bool multiGetFromIndex(
+      const std::vector<std::string> &keys,
+      std::vector<std::tuple<std::string, std::string>> &result);
+
+  StorageLog &log();
+  const std::string *currentValue(const std::string &key) const;
+  void setEntries(
+      const std::vector<std::tuple<std::string, std::string>> &keyValuePairs);
+  void commitPending(bool flush);
+  void writeIndex();
+  void compactIfNeeded();
+  void compact(std::vector<std::pair<std::string, std::string>> snapshot);
 };
 } // namespace react
 } // namespace facebook
@@ -0,0 +1,304 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "Base64.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <intrin.h>
+#define BASE64_SSSE3 1
+#elif defined(__SSSE3__)
+#define BASE64_SSSE3 1
+#endif
+
+#if BASE64_SSSE3
+#include <tmmintrin.h>
+#endif
+
+using std::string;
+using std::string_view;
+
+namespace Microsoft::React {
+
+namespace {
+
+constexpr char s_alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+constexpr uint8_t s_invalid = 0xff;
+
+constexpr std::array<uint8_t, 256> MakeDecodeTable() {
+  std::array<uint8_t, 256> table{};
+  for (auto &value : table)
+    value = s_invalid;
+  for (uint8_t i = 0; i < 64; ++i)
+    table[static_cast<uint8_t>(s_alphabet[i])] = i;
+  return table;
+}
+
+constexpr auto s_decodeTable = MakeDecodeTable();
+
+#if BASE64_SSSE3
+
+bool HasSsse3() noexcept {
+#if defined(_MSC_VER)
+  static const bool hasSsse3 = []() {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+  }();
+  return hasSsse3;
+#else
+  // Only compiled in when the target has it.
+  return true;
+#endif
+}
+
+// Encodes the first 12 of the 16 bytes at in into 16 characters.
+// See http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html.
+__m128i EncodeBlock(__m128i in) noexcept {
+  // Spread each group of 3 bytes over 4 bytes, then move each of the four
+  // 6-bit values to the low bits of its own byte.
+  in = _mm_shuffle_epi8(
+      in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+  auto ac = _mm_mulhi_epu16(
+      _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+      _mm_set1_epi32(0x04000040));
+  auto bd = _mm_mullo_epi16(
+      _mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+      _mm_set1_epi32(0x01000010));
+  auto indices = _mm_or_si128(ac, bd);
+
+  // Add to each value the offset of its range in the alphabet.
+  auto ranges = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  auto lower = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  ranges = _mm_or_si128(ranges, _mm_and_si128(lower, _mm_set1_epi8(13)));
+  auto offsets = _mm_setr_epi8(
+      'a' - 26,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '0' - 52,
+      '+' - 62,
+      '/' - 63,
+      'A',
+      0,
+      0);
+  return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, ranges));
+}
+
+// Decodes 16 characters into the first 12 bytes of the result. Sets valid to
+// false if any character is not in the alphabet.
+// See http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html.
+__m128i DecodeBlock(__m128i in, bool &valid) noexcept {
+  auto highNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+  auto lowNibbles = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+
+  auto lowMasks = _mm_setr_epi8(
+      0x15,
+      0x11,
+      0x11,
+      0x11,
+      0x11,
+      0x11,
+      0x11,
+      0x11,
+      0x11,
+      0x11,
+      0x13,
+      0x1a,
+      0x1b,
+      0x1b,
+      0x1b,
+      0x1a);
+  auto highMasks = _mm_setr_epi8(
+      0x10,
+      0x10,
+      0x01,
+      0x02,
+      0x04,
+      0x08,
+      0x04,
+      0x08,
+      0x10,
+      0x10,
+      0x10,
+      0x10,
+      0x10,
+      0x10,
+      0x10,
+      0x10);
+  auto invalid = _mm_and_si128(
+      _mm_shuffle_epi8(lowMasks, lowNibbles),
+      _mm_shuffle_epi8(highMasks, highNibbles));
+  valid = _mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) ==
+      0xffff;
+
+  // '/' is the only character whose offset its high nibble does not give.
+  auto offsets =
+      _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  auto slashes = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+  auto values = _mm_add_epi8(
+      in, _mm_shuffle_epi8(offsets, _mm_add_epi8(slashes, highNibbles)));
+
+  // Join each four 6-bit values into 3 bytes, then pack those.
+  auto pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  auto groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+  return _mm_shuffle_epi8(
+      groups,
+      _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+#endif // BASE64_SSSE3
+
+// Encodes size bytes, a multiple of 3.
+char *EncodeGroups(const uint8_t *in, size_t size, char *out) noexcept {
+  auto end = in + size;
+
+#if BASE64_SSSE3
+  if (HasSsse3()) {
+    // Each step reads 16 bytes and encodes 12 of them.
+    for (; end - in >= 16; in += 12, out += 16) {
+      auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), EncodeBlock(block));
+    }
+  }
+#endif
+
+  for (; in != end; in += 3) {
+    *out++ = s_alphabet[in[0] >> 2];
+    *out++ = s_alphabet[((in[0] & 0x03) << 4) | (in[1] >> 4)];
+    *out++ = s_alphabet[((in[1] & 0x0f) << 2) | (in[2] >> 6)];
+    *out++ = s_alphabet[in[2] & 0x3f];
+  }
+
+  return out;
+}
+
+} // namespace
+
+#pragma region Base64Encoder
+
+Base64Encoder::Base64Encoder(string &result, size_t expectedSize)
+    : m_result{result} {
+  m_result.reserve(m_result.size() + (expectedSize + 2) / 3 * 4);
+}
+
+void Base64Encoder::Write(const void *data, size_t size) {
+  auto in = static_cast<const uint8_t *>(data);
+
+  // Complete the group the last piece ended in.
+  if (m_pendingSize > 0) {
+    if (m_pendingSize + size < 3) {
+      std::memcpy(m_pending + m_pendingSize, in, size);
+      m_pendingSize += size;
+      return;
+    }
+
+    uint8_t group[3];
+    std::memcpy(group, m_pending, m_pendingSize);
+    std::memcpy(group + m_pendingSize, in, 3 - m_pendingSize);
+    in += 3 - m_pendingSize;
+    size -= 3 - m_pendingSize;
+    m_pendingSize = 0;
+
+    auto offset = m_result.size();
+    m_result.resize(offset + 4);
+    EncodeGroups(group, 3, &m_result[offset]);
+  }
+
+  auto groupsSize = size - size % 3;
+  if (groupsSize > 0) {
+    auto offset = m_result.size();
+    m_result.resize(offset + groupsSize / 3 * 4);
+    EncodeGroups(in, groupsSize, &m_result[offset]);
+  }
+
+  m_pendingSize = size - groupsSize;
+  std::memcpy(m_pending, in + groupsSize, m_pendingSize);
+}
+
+void Base64Encoder::Finish() {
+  if (m_pendingSize == 0)
+    return;
+
+  uint8_t first = m_pending[0];
+  uint8_t second = m_pendingSize > 1 ? m_pending[1] : 0;
+  m_result += s_alphabet[first >> 2];
+  m_result += s_alphabet[((first & 0x03) << 4) | (second >> 4)];
+  m_result += m_pendingSize > 1 ? s_alphabet[(second & 0x0f) << 2] : '=';
+  m_result += '=';
+  m_pendingSize = 0;
+}
+
+#pragma endregion Base64Encoder
+
+string EncodeBase64(string_view data) {
+  string result;
+  Base64Encoder encoder{result, data.size()};
+  encoder.Write(data.data(), data.size());
+  encoder.Finish();
+  return result;
+}
+
+bool DecodeBase64(string_view text, string &result) {
+  auto length = text.size();
+  if (length % 4 == 0) {
+    for (int i = 0; i < 2 && length > 0 && text[length - 1] == '='; ++i)
+      --length;
+  }
+  if (length % 4 == 1)
+    return false;
+
+  result.resize(length / 4 * 3 + (length % 4 == 0 ? 0 : length % 4 - 1));
+  auto in = reinterpret_cast<const uint8_t *>(text.data());
+  auto end = in + length;
+  auto out = reinterpret_cast<uint8_t *>(&result[0]);
+
+#if BASE64_SSSE3
+  if (HasSsse3()) {
+    auto outEnd = out + result.size();
+
+    // Each step decodes 16 characters, and writes 16 bytes of which 12 are
+    // data.
+    for (; end - in >= 16 && outEnd - out >= 16; in += 16, out += 12) {
+      bool valid;
+      auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+      block = DecodeBlock(block, valid);
+      if (!valid)
+        return false;
+
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), block);
+    }
+  }
+#endif
+
+  uint32_t bits = 0;
+  int bitCount = 0;
+  for (; in != end; ++in) {
+    auto value = s_decodeTable[*in];
+    if (value == s_invalid)
+      return false;
+
+    bits = (bits << 6) | value;
+    bitCount += 6;
+    if (bitCount >= 8) {
+      bitCount -= 8;
+      *out++ = static_cast<uint8_t>(bits >> bitCount);
+    }
+  }
+
+  return true;
+}
+
+} // namespace Microsoft::React
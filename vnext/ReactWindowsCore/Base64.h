@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Microsoft::React {
+
+///
+// Encodes to padded base64 (RFC 4648) data that comes in several pieces,
+// such as the buffers of a web socket message, without joining them first.
+// On CPUs with SSSE3, encodes 12 bytes at a time.
+///
+class Base64Encoder {
+  std::string &m_result;
+  uint8_t m_pending[2];
+  size_t m_pendingSize{0};
+
+ public:
+  // Appends to result. Reserves room for expectedSize bytes of data, if given.
+  explicit Base64Encoder(std::string &result, size_t expectedSize = 0);
+
+  void Write(const void *data, size_t size);
+
+  // Writes the last bytes and the padding.
+  void Finish();
+};
+
+std::string EncodeBase64(std::string_view data);
+
+// Decodes padded or unpadded base64 into result. Returns false if text is not
+// valid base64.
+bool DecodeBase64(std::string_view text, std::string &result);
+
+} // namespace Microsoft::React
@@ -3,6 +3,7 @@
 #include "BaseScriptStoreImpl.h"
 
 #include <fstream>
+#include <string>
 
 namespace facebook {
 namespace react {
@@ -171,13 +172,35 @@ bool LocalFileSimpleBufferStore::persistBuffer(
   if (storeDirectory_.empty())
     std::terminate();
 
+  // Write to a temporary file and move it over the buffer, so that a reader
+  // never sees a partially written buffer, even if the app exits while
+  // writing. The temporary file is named after the writing thread, so that
+  // concurrent writers of the same buffer, in this process or another one,
+  // don't write to the same file.
+  const std::string bufferPath = storeDirectory_ + relativeUrl;
+  const std::string tempPath = bufferPath + "." +
+      std::to_string(GetCurrentProcessId()) + "." +
+      std::to_string(GetCurrentThreadId()) + ".tmp";
+
   std::ofstream file;
-  file.open(storeDirectory_ + relativeUrl, std::ios::binary | std::ios::trunc);
+  file.open(tempPath, std::ios::binary | std::ios::trunc);
   if (!file)
     return false;
 
   file.write(reinterpret_cast<const char *>(buffer->data()), buffer->size());
   file.close();
+  if (!file) {
+    DeleteFileA(tempPath.c_str());
+    return false;
+  }
+
+  if (!MoveFileExA(
+          tempPath.c_str(),
+          bufferPath.c_str(),
+          MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    DeleteFileA(tempPath.c_str());
+    return false;
+  }
 
   return true;
 }
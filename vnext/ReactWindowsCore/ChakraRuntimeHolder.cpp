@@ -56,6 +56,9 @@ ChakraRuntimeArgs ChakraRuntimeHolder::RuntimeArgsFromDevSettings(
 
   runtimeArgs.memoryTracker = devSettings->memoryTracker;
 
+  runtimeArgs.prepareScriptsInBackground =
+      devSettings->prepareScriptsInBackground;
+
   return runtimeArgs;
 }
 
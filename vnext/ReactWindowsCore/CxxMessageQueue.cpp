@@ -3,11 +3,17 @@
 
 #include "CxxMessageQueue.h"
 
-#include <folly/AtomicIntrusiveLinkedList.h>
-
+#include <deque>
 #include <mutex>
 #include <queue>
 #include <unordered_map>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 #include <glog/logging.h>
 
@@ -26,104 +32,236 @@ time_point now() {
   return clock::now();
 }
 
-class Task {
- public:
-  static Task *create(std::function<void()> &&func) {
-    return new Task{std::move(func), false, time_point()};
-  }
-
-  static Task *createSync(std::function<void()> &&func) {
-    return new Task{std::move(func), true, time_point()};
-  }
+// How many times the runner checks for new tasks before it sleeps. Tasks
+// often come in bursts, and waking a sleeping thread costs a lot more than
+// spinning for a few microseconds. With a single core, spinning only keeps
+// the threads that post tasks from running.
+int spinCount() {
+  static const int count = std::thread::hardware_concurrency() > 1 ? 1000 : 0;
+  return count;
+}
 
-  static Task *createDelayed(
-      std::function<void()> &&func,
-      time_point startTime) {
-    return new Task{std::move(func), false, startTime};
-  }
+void cpuRelax() {
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || \
+    defined(__x86_64__)
+  _mm_pause();
+#elif defined(_M_ARM) || defined(_M_ARM64)
+  __yield();
+#else
+  std::this_thread::yield();
+#endif
+}
 
+struct Task {
   std::function<void()> func;
   // This flag is just to mark that the task is expected to be synchronous. If
   // a synchronous task races with stopping the queue, the thread waiting on
   // the synchronous task might never resume. We use this flag to detect this
   // case and throw an error.
-  bool sync;
+  bool sync{false};
   time_point startTime;
+  // Breaks ties between delayed tasks scheduled for the same time.
+  uint64_t sequence{0};
 
-  folly::AtomicIntrusiveLinkedListHook<Task> hook;
+  Task *next{nullptr};
 
-  // Should this sort consider id also?
   struct Compare {
     bool operator()(const Task *a, const Task *b) {
-      return a->startTime > b->startTime;
+      if (a->startTime != b->startTime) {
+        return a->startTime > b->startTime;
+      }
+      return a->sequence > b->sequence;
     }
   };
 };
 
-class DelayedTaskQueue {
+// Recycles tasks, so that posting a task does not allocate one. Each thread
+// keeps a few tasks of its own, and trades them with other threads in
+// batches. The runner thread frees the tasks that other threads allocate, so
+// without batches, every task would go through the shared lock.
+class TaskPool {
  public:
-  ~DelayedTaskQueue() {
-    while (!queue_.empty()) {
-      delete queue_.top();
-      queue_.pop();
+  static Task *allocate(std::function<void()> &&func) {
+    ThreadCache &cache = threadCache();
+    if (cache.tasks.empty()) {
+      instance().refill(cache);
+    }
+    Task *task = cache.tasks.back();
+    cache.tasks.pop_back();
+    task->func = std::move(func);
+    return task;
+  }
+
+  static void free(Task *task) {
+    task->func = nullptr;
+    task->sync = false;
+    task->startTime = time_point();
+    task->next = nullptr;
+
+    ThreadCache &cache = threadCache();
+    cache.tasks.push_back(task);
+    if (cache.tasks.size() == kCacheSize) {
+      instance().spill(cache, kBatchSize);
+    }
+  }
+
+ private:
+  static constexpr size_t kBatchSize = 32;
+  static constexpr size_t kCacheSize = 2 * kBatchSize;
+  // Tasks beyond this many are deleted rather than kept in the pool, so that
+  // a burst does not hold on to its memory forever.
+  static constexpr size_t kMaxPoolSize = 4096;
+
+  struct ThreadCache {
+    ThreadCache() {
+      // free() must not throw.
+      tasks.reserve(kCacheSize);
+    }
+
+    ~ThreadCache() {
+      instance().spill(*this, tasks.size());
+    }
+
+    std::vector<Task *> tasks;
+  };
+
+  // The pool is never destroyed, as threads may exit after static
+  // destructors have run.
+  static TaskPool &instance() {
+    static TaskPool *pool = new TaskPool();
+    return *pool;
+  }
+
+  static ThreadCache &threadCache() {
+    thread_local ThreadCache cache;
+    return cache;
+  }
+
+  void refill(ThreadCache &cache) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      while (head_ && cache.tasks.size() < kBatchSize) {
+        Task *task = head_;
+        head_ = task->next;
+        task->next = nullptr;
+        --size_;
+        cache.tasks.push_back(task);
+      }
+    }
+
+    while (cache.tasks.size() < kBatchSize) {
+      cache.tasks.push_back(new Task());
     }
   }
 
-  void process() {
-    while (!queue_.empty()) {
-      Task *d = queue_.top();
-      if (now() < d->startTime) {
-        break;
+  void spill(ThreadCache &cache, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (; count > 0; --count) {
+      Task *task = cache.tasks.back();
+      cache.tasks.pop_back();
+      if (size_ < kMaxPoolSize) {
+        task->next = head_;
+        head_ = task;
+        ++size_;
+      } else {
+        delete task;
       }
-      auto owned = std::unique_ptr<Task>(queue_.top());
-      queue_.pop();
-      owned->func();
     }
   }
 
-  void push(Task *t) {
-    queue_.push(t);
+  std::mutex mutex_;
+  Task *head_{nullptr};
+  size_t size_{0};
+};
+
+// A lock-free queue that any thread may push tasks to, and only the runner
+// thread takes tasks from. Tasks are pushed onto a stack, and the runner
+// takes the whole stack at once, so there is no ABA problem.
+class TaskLane {
+ public:
+  // Returns true if the lane was empty.
+  bool push(Task *task) {
+    Task *head = head_.load(std::memory_order_relaxed);
+    do {
+      task->next = head;
+    } while (!head_.compare_exchange_weak(
+        head, task, std::memory_order_seq_cst, std::memory_order_relaxed));
+    return head == nullptr;
   }
 
-  bool empty() {
-    return queue_.empty();
+  // Returns the tasks in the order they were pushed.
+  Task *takeAll() {
+    Task *head = head_.exchange(nullptr, std::memory_order_acquire);
+    Task *reversed = nullptr;
+    while (head) {
+      Task *next = head->next;
+      head->next = reversed;
+      reversed = head;
+      head = next;
+    }
+    return reversed;
   }
 
-  time_point nextTime() {
-    return queue_.top()->startTime;
+  bool empty() const {
+    return head_.load(std::memory_order_seq_cst) == nullptr;
   }
 
  private:
-  std::priority_queue<Task *, std::vector<Task *>, Task::Compare> queue_;
+  std::atomic<Task *> head_{nullptr};
 };
 
+void freeTasks(Task *tasks) {
+  while (tasks) {
+    Task *next = tasks->next;
+    TaskPool::free(tasks);
+    tasks = next;
+  }
+}
+
 } // namespace
 
 class CxxMessageQueue::QueueRunner {
  public:
   ~QueueRunner() {
-    queue_.sweep([](Task *t) { delete t; });
+    freeTasks(running_);
+    freeTasks(immediate_.takeAll());
+    freeTasks(delayed_.takeAll());
+    freeTasks(idle_.takeAll());
+    while (!timers_.empty()) {
+      TaskPool::free(timers_.top());
+      timers_.pop();
+    }
+    for (Task *t : idleTasks_) {
+      TaskPool::free(t);
+    }
   }
 
   void enqueue(std::function<void()> &&func) {
-    enqueueTask(Task::create(std::move(func)));
+    post(immediate_, TaskPool::allocate(std::move(func)));
   }
 
   void enqueueDelayed(std::function<void()> &&func, uint64_t delayMs) {
     if (delayMs) {
-      enqueueTask(Task::createDelayed(
-          std::move(func), now() + std::chrono::milliseconds(delayMs)));
+      Task *task = TaskPool::allocate(std::move(func));
+      task->startTime = now() + std::chrono::milliseconds(delayMs);
+      post(delayed_, task);
     } else {
       enqueue(std::move(func));
     }
   }
 
+  void enqueueIdle(std::function<void()> &&func) {
+    post(idle_, TaskPool::allocate(std::move(func)));
+  }
+
   void enqueueSync(std::function<void()> &&func) {
     EventFlag done;
-    enqueueTask(Task::createSync([&]() mutable {
+    Task *task = TaskPool::allocate([&]() mutable {
       func();
       done.set();
-    }));
+    });
+    task->sync = true;
+    post(immediate_, task);
     if (stopped_) {
       // If this queue is stopped_, the sync task might never actually run.
       throw std::runtime_error("Stopped within enqueueSync.");
@@ -154,46 +292,19 @@ class CxxMessageQueue::QueueRunner {
     // If we are stopped on this thread, then memory order doesn't really
     // matter reading stopped_.
     while (!stopped_.load(std::memory_order_relaxed)) {
-      sweep();
-      if (delayed_.empty()) {
-        pending_.wait();
-      } else {
-        pending_.wait_until(delayed_.nextTime());
+      if (!runOnce()) {
+        waitForTasks();
       }
     }
     // This sweep is just to catch erroneous enqueueSync. That is, there could
     // be a task marked sync that another thread is waiting for, but we'll
     // never actually run it.
-    sweep();
+    discardRunning();
+    running_ = immediate_.takeAll();
+    discardRunning();
     finished_.set();
   }
 
-  // We are processing two queues, the posted tasks (queue_) and the delayed
-  // tasks (delayed_). Delayed tasks first go into posted tasks, and then are
-  // moved to the delayed queue if we pop them before the time they are
-  // scheduled for.
-  // As we pop things from queue_, before dealing with that thing, we run any
-  // delayed tasks whose scheduled time has arrived.
-  void sweep() {
-    queue_.sweep([this](Task *t) {
-      std::unique_ptr<Task> owned(t);
-      if (stopped_.load(std::memory_order_relaxed)) {
-        if (t->sync) {
-          throw std::runtime_error("Sync task posted while stopped.");
-        }
-        return;
-      }
-
-      delayed_.process();
-      if (t->startTime != time_point() && now() <= t->startTime) {
-        delayed_.push(owned.release());
-      } else {
-        t->func();
-      }
-    });
-    delayed_.process();
-  }
-
   void bindToThisThread() {
     if (tid_ != std::thread::id{}) {
       throw std::runtime_error("Message queue already bound to thread.");
@@ -206,18 +317,143 @@ class CxxMessageQueue::QueueRunner {
   }
 
  private:
-  void enqueueTask(Task *task) {
-    if (queue_.insertHead(task)) {
+  void post(TaskLane &lane, Task *task) {
+    // This pairs with the store to parked_ in waitForTasks. Either the runner
+    // sees the task before it sleeps, or we see that it is about to sleep.
+    // The runner only sleeps when all lanes are empty, so only the task that
+    // makes a lane non-empty needs to wake it.
+    if (lane.push(task) && parked_.load(std::memory_order_seq_cst)) {
       pending_.set();
     }
   }
 
+  // Runs the tasks that are ready. Returns false if there were none.
+  bool runOnce() {
+    bool ran = runTimers();
+
+    // Only the tasks posted so far run in this pass, so that a steady stream
+    // of tasks does not keep the idle lane from running.
+    running_ = immediate_.takeAll();
+    while (running_) {
+      if (stopped_.load(std::memory_order_relaxed)) {
+        return true;
+      }
+
+      Task *t = running_;
+      running_ = t->next;
+      runTask(t);
+      ran = true;
+
+      runTimers();
+    }
+
+    if (!ran && immediate_.empty()) {
+      ran = runIdleTask();
+    }
+    return ran;
+  }
+
+  // Runs the delayed tasks whose time has come.
+  bool runTimers() {
+    if (!delayed_.empty()) {
+      for (Task *t = delayed_.takeAll(); t;) {
+        Task *next = t->next;
+        t->sequence = ++sequence_;
+        timers_.push(t);
+        t = next;
+      }
+    }
+
+    bool ran = false;
+    if (!timers_.empty()) {
+      const time_point current = now();
+      while (!timers_.empty() && timers_.top()->startTime <= current &&
+             !stopped_.load(std::memory_order_relaxed)) {
+        Task *t = timers_.top();
+        timers_.pop();
+        runTask(t);
+        ran = true;
+      }
+    }
+    return ran;
+  }
+
+  bool runIdleTask() {
+    for (Task *t = idle_.takeAll(); t; t = t->next) {
+      idleTasks_.push_back(t);
+    }
+
+    if (idleTasks_.empty()) {
+      return false;
+    }
+
+    Task *t = idleTasks_.front();
+    idleTasks_.pop_front();
+    runTask(t);
+    return true;
+  }
+
+  void runTask(Task *t) {
+    struct Guard {
+      ~Guard() {
+        TaskPool::free(task);
+      }
+      Task *task;
+    } guard{t};
+    t->func();
+  }
+
+  void discardRunning() {
+    while (running_) {
+      Task *t = running_;
+      running_ = t->next;
+      bool sync = t->sync;
+      TaskPool::free(t);
+      if (sync) {
+        throw std::runtime_error("Sync task posted while stopped.");
+      }
+    }
+  }
+
+  bool hasTasks() const {
+    return !immediate_.empty() || !delayed_.empty() || !idle_.empty() ||
+        !idleTasks_.empty() || stopped_.load(std::memory_order_relaxed) ||
+        (!timers_.empty() && timers_.top()->startTime <= now());
+  }
+
+  void waitForTasks() {
+    for (int i = spinCount(); i > 0; --i) {
+      if (hasTasks()) {
+        return;
+      }
+      cpuRelax();
+    }
+
+    parked_.store(true, std::memory_order_seq_cst);
+    if (!hasTasks()) {
+      if (timers_.empty()) {
+        pending_.wait();
+      } else {
+        pending_.wait_until(timers_.top()->startTime);
+      }
+    }
+    parked_.store(false, std::memory_order_relaxed);
+  }
+
   std::thread::id tid_;
 
-  folly::AtomicIntrusiveLinkedList<Task, &Task::hook> queue_;
+  TaskLane immediate_;
+  TaskLane delayed_;
+  TaskLane idle_;
+
+  // These are only used on the runner thread.
+  Task *running_{nullptr};
+  std::priority_queue<Task *, std::vector<Task *>, Task::Compare> timers_;
+  std::deque<Task *> idleTasks_;
+  uint64_t sequence_{0};
 
   std::atomic_bool stopped_{false};
-  DelayedTaskQueue delayed_;
+  std::atomic_bool parked_{false};
 
   BinarySemaphore pending_;
   EventFlag finished_;
@@ -243,6 +479,10 @@ void CxxMessageQueue::runOnQueueDelayed(
   qr_->enqueueDelayed(std::move(func), delayMs);
 }
 
+void CxxMessageQueue::runOnQueueIdle(std::function<void()> &&func) {
+  qr_->enqueueIdle(std::move(func));
+}
+
 void CxxMessageQueue::runOnQueueSync(std::function<void()> &&func) {
   if (isOnQueue()) {
     func();
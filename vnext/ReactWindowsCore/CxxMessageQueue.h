@@ -7,6 +7,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -51,12 +52,18 @@ using BinarySemaphore = CVFlag<true>;
 using EventFlag = CVFlag<false>;
 } // namespace detail
 
+// Tasks are posted to one of three lanes. Delayed tasks whose time has come
+// run first, even during a burst of posted tasks, so that timers are not
+// starved. Then posted tasks run in the order they were posted, and idle
+// tasks run last.
 class CxxMessageQueue : public MessageQueueThread {
  public:
   CxxMessageQueue();
   virtual ~CxxMessageQueue() override;
   virtual void runOnQueue(std::function<void()> &&) override;
   void runOnQueueDelayed(std::function<void()> &&, uint64_t delayMs);
+  // Idle tasks run one at a time, only when no other task is ready to run.
+  void runOnQueueIdle(std::function<void()> &&);
   // runOnQueueSync and quitSynchronous are dangerous.  They should only be
   // used for initialization and cleanup.
   virtual void runOnQueueSync(std::function<void()> &&) override;
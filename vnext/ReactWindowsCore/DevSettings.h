@@ -90,6 +90,11 @@ struct DevSettings {
   // Enables ChakraCore console redirection to debugger
   bool debuggerConsoleRedirection{false};
 
+  /// When the prepared script (bytecode) cache has no entry for the bundle,
+  /// run the bundle source right away and generate the cache entry on a
+  /// background thread for the next launch.
+  bool prepareScriptsInBackground{false};
+
   /// Dispatcher for notifications about JS engine memory consumption.
   std::shared_ptr<MemoryTracker> memoryTracker;
 
@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "EventCoalescer.h"
+
+#include <functional>
+
+namespace facebook {
+namespace react {
+
+/*static*/ bool EventCoalescer::IsCoalescable(
+    const std::string &eventName) noexcept {
+  return eventName == "topScroll" || eventName == "topTouchMove" ||
+      eventName == "topMouseMove";
+}
+
+bool EventCoalescer::Push(
+    std::string method,
+    folly::dynamic &&params,
+    std::optional<Key> key) {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  ++m_counters.queued;
+
+  if (!key) {
+    m_coalescable.clear();
+  } else {
+    auto queued = m_coalescable.find(*key);
+    if (queued != m_coalescable.end()) {
+      Event &event = m_events[queued->second];
+      event.method = std::move(method);
+      event.params = std::move(params);
+      ++m_counters.coalesced;
+      return false;
+    }
+
+    m_coalescable.emplace(std::move(*key), m_events.size());
+  }
+
+  m_events.push_back(Event{std::move(method), std::move(params)});
+  return m_events.size() == 1;
+}
+
+std::vector<EventCoalescer::Event> EventCoalescer::Drain() {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  ++m_counters.drained;
+  m_coalescable.clear();
+
+  std::vector<Event> events;
+  events.swap(m_events);
+  return events;
+}
+
+EventCoalescer::Counters EventCoalescer::GetCounters() const {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_counters;
+}
+
+size_t EventCoalescer::KeyHash::operator()(const Key &key) const noexcept {
+  size_t hash = std::hash<std::string>{}(key.eventName);
+  hash ^= std::hash<int64_t>{}(key.viewTag) + 0x9e3779b9 + (hash << 6) +
+      (hash >> 2);
+  hash ^= std::hash<int64_t>{}(key.coalescingKey) + 0x9e3779b9 + (hash << 6) +
+      (hash >> 2);
+  return hash;
+}
+
+bool EventCoalescer::KeyEqual::operator()(const Key &a, const Key &b) const
+    noexcept {
+  return a.viewTag == b.viewTag && a.coalescingKey == b.coalescingKey &&
+      a.eventName == b.eventName;
+}
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <folly/dynamic.h>
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace facebook {
+namespace react {
+
+// Holds the events native views send to JS until the JS thread takes them,
+// so that JS only receives the latest of the events a view sends faster than
+// JS handles them, such as scroll events and touch moves.
+//
+// An event with a coalescing key replaces the payload of the queued event
+// with the same view tag, name and coalescing key, which keeps its place in
+// the queue. Events are never coalesced across an event without a key, so
+// that, for instance, a scroll event sent after topScrollEndDrag is not
+// received before it.
+class EventCoalescer {
+ public:
+  struct Key {
+    int64_t viewTag;
+    std::string eventName;
+    int64_t coalescingKey;
+  };
+
+  // A call to RCTEventEmitter.
+  struct Event {
+    std::string method;
+    folly::dynamic params;
+  };
+
+  struct Counters {
+    // Events queued.
+    uint64_t queued{0};
+
+    // Events dropped because a later event replaced their payload before JS
+    // received them.
+    uint64_t coalesced{0};
+
+    // Times the JS thread took the queued events.
+    uint64_t drained{0};
+  };
+
+  // Whether the events named eventName are sent too often for JS to receive
+  // them all, and only the latest one matters.
+  static bool IsCoalescable(const std::string &eventName) noexcept;
+
+  // Returns true if the queue was empty. The caller must then have the JS
+  // thread call Drain.
+  bool Push(
+      std::string method,
+      folly::dynamic &&params,
+      std::optional<Key> key = std::nullopt);
+
+  std::vector<Event> Drain();
+
+  Counters GetCounters() const;
+
+ private:
+  struct KeyHash {
+    size_t operator()(const Key &key) const noexcept;
+  };
+
+  struct KeyEqual {
+    bool operator()(const Key &a, const Key &b) const noexcept;
+  };
+
+  mutable std::mutex m_mutex;
+  std::vector<Event> m_events;
+
+  // The index in m_events of the events that later events may replace.
+  std::unordered_map<Key, size_t, KeyHash, KeyEqual> m_coalescable;
+
+  Counters m_counters;
+};
+
+} // namespace react
+} // namespace facebook
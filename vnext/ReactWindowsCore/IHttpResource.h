@@ -4,6 +4,7 @@
 #pragma once
 
 #include <Folly/dynamic.h>
+#include <cxxreact/MessageQueueThread.h>
 
 namespace Microsoft::React {
 
@@ -12,8 +13,25 @@ struct IHttpResource {
 
   static std::unique_ptr<IHttpResource> Make() noexcept;
 
+  // The resource calls its handlers on callbackQueue. Without one, it calls
+  // them on the thread that completed the request.
+  static std::unique_ptr<IHttpResource> Make(
+      std::shared_ptr<facebook::react::MessageQueueThread>
+          callbackQueue) noexcept;
+
   virtual ~IHttpResource() noexcept {}
 
+  // responseType is "text", "base64", or "file". With "base64", the response
+  // handler receives the body encoded. With "file", the body is written to the
+  // file set with SetResponseFile, and the response handler receives its path.
+  //
+  // bodyData holds one of "string", "base64", or "uri", the path or file://
+  // URI of a file that is sent as it is read.
+  //
+  // With useIncrementalUpdates, "text" bodies go to the incremental data
+  // handler as they arrive, and the response handler receives an empty
+  // string. Other response types report their progress to the data progress
+  // handler.
   virtual void SendRequest(
       const std::string &method,
       const std::string &url,
@@ -26,7 +44,24 @@ struct IHttpResource {
   virtual void AbortRequest() noexcept = 0;
   virtual void ClearCookies() noexcept = 0;
 
+  virtual void SetResponseFile(std::string &&path) noexcept = 0;
+
+  // total is -1 when the size of the request body is not known up front.
+  virtual void SetOnDataSent(
+      std::function<void(int64_t sent, int64_t total)> &&handler) noexcept = 0;
   virtual void SetOnRequest(std::function<void()> &&handler) noexcept = 0;
+  virtual void SetOnResponseReceived(
+      std::function<void(int64_t statusCode, const Headers &headers)>
+          &&handler) noexcept = 0;
+
+  // total is -1 when the server did not send the length of the body.
+  virtual void SetOnIncrementalData(
+      std::function<
+          void(const std::string &data, int64_t loaded, int64_t total)>
+          &&handler) noexcept = 0;
+  virtual void SetOnDataProgress(
+      std::function<void(int64_t loaded, int64_t total)>
+          &&handler) noexcept = 0;
   virtual void SetOnResponse(
       std::function<void(const std::string &)> &&handler) noexcept = 0;
   virtual void SetOnError(
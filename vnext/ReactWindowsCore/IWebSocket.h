@@ -5,6 +5,8 @@
 
 #include <functional>
 #include <map>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace Microsoft::React {
@@ -18,6 +20,10 @@ struct IWebSocket {
   using Protocols = std::vector<std::string>;
   using Options = std::map<std::wstring, std::string>;
 
+  // The buffers a binary message arrived in, in order. They are only valid
+  // while the handler that receives them runs.
+  using BinaryMessage = std::vector<std::string_view>;
+
 #pragma endregion Aliases
 
 #pragma region Inner types
@@ -123,9 +129,21 @@ struct IWebSocket {
   /// </param>
   virtual void SendBinary(const std::string &base64String) = 0;
 
+  /// <summary>
+  /// Sends a non-plain-text message to the remote endpoint, without the
+  /// Base64 round trip. For callers that hold the raw bytes, such as a JSI
+  /// ArrayBuffer.
+  /// </summary>
+  /// <param name="data">
+  /// Binary message.
+  /// </param>
+  virtual void SendBinaryData(std::string &&data) = 0;
+
   /// <summary>
   /// Terminates this resource's connection to the remote endpoint.
   /// This instance can't be restarted or re-connected afterwards.
+  /// Returns right away; the close handler runs once the remote endpoint
+  /// acknowledged the close.
   /// </summary>
   /// <param name="close">
   /// </param>
@@ -169,6 +187,17 @@ struct IWebSocket {
   virtual void SetOnMessage(
       std::function<void(std::size_t, const std::string &)> &&handler) = 0;
 
+  /// <summary>
+  /// Sets the optional custom behavior to run when there is an incoming
+  /// binary message. When set, binary messages are passed to this handler as
+  /// raw bytes, without copying them, instead of to the <c>SetOnMessage</c>
+  /// handler as Base64.
+  /// </summary>
+  /// <param name="handler">
+  /// </param>
+  virtual void SetOnBinaryMessage(
+      std::function<void(const BinaryMessage &)> &&handler) = 0;
+
   /// <summary>
   /// Sets the optional custom behavior to run when this instance is closed.
   /// </summary>
@@ -0,0 +1,379 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "ImageCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <string>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace Microsoft::React {
+
+ImageCache::ImageCache(Options options, Fetch fetch)
+    : m_options{std::move(options)},
+      m_fetch{std::move(fetch)},
+      m_diskDirectory{m_options.diskDirectory.empty()
+                          ? fs::path{}
+                          : fs::u8path(m_options.diskDirectory)} {
+  if (!m_diskDirectory.empty()) {
+    LoadDiskIndex();
+  }
+}
+
+void ImageCache::Get(const Request &request, Callback &&done) {
+  std::string key = Key(request);
+  bool onDisk = false;
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    if (Bytes bytes = FindInMemory(key)) {
+      lock.unlock();
+      done(std::move(bytes));
+      return;
+    }
+
+    auto pending = m_pending.find(key);
+    if (pending != m_pending.end()) {
+      pending->second.push_back(std::move(done));
+      return;
+    }
+
+    m_pending[key].push_back(std::move(done));
+    onDisk = m_diskIndex.count(FileName(key)) != 0;
+  }
+
+  if (onDisk) {
+    if (Bytes bytes = ReadFromDisk(key)) {
+      Complete(key, std::move(bytes), true /*fromDisk*/);
+      return;
+    }
+  }
+
+  try {
+    m_fetch(request, [self = shared_from_this(), key](Bytes bytes) {
+      self->Complete(key, std::move(bytes), false /*fromDisk*/);
+    });
+  } catch (...) {
+    // Reported like any failed download, to every request for the image.
+    Complete(key, nullptr, false /*fromDisk*/);
+  }
+}
+
+ImageCache::Bytes ImageCache::Find(const Request &request) {
+  const std::string key = Key(request);
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return FindInMemory(key);
+}
+
+ImageCache::Location ImageCache::Query(const Request &request) const {
+  const std::string key = Key(request);
+  std::lock_guard<std::mutex> lock{m_mutex};
+  if (m_memoryIndex.count(key) != 0) {
+    return Location::Memory;
+  }
+  if (m_diskIndex.count(FileName(key)) != 0) {
+    return Location::Disk;
+  }
+  return Location::None;
+}
+
+void ImageCache::Clear() {
+  std::list<DiskEntry> disk;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_memory.clear();
+    m_memoryIndex.clear();
+    m_memorySize = 0;
+
+    disk = std::move(m_disk);
+    m_disk.clear();
+    m_diskIndex.clear();
+    m_diskSize = 0;
+  }
+
+  std::error_code ec;
+  for (const DiskEntry &entry : disk) {
+    fs::remove(m_diskDirectory / entry.fileName, ec);
+  }
+}
+
+size_t ImageCache::MemorySize() const {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_memorySize;
+}
+
+size_t ImageCache::DiskSize() const {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_diskSize;
+}
+
+/*static*/ std::string ImageCache::Key(const Request &request) {
+  std::vector<std::pair<std::string, std::string>> headers;
+  headers.reserve(request.headers.size());
+  for (const auto &header : request.headers) {
+    std::string name = header.first;
+    std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+      return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+    headers.emplace_back(std::move(name), header.second);
+  }
+  std::sort(headers.begin(), headers.end());
+
+  std::string key = request.method.empty() ? "GET" : request.method;
+  key += ' ';
+  key += request.uri;
+  for (const auto &header : headers) {
+    key += '\n';
+    key += header.first;
+    key += ':';
+    key += header.second;
+  }
+  return key;
+}
+
+/*static*/ std::string ImageCache::FileName(const std::string &key) {
+  // 64-bit FNV-1a, which unlike std::hash is the same from one build to the
+  // next. Files start with their key, so that collisions are detected.
+  uint64_t hash = 14695981039346656037ull;
+  for (char c : key) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+
+  constexpr char digits[] = "0123456789abcdef";
+  std::string fileName(16, '0');
+  for (size_t i = 0; i < fileName.size(); ++i) {
+    fileName[fileName.size() - 1 - i] = digits[(hash >> (4 * i)) & 0xf];
+  }
+  return fileName;
+}
+
+void ImageCache::LoadDiskIndex() {
+  std::error_code ec;
+  fs::create_directories(m_diskDirectory, ec);
+
+  struct File {
+    std::string fileName;
+    size_t size;
+    fs::file_time_type lastWriteTime;
+  };
+  std::vector<File> files;
+  for (fs::directory_iterator it{m_diskDirectory, ec}, end; !ec && it != end;
+       it.increment(ec)) {
+    const fs::path &path = it->path();
+    if (path.extension() == ".tmp") {
+      // Left over by a write that did not complete.
+      std::error_code removeEc;
+      fs::remove(path, removeEc);
+      continue;
+    }
+
+    std::error_code sizeEc, timeEc;
+    const uintmax_t size = it->file_size(sizeEc);
+    const fs::file_time_type lastWriteTime = it->last_write_time(timeEc);
+    if (!sizeEc && !timeEc) {
+      files.push_back(File{
+          path.filename().u8string(),
+          static_cast<size_t>(size),
+          lastWriteTime});
+    }
+  }
+
+  // Files are touched as they are read, so the most recently used come first.
+  std::sort(files.begin(), files.end(), [](const File &a, const File &b) {
+    return a.lastWriteTime > b.lastWriteTime;
+  });
+
+  std::vector<std::string> evicted;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    for (File &file : files) {
+      m_disk.push_back(DiskEntry{std::move(file.fileName), file.size});
+      m_diskIndex[m_disk.back().fileName] = std::prev(m_disk.end());
+      m_diskSize += file.size;
+    }
+    evicted = EvictFromDisk();
+  }
+
+  for (const std::string &fileName : evicted) {
+    fs::remove(m_diskDirectory / fileName, ec);
+  }
+}
+
+ImageCache::Bytes ImageCache::ReadFromDisk(const std::string &key) {
+  const std::string fileName = FileName(key);
+  const fs::path path = m_diskDirectory / fileName;
+
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (file) {
+    const std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    const std::streamsize headerSize =
+        static_cast<std::streamsize>(key.size() + 1);
+    std::string fileKey;
+    if (size >= headerSize && std::getline(file, fileKey, '\0') &&
+        fileKey == key) {
+      auto bytes = std::make_shared<std::vector<uint8_t>>(
+          static_cast<size_t>(size - headerSize));
+      if (file.read(
+              reinterpret_cast<char *>(bytes->data()), size - headerSize)) {
+        std::error_code ec;
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+        auto entry = m_diskIndex.find(fileName);
+        if (entry != m_diskIndex.end()) {
+          m_disk.splice(m_disk.begin(), m_disk, entry->second);
+        }
+        return bytes;
+      }
+    }
+  }
+
+  // The file is gone, or holds another image whose key has the same hash.
+  std::lock_guard<std::mutex> lock{m_mutex};
+  auto entry = m_diskIndex.find(fileName);
+  if (entry != m_diskIndex.end()) {
+    m_diskSize -= entry->second->size;
+    m_disk.erase(entry->second);
+    m_diskIndex.erase(entry);
+  }
+  return nullptr;
+}
+
+void ImageCache::WriteToDisk(const std::string &key, const Bytes &bytes) {
+  // Write to a temporary file and move it over the image, so that a reader
+  // never sees a partially written image, even if the app exits while
+  // writing. Each writer has a file of its own, as two may store the same
+  // key.
+  const std::string fileName = FileName(key);
+  const fs::path path = m_diskDirectory / fileName;
+  fs::path tempPath = path;
+  tempPath += "." + std::to_string(GetCurrentProcessId()) + "." +
+      std::to_string(GetCurrentThreadId()) + ".tmp";
+
+  std::error_code ec;
+  std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return;
+  }
+
+  file.write(key.c_str(), key.size() + 1);
+  file.write(
+      reinterpret_cast<const char *>(bytes->data()),
+      static_cast<std::streamsize>(bytes->size()));
+  file.close();
+  if (!file) {
+    fs::remove(tempPath, ec);
+    return;
+  }
+
+  fs::rename(tempPath, path, ec);
+  if (ec) {
+    fs::remove(tempPath, ec);
+    return;
+  }
+
+  std::vector<std::string> evicted;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    AddToDiskIndex(fileName, key.size() + 1 + bytes->size());
+    evicted = EvictFromDisk();
+  }
+
+  for (const std::string &evictedFileName : evicted) {
+    fs::remove(m_diskDirectory / evictedFileName, ec);
+  }
+}
+
+void ImageCache::Complete(const std::string &key, Bytes bytes, bool fromDisk) {
+  std::vector<Callback> waiting;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto pending = m_pending.find(key);
+    if (pending != m_pending.end()) {
+      waiting = std::move(pending->second);
+      m_pending.erase(pending);
+    }
+
+    if (bytes) {
+      AddToMemory(key, bytes);
+    }
+  }
+
+  for (Callback &done : waiting) {
+    done(bytes);
+  }
+
+  if (bytes && !fromDisk && !m_diskDirectory.empty()) {
+    WriteToDisk(key, bytes);
+  }
+}
+
+ImageCache::Bytes ImageCache::FindInMemory(const std::string &key) {
+  auto entry = m_memoryIndex.find(key);
+  if (entry == m_memoryIndex.end()) {
+    return nullptr;
+  }
+
+  m_memory.splice(m_memory.begin(), m_memory, entry->second);
+  return entry->second->bytes;
+}
+
+void ImageCache::AddToMemory(const std::string &key, Bytes bytes) {
+  const size_t size = bytes->size();
+  if (size > m_options.memoryCapacity) {
+    return;
+  }
+
+  auto entry = m_memoryIndex.find(key);
+  if (entry != m_memoryIndex.end()) {
+    m_memorySize -= entry->second->bytes->size();
+    entry->second->bytes = std::move(bytes);
+    m_memory.splice(m_memory.begin(), m_memory, entry->second);
+  } else {
+    m_memory.push_front(MemoryEntry{key, std::move(bytes)});
+    m_memoryIndex[key] = m_memory.begin();
+  }
+  m_memorySize += size;
+
+  while (m_memorySize > m_options.memoryCapacity) {
+    const MemoryEntry &leastRecentlyUsed = m_memory.back();
+    m_memorySize -= leastRecentlyUsed.bytes->size();
+    m_memoryIndex.erase(leastRecentlyUsed.key);
+    m_memory.pop_back();
+  }
+}
+
+void ImageCache::AddToDiskIndex(std::string fileName, size_t size) {
+  auto entry = m_diskIndex.find(fileName);
+  if (entry != m_diskIndex.end()) {
+    m_diskSize -= entry->second->size;
+    entry->second->size = size;
+    m_disk.splice(m_disk.begin(), m_disk, entry->second);
+  } else {
+    m_disk.push_front(DiskEntry{std::move(fileName), size});
+    m_diskIndex[m_disk.front().fileName] = m_disk.begin();
+  }
+  m_diskSize += size;
+}
+
+std::vector<std::string> ImageCache::EvictFromDisk() {
+  std::vector<std::string> evicted;
+  while (m_diskSize > m_options.diskCapacity) {
+    DiskEntry &leastRecentlyUsed = m_disk.back();
+    m_diskSize -= leastRecentlyUsed.size;
+    m_diskIndex.erase(leastRecentlyUsed.fileName);
+    evicted.push_back(std::move(leastRecentlyUsed.fileName));
+    m_disk.pop_back();
+  }
+  return evicted;
+}
+
+} // namespace Microsoft::React
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Microsoft::React {
+
+// Caches the bytes of downloaded images, so that the images of a list are
+// not downloaded again as it scrolls back, and so that prefetched images are
+// there when an Image asks for them. The cache only deals in bytes: how an
+// image is downloaded is up to the fetch function it is created with, and
+// decoding is up to the caller.
+//
+// Images are cached by method, URI and headers. The most recently used ones
+// are kept in memory, up to a number of bytes, and, if the cache is given a
+// directory, on disk as well. Concurrent requests for an image that is not
+// cached share a single download. Responses are cached as long as they are
+// not evicted; cache headers are not taken into account.
+//
+// Create caches with std::make_shared, as the downloads in progress keep
+// their cache alive. A cache may be used from any thread.
+class ImageCache final : public std::enable_shared_from_this<ImageCache> {
+ public:
+  using Bytes = std::shared_ptr<const std::vector<uint8_t>>;
+  using Callback = std::function<void(Bytes)>;
+
+  // Header names are not case sensitive. The cache lowercases them.
+  using Headers = std::map<std::string, std::string>;
+
+  struct Request {
+    std::string uri;
+    std::string method{"GET"};
+    Headers headers;
+  };
+
+  // Downloads an image, and calls done exactly once, on any thread, with the
+  // body of the response, or with nullptr if the request fails.
+  using Fetch = std::function<void(const Request &request, Callback &&done)>;
+
+  struct Options {
+    size_t memoryCapacity{32 * 1024 * 1024};
+
+    // UTF-8. Images are only cached in memory if empty.
+    std::string diskDirectory;
+    size_t diskCapacity{128 * 1024 * 1024};
+  };
+
+  enum class Location { None, Memory, Disk };
+
+  ImageCache(Options options, Fetch fetch);
+
+  ImageCache(const ImageCache &) = delete;
+  ImageCache &operator=(const ImageCache &) = delete;
+
+  // Calls done with the bytes of the image, or with nullptr if it cannot be
+  // downloaded, which includes fetch throwing. done is called before Get
+  // returns if the image is in memory. Otherwise, Get may read the image from
+  // disk before returning, and done is called on the thread the image is read
+  // or downloaded on.
+  void Get(const Request &request, Callback &&done);
+
+  // The bytes of the image if it is in memory, or nullptr.
+  Bytes Find(const Request &request);
+
+  Location Query(const Request &request) const;
+
+  // Empties both tiers. Downloads in progress are still cached when they
+  // complete.
+  void Clear();
+
+  size_t MemorySize() const;
+  size_t DiskSize() const;
+
+ private:
+  struct MemoryEntry {
+    std::string key;
+    Bytes bytes;
+  };
+
+  struct DiskEntry {
+    std::string fileName;
+    size_t size;
+  };
+
+  static std::string Key(const Request &request);
+  static std::string FileName(const std::string &key);
+
+  void LoadDiskIndex();
+  Bytes ReadFromDisk(const std::string &key);
+  void WriteToDisk(const std::string &key, const Bytes &bytes);
+  void Complete(const std::string &key, Bytes bytes, bool fromDisk);
+
+  // The following require m_mutex to be held.
+  Bytes FindInMemory(const std::string &key);
+  void AddToMemory(const std::string &key, Bytes bytes);
+  void AddToDiskIndex(std::string fileName, size_t size);
+  std::vector<std::string> EvictFromDisk();
+
+  const Options m_options;
+  const Fetch m_fetch;
+  const std::filesystem::path m_diskDirectory;
+
+  mutable std::mutex m_mutex;
+
+  // Most recently used first.
+  std::list<MemoryEntry> m_memory;
+  std::unordered_map<std::string, std::list<MemoryEntry>::iterator>
+      m_memoryIndex;
+  size_t m_memorySize{0};
+
+  std::list<DiskEntry> m_disk;
+  std::unordered_map<std::string, std::list<DiskEntry>::iterator> m_diskIndex;
+  size_t m_diskSize{0};
+
+  // The callbacks waiting for each image being read or downloaded.
+  std::unordered_map<std::string, std::vector<Callback>> m_pending;
+};
+
+} // namespace Microsoft::React
@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cxxreact/JSBigString.h>
+#include <cxxreact/JSModulesUnbundle.h>
+#include <jsi/jsi.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Microsoft::React {
+
+// Reads an indexed RAM bundle (what `react-native ram-bundle
+// --indexed-ram-bundle` writes) out of a buffer holding the whole file,
+// usually one from MakeMemoryMappedBuffer. Only the startup code runs when
+// the bundle loads; every other module is evaluated when nativeRequire first
+// asks for it. The startup code and the modules are handed out as views into
+// the buffer, so the code of a module is only paged in when it is required,
+// and is not copied on its way to the JS engine.
+//
+// The file starts with three little-endian uint32_t: the magic number, the
+// number of modules and the length of the startup code. A table with the
+// offset and the length of each module follows, then the startup code and the
+// modules. Offsets count from the end of the table, lengths include the null
+// character that ends every piece of code, and modules without code have a
+// length of 0.
+class IndexedRAMBundle final : public facebook::react::JSModulesUnbundle {
+ public:
+  static constexpr uint32_t MagicNumber = 0xFB0BD1E5;
+
+  static bool IsIndexedRAMBundle(const facebook::jsi::Buffer &bundle) noexcept;
+
+  // Reads only the header of the file, so that other bundles need not be
+  // mapped to find out they are not indexed RAM bundles.
+  static bool IsIndexedRAMBundle(const wchar_t *path) noexcept;
+
+  // Throws std::invalid_argument if bundle is not an indexed RAM bundle.
+  explicit IndexedRAMBundle(
+      std::shared_ptr<const facebook::jsi::Buffer> bundle);
+
+  uint32_t ModuleCount() const noexcept {
+    return m_moduleCount;
+  }
+
+  std::unique_ptr<const facebook::react::JSBigString> StartupCode() const;
+
+  // The following throw ModuleNotFound if the bundle has no code for
+  // moduleId.
+  std::shared_ptr<const facebook::jsi::Buffer> ModuleCode(
+      uint32_t moduleId) const;
+  std::unique_ptr<const facebook::react::JSBigString> ModuleCodeString(
+      uint32_t moduleId) const;
+
+  // The source URL modules are evaluated with, as in JSIndexedRAMBundle.
+  static std::string ModuleSourceURL(uint32_t moduleId);
+
+  // For the executors that take the code of a module as a std::string, which
+  // this copies out of the bundle.
+  Module getModule(uint32_t moduleId) const override;
+
+ private:
+  struct ModuleEntry {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  ModuleEntry FindModule(uint32_t moduleId) const;
+
+  std::shared_ptr<const facebook::jsi::Buffer> m_bundle;
+  uint32_t m_moduleCount{0};
+  uint32_t m_startupCodeLength{0};
+  size_t m_baseOffset{0};
+};
+
+} // namespace Microsoft::React
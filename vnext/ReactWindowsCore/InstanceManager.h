@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 #include "DevSettings.h"
+#include "EventCoalescer.h"
 #include "IReactRootView.h"
 
 namespace folly {
@@ -38,11 +39,18 @@ struct InstanceWrapper {
       int64_t viewTag,
       std::string eventName,
       folly::dynamic &&eventData) = 0;
+  virtual void DispatchTouchEvent(
+      std::string eventName,
+      folly::dynamic &&touches,
+      folly::dynamic &&changedIndices) = 0;
   virtual void invokeCallback(
       const int64_t callbackId,
       folly::dynamic &&params) = 0;
   virtual void loadBundle(std::string &&jsBundleRelativePath) = 0;
   virtual void loadBundleSync(std::string &&jsBundleRelativePath) = 0;
+
+  // How many of the events sent to JS were coalesced.
+  virtual EventCoalescer::Counters GetEventCounters() const noexcept = 0;
 };
 
 // Things that used to be exported from InstanceManager, but probably belong
@@ -54,10 +54,18 @@ AsyncStorageModule::getMethods() {
                 jsCallback);
           }),
 
-      // The 'multiMerge' method is currently not implemented. We assume that
-      // the ReactNative framework translates its absence into the AsyncStorage
-      // JS object (see Libraries\Storage\AsyncStorage.js around line 485) which
-      // in turn allows JS user code to test for support of merge methods.
+      Method(
+          "multiMerge",
+          [this](
+              dynamic args,
+              Callback jsCallback) // params - array<array<std::string>>
+                                   // KeyValuePairs , Callback(error)
+          {
+            m_asyncStorageManager->executeKVOperation(
+                AsyncStorageManager::AsyncStorageOperation::multiMerge,
+                args,
+                jsCallback);
+          }),
 
       Method(
           "multiRemove",
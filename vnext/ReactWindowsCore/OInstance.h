@@ -10,10 +10,15 @@
 #include <vector>
 
 #include <cxxreact/Instance.h>
+#include "EventCoalescer.h"
 #include "InstanceManager.h"
 #include "Sandbox/SandboxEndpoint.h"
 #include "ViewManager.h"
 
+namespace Microsoft::React {
+class IndexedRAMBundle;
+} // namespace Microsoft::React
+
 namespace facebook {
 namespace react {
 
@@ -89,9 +94,17 @@ class InstanceImpl : public InstanceWrapper,
       int64_t viewTag,
       std::string eventName,
       folly::dynamic &&eventData) override;
+  void DispatchTouchEvent(
+      std::string eventName,
+      folly::dynamic &&touches,
+      folly::dynamic &&changedIndices) override;
   void invokeCallback(const int64_t callbackId, folly::dynamic &&params)
       override;
 
+  EventCoalescer::Counters GetEventCounters() const noexcept override {
+    return m_events->GetCounters();
+  }
+
   ~InstanceImpl();
 
  private:
@@ -147,6 +160,10 @@ class InstanceImpl : public InstanceWrapper,
   void loadBundleInternal(
       std::string &&jsBundleRelativePath,
       bool synchronously);
+  void QueueEvent(
+      std::string &&method,
+      folly::dynamic &&params,
+      std::optional<EventCoalescer::Key> key);
 
  private:
   std::shared_ptr<Instance> m_innerInstance;
@@ -159,6 +176,17 @@ class InstanceImpl : public InstanceWrapper,
 
   std::shared_ptr<IDevSupportManager> m_devManager;
   std::shared_ptr<DevSettings> m_devSettings;
+
+  // The events waiting for the JS thread. Scroll events and touch moves are
+  // coalesced while JS is busy.
+  std::shared_ptr<EventCoalescer> m_events{std::make_shared<EventCoalescer>()};
+
+  // The indexed RAM bundle loaded last, if any, which the JSI executor
+  // requires modules from. It is set before the bundle is loaded, and read on
+  // the JS thread when the bundle is evaluated.
+  std::shared_ptr<std::shared_ptr<const Microsoft::React::IndexedRAMBundle>>
+      m_ramBundle{std::make_shared<
+          std::shared_ptr<const Microsoft::React::IndexedRAMBundle>>()};
 };
 
 } // namespace react
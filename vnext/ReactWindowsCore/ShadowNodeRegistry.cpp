@@ -5,6 +5,10 @@
 #include "ShadowNode.h"
 #include "ViewManager.h"
 
+#include <stdexcept>
+#include <string>
+#include <utility>
+
 namespace facebook {
 namespace react {
 
@@ -17,7 +21,7 @@ void ShadowNodeRegistry::addRootView(
     std::unique_ptr<ShadowNode, ShadowNodeDeleter> &&root,
     int64_t rootViewTag) {
   m_roots.insert(rootViewTag);
-  m_allNodes[rootViewTag] = std::move(root);
+  addNode(std::move(root), rootViewTag);
 }
 
 ShadowNode &ShadowNodeRegistry::getRoot(int64_t rootViewTag) {
@@ -33,20 +37,79 @@ void ShadowNodeRegistry::removeRootView(int64_t rootViewTag) {
 void ShadowNodeRegistry::addNode(
     std::unique_ptr<ShadowNode, ShadowNodeDeleter> &&node,
     int64_t tag) {
-  m_allNodes[tag] = std::move(node);
+  if (!isPaged(tag)) {
+    m_sparseNodes[tag] = std::move(node);
+    return;
+  }
+
+  const size_t pageIndex = static_cast<size_t>(tag) >> PageShift;
+  if (pageIndex >= m_pages.size())
+    m_pages.resize(pageIndex + 1);
+
+  auto &page = m_pages[pageIndex];
+  if (!page) {
+    if (m_freePages.empty()) {
+      page = std::make_unique<Page>();
+    } else {
+      page = std::move(m_freePages.back());
+      m_freePages.pop_back();
+    }
+  }
+
+  auto &slot = page->nodes[static_cast<size_t>(tag) & (PageSize - 1)];
+  const bool replaced = slot != nullptr;
+  shadow_ptr previous = std::exchange(slot, std::move(node));
+  if (!replaced)
+    ++page->count;
 }
 
 ShadowNode *ShadowNodeRegistry::findNode(int64_t tag) {
-  auto iter = m_allNodes.find(tag);
-  return (iter != m_allNodes.end()) ? iter->second.get() : nullptr;
+  auto slot = findSlot(tag);
+  return slot ? slot->get() : nullptr;
 }
 
 ShadowNode &ShadowNodeRegistry::getNode(int64_t tag) {
-  return *m_allNodes.at(tag);
+  auto node = findNode(tag);
+  if (!node)
+    throw std::out_of_range("No shadow node with tag " + std::to_string(tag));
+  return *node;
 }
 
 void ShadowNodeRegistry::removeNode(int64_t tag) {
-  m_allNodes.erase(tag);
+  if (!isPaged(tag)) {
+    m_sparseNodes.erase(tag);
+    return;
+  }
+
+  auto slot = findSlot(tag);
+  if (!slot || !*slot)
+    return;
+
+  // The node is destroyed once the registry is up to date.
+  shadow_ptr node = std::move(*slot);
+  const size_t pageIndex = static_cast<size_t>(tag) >> PageShift;
+  if (--m_pages[pageIndex]->count == 0) {
+    if (m_freePages.size() < MaxFreePages)
+      m_freePages.push_back(std::move(m_pages[pageIndex]));
+    else
+      m_pages[pageIndex].reset();
+  }
+}
+
+/*static*/ bool ShadowNodeRegistry::isPaged(int64_t tag) noexcept {
+  return tag >= 0 && tag < MaxPagedTag;
+}
+
+shadow_ptr *ShadowNodeRegistry::findSlot(int64_t tag) noexcept {
+  if (!isPaged(tag)) {
+    auto iter = m_sparseNodes.find(tag);
+    return iter != m_sparseNodes.end() ? &iter->second : nullptr;
+  }
+
+  const size_t pageIndex = static_cast<size_t>(tag) >> PageShift;
+  if (pageIndex >= m_pages.size() || !m_pages[pageIndex])
+    return nullptr;
+  return &m_pages[pageIndex]->nodes[static_cast<size_t>(tag) & (PageSize - 1)];
 }
 
 void ShadowNodeRegistry::removeAllRootViews(
@@ -3,7 +3,12 @@
 
 #pragma once
 #include <ShadowNode.h>
-#include <map>
+#include <array>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace facebook {
 namespace react {
@@ -37,8 +42,28 @@ struct ShadowNodeRegistry {
   ShadowNode *getParentRootShadowNode(int64_t nodeTag);
 
  private:
+  static constexpr size_t PageShift = 10;
+  static constexpr size_t PageSize = size_t{1} << PageShift;
+  // Tags from this one on are kept in m_sparseNodes.
+  static constexpr int64_t MaxPagedTag = int64_t{1} << 24;
+  static constexpr size_t MaxFreePages = 8;
+
+  struct Page {
+    std::array<shadow_ptr, PageSize> nodes;
+    size_t count{0};
+  };
+
+  static bool isPaged(int64_t tag) noexcept;
+  shadow_ptr *findSlot(int64_t tag) noexcept;
+
   std::unordered_set<int64_t> m_roots;
-  std::map<int64_t, std::unique_ptr<ShadowNode, ShadowNodeDeleter>> m_allNodes;
+
+  // React allocates tags in sequence, starting from small integers, so nodes
+  // are kept in pages of consecutive tags and found by indexing. Pages that
+  // empty out are kept for the tags React allocates next.
+  std::vector<std::unique_ptr<Page>> m_pages;
+  std::vector<std::unique_ptr<Page>> m_freePages;
+  std::unordered_map<int64_t, shadow_ptr> m_sparseNodes;
 };
 
 } // namespace react
@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "UIBatchQueue.h"
+
+namespace facebook {
+namespace react {
+
+using std::chrono::steady_clock;
+
+void UIBatchQueue::Histogram::Add(uint64_t value) noexcept {
+  size_t bucket = 0;
+  while (value != 0 && bucket < BucketCount - 1) {
+    value >>= 1;
+    ++bucket;
+  }
+  ++buckets[bucket];
+}
+
+UIBatchQueue::UIBatchQueue(Post post, std::chrono::microseconds budget)
+    : m_post(std::move(post)), m_budget(budget) {}
+
+void UIBatchQueue::Submit(WorkItems &&items) {
+  if (items.empty())
+    return;
+
+  if (m_budget.count() == 0) {
+    m_post([self = shared_from_this(), items = std::move(items)]() mutable {
+      self->CountCallback();
+      const auto start = steady_clock::now();
+      for (auto &func : items) {
+        func();
+      }
+      self->Record(steady_clock::now() - start, items.size());
+    });
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_batches.push_back(Batch{std::move(items)});
+    if (m_scheduled)
+      return;
+    m_scheduled = true;
+  }
+
+  m_post([self = shared_from_this()]() { self->Drain(); });
+}
+
+UIBatchQueue::Stats UIBatchQueue::GetStats() const {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_stats;
+}
+
+void UIBatchQueue::Drain() {
+  const auto deadline = steady_clock::now() + m_budget;
+  CountCallback();
+
+  for (;;) {
+    Batch *batch;
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      if (m_batches.empty()) {
+        m_scheduled = false;
+        return;
+      }
+      batch = &m_batches.front();
+    }
+
+    // Always run at least one operation, so that every callback makes
+    // progress. The batch has none left if its last operation threw.
+    auto now = steady_clock::now();
+    const auto batchStart = now;
+    while (batch->next < batch->items.size()) {
+      try {
+        batch->items[batch->next++]();
+      } catch (...) {
+        // m_scheduled is still set, so without another callback nothing
+        // would run the rest of the queue.
+        m_post([self = shared_from_this()]() { self->Drain(); });
+        throw;
+      }
+
+      now = steady_clock::now();
+      if (now >= deadline)
+        break;
+    }
+    batch->elapsed += now - batchStart;
+
+    if (batch->next == batch->items.size()) {
+      Batch done;
+      {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        done = std::move(m_batches.front());
+        m_batches.pop_front();
+      }
+      Record(done.elapsed, done.items.size());
+    }
+
+    if (now >= deadline)
+      break;
+  }
+
+  m_post([self = shared_from_this()]() { self->Drain(); });
+}
+
+void UIBatchQueue::CountCallback() {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  ++m_stats.callbacks;
+}
+
+void UIBatchQueue::Record(steady_clock::duration elapsed, size_t itemCount) {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  m_stats.durationUs.Add(
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+  m_stats.itemCount.Add(itemCount);
+}
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace facebook {
+namespace react {
+
+// Runs the batches of UI operations that JS sends on the UI thread, in the
+// order they were submitted.
+//
+// With no time budget, each batch runs in a single UI thread callback. With a
+// time budget, a callback stops once it has spent the budget, and schedules
+// another callback for the rest, so that a large batch does not hold up input
+// and rendering. Operations still run in order, and a batch always completes
+// before the next one starts, so the layout the UIManager queues at the end of
+// a batch only runs once all of the batch's operations have.
+class UIBatchQueue : public std::enable_shared_from_this<UIBatchQueue> {
+ public:
+  using WorkItems = std::vector<std::function<void()>>;
+
+  // Schedules a callback on the UI thread.
+  using Post = std::function<void(std::function<void()> &&)>;
+
+  // Counts values in power-of-two buckets: bucket 0 counts zeros, and bucket
+  // i counts values in [2^(i-1), 2^i). The last bucket also counts all larger
+  // values.
+  struct Histogram {
+    static constexpr size_t BucketCount = 24;
+
+    void Add(uint64_t value) noexcept;
+
+    std::array<uint64_t, BucketCount> buckets{};
+  };
+
+  struct Stats {
+    // Time spent running the operations of each batch, in microseconds.
+    Histogram durationUs;
+    Histogram itemCount;
+
+    // UI thread callbacks that ran operations.
+    uint64_t callbacks{0};
+  };
+
+  UIBatchQueue(Post post, std::chrono::microseconds budget);
+
+  // May be called from any thread.
+  void Submit(WorkItems &&items);
+
+  Stats GetStats() const;
+
+ private:
+  struct Batch {
+    WorkItems items;
+    size_t next{0};
+    std::chrono::steady_clock::duration elapsed{};
+  };
+
+  void Drain();
+  void CountCallback();
+  void Record(std::chrono::steady_clock::duration elapsed, size_t itemCount);
+
+  const Post m_post;
+  const std::chrono::microseconds m_budget;
+
+  mutable std::mutex m_mutex;
+  // Only the UI thread removes batches, so it can run the front batch
+  // without holding the lock.
+  std::deque<Batch> m_batches;
+  bool m_scheduled{false};
+  Stats m_stats;
+};
+
+} // namespace react
+} // namespace facebook
@@ -22,7 +22,9 @@
 
 namespace facebook {
 namespace react {
-StorageFileIO::StorageFileIO(const WCHAR *storageFileName) {
+std::wstring StorageFileIO::storageFilePath(
+    const WCHAR *storageFileName,
+    const WCHAR *extension) {
   if (storageFileName == nullptr || storageFileName[0] == 0)
     throw std::exception("Storage File name is empty.");
 
@@ -31,7 +33,7 @@ StorageFileIO::StorageFileIO(const WCHAR *storageFileName) {
       winrt::Windows::Storage::ApplicationData::Current().LocalFolder().Path());
   const std::wstring strStorageFolderFullPath = localFolder + L"\\react-native";
   const std::wstring strStorageFileFullPath =
-      strStorageFolderFullPath + L"\\" + storageFileName + L".txt";
+      strStorageFolderFullPath + L"\\" + storageFileName + extension;
 #else
   WCHAR wzMyAppDataDirPathArr[MAX_PATH];
   HRESULT hr = SHGetFolderPathW(
@@ -49,9 +51,8 @@ StorageFileIO::StorageFileIO(const WCHAR *storageFileName) {
   const std::wstring strOfficeFullPath = strMicrosoftFullPath + L"\\Office";
   const std::wstring strStorageFolderFullPath =
       strOfficeFullPath + L"\\SDXStorage";
-  const std::wstring strStorageFileExtension = L".txt";
-  const std::wstring strStorageFileFullPath = strStorageFolderFullPath + L"\\" +
-      storageFileName + strStorageFileExtension;
+  const std::wstring strStorageFileFullPath =
+      strStorageFolderFullPath + L"\\" + storageFileName + extension;
   // full path should be like -
   // C:\Users\<username>\AppData\Local\Microsoft\Office\SDXStorage\ReactNativeAsyncStorage.txt
 
@@ -66,8 +67,15 @@ StorageFileIO::StorageFileIO(const WCHAR *storageFileName) {
       GetLastError() != ERROR_ALREADY_EXISTS)
     throwLastErrorMessage();
 
-    // The FILE_FLAG_WRITE_THROUGH can be specified to ensure any writes are
-    // written to the disk right away but it causes IO to be much slower (~10x).
+  return strStorageFileFullPath;
+}
+
+StorageFileIO::StorageFileIO(const WCHAR *storageFileName) {
+  const std::wstring strStorageFileFullPath =
+      storageFilePath(storageFileName, L".txt");
+
+  // The FILE_FLAG_WRITE_THROUGH can be specified to ensure any writes are
+  // written to the disk right away but it causes IO to be much slower (~10x).
 #ifdef WINRT
   CREATEFILE2_EXTENDED_PARAMETERS extendedParams = {};
   extendedParams.dwSize = sizeof(CREATEFILE2_EXTENDED_PARAMETERS);
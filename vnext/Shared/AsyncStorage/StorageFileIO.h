@@ -24,6 +24,12 @@ class StorageFileIO {
 
   static void throwLastErrorMessage();
 
+  // Returns the full path of a storage file, creating the storage folder if
+  // it does not exist yet.
+  static std::wstring storageFilePath(
+      const WCHAR *storageFileName,
+      const WCHAR *extension);
+
  private:
   HANDLE m_storageFileHandle;
   std::unique_ptr<FILE, std::function<void(FILE *)>> m_storageFile;
@@ -0,0 +1,329 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include <AsyncStorage/StorageFileIO.h>
+#include <AsyncStorage/StorageLog.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+constexpr uint32_t LogMagic = 0x564b4e52; // "RNKV"
+constexpr uint32_t LogVersion = 1;
+
+uint64_t newGeneration(uint64_t previous) {
+  std::random_device random;
+  uint64_t generation;
+  do {
+    generation = (static_cast<uint64_t>(random()) << 32) | random();
+  } while (generation == 0 || generation == previous);
+  return generation;
+}
+
+HANDLE openFile(const std::wstring &path, DWORD access, DWORD disposition) {
+#ifdef WINRT
+  CREATEFILE2_EXTENDED_PARAMETERS extendedParams = {};
+  extendedParams.dwSize = sizeof(CREATEFILE2_EXTENDED_PARAMETERS);
+  extendedParams.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+  return CreateFile2(
+      path.c_str(),
+      access,
+      FILE_SHARE_READ | FILE_SHARE_WRITE,
+      disposition,
+      &extendedParams);
+#else
+  return CreateFileW(
+      path.c_str(),
+      access,
+      FILE_SHARE_READ | FILE_SHARE_WRITE,
+      nullptr,
+      disposition,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+#endif
+}
+
+OVERLAPPED overlappedAt(uint64_t offset) {
+  OVERLAPPED overlapped = {};
+  overlapped.Offset = static_cast<DWORD>(offset);
+  overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+  return overlapped;
+}
+
+} // namespace
+
+StorageLog::StorageLog(const std::wstring &path) {
+  HANDLE handle = openFile(path, GENERIC_READ | GENERIC_WRITE, OPEN_ALWAYS);
+  if (handle == INVALID_HANDLE_VALUE)
+    StorageFileIO::throwLastErrorMessage();
+  m_handle.reset(handle);
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(handle, &fileSize))
+    StorageFileIO::throwLastErrorMessage();
+
+  // A file shorter than the header was never written past its creation.
+  if (static_cast<uint64_t>(fileSize.QuadPart) < HeaderSize) {
+    reset();
+    return;
+  }
+
+  uint8_t header[HeaderSize];
+  DWORD bytesRead = 0;
+  OVERLAPPED overlapped = overlappedAt(0);
+  if (!ReadFile(handle, header, HeaderSize, &bytesRead, &overlapped))
+    StorageFileIO::throwLastErrorMessage();
+
+  if (bytesRead != HeaderSize ||
+      !parseHeader(header, HeaderSize, m_generation))
+    throw std::exception("Corrupt storage file. Unexpected header.");
+
+  m_size = static_cast<uint64_t>(fileSize.QuadPart);
+}
+
+uint64_t StorageLog::append(const std::string &records) {
+  const uint64_t offset = m_size;
+  writeAt(offset, records.data(), records.size());
+  m_size += records.size();
+  return offset;
+}
+
+void StorageLog::flush() {
+  if (!FlushFileBuffers(m_handle.get()))
+    StorageFileIO::throwLastErrorMessage();
+}
+
+void StorageLog::truncate(uint64_t size) {
+  LARGE_INTEGER position;
+  position.QuadPart = static_cast<LONGLONG>(size);
+  if (!SetFilePointerEx(m_handle.get(), position, nullptr, FILE_BEGIN) ||
+      !SetEndOfFile(m_handle.get()))
+    StorageFileIO::throwLastErrorMessage();
+
+  m_size = size;
+}
+
+void StorageLog::reset() {
+  truncate(0);
+  m_generation = newGeneration(m_generation);
+  writeHeader();
+  m_size = HeaderSize;
+}
+
+void StorageLog::writeHeader() {
+  uint8_t header[HeaderSize];
+  memcpy(header, &LogMagic, sizeof(uint32_t));
+  memcpy(header + 4, &LogVersion, sizeof(uint32_t));
+  memcpy(header + 8, &m_generation, sizeof(uint64_t));
+  writeAt(0, header, HeaderSize);
+}
+
+void StorageLog::writeAt(uint64_t offset, const void *data, size_t size) {
+  auto bytes = static_cast<const uint8_t *>(data);
+  while (size > 0) {
+    const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1 << 30));
+    DWORD bytesWritten = 0;
+    OVERLAPPED overlapped = overlappedAt(offset);
+    if (!WriteFile(
+            m_handle.get(), bytes, chunk, &bytesWritten, &overlapped))
+      StorageFileIO::throwLastErrorMessage();
+
+    bytes += bytesWritten;
+    offset += bytesWritten;
+    size -= bytesWritten;
+  }
+}
+
+void StorageLog::appendRecord(
+    std::string &buffer,
+    RecordType type,
+    std::string_view key,
+    std::string_view value) {
+  if (key.size() > UINT32_MAX || value.size() > UINT32_MAX)
+    throw std::exception("Storage record is too large.");
+
+  const uint32_t keySize = static_cast<uint32_t>(key.size());
+  const uint32_t valueSize = static_cast<uint32_t>(value.size());
+  const size_t start = buffer.size();
+  buffer.resize(start + RecordHeaderSize);
+
+  char *header = &buffer[start];
+  header[4] = static_cast<char>(type);
+  memcpy(header + 5, &keySize, sizeof(uint32_t));
+  memcpy(header + 9, &valueSize, sizeof(uint32_t));
+  buffer.append(key);
+  buffer.append(value);
+
+  const uint32_t crc =
+      crc32(buffer.data() + start + 4, buffer.size() - start - 4);
+  memcpy(&buffer[start], &crc, sizeof(uint32_t));
+}
+
+uint64_t StorageLog::parseRecord(
+    const uint8_t *data,
+    uint64_t size,
+    uint64_t offset,
+    Record &record,
+    bool verify) {
+  if (offset > size || size - offset < RecordHeaderSize)
+    return 0;
+
+  const uint8_t *header = data + offset;
+  uint32_t crc, keySize, valueSize;
+  memcpy(&crc, header, sizeof(uint32_t));
+  memcpy(&keySize, header + 5, sizeof(uint32_t));
+  memcpy(&valueSize, header + 9, sizeof(uint32_t));
+
+  const auto type = static_cast<RecordType>(header[4]);
+  if (type != RecordType::Set && type != RecordType::Remove)
+    return 0;
+
+  const uint64_t total = recordSize(keySize, valueSize);
+  if (size - offset < total)
+    return 0;
+
+  if (verify && crc32(header + 4, static_cast<size_t>(total - 4)) != crc)
+    return 0;
+
+  const char *key = reinterpret_cast<const char *>(header + RecordHeaderSize);
+  record.type = type;
+  record.key = std::string_view(key, keySize);
+  record.value = std::string_view(key + keySize, valueSize);
+  return total;
+}
+
+bool StorageLog::parseHeader(
+    const uint8_t *data,
+    uint64_t size,
+    uint64_t &generation) {
+  if (size < HeaderSize)
+    return false;
+
+  uint32_t magic, version;
+  memcpy(&magic, data, sizeof(uint32_t));
+  memcpy(&version, data + 4, sizeof(uint32_t));
+  if (magic != LogMagic || version != LogVersion)
+    return false;
+
+  memcpy(&generation, data + 8, sizeof(uint64_t));
+  return true;
+}
+
+// Table driven CRC-32 (IEEE 802.3, reflected), the same checksum zip uses.
+uint32_t StorageLog::crc32(const void *data, size_t size, uint32_t crc) {
+  static const std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> result;
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t value = i;
+      for (int bit = 0; bit < 8; bit++)
+        value = (value & 1) ? (value >> 1) ^ 0xedb88320 : value >> 1;
+      result[i] = value;
+    }
+    return result;
+  }();
+
+  auto bytes = static_cast<const uint8_t *>(data);
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++)
+    crc = table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+void StorageLog::replaceFile(
+    const std::wstring &path,
+    const std::string &content) {
+  const std::wstring tempPath = path + L".tmp";
+  {
+    HANDLE handle = openFile(tempPath, GENERIC_WRITE, CREATE_ALWAYS);
+    if (handle == INVALID_HANDLE_VALUE)
+      StorageFileIO::throwLastErrorMessage();
+    std::unique_ptr<void, decltype(&CloseHandle)> file{handle, &CloseHandle};
+
+    DWORD bytesWritten = 0;
+    if (!WriteFile(
+            file.get(),
+            content.data(),
+            static_cast<DWORD>(content.size()),
+            &bytesWritten,
+            nullptr) ||
+        bytesWritten != content.size())
+      StorageFileIO::throwLastErrorMessage();
+
+    // The content must be on disk before the rename is, or a crash in
+    // between could leave an empty or partial file at path.
+    if (!FlushFileBuffers(file.get()))
+      StorageFileIO::throwLastErrorMessage();
+  }
+
+  if (!MoveFileExW(
+          tempPath.c_str(),
+          path.c_str(),
+          MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    StorageFileIO::throwLastErrorMessage();
+}
+
+MappedStorageFile::MappedStorageFile(const std::wstring &path) {
+  HANDLE file = openFile(path, GENERIC_READ, OPEN_EXISTING);
+  if (file == INVALID_HANDLE_VALUE) {
+    if (GetLastError() == ERROR_FILE_NOT_FOUND)
+      return;
+    StorageFileIO::throwLastErrorMessage();
+  }
+  m_file.reset(file);
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize))
+    StorageFileIO::throwLastErrorMessage();
+
+  if (fileSize.QuadPart == 0)
+    return;
+
+#ifdef WINRT
+  m_mapping.reset(CreateFileMappingFromApp(
+      file,
+      nullptr /* SecurityAttributes */,
+      PAGE_READONLY,
+      static_cast<ULONG64>(fileSize.QuadPart),
+      nullptr /* Name */));
+#else
+  m_mapping.reset(CreateFileMappingW(
+      file,
+      nullptr /* lpAttributes */,
+      PAGE_READONLY,
+      static_cast<DWORD>(fileSize.HighPart),
+      fileSize.LowPart,
+      nullptr /* lpName */));
+#endif
+  if (!m_mapping)
+    StorageFileIO::throwLastErrorMessage();
+
+#ifdef WINRT
+  m_view.reset(MapViewOfFileFromApp(
+      m_mapping.get(),
+      FILE_MAP_READ,
+      0 /* FileOffset */,
+      0 /* NumberOfBytesToMap */));
+#else
+  m_view.reset(MapViewOfFile(
+      m_mapping.get(),
+      FILE_MAP_READ,
+      0 /* dwFileOffsetHigh */,
+      0 /* dwFileOffsetLow */,
+      0 /* dwNumberOfBytesToMap */));
+#endif
+  if (!m_view)
+    StorageFileIO::throwLastErrorMessage();
+
+  m_size = static_cast<uint64_t>(fileSize.QuadPart);
+}
+
+} // namespace react
+} // namespace facebook
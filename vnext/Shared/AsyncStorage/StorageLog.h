@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <Windows.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace facebook {
+namespace react {
+
+// Append-only, binary framed storage file. The file starts with a header
+// (magic, version, generation) followed by records laid out as
+//
+//   uint32 crc | uint8 type | uint32 keySize | uint32 valueSize | key | value
+//
+// where crc is the CRC-32 of everything that follows it in the record. A
+// record that is torn or fails its CRC ends the log; the caller truncates it
+// away. The generation is a random id that changes whenever the file is reset
+// or rewritten, so side files (e.g. an offset index) can tell whether they
+// still describe this log.
+class StorageLog {
+ public:
+  enum class RecordType : uint8_t { Set = 1, Remove = 2 };
+
+  struct Record {
+    RecordType type;
+    std::string_view key;
+    std::string_view value;
+  };
+
+  static constexpr uint32_t HeaderSize = 16;
+  static constexpr uint32_t RecordHeaderSize = 13;
+
+  // Opens the log at path, creating it with a new header if it does not
+  // exist or is empty.
+  StorageLog(const std::wstring &path);
+
+  StorageLog(const StorageLog &) = delete;
+  StorageLog &operator=(const StorageLog &) = delete;
+
+  uint64_t generation() const {
+    return m_generation;
+  }
+
+  uint64_t size() const {
+    return m_size;
+  }
+
+  // Writes serialized records at the end of the log and returns the offset
+  // they were written at.
+  uint64_t append(const std::string &records);
+
+  // Flushes the OS buffers of the log to the disk.
+  void flush();
+
+  // Drops everything past size. Used to cut off a torn tail.
+  void truncate(uint64_t size);
+
+  // Removes all records and assigns the log a new generation.
+  void reset();
+
+  static uint64_t recordSize(size_t keySize, size_t valueSize) {
+    return RecordHeaderSize + static_cast<uint64_t>(keySize) + valueSize;
+  }
+
+  static void appendRecord(
+      std::string &buffer,
+      RecordType type,
+      std::string_view key,
+      std::string_view value);
+
+  // Parses the record at offset of the size bytes at data. Returns the size
+  // of the record, or 0 if it is truncated or corrupt. The CRC is only
+  // checked when verify is set, so a binary search over an index can look at
+  // keys cheaply and verify the record it ends on.
+  static uint64_t parseRecord(
+      const uint8_t *data,
+      uint64_t size,
+      uint64_t offset,
+      Record &record,
+      bool verify = true);
+
+  // Reads the generation from a mapped log, or returns false if data does
+  // not start with a valid header.
+  static bool
+  parseHeader(const uint8_t *data, uint64_t size, uint64_t &generation);
+
+  static uint32_t crc32(const void *data, size_t size, uint32_t crc = 0);
+
+  // Replaces the file at path with content, through a temporary file so a
+  // crash leaves either the old or the new content behind.
+  static void replaceFile(const std::wstring &path, const std::string &content);
+
+ private:
+  void writeHeader();
+  void writeAt(uint64_t offset, const void *data, size_t size);
+
+  std::unique_ptr<void, decltype(&CloseHandle)> m_handle{nullptr,
+                                                          &CloseHandle};
+  uint64_t m_generation{0};
+  uint64_t m_size{0};
+};
+
+// Read-only view of a whole file. A file that does not exist or is empty
+// yields an empty view. The file can keep being appended to through other
+// handles while it is mapped, but cannot be truncated.
+class MappedStorageFile {
+ public:
+  MappedStorageFile(const std::wstring &path);
+
+  MappedStorageFile(const MappedStorageFile &) = delete;
+  MappedStorageFile &operator=(const MappedStorageFile &) = delete;
+
+  const uint8_t *data() const {
+    return static_cast<const uint8_t *>(m_view.get());
+  }
+
+  uint64_t size() const {
+    return m_size;
+  }
+
+ private:
+  static void unmapView(void *view) {
+    UnmapViewOfFile(view);
+  }
+
+  std::unique_ptr<void, decltype(&CloseHandle)> m_file{nullptr, &CloseHandle};
+  std::unique_ptr<void, decltype(&CloseHandle)> m_mapping{nullptr,
+                                                           &CloseHandle};
+  std::unique_ptr<void, decltype(&unmapView)> m_view{nullptr, &unmapView};
+  uint64_t m_size{0};
+};
+
+} // namespace react
+} // namespace facebook
@@ -0,0 +1,160 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "pch.h"
+
+#include "IndexedRAMBundle.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+using facebook::jsi::Buffer;
+using facebook::react::JSBigString;
+
+namespace {
+
+constexpr size_t HeaderSize = 3 * sizeof(uint32_t);
+
+uint32_t ReadUInt32(const Buffer &bundle, size_t offset) noexcept {
+  // Indexed RAM bundles are little-endian, as is every Windows target.
+  uint32_t value;
+  memcpy(&value, bundle.data() + offset, sizeof(value));
+  return value;
+}
+
+// A piece of code in the bundle, without its null character, which keeps the
+// bundle alive. It is a Buffer for JSI runtimes, and a JSBigString (whose
+// c_str() must be null-terminated) for the Chakra executor.
+class CodeView final : public Buffer, public JSBigString {
+ public:
+  CodeView(std::shared_ptr<const Buffer> bundle, size_t offset, size_t length)
+      : m_bundle{std::move(bundle)}, m_offset{offset}, m_length{length} {}
+
+  size_t size() const override {
+    return m_length;
+  }
+
+  const uint8_t *data() const override {
+    return m_bundle->data() + m_offset;
+  }
+
+  bool isAscii() const override {
+    return false;
+  }
+
+  const char *c_str() const override {
+    return reinterpret_cast<const char *>(data());
+  }
+
+ private:
+  std::shared_ptr<const Buffer> m_bundle;
+  size_t m_offset;
+  size_t m_length;
+};
+
+} // namespace
+
+namespace Microsoft::React {
+
+/*static*/ bool IndexedRAMBundle::IsIndexedRAMBundle(
+    const Buffer &bundle) noexcept {
+  return bundle.size() >= HeaderSize && ReadUInt32(bundle, 0) == MagicNumber;
+}
+
+/*static*/ bool IndexedRAMBundle::IsIndexedRAMBundle(
+    const wchar_t *path) noexcept {
+  std::ifstream file{path, std::ios::binary};
+  uint32_t header[3];
+  if (!file.read(reinterpret_cast<char *>(header), sizeof(header))) {
+    return false;
+  }
+  return header[0] == MagicNumber;
+}
+
+IndexedRAMBundle::IndexedRAMBundle(std::shared_ptr<const Buffer> bundle)
+    : m_bundle{std::move(bundle)} {
+  if (!m_bundle || !IsIndexedRAMBundle(*m_bundle)) {
+    throw std::invalid_argument("Not an indexed RAM bundle.");
+  }
+
+  m_moduleCount = ReadUInt32(*m_bundle, sizeof(uint32_t));
+  m_startupCodeLength = ReadUInt32(*m_bundle, 2 * sizeof(uint32_t));
+
+  // In 64 bits, so that a large module count cannot wrap it around on x86.
+  const uint64_t baseOffset =
+      HeaderSize + static_cast<uint64_t>(m_moduleCount) * sizeof(ModuleEntry);
+  const size_t size = m_bundle->size();
+  if (baseOffset > size) {
+    throw std::invalid_argument("Indexed RAM bundle is truncated.");
+  }
+  m_baseOffset = static_cast<size_t>(baseOffset);
+
+  if (m_startupCodeLength == 0 || m_startupCodeLength > size - m_baseOffset ||
+      m_bundle->data()[m_baseOffset + m_startupCodeLength - 1] != '\0') {
+    throw std::invalid_argument("Indexed RAM bundle is truncated.");
+  }
+}
+
+std::unique_ptr<const JSBigString> IndexedRAMBundle::StartupCode() const {
+  return std::make_unique<const CodeView>(
+      m_bundle, m_baseOffset, m_startupCodeLength - 1);
+}
+
+std::shared_ptr<const Buffer> IndexedRAMBundle::ModuleCode(
+    uint32_t moduleId) const {
+  const ModuleEntry module = FindModule(moduleId);
+  return std::make_shared<const CodeView>(
+      m_bundle, m_baseOffset + module.offset, module.length - 1);
+}
+
+std::unique_ptr<const JSBigString> IndexedRAMBundle::ModuleCodeString(
+    uint32_t moduleId) const {
+  const ModuleEntry module = FindModule(moduleId);
+  return std::make_unique<const CodeView>(
+      m_bundle, m_baseOffset + module.offset, module.length - 1);
+}
+
+/*static*/ std::string IndexedRAMBundle::ModuleSourceURL(uint32_t moduleId) {
+  return std::to_string(moduleId) + ".js";
+}
+
+IndexedRAMBundle::Module IndexedRAMBundle::getModule(
+    uint32_t moduleId) const {
+  const ModuleEntry module = FindModule(moduleId);
+  return Module{
+      ModuleSourceURL(moduleId),
+      std::string(
+          reinterpret_cast<const char *>(m_bundle->data()) + m_baseOffset +
+              module.offset,
+          module.length - 1)};
+}
+
+IndexedRAMBundle::ModuleEntry IndexedRAMBundle::FindModule(
+    uint32_t moduleId) const {
+  if (moduleId >= m_moduleCount) {
+    throw ModuleNotFound("Module not found: " + std::to_string(moduleId));
+  }
+
+  ModuleEntry module;
+  memcpy(
+      &module,
+      m_bundle->data() + HeaderSize + moduleId * sizeof(ModuleEntry),
+      sizeof(module));
+
+  // The table is only checked as modules are required, so that loading the
+  // bundle does not touch every page of it.
+  const size_t size = m_bundle->size() - m_baseOffset;
+  if (module.length == 0 || module.offset > size ||
+      module.length > size - module.offset ||
+      m_bundle->data()[m_baseOffset + module.offset + module.length - 1] !=
+          '\0') {
+    throw ModuleNotFound(
+        "Module " + std::to_string(moduleId) +
+        " has no code in the indexed RAM bundle.");
+  }
+
+  return module;
+}
+
+} // namespace Microsoft::React
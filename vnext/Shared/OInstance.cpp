@@ -23,6 +23,7 @@
 
 #include <cxxreact/MessageQueueThread.h>
 #include <cxxreact/ModuleRegistry.h>
+#include <cxxreact/RAMBundleRegistry.h>
 
 #if (defined(_MSC_VER) && !defined(WINRT))
 #include <WebSocketModule.h>
@@ -57,6 +58,8 @@
 #include "V8JSIRuntimeHolder.h"
 #endif
 #include "ChakraRuntimeHolder.h"
+#include "IndexedRAMBundle.h"
+#include "MemoryMappedBuffer.h"
 
 // foreward declaration.
 namespace facebook {
@@ -196,10 +199,47 @@ namespace react {
 #if !defined(OSS_RN)
 namespace {
 
-void runtimeInstaller(jsi::Runtime &runtime) {
-#ifdef ENABLE_JS_SYSTRACE
-  facebook::react::tracing::initializeJSHooks(runtime);
-#endif
+using Microsoft::React::IndexedRAMBundle;
+
+// Replaces the nativeRequire JSIExecutor installs, which copies each module
+// out of the bundle into a string, with one that evaluates modules straight
+// out of the memory-mapped bundle.
+void installNativeRequire(
+    jsi::Runtime &runtime,
+    std::shared_ptr<const IndexedRAMBundle> bundle) {
+  runtime.global().setProperty(
+      runtime,
+      "nativeRequire",
+      jsi::Function::createFromHostFunction(
+          runtime,
+          jsi::PropNameID::forAscii(runtime, "nativeRequire"),
+          2,
+          [bundle = std::move(bundle)](
+              jsi::Runtime &runtime,
+              const jsi::Value & /*thisVal*/,
+              const jsi::Value *args,
+              size_t count) {
+            if (count == 0 || count > 2) {
+              throw std::invalid_argument("Got wrong number of args");
+            }
+
+            const double moduleId = args[0].getNumber();
+            if (moduleId < 0 || moduleId > UINT32_MAX) {
+              throw std::invalid_argument(folly::to<std::string>(
+                  "Received invalid module ID: ", moduleId));
+            }
+
+            // Like ChakraExecutor, only the main bundle can be required from.
+            if (count == 2 && args[1].getNumber() != 0) {
+              throw std::invalid_argument(folly::to<std::string>(
+                  "Received invalid bundle ID: ", args[1].getNumber()));
+            }
+
+            const auto id = static_cast<uint32_t>(moduleId);
+            runtime.evaluateJavaScript(
+                bundle->ModuleCode(id), IndexedRAMBundle::ModuleSourceURL(id));
+            return jsi::Value::undefined();
+          }));
 }
 
 class OJSIExecutorFactory : public JSExecutorFactory {
@@ -220,22 +260,37 @@ class OJSIExecutorFactory : public JSExecutorFactory {
     }
     bindNativeLogger(*runtimeHolder_->getRuntime(), logger);
 
+    // JSIExecutor calls the installer when it loads a bundle, after it has
+    // installed its own nativeRequire.
+    auto runtimeInstaller = [ramBundle = ramBundle_](jsi::Runtime &runtime) {
+#ifdef ENABLE_JS_SYSTRACE
+      facebook::react::tracing::initializeJSHooks(runtime);
+#endif
+      if (auto bundle = std::atomic_load(ramBundle.get())) {
+        installNativeRequire(runtime, std::move(bundle));
+      }
+    };
+
     return std::make_unique<JSIExecutor>(
         runtimeHolder_->getRuntime(),
         std::move(delegate),
         JSIExecutor::defaultTimeoutInvoker,
-        runtimeInstaller);
+        std::move(runtimeInstaller));
   }
 
   OJSIExecutorFactory(
       std::shared_ptr<jsi::RuntimeHolderLazyInit> runtimeHolder,
-      NativeLoggingHook loggingHook) noexcept
+      NativeLoggingHook loggingHook,
+      std::shared_ptr<std::shared_ptr<const IndexedRAMBundle>>
+          ramBundle) noexcept
       : runtimeHolder_{std::move(runtimeHolder)},
-        loggingHook_{std::move(loggingHook)} {}
+        loggingHook_{std::move(loggingHook)},
+        ramBundle_{std::move(ramBundle)} {}
 
  private:
   std::shared_ptr<jsi::RuntimeHolderLazyInit> runtimeHolder_;
   NativeLoggingHook loggingHook_;
+  std::shared_ptr<std::shared_ptr<const IndexedRAMBundle>> ramBundle_;
 };
 
 } // namespace
@@ -473,7 +528,9 @@ InstanceImpl::InstanceImpl(
     if (m_devSettings->jsiRuntimeHolder) {
       assert(m_devSettings->jsiEngineOverride == JSIEngineOverride::Default);
       jsef = std::make_shared<OJSIExecutorFactory>(
-          m_devSettings->jsiRuntimeHolder, m_devSettings->loggingCallback);
+          m_devSettings->jsiRuntimeHolder,
+          m_devSettings->loggingCallback,
+          m_ramBundle);
     } else if (m_devSettings->jsiEngineOverride != JSIEngineOverride::Default) {
       switch (m_devSettings->jsiEngineOverride) {
         case JSIEngineOverride::Hermes:
@@ -520,7 +577,9 @@ InstanceImpl::InstanceImpl(
           break;
       }
       jsef = std::make_shared<OJSIExecutorFactory>(
-          m_devSettings->jsiRuntimeHolder, m_devSettings->loggingCallback);
+          m_devSettings->jsiRuntimeHolder,
+          m_devSettings->loggingCallback,
+          m_ramBundle);
     } else
 #endif
     {
@@ -681,6 +740,32 @@ void InstanceImpl::loadBundleInternal(
       // Otherwise all bundles (User and Platform) are loaded through
       // platformBundles.
       if (PathFileExistsA(fullBundleFilePath.c_str())) {
+#if !defined(OSS_RN)
+        // Only map the file here if it is an indexed RAM bundle; other
+        // bundles (empty ones included) are mapped as strings below.
+        auto bundleFilePath =
+            Microsoft::Common::Unicode::Utf8ToUtf16(fullBundleFilePath);
+        if (IndexedRAMBundle::IsIndexedRAMBundle(bundleFilePath.c_str())) {
+          // Only the startup code is evaluated now, and every other module
+          // when nativeRequire first asks for it. Both views of the bundle
+          // share the one mapping.
+          auto bundleBuffer =
+              Microsoft::JSI::MakeMemoryMappedBuffer(bundleFilePath.c_str());
+          auto bundle = std::make_shared<const IndexedRAMBundle>(bundleBuffer);
+          auto startupCode = bundle->StartupCode();
+          std::atomic_store(m_ramBundle.get(), std::move(bundle));
+          m_innerInstance->loadRAMBundle(
+              RAMBundleRegistry::singleBundleRegistry(
+                  std::make_unique<IndexedRAMBundle>(std::move(bundleBuffer))),
+              std::move(startupCode),
+              std::move(fullBundleFilePath),
+              synchronously);
+          return;
+        }
+        std::atomic_store(
+            m_ramBundle.get(), std::shared_ptr<const IndexedRAMBundle>{});
+#endif
+
 #if defined(_CHAKRACORE_H_)
         auto bundleString = FileMappingBigString::fromPath(fullBundleFilePath);
 #else
@@ -945,10 +1030,68 @@ void InstanceImpl::DispatchEvent(
     return;
   }
 
-  folly::dynamic params =
-      folly::dynamic::array(viewTag, eventName, std::move(eventData));
-  m_innerInstance->callJSFunction(
-      "RCTEventEmitter", "receiveEvent", std::move(params));
+  std::optional<EventCoalescer::Key> key;
+  if (EventCoalescer::IsCoalescable(eventName)) {
+    key = EventCoalescer::Key{viewTag, eventName, 0};
+  }
+
+  folly::dynamic params = folly::dynamic::array(
+      viewTag, std::move(eventName), std::move(eventData));
+  QueueEvent("receiveEvent", std::move(params), std::move(key));
+}
+
+void InstanceImpl::DispatchTouchEvent(
+    std::string eventName,
+    folly::dynamic &&touches,
+    folly::dynamic &&changedIndices) {
+  if (m_devManager->HasException()) {
+    return;
+  }
+
+  // Moves of one pointer are coalesced, but not those of different pointers,
+  // so that JS does not miss that a pointer moved.
+  std::optional<EventCoalescer::Key> key;
+  if (EventCoalescer::IsCoalescable(eventName) && changedIndices.size() == 1 &&
+      changedIndices[0].isInt()) {
+    key = EventCoalescer::Key{-1, eventName, changedIndices[0].getInt()};
+  }
+
+  folly::dynamic params = folly::dynamic::array(
+      std::move(eventName), std::move(touches), std::move(changedIndices));
+  QueueEvent("receiveTouches", std::move(params), std::move(key));
+}
+
+void InstanceImpl::QueueEvent(
+    std::string &&method,
+    folly::dynamic &&params,
+    std::optional<EventCoalescer::Key> key) {
+  if (!m_events->Push(std::move(method), std::move(params), std::move(key))) {
+    // The queued events are already waiting for the JS thread.
+    return;
+  }
+
+  // Events are taken in one go, on the JS thread, so that events sent while
+  // JS is busy are coalesced. The queue is drained even once the instance is
+  // gone, as Push only schedules a drain when it finds the queue empty.
+  std::weak_ptr<EventCoalescer> weakEvents(m_events);
+  std::weak_ptr<Instance> weakInstance(m_innerInstance);
+  m_jsThread->runOnQueue([weakEvents, weakInstance]() {
+    auto strongEvents = weakEvents.lock();
+    if (!strongEvents) {
+      return;
+    }
+
+    std::vector<EventCoalescer::Event> events = strongEvents->Drain();
+    auto strongInstance = weakInstance.lock();
+    if (!strongInstance) {
+      return;
+    }
+
+    for (EventCoalescer::Event &event : events) {
+      strongInstance->callJSFunction(
+          "RCTEventEmitter", std::move(event.method), std::move(event.params));
+    }
+  });
 }
 
 void InstanceImpl::invokeCallback(
@@ -38,8 +38,8 @@ boost::beast::multi_buffer CreateStringResponseBody(string &&content) {
 
 #pragma region HttpSession
 
-HttpSession::HttpSession(tcp::socket &socket, HttpCallbacks &callbacks)
-    : m_socket{socket},
+HttpSession::HttpSession(tcp::socket &&socket, HttpCallbacks &callbacks)
+    : m_socket{std::move(socket)},
       m_strand{m_socket.get_executor()},
       m_callbacks{callbacks} {}
 
@@ -128,6 +128,22 @@ void HttpSession::Respond() {
       break;
 
     case http::verb::post:
+      m_response = make_shared<http::response<http::dynamic_body>>(
+          m_callbacks.OnPost(m_request));
+
+      http::async_write(
+          m_socket,
+          *m_response,
+          bind_executor(
+              m_strand,
+              std::bind(
+                  &HttpSession::OnWrite,
+                  shared_from_this(),
+                  _1, // error code
+                  _2, // transferred
+                  m_response->need_eof() // close
+                  )));
+
       break;
     case http::verb::put:
       break;
@@ -143,7 +159,7 @@ void HttpSession::Respond() {
 void HttpSession::OnWrite(
     error_code ec,
     size_t /*transferred*/,
-    bool /*close*/) {
+    bool close) {
   if (ec) {
     m_response = nullptr;
     return;
@@ -151,26 +167,32 @@ void HttpSession::OnWrite(
 
   m_callbacks.OnResponseSent();
 
-  // TODO: Re-enable when concurrent sessions are implemented.
   // If response indicates "Connection: close"
-  // if (close)
-  //  return Close();
+  if (close)
+    return Close();
 
   // Clear response
   m_response = nullptr;
 
-  // ISS:2735328: Re-enable for subsequent dispatching.
-  // Read();
+  // Keep the connection alive for the client's next request.
+  Read();
 }
 
 void HttpSession::Close() {
-  m_socket.shutdown(tcp::socket::shutdown_send);
+  error_code ec;
+  m_socket.shutdown(tcp::socket::shutdown_send, ec);
 }
 
 void HttpSession::Start() {
   Read();
 }
 
+void HttpSession::Stop() {
+  error_code ec;
+  m_socket.shutdown(tcp::socket::shutdown_both, ec);
+  m_socket.close(ec);
+}
+
 #pragma warning(pop)
 
 #pragma endregion // HttpSession
@@ -178,7 +200,7 @@ void HttpSession::Start() {
 #pragma region HttpServer
 
 HttpServer::HttpServer(string &&address, uint16_t port)
-    : m_acceptor{m_context}, m_socket{m_context}, m_sessions{} {
+    : m_acceptor{m_context}, m_socket{m_context} {
   auto endpoint = tcp::endpoint{make_address(std::move(address)), port};
   error_code ec;
   m_acceptor.open(endpoint.protocol(), ec);
@@ -219,15 +241,17 @@ void HttpServer::Accept() {
 void HttpServer::OnAccept(error_code ec) {
   if (ec) {
     // ISS:2735328 - Implement failure propagation mechanism
-  } else {
-    auto session = make_shared<HttpSession>(m_socket, m_callbacks);
-    m_sessions.push_back(session);
-    session->Start();
+    return;
   }
 
+  // The session keeps itself alive while it reads or writes. A moved-from
+  // socket is ready to accept the next connection.
+  auto session = make_shared<HttpSession>(std::move(m_socket), m_callbacks);
+  m_sessions.push_back(session);
+  session->Start();
+
   // Accept next connection.
-  // Accept(); //ISS:2735328: Uncomment after implementing multiple context
-  // threading.
+  Accept();
 }
 
 void HttpServer::Start() {
@@ -243,10 +267,22 @@ void HttpServer::Start() {
 }
 
 void HttpServer::Stop() {
-  m_contextThread.join();
+  // The accept loop never runs out of work, so run() only returns once the
+  // context stops.
+  m_context.stop();
+  if (m_contextThread.joinable())
+    m_contextThread.join();
 
   if (m_acceptor.is_open())
     m_acceptor.close();
+
+  // Close connections that clients kept alive, so that they do not wait for
+  // responses that never come.
+  for (auto &weak : m_sessions) {
+    if (auto session = weak.lock())
+      session->Stop();
+  }
+  m_sessions.clear();
 }
 
 void HttpServer::SetOnResponseSent(function<void()> &&handler) noexcept {
@@ -259,6 +295,12 @@ void HttpServer::SetOnGet(
   m_callbacks.OnGet = std::move(handler);
 }
 
+void HttpServer::SetOnPost(
+    function<http::response<http::dynamic_body>(
+        const http::request<http::string_body> &)> &&handler) noexcept {
+  m_callbacks.OnPost = std::move(handler);
+}
+
 #pragma endregion HttpServer
 
 } // namespace Microsoft::React::Test
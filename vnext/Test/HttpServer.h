@@ -6,6 +6,7 @@
 #include <boost/beast/http.hpp>
 
 #include <thread>
+#include <vector>
 
 namespace Microsoft::React::Test {
 
@@ -20,6 +21,9 @@ struct HttpCallbacks {
   std::function<boost::beast::http::response<boost::beast::http::dynamic_body>(
       const boost::beast::http::request<boost::beast::http::string_body> &)>
       OnGet;
+  std::function<boost::beast::http::response<boost::beast::http::dynamic_body>(
+      const boost::beast::http::request<boost::beast::http::string_body> &)>
+      OnPost;
 };
 
 ///
@@ -27,7 +31,7 @@ struct HttpCallbacks {
 // Generates and submits the appropriate HTTP response.
 ///
 class HttpSession : public std::enable_shared_from_this<HttpSession> {
-  boost::asio::ip::tcp::socket &m_socket;
+  boost::asio::ip::tcp::socket m_socket;
   boost::asio::strand<boost::asio::io_context::executor_type> m_strand;
   boost::beast::flat_buffer m_buffer;
   boost::beast::http::request<boost::beast::http::string_body> m_request;
@@ -45,11 +49,14 @@ class HttpSession : public std::enable_shared_from_this<HttpSession> {
   OnWrite(boost::system::error_code ec, std::size_t transferred, bool close);
 
  public:
-  HttpSession(boost::asio::ip::tcp::socket &socket, HttpCallbacks &callbacks);
+  HttpSession(boost::asio::ip::tcp::socket &&socket, HttpCallbacks &callbacks);
 
   ~HttpSession();
 
   void Start();
+
+  // Ends the session. Call only once the server's context stopped.
+  void Stop();
 };
 
 ///
@@ -63,7 +70,7 @@ class HttpServer : public std::enable_shared_from_this<HttpServer> {
   boost::asio::ip::tcp::acceptor m_acceptor;
   boost::asio::ip::tcp::socket m_socket;
   HttpCallbacks m_callbacks;
-  std::vector<std::shared_ptr<HttpSession>> m_sessions;
+  std::vector<std::weak_ptr<HttpSession>> m_sessions;
 
   void OnAccept(boost::system::error_code ec);
 
@@ -94,6 +101,16 @@ class HttpServer : public std::enable_shared_from_this<HttpServer> {
           boost::beast::http::dynamic_body>(
           const boost::beast::http::request<boost::beast::http::string_body> &)>
           &&onGet) noexcept;
+
+  ///
+  // Function that creates an HTTP response to send to the client on POST
+  // requests.
+  ///
+  void SetOnPost(
+      std::function<boost::beast::http::response<
+          boost::beast::http::dynamic_body>(
+          const boost::beast::http::request<boost::beast::http::string_body> &)>
+          &&onPost) noexcept;
 };
 
 } // namespace Microsoft::React::Test
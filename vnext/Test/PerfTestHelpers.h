@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <Windows.h>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#ifndef TEST_CLASS
+#include <iostream>
+#endif
+
+// Helpers for the benchmarks that the unit tests build with PERF_TESTS.
+// Include this after the header of the test framework, which PrintResult
+// writes to: CppUnitTest.h, or else gtest, which writes to stdout.
+namespace Microsoft::React::Test {
+
+// Adds the performance counter ticks that func takes to accu.
+template <typename Func>
+void AddTime(LARGE_INTEGER &accu, Func &&func) {
+  LARGE_INTEGER start{0}, end{0};
+  QueryPerformanceCounter(&start);
+  func();
+  QueryPerformanceCounter(&end);
+  accu.QuadPart += end.QuadPart - start.QuadPart;
+}
+
+// QueryPerformanceFrequency cannot fail on Windows XP or later.
+inline double ToSeconds(LARGE_INTEGER ticks) {
+  LARGE_INTEGER freq{0};
+  QueryPerformanceFrequency(&freq);
+  return static_cast<double>(ticks.QuadPart) / freq.QuadPart;
+}
+
+// Formats the total time of a benchmark, and its time per iteration.
+inline std::string
+FormatResult(const char *testName, uint32_t iterations, LARGE_INTEGER accu) {
+  std::ostringstream ss;
+  double time = ToSeconds(accu);
+  ss << testName << ": its=" << iterations << "; tt=" << time
+     << " s; tc=" << time / iterations * 1000000 << " us";
+  return ss.str();
+}
+
+inline void
+PrintResult(const char *testName, uint32_t iterations, LARGE_INTEGER accu) {
+#ifdef TEST_CLASS
+  Microsoft::VisualStudio::CppUnitTestFramework::Logger::WriteMessage(
+      FormatResult(testName, iterations, accu).c_str());
+#else
+  std::cout << FormatResult(testName, iterations, accu) << std::endl;
+#endif
+}
+
+} // namespace Microsoft::React::Test
@@ -337,8 +337,11 @@ void WebSocketServer::Accept() {
 }
 
 void WebSocketServer::Stop() {
-  if (m_acceptor.is_open())
-    m_acceptor.close();
+  // Close the acceptor on the context thread, where the accept loop runs.
+  post(m_context, [self = shared_from_this()]() {
+    if (self->m_acceptor.is_open())
+      self->m_acceptor.close();
+  });
 
   m_contextThread.join();
 }
@@ -346,21 +349,22 @@ void WebSocketServer::Stop() {
 void WebSocketServer::OnAccept(error_code ec) {
   if (ec) {
     // TODO: fail
-  } else {
-    std::shared_ptr<IWebSocketSession> session;
-    if (m_isSecure)
-      session = std::shared_ptr<IWebSocketSession>(
-          new SecureWebSocketSession(std::move(m_socket), m_callbacks));
-    else
-      session = std::shared_ptr<IWebSocketSession>(
-          new WebSocketSession(std::move(m_socket), m_callbacks));
-
-    m_sessions.push_back(session);
-    session->Start();
+    // This also ends the accept loop once Stop closes the acceptor.
+    return;
   }
 
-  // TODO: Accept again.
-  // Accept();
+  std::shared_ptr<IWebSocketSession> session;
+  if (m_isSecure)
+    session = std::shared_ptr<IWebSocketSession>(
+        new SecureWebSocketSession(std::move(m_socket), m_callbacks));
+  else
+    session = std::shared_ptr<IWebSocketSession>(
+        new WebSocketSession(std::move(m_socket), m_callbacks));
+
+  m_sessions.push_back(session);
+  session->Start();
+
+  Accept();
 }
 
 void WebSocketServer::SetOnConnection(function<void()> &&func) {
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include <CppUnitTest.h>
+
+#include <Modules/NativeUIManager.h>
+
+#include <set>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+using namespace facebook::react;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace react::uwp;
+
+namespace {
+
+// A host without shadow nodes or roots.
+class EmptyHost : public INativeUIManagerHost {
+ public:
+  void zombieView(int64_t /*tag*/) override {}
+
+  std::unordered_set<int64_t> &GetAllRootTags() override {
+    return m_rootTags;
+  }
+
+  ShadowNode &GetShadowNodeForTag(int64_t /*tag*/) override {
+    throw std::out_of_range("No shadow nodes");
+  }
+
+  ShadowNode *FindShadowNodeForTag(int64_t /*tag*/) override {
+    return nullptr;
+  }
+
+  ShadowNode *FindParentRootShadowNode(int64_t /*tag*/) override {
+    return nullptr;
+  }
+
+ private:
+  std::unordered_set<int64_t> m_rootTags;
+};
+
+} // namespace
+
+TEST_CLASS(NativeUIManagerTests) {
+ public:
+  TEST_METHOD(NativeUIManager_WalksOnlyNodesLaidOutAgain) {
+    // A row of three columns, each holding three boxes of two items.
+    YGNodeRef root = YGNodeNew();
+    YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+    std::vector<YGNodeRef> boxes;
+    std::vector<YGNodeRef> items;
+    for (uint32_t c = 0; c < 3; ++c) {
+      YGNodeRef column = YGNodeNew();
+      YGNodeStyleSetWidth(column, 100);
+      YGNodeInsertChild(root, column, c);
+      for (uint32_t b = 0; b < 3; ++b) {
+        YGNodeRef box = YGNodeNew();
+        YGNodeInsertChild(column, box, b);
+        boxes.push_back(box);
+        for (uint32_t i = 0; i < 2; ++i) {
+          YGNodeRef item = YGNodeNew();
+          YGNodeStyleSetHeight(item, 10);
+          YGNodeInsertChild(box, item, i);
+          items.push_back(item);
+        }
+      }
+    }
+    const uint64_t nodeCount = 1 + 3 + boxes.size() + items.size();
+
+    std::set<YGNodeRef> applied;
+    auto apply = [&applied](YGNodeRef node) {
+      applied.insert(node);
+      return true;
+    };
+
+    LayoutStatistics first;
+    YGNodeCalculateLayout(root, 300, 300, YGDirectionLTR);
+    ApplyNewLayouts(root, first, apply);
+    Assert::IsTrue(nodeCount == first.NodesVisited);
+    Assert::IsTrue(nodeCount == first.NodesApplied);
+
+    // Grows the first item of the first column.
+    applied.clear();
+    LayoutStatistics second;
+    YGNodeStyleSetHeight(items[0], 20);
+    YGNodeCalculateLayout(root, 300, 300, YGDirectionLTR);
+    ApplyNewLayouts(root, second, apply);
+
+    Assert::IsTrue(applied.count(items[0]) == 1);
+    Assert::IsTrue(applied.size() == second.NodesApplied);
+
+    // Yoga reused the layouts of the other columns, so the walk looks at
+    // their boxes but at none of their items.
+    for (size_t i = 3; i < boxes.size(); ++i)
+      Assert::IsTrue(applied.count(boxes[i]) == 0);
+    for (size_t i = 6; i < items.size(); ++i)
+      Assert::IsTrue(applied.count(items[i]) == 0);
+    Assert::IsTrue(second.NodesVisited <= nodeCount - (items.size() - 6));
+
+    YGNodeFreeRecursive(root);
+  }
+
+  TEST_METHOD(NativeUIManager_VisitsOnlyMarkedExternalLayoutNodes) {
+    EmptyHost host;
+    NativeUIManager manager;
+    manager.setHost(&host);
+
+    manager.MarkExternalLayoutDirty(3);
+    manager.MarkExternalLayoutDirty(7);
+    manager.MarkExternalLayoutDirty(3);
+    manager.ensureInBatch();
+    manager.onBatchComplete();
+    Assert::IsTrue(
+        2 == manager.GetLayoutStatistics().ExternalLayoutNodesVisited);
+
+    // The layout used up the marks.
+    manager.ensureInBatch();
+    manager.onBatchComplete();
+    Assert::IsTrue(
+        2 == manager.GetLayoutStatistics().ExternalLayoutNodesVisited);
+    Assert::IsTrue(0 == manager.GetLayoutStatistics().RootsLaidOut);
+  }
+};
@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+#include "pch.h"
+
+#include <CppUnitTest.h>
+
+#include <Modules/YogaStyleProps.h>
+#include <Test/PerfTestHelpers.h>
+#include <folly/dynamic.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace react::uwp;
+using Microsoft::React::Test::AddTime;
+using Microsoft::React::Test::PrintResult;
+
+namespace {
+
+// Props of updateView calls recorded while scrolling a list of cards. Most
+// of them are not layout props and are passed on to the view managers.
+folly::dynamic RecordedUpdateViewPayloads() {
+  return folly::dynamic::array(
+      folly::dynamic::object("flexDirection", "row")("alignItems", "center")(
+          "paddingHorizontal", 12)("height", 48)("backgroundColor", -1)(
+          "opacity", 1),
+      folly::dynamic::object("accessibilityLabel", "Card 12")(
+          "testID", "card-12")("borderRadius", 4)("borderWidth", 1)(
+          "borderColor", -2039584)("marginBottom", 8),
+      folly::dynamic::object("fontSize", 14)("color", -16777216)(
+          "marginTop", 4)("numberOfLines", 2)("fontWeight", "600"),
+      folly::dynamic::object("position", "absolute")("top", 0)("left", 0)(
+          "right", 0)("bottom", 0)("overflow", "hidden"),
+      folly::dynamic::object("width", "100%")("aspectRatio", 1.5)(
+          "resizeMode", "cover")("source", "https://example.com/12.png"),
+      folly::dynamic::object("flex", 1)("justifyContent", "space-between")(
+          "transform", folly::dynamic::array())("pointerEvents", "box-none"));
+}
+
+// The cost of the if/else chain the style applier used before: each key is
+// compared with the layout props in order until one matches.
+const StaticStringMapEntry<YogaStyleProp> *FindByComparison(
+    const std::string &key) {
+  for (const auto &entry : YogaStylePropEntries) {
+    if (key == entry.key)
+      return &entry;
+  }
+  return nullptr;
+}
+
+const StaticStringMapEntry<YogaStyleValue> *FindValueByComparison(
+    const std::string &value) {
+  for (const auto &entry : YogaStyleValueEntries) {
+    if (value == entry.key)
+      return &entry;
+  }
+  return nullptr;
+}
+
+} // namespace
+
+TEST_CLASS(YogaStylePropsTests) {
+ public:
+  TEST_METHOD(YogaStyleProps_FindsEveryProp) {
+    for (const auto &entry : YogaStylePropEntries) {
+      auto prop = YogaStyleProps.find(entry.key);
+      Assert::IsNotNull(prop);
+      Assert::IsTrue(*prop == entry.value);
+    }
+  }
+
+  TEST_METHOD(YogaStyleProps_FindsEveryValue) {
+    for (const auto &entry : YogaStyleValueEntries) {
+      auto value = YogaStyleValues.find(entry.key);
+      Assert::IsNotNull(value);
+      Assert::IsTrue(*value == entry.value);
+    }
+  }
+
+  TEST_METHOD(YogaStyleProps_RejectsOtherKeys) {
+    for (const char *key :
+         {"", "backgroundColor", "Flex", "flexx", "fle", "margin "}) {
+      Assert::IsNull(YogaStyleProps.find(key));
+    }
+    Assert::IsNull(YogaStyleValues.find("row-"));
+    Assert::IsNull(YogaStyleValues.find("flexDirection"));
+  }
+
+#ifdef PERF_TESTS
+  TEST_METHOD(YogaStyleProps_TimeRecordedPayloads) {
+    constexpr uint32_t iterations = 100000;
+    const folly::dynamic payloads = RecordedUpdateViewPayloads();
+    uint32_t propCount = 0;
+    for (const auto &props : payloads)
+      propCount += static_cast<uint32_t>(props.size());
+
+    LARGE_INTEGER comparison{0}, perfectHash{0};
+    size_t found = 0;
+
+    AddTime(comparison, [&]() {
+      for (uint32_t i = 0; i < iterations; ++i) {
+        for (const auto &props : payloads) {
+          for (const auto &pair : props.items()) {
+            if (FindByComparison(pair.first.getString())) {
+              ++found;
+              if (pair.second.isString() &&
+                  FindValueByComparison(pair.second.getString()))
+                ++found;
+            }
+          }
+        }
+      }
+    });
+
+    AddTime(perfectHash, [&]() {
+      for (uint32_t i = 0; i < iterations; ++i) {
+        for (const auto &props : payloads) {
+          for (const auto &pair : props.items()) {
+            if (YogaStyleProps.find(pair.first.getString())) {
+              --found;
+              if (pair.second.isString() &&
+                  YogaStyleValues.find(pair.second.getString()))
+                --found;
+            }
+          }
+        }
+      }
+    });
+
+    Assert::AreEqual(static_cast<size_t>(0), found);
+    PrintResult("string comparisons", iterations * propCount, comparison);
+    PrintResult("perfect hash", iterations * propCount, perfectHash);
+  }
+#endif // PERF_TESTS
+};
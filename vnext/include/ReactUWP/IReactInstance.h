@@ -37,6 +37,15 @@ struct ReactInstanceSettings {
   bool EnableByteCodeCaching{false};
   bool EnableDeveloperMenu{false};
 
+  // How long a UI thread callback may run the UI operations JS sends before
+  // it lets input and rendering through. 0 runs each batch in one callback.
+  uint32_t UIBatchFrameBudgetMs{0};
+
+  // Keeps downloaded images on disk from one session to the next. The cache
+  // ignores cache headers, so only enable it for images that do not change.
+  // The first instance started decides for the process.
+  bool EnableImageDiskCache{false};
+
   std::string ByteCodeFileUri;
   std::string DebugHost;
   std::string DebugBundlePath;
@@ -77,6 +86,14 @@ struct IReactInstance {
       int64_t viewTag,
       std::string eventName,
       folly::dynamic &&eventData) = 0;
+  virtual void DispatchTouchEvent(
+      std::string eventName,
+      folly::dynamic &&touches,
+      folly::dynamic &&changedIndices) = 0;
+
+  // How many of the events sent to JS were coalesced.
+  virtual facebook::react::EventCoalescer::Counters GetEventCounters() const
+      noexcept = 0;
 
   virtual void CallJsFunction(
       std::string &&moduleName,
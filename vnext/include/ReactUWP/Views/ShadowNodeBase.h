@@ -98,11 +98,14 @@ struct REACTWINDOWS_EXPORT ShadowNodeBase : public facebook::react::ShadowNode {
 
   void ReparentView(XamlView view);
 
-  // Extra layout handling
+  // Extra layout handling. Nodes whose IsExternalLayoutDirty becomes true
+  // call MarkExternalLayoutDirty, so that the next layout calls their
+  // DoExtraLayoutPrep.
   virtual bool IsExternalLayoutDirty() const {
     return false;
   }
   virtual void DoExtraLayoutPrep(YGNodeRef /*yogaNode*/) {}
+  void MarkExternalLayoutDirty();
 
   bool HasTransformPS() const {
     return m_transformPS != nullptr;